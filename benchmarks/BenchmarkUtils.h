@@ -0,0 +1,50 @@
+#ifndef SIMPLE_TUNER_BENCHMARKS_BENCHMARK_UTILS_H_
+#define SIMPLE_TUNER_BENCHMARKS_BENCHMARK_UTILS_H_
+
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace simple_tuner {
+namespace bench {
+
+constexpr double kPi = 3.14159265358979323846;
+
+// Prevents the optimizer from discarding a benchmarked result
+template <typename T>
+inline void do_not_optimize(const T& value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Mean wall-clock time of one call to fn in microseconds
+template <typename Fn>
+double time_per_call_us(Fn&& fn, std::size_t iterations) {
+  fn();  // Warm caches and lazy state
+  const auto start = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < iterations; ++i) {
+    fn();
+  }
+  const auto stop = std::chrono::steady_clock::now();
+  const std::chrono::duration<double, std::micro> elapsed = stop - start;
+  return elapsed.count() / static_cast<double>(iterations);
+}
+
+inline std::vector<float> make_sine(double frequency, std::size_t num_samples,
+                                    double sample_rate) {
+  std::vector<float> samples(num_samples);
+  for (std::size_t i = 0; i < num_samples; ++i) {
+    samples[i] = static_cast<float>(
+        std::sin(2.0 * kPi * frequency * static_cast<double>(i) / sample_rate));
+  }
+  return samples;
+}
+
+inline double cents_error(double detected, double expected) {
+  return std::abs(1200.0 * std::log2(detected / expected));
+}
+
+}  // namespace bench
+}  // namespace simple_tuner
+
+#endif  // SIMPLE_TUNER_BENCHMARKS_BENCHMARK_UTILS_H_
@@ -0,0 +1,79 @@
+// Time per full-tier detection (4096 samples) for the direct NSDF and the
+// harmonic-sum detector, and the cents error of each on bass strings with
+// a full and a weak (-30 dB) fundamental
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "simple_tuner/algorithms/HarmonicSumDetector.h"
+#include "simple_tuner/algorithms/PitchDetectorFactory.h"
+
+#include "BenchmarkUtils.h"
+
+namespace {
+
+using simple_tuner::DetectionResult;
+using simple_tuner::IPitchDetector;
+
+constexpr double kSampleRate = 48000.0;
+constexpr std::size_t kBufferSize = 4096;
+constexpr double kInharmonicity = 3e-4;
+
+// Eight partials of amplitude 1 / n on a stiff string
+std::vector<float> make_string(double f0, double fundamental) {
+  std::vector<float> samples(kBufferSize, 0.0f);
+  for (int n = 1; n <= 8; ++n) {
+    const double frequency =
+        n * f0 * std::sqrt((1.0 + kInharmonicity * n * n) /
+                           (1.0 + kInharmonicity));
+    const double amplitude = (n == 1 ? fundamental : 1.0) * 0.2 / n;
+    const auto partial =
+        simple_tuner::bench::make_sine(frequency, kBufferSize, kSampleRate);
+    for (std::size_t i = 0; i < kBufferSize; ++i) {
+      samples[i] += static_cast<float>(amplitude * partial[i]);
+    }
+  }
+  return samples;
+}
+
+void run(const char* name, IPitchDetector& detector) {
+  for (double fundamental : {1.0, 0.03}) {
+    double total_us = 0.0;
+    double worst_cents = 0.0;
+    const std::vector<double> notes = {41.2, 55.0, 82.41, 110.0};
+    for (double f0 : notes) {
+      const auto samples = make_string(f0, fundamental);
+      DetectionResult result;
+      total_us += simple_tuner::bench::time_per_call_us(
+          [&]() {
+            result = detector.detect_pitch_detailed(samples.data(),
+                                                    samples.size());
+            simple_tuner::bench::do_not_optimize(result);
+          },
+          50);
+      worst_cents = std::max(
+          worst_cents,
+          result.is_valid
+              ? simple_tuner::bench::cents_error(result.frequency, f0)
+              : 9999.0);
+    }
+    std::printf("%-9s %12.0f %12.1f %16.2f\n", name,
+                20.0 * std::log10(fundamental),
+                total_us / static_cast<double>(notes.size()), worst_cents);
+  }
+}
+
+}  // namespace
+
+int main() {
+  std::printf("%-9s %12s %12s %16s\n", "detector", "fund. (dB)",
+              "us/detect", "max err (cents)");
+  auto nsdf =
+      simple_tuner::PitchDetectorFactory::create(kSampleRate, kBufferSize);
+  run("nsdf", *nsdf);
+  simple_tuner::HarmonicSumDetector harmonic(kSampleRate, kBufferSize);
+  harmonic.set_inharmonicity(kInharmonicity);
+  run("harmonic", harmonic);
+  return 0;
+}
@@ -0,0 +1,39 @@
+// Time per MultiPitchEstimator estimate for each window length, as a share
+// of one core at four estimates per second, on a three-string unison
+#include <cstdio>
+#include <vector>
+
+#include "simple_tuner/algorithms/MultiPitchEstimator.h"
+
+#include "BenchmarkUtils.h"
+
+int main() {
+  constexpr double kSampleRate = 48000.0;
+  constexpr double kEstimatesPerSecond = 4.0;
+
+  std::printf("%-8s %10s %12s %10s %12s\n", "window", "baseband",
+              "us/estimate", "core %", "components");
+  for (double seconds : {0.5, 1.0, 2.0, 4.0}) {
+    simple_tuner::MultiPitchEstimator estimator(kSampleRate, seconds);
+    const std::size_t length = estimator.input_length();
+    const auto a = simple_tuner::bench::make_sine(219.6, length, kSampleRate);
+    const auto b = simple_tuner::bench::make_sine(220.2, length, kSampleRate);
+    const auto c = simple_tuner::bench::make_sine(221.1, length, kSampleRate);
+    std::vector<float> samples(length);
+    for (std::size_t i = 0; i < length; ++i) {
+      samples[i] = 0.1f * a[i] + 0.08f * b[i] + 0.05f * c[i];
+    }
+
+    simple_tuner::MultiPitchResult result;
+    const double us = simple_tuner::bench::time_per_call_us(
+        [&]() {
+          result = estimator.estimate(samples.data(), samples.size(), 220.0);
+          simple_tuner::bench::do_not_optimize(result);
+        },
+        20);
+    std::printf("%-8.1f %10zu %12.1f %10.2f %12d\n", seconds,
+                estimator.window_length(), us,
+                us * kEstimatesPerSecond * 1e-4, result.count);
+  }
+  return 0;
+}
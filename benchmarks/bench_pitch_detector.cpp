@@ -0,0 +1,87 @@
+// Per-tier time per detection and worst-case cents error for each
+// BasicPitchDetector precision policy and the compile-time FixedPitchDetector
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+#include "simple_tuner/algorithms/PitchDetector.h"
+#include "simple_tuner/algorithms/PitchDetectorFactory.h"
+
+#include "BenchmarkUtils.h"
+
+namespace {
+
+using simple_tuner::DetectionResult;
+
+constexpr double kSampleRate = 44100.0;
+
+struct Tier {
+  const char* name;
+  std::size_t buffer_size;
+  std::vector<double> frequencies;
+  std::size_t iterations;
+};
+
+template <typename Detector>
+void run_tier(const char* policy, const Tier& tier, Detector& detector) {
+  double worst_cents = 0.0;
+  double total_us = 0.0;
+  for (double frequency : tier.frequencies) {
+    const auto samples = simple_tuner::bench::make_sine(
+        frequency, tier.buffer_size, kSampleRate);
+
+    DetectionResult result;
+    total_us += simple_tuner::bench::time_per_call_us(
+        [&]() {
+          result = detector.detect_pitch_detailed(samples.data(),
+                                                  samples.size());
+          simple_tuner::bench::do_not_optimize(result);
+        },
+        tier.iterations);
+
+    if (result.is_valid) {
+      worst_cents = std::max(worst_cents, simple_tuner::bench::cents_error(
+                                              result.frequency, frequency));
+    } else {
+      worst_cents = -1.0;
+      break;
+    }
+  }
+
+  const double mean_us =
+      total_us / static_cast<double>(tier.frequencies.size());
+  std::printf("%-6s %-8s %12.1f %16.4f\n", tier.name, policy, mean_us,
+              worst_cents);
+}
+
+template <typename Detector>
+void run_precision(const char* policy, const Tier& tier) {
+  Detector detector(kSampleRate, tier.buffer_size);
+  run_tier(policy, tier, detector);
+}
+
+void run_fixed(const Tier& tier) {
+  auto detector = simple_tuner::PitchDetectorFactory::create(kSampleRate,
+                                                             tier.buffer_size);
+  run_tier("fixed", tier, *detector);
+}
+
+}  // namespace
+
+int main() {
+  const std::vector<Tier> tiers = {
+      {"fast", 512, {261.63, 440.0, 987.77, 4186.01}, 2000},
+      {"medium", 1024, {65.41, 110.0, 196.0, 440.0}, 500},
+      {"full", 4096, {32.70, 65.41, 220.0, 1479.98}, 20},
+  };
+
+  std::printf("%-6s %-8s %12s %16s\n", "tier", "policy", "us/detect",
+              "max err (cents)");
+  for (const Tier& tier : tiers) {
+    run_precision<simple_tuner::FloatPitchDetector>("float", tier);
+    run_precision<simple_tuner::MixedPitchDetector>("mixed", tier);
+    run_precision<simple_tuner::PitchDetector>("double", tier);
+    run_fixed(tier);
+  }
+  return 0;
+}
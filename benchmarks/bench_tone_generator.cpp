@@ -0,0 +1,88 @@
+// Time to fill one device buffer with the reference tone (sine and piano
+// wavetable, one to eight voices), to build the 88-key wavetable bank at
+// startup, and to render an additive stretched-partial voice
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "simple_tuner/algorithms/AdditiveSynth.h"
+#include "simple_tuner/algorithms/ToneGenerator.h"
+#include "simple_tuner/algorithms/WavetableBank.h"
+
+#include "BenchmarkUtils.h"
+
+int main() {
+  constexpr double kSampleRate = 48000.0;
+
+  const auto build_start = std::chrono::steady_clock::now();
+  simple_tuner::WavetableBank bank(kSampleRate);
+  const std::chrono::duration<double, std::milli> build_ms =
+      std::chrono::steady_clock::now() - build_start;
+  std::printf("wavetable bank: %zu-sample tables, %zu KiB, built in %.1f ms\n",
+              bank.table_length(), bank.memory_bytes() / 1024,
+              build_ms.count());
+
+  simple_tuner::ToneGenerator generator;
+  generator.set_wavetable_bank(&bank);
+  generator.set_frequency(440.0);
+  generator.set_enabled(true);
+
+  std::printf("%-12s %-8s %12s\n", "block", "waveform", "us/block");
+  for (auto waveform : {simple_tuner::ToneGenerator::Waveform::kSine,
+                        simple_tuner::ToneGenerator::Waveform::kPiano}) {
+    generator.set_waveform(waveform);
+    const char* name =
+        waveform == simple_tuner::ToneGenerator::Waveform::kSine ? "sine"
+                                                                 : "piano";
+    for (std::size_t block : {64u, 128u, 256u, 512u}) {
+      std::vector<float> buffer(block);
+      const double us = simple_tuner::bench::time_per_call_us(
+          [&]() {
+            generator.generate_samples(buffer.data(), buffer.size(),
+                                       kSampleRate);
+            simple_tuner::bench::do_not_optimize(buffer[0]);
+          },
+          200000);
+      std::printf("%-12zu %-8s %12.4f\n", block, name, us);
+    }
+  }
+
+  // Primary tone plus pool voices (sine, vectorized across voices)
+  generator.set_waveform(simple_tuner::ToneGenerator::Waveform::kSine);
+  std::printf("\n%-12s %-8s %12s\n", "block", "voices", "us/block");
+  int voices = 1;
+  for (int target : {1, 2, 4, 8}) {
+    for (; voices < target; ++voices) {
+      generator.note_on(440.0 * (1.0 + 0.25 * voices), 0.1f);
+    }
+    std::vector<float> buffer(128);
+    const double us = simple_tuner::bench::time_per_call_us(
+        [&]() {
+          generator.generate_samples(buffer.data(), buffer.size(),
+                                     kSampleRate);
+          simple_tuner::bench::do_not_optimize(buffer[0]);
+        },
+        200000);
+    std::printf("%-12d %-8d %12.4f\n", 128, voices, us);
+  }
+
+  // Sustained partials so every one renders for the whole run
+  simple_tuner::AdditiveSynth synth(kSampleRate);
+  synth.set_inharmonicity(4e-4);
+  std::printf("\n%-12s %-8s %12s\n", "block", "partials", "us/block");
+  for (int partials : {1, 8, 16, 32}) {
+    synth.set_default_spectrum(partials, 0.0);
+    synth.note_on(110.0);
+    for (std::size_t block : {128u, 512u}) {
+      std::vector<float> buffer(block);
+      const double us = simple_tuner::bench::time_per_call_us(
+          [&]() {
+            synth.render(buffer.data(), buffer.size());
+            simple_tuner::bench::do_not_optimize(buffer[0]);
+          },
+          100000);
+      std::printf("%-12zu %-8d %12.4f\n", block, partials, us);
+    }
+  }
+  return 0;
+}
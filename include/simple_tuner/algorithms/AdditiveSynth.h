@@ -0,0 +1,107 @@
+#ifndef SIMPLE_TUNER_ALGORITHMS_ADDITIVE_SYNTH_H_
+#define SIMPLE_TUNER_ALGORITHMS_ADDITIVE_SYNTH_H_
+
+#include <cstddef>
+
+namespace simple_tuner {
+
+// Additive synthesis of stretched (inharmonic) reference tones for tuning by
+// partial matching. Partial n sounds at f_n = n * f0 * sqrt(1 + B * n^2)
+// with its own amplitude and exponential decay.
+//
+// Each partial is a recurrence oscillator: a complex phasor rotated (and
+// decayed) by a fixed complex multiplier per step, so rendering never calls
+// sin/cos. Within a block a partial runs kLanes phasors, kLanes samples
+// apart, that step kLanes samples at a time; the lane loop vectorizes and
+// each output sample is a plain add per partial. Per-block phasor state is
+// kept in double, so the float lanes never accumulate drift across blocks.
+//
+// Cost (x86-64 SSE2, GCC -O3, 48 kHz): a 16-partial voice renders a
+// 128-sample block in about 1.5 us and a 512-sample block in about 4 us,
+// under 0.1% of the block's duration; cost is linear in the number of
+// sounding partials (see bench_tone_generator).
+//
+// Not thread-safe: configure and render from one thread. render() never
+// allocates; note_on() and the setters are cheap but not for concurrent use.
+class AdditiveSynth {
+ public:
+  static constexpr int kMaxPartials = 32;
+  static constexpr int kLanes = 32;  // Samples per recurrence step
+
+  explicit AdditiveSynth(double sample_rate = 44100.0) noexcept;
+  ~AdditiveSynth() = default;
+
+  // Sample rate for subsequent notes (ignored if <= 0)
+  void set_sample_rate(double sample_rate) noexcept;
+  double get_sample_rate() const noexcept { return sample_rate_; }
+
+  // Inharmonicity coefficient B for subsequent notes, clamped to [0, 0.1]
+  void set_inharmonicity(double inharmonicity) noexcept;
+  double get_inharmonicity() const noexcept { return inharmonicity_; }
+
+  // Partial n (1-based, up to kMaxPartials) for subsequent notes: initial
+  // amplitude and decay time to -60 dB (<= 0 sustains). Partials above
+  // get_num_partials() are silent.
+  void set_partial(int partial, float amplitude,
+                   double decay_seconds) noexcept;
+
+  // Number of partials rendered, clamped to [1, kMaxPartials]
+  void set_num_partials(int num_partials) noexcept;
+  int get_num_partials() const noexcept { return num_partials_; }
+
+  // Piano-like defaults: num_partials partials with amplitudes falling as
+  // 1/n (scaled to sum to 1, so the output never clips) and decay times
+  // decay_seconds / sqrt(n)
+  void set_default_spectrum(int num_partials, double decay_seconds) noexcept;
+
+  // Starts a note: every partial restarts at zero phase and full amplitude.
+  // Partials at or above 0.45 * sample rate are dropped (band limit).
+  void note_on(double frequency_hz) noexcept;
+
+  // Silences the voice immediately
+  void reset() noexcept;
+
+  // Overwrites out with the next num_samples of the voice
+  void render(float* out, std::size_t num_samples) noexcept;
+
+  // Partials still above -100 dB
+  int active_partials() const noexcept { return num_active_; }
+
+  // f_n = n * f0 * sqrt(1 + B * n^2)
+  static double partial_frequency(double fundamental_hz, int partial,
+                                  double inharmonicity) noexcept;
+
+  AdditiveSynth(const AdditiveSynth&) = delete;
+  AdditiveSynth& operator=(const AdditiveSynth&) = delete;
+
+ private:
+  // Sets block_re_/block_im_ to the num_samples-step multipliers
+  void update_block_rotation(std::size_t num_samples) noexcept;
+
+  // Configuration
+  double sample_rate_;
+  double inharmonicity_;
+  int num_partials_;
+  float amplitude_[kMaxPartials];
+  double decay_seconds_[kMaxPartials];
+
+  // Active partials of the current note (structure of arrays, compacted)
+  int num_active_;
+  double phasor_re_[kMaxPartials];  // Amplitude * cos(phase)
+  double phasor_im_[kMaxPartials];  // Amplitude * sin(phase); the output
+  double step_re_[kMaxPartials];    // One-sample decay * rotation
+  double step_im_[kMaxPartials];
+  float lane_step_re_[kMaxPartials];  // kLanes-sample decay * rotation
+  float lane_step_im_[kMaxPartials];
+  double lane_re_[kMaxPartials][kLanes];  // Lane k offset: step^k
+  double lane_im_[kMaxPartials][kLanes];
+
+  // Cached multipliers for the last block size (recomputed on change)
+  std::size_t block_size_;
+  double block_re_[kMaxPartials];
+  double block_im_[kMaxPartials];
+};
+
+}  // namespace simple_tuner
+
+#endif  // SIMPLE_TUNER_ALGORITHMS_ADDITIVE_SYNTH_H_
@@ -0,0 +1,120 @@
+#ifndef SIMPLE_TUNER_ALGORITHMS_BEAT_DETECTOR_H_
+#define SIMPLE_TUNER_ALGORITHMS_BEAT_DETECTOR_H_
+
+#include <cstddef>
+
+#include "simple_tuner/memory/BufferArena.h"
+
+namespace simple_tuner {
+
+// Beat analysis result
+struct BeatResult {
+  double rate = 0.0;     // Beats per second (0 when the partial is steady)
+  double clarity = 0.0;  // Envelope NSDF at the beat period [0, 1]
+  double depth = 0.0;    // Envelope modulation depth (std / mean)
+  bool is_valid = false;
+};
+
+// Streaming beat-rate meter for unisons and intervals: the beat rate is the
+// difference between two near-coincident partials (e.g. two strings of a
+// unison, or the 3rd partial of a fifth's lower note against the 2nd of
+// its upper note) near a known frequency.
+//  1. Band-pass: two RBJ sections around the coincident frequency
+//     (kBandwidth wide), so other partials do not modulate the envelope.
+//  2. Envelope: the filtered signal squared, smoothed by a one-pole
+//     low-pass and averaged over blocks down to about kEnvelopeRate. Two
+//     partials of amplitudes a, b give a power envelope
+//     a^2 + b^2 + 2ab cos(2 pi df t): a pure cosine at the beat.
+//  3. Autocorrelation: NSDF of up to kHistorySeconds of envelope from lag
+//     1 to the period of kMinBeatRate (SIMD dot products, prefix-sum
+//     normalizers); as in MPM, the first peak past the first negative
+//     lobe that is within kPeakRatio of the highest wins, with peaks
+//     limited to the periods of kMinBeatRate..kMaxBeatRate.
+// A steady envelope (depth below kMinDepth) is a valid zero rate. The
+// per-sample cost is the two biquads and the one-pole; detect() is ~0.2M
+// multiply-adds (~20 us) and only needs to run a few times a second.
+// Zero allocations after construction.
+class BeatDetector {
+ public:
+  static constexpr double kEnvelopeRate = 200.0;   // Hz
+  static constexpr double kHistorySeconds = 4.0;   // Longest analysis
+  static constexpr double kMinSeconds = 1.0;       // Shortest analysis
+  static constexpr double kMinBeatRate = 0.5;      // Hz
+  static constexpr double kMaxBeatRate = 20.0;     // Hz
+  static constexpr double kBandwidth = 40.0;       // Hz, per section
+  static constexpr double kMinDepth = 0.05;
+  static constexpr double kPeakRatio = 0.8;
+
+  explicit BeatDetector(double sample_rate);
+
+  // Same, with the history and scratch buffers carved from arena (must
+  // outlive the detector; see arena_bytes())
+  BeatDetector(double sample_rate, BufferArena& arena);
+
+  BeatDetector(const BeatDetector&) = delete;
+  BeatDetector& operator=(const BeatDetector&) = delete;
+
+  static std::size_t arena_bytes(double sample_rate) noexcept;
+
+  // Centers the band-pass on the coincident partial and clears the history
+  // (<= 0 or beyond 0.45 x the sample rate disables the detector)
+  void set_frequency(double frequency) noexcept;
+  double get_frequency() const noexcept { return frequency_; }
+
+  // Audio thread: filters samples into the envelope history (no-op while
+  // disabled)
+  void push_samples(const float* samples, std::size_t num_samples) noexcept;
+
+  // Beat rate over the envelope history (invalid until kMinSeconds have
+  // been pushed, or if the band is below the level threshold)
+  BeatResult detect() noexcept;
+
+  // Clears the history and filter state
+  void reset() noexcept;
+
+  // Band RMS below this (dBFS) is invalid (default -60)
+  void set_threshold_db(double threshold_db) noexcept;
+
+  double envelope_rate() const noexcept { return envelope_rate_; }
+
+ private:
+  struct Biquad {
+    double b0, b2, a1, a2;  // Band-pass: b1 = 0, b2 = -b0
+    double z1, z2;
+  };
+  static constexpr int kNumSections = 2;
+
+  BeatDetector(double sample_rate, BufferArena* arena);
+
+  static int decimation_for(double sample_rate) noexcept;
+  static std::size_t history_length_for(double sample_rate) noexcept;
+  static std::size_t window_length_for(double sample_rate) noexcept;
+  static int max_lag_for(double sample_rate) noexcept;
+
+  double sample_rate_;
+  int decimation_;
+  double envelope_rate_;
+  std::size_t window_length_;  // Envelope samples in a full analysis
+  std::size_t history_mask_;   // History length - 1 (power of two)
+  int lag_capacity_;
+
+  double frequency_;
+  double threshold_db_;
+  Biquad sections_[kNumSections];
+  double smoothing_;  // One-pole coefficient for the squared signal
+  double smoothed_;
+  double block_sum_;  // Smoothed power since the last envelope sample
+  int phase_;
+  int settling_;  // Envelope samples still to drop after a reset
+  std::size_t write_index_;
+  std::size_t filled_;
+
+  ArenaVector<float> history_;  // Ring of envelope samples
+  ArenaVector<float> working_;  // Linearized, mean-removed envelope
+  ArenaVector<double> energy_;  // Prefix sums of working_ squared
+  ArenaVector<double> nsdf_;    // Lags 0 .. lag_capacity_ + 1
+};
+
+}  // namespace simple_tuner
+
+#endif  // SIMPLE_TUNER_ALGORITHMS_BEAT_DETECTOR_H_
@@ -0,0 +1,30 @@
+#ifndef SIMPLE_TUNER_ALGORITHMS_DETECTION_RESULT_H_
+#define SIMPLE_TUNER_ALGORITHMS_DETECTION_RESULT_H_
+
+namespace simple_tuner {
+
+// Window types for signal pre-processing
+enum class WindowType { kRectangular, kHann, kHamming };
+
+// Pitch detection result with confidence and validity
+struct DetectionResult {
+  double frequency;   // Detected frequency in Hz (0.0 if invalid)
+  double confidence;  // Detection confidence [0.0, 1.0]
+  bool is_valid;      // True if detection meets quality thresholds
+
+  DetectionResult() : frequency(0.0), confidence(0.0), is_valid(false) {}
+  DetectionResult(double freq, double conf, bool valid)
+      : frequency(freq), confidence(conf), is_valid(valid) {}
+};
+
+// A published detection stamped with when it happened, as queued by
+// PitchDetectionController for consumers off the audio thread
+struct DetectionEvent {
+  double frequency = 0.0;   // Hz
+  double confidence = 0.0;  // [0.0, 1.0]
+  double time = 0.0;        // Seconds of audio processed when detected
+};
+
+}  // namespace simple_tuner
+
+#endif  // SIMPLE_TUNER_ALGORITHMS_DETECTION_RESULT_H_
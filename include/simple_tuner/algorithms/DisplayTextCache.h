@@ -0,0 +1,47 @@
+#ifndef SIMPLE_TUNER_ALGORITHMS_DISPLAY_TEXT_CACHE_H_
+#define SIMPLE_TUNER_ALGORITHMS_DISPLAY_TEXT_CACHE_H_
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+#include "simple_tuner/algorithms/TuningTable.h"
+
+namespace simple_tuner {
+
+// Preformatted display strings for the UI frame path, so per-frame text
+// needs no heap allocation or locale-dependent stream formatting.
+// Reference-frequency strings ("440.00 Hz") are cached per piano key and
+// reformatted only when that key's frequency, rounded to 0.01 Hz, changes
+// (e.g. a new reference pitch or temperament). The UI shows no cents text
+// (the meter and the note color carry the deviation), so none is cached.
+// Returned views stay valid until the next call for the same key (notes
+// outside the piano range share one slot). Not thread-safe: use from the
+// message thread.
+class DisplayTextCache {
+ public:
+  DisplayTextCache() noexcept;
+
+  // frequency_hz rounded to 0.01 Hz, with a " Hz" suffix
+  std::string_view reference_text(int midi_note, double frequency_hz) noexcept;
+
+ private:
+  static constexpr std::size_t kTextCapacity = 16;
+
+  struct Text {
+    std::array<char, kTextCapacity> chars;
+    std::size_t length;
+  };
+
+  struct ReferenceEntry {
+    long long centihertz;  // Rounded frequency the text was built for
+    Text text;
+  };
+
+  // Piano keys, then one slot shared by notes outside the range
+  std::array<ReferenceEntry, TuningTable::kNumKeys + 1> reference_;
+};
+
+}  // namespace simple_tuner
+
+#endif  // SIMPLE_TUNER_ALGORITHMS_DISPLAY_TEXT_CACHE_H_
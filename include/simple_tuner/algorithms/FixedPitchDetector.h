@@ -0,0 +1,83 @@
+#ifndef SIMPLE_TUNER_ALGORITHMS_FIXED_PITCH_DETECTOR_H_
+#define SIMPLE_TUNER_ALGORITHMS_FIXED_PITCH_DETECTOR_H_
+
+#include <array>
+#include <cstddef>
+
+#include "simple_tuner/algorithms/DetectionResult.h"
+#include "simple_tuner/interfaces/IPitchDetector.h"
+
+namespace simple_tuner {
+
+// MPM pitch detector specialized at compile time for one frame size and
+// sample rate. Storage is inline std::array (no heap blocks) and the window
+// tables are constexpr; pre-processing and the NSDF dot products run on the
+// SIMD kernels in dsp/BlockOps.h.
+// Buffers are float; the lag products r(tau) come from the float
+// dot_product kernel, while the energy terms of the NSDF are accumulated in
+// double.
+//
+// Only the controller's tier sizes (512, 1024, 4096) at 44100 and 48000 Hz
+// are instantiated, in FixedPitchDetector.cpp; use PitchDetectorFactory to
+// pick between this and the runtime-sized PitchDetector.
+template <std::size_t N, int SampleRate>
+class FixedPitchDetector : public IPitchDetector {
+ public:
+  static_assert(N >= 4, "Frame must hold at least a few samples");
+  static_assert(SampleRate > 0, "Sample rate must be positive");
+
+  static constexpr std::size_t kBufferSize = N;
+  static constexpr double kSampleRate = static_cast<double>(SampleRate);
+
+  FixedPitchDetector() noexcept;
+  ~FixedPitchDetector() override = default;
+
+  // Simple API: returns detected frequency in Hz, or 0.0 if no pitch detected
+  double detect_pitch(const float* samples, std::size_t num_samples) noexcept;
+
+  // Extended API: analyzes the first N samples; returns an invalid result
+  // if fewer than N samples are supplied
+  DetectionResult detect_pitch_detailed(
+      const float* samples, std::size_t num_samples) noexcept override;
+
+  // Configuration methods
+  void set_threshold_db(double threshold_db) noexcept override;
+  void set_min_frequency(double min_freq) noexcept override;
+  void set_max_frequency(double max_freq) noexcept override;
+  void set_window_type(WindowType type) noexcept override;
+  void set_base_clarity_threshold(double threshold) noexcept override;
+
+  // Getters for configuration
+  double get_threshold_db() const noexcept { return threshold_db_; }
+  double get_min_frequency() const noexcept { return min_freq_; }
+  double get_max_frequency() const noexcept { return max_freq_; }
+  WindowType get_window_type() const noexcept { return window_type_; }
+  double get_base_clarity_threshold() const noexcept {
+    return base_clarity_threshold_;
+  }
+
+ private:
+  // NSDF over lags [first_lag, max_lag_]; energy is the sum of squares of
+  // the pre-processed frame
+  void compute_nsdf(int first_lag, double energy) noexcept;
+
+  // Configuration
+  double threshold_db_;
+  double threshold_linear_;  // Cached 10^(threshold_db / 20)
+  double min_freq_;
+  double max_freq_;
+  WindowType window_type_;
+  double base_clarity_threshold_;
+
+  // Lag range for autocorrelation
+  int min_lag_;
+  int max_lag_;
+
+  // Inline buffers (cache-line aligned)
+  alignas(64) std::array<float, N> working_;
+  alignas(64) std::array<float, N> nsdf_;
+};
+
+}  // namespace simple_tuner
+
+#endif  // SIMPLE_TUNER_ALGORITHMS_FIXED_PITCH_DETECTOR_H_
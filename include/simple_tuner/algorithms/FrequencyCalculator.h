@@ -1,33 +1,63 @@
 #ifndef SIMPLE_TUNER_ALGORITHMS_FREQUENCY_CALCULATOR_H_
 #define SIMPLE_TUNER_ALGORITHMS_FREQUENCY_CALCULATOR_H_
 
-#include <string>
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+#include "simple_tuner/algorithms/TuningTable.h"
 
 namespace simple_tuner {
 
+// Structure-of-arrays output of FrequencyCalculator::convert_batch
+struct NoteResults {
+  int* midi_note;  // Nearest piano key per frequency
+  double* cents;   // Deviation from that key's target (positive is sharp)
+};
+
+// Note and cents arithmetic against a TuningTable (equal temperament at
+// A4 = 440 Hz by default); queries are table reads plus one fast log2
 class FrequencyCalculator {
  public:
   FrequencyCalculator();
   explicit FrequencyCalculator(double reference_a4_hz);
   ~FrequencyCalculator() = default;
 
-  // Equal temperament frequency conversions
+  // Target frequency of a note under the current tuning
   double midi_to_frequency(int midi_note) const noexcept;
+  // Nearest piano key (MIDI 21..108) to a positive frequency
   int frequency_to_midi(double frequency) const noexcept;
 
   // Tuning calculations
   double calculate_cents(double frequency, int target_midi) const noexcept;
 
-  // Note naming
-  std::string midi_to_note_name(int midi_note) const noexcept;
+  // frequency_to_midi and calculate_cents against the nearest key for count
+  // frequencies, e.g. a run of detector frames; the log2 pass is vectorized.
+  // Non-positive frequencies give MIDI 21 and 0 cents.
+  void convert_batch(const double* frequencies, std::size_t count,
+                     const NoteResults& results) const noexcept;
+
+  // Note naming: views into a static table (no allocation)
+  static constexpr std::string_view note_name(int midi_note) noexcept {
+    constexpr std::array<std::string_view, 12> kNoteNames = {
+        "C", "C#", "D", "D#", "E", "F", "F#", "G", "G#", "A", "A#", "B"};
+    return kNoteNames[static_cast<std::size_t>(((midi_note % 12) + 12) % 12)];
+  }
+  std::string_view midi_to_note_name(int midi_note) const noexcept {
+    return note_name(midi_note);
+  }
   int midi_to_octave(int midi_note) const noexcept;
 
   // Reference pitch
   void set_reference_a4(double frequency) noexcept;
   double get_reference_a4() const noexcept;
 
+  // Temperament and stretch curve
+  TuningTable& tuning_table() noexcept { return tuning_table_; }
+  const TuningTable& tuning_table() const noexcept { return tuning_table_; }
+
  private:
-  double reference_a4_;
+  TuningTable tuning_table_;
 };
 
 }  // namespace simple_tuner
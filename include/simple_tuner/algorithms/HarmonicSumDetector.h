@@ -0,0 +1,124 @@
+#ifndef SIMPLE_TUNER_ALGORITHMS_HARMONIC_SUM_DETECTOR_H_
+#define SIMPLE_TUNER_ALGORITHMS_HARMONIC_SUM_DETECTOR_H_
+
+#include <array>
+#include <complex>
+#include <cstddef>
+
+#include "simple_tuner/algorithms/DetectionResult.h"
+#include "simple_tuner/dsp/Fft.h"
+#include "simple_tuner/interfaces/IPitchDetector.h"
+#include "simple_tuner/memory/BufferArena.h"
+
+namespace simple_tuner {
+
+// Spectral full-tier detector for bass strings whose fundamental is much
+// weaker than their 2nd-4th partials, where the NSDF risks an octave error.
+//  1. Spectrum: one FFT of the Hann-windowed frame, zero-padded to twice
+//     its length (computed as a half-size complex FFT of the packed real
+//     frame). Only local maxima are kept, as their excess over the
+//     spectrum's median, so one main lobe cannot pass for several partials.
+//  2. Subharmonic summation: every candidate on a quarter-semitone grid
+//     over [min, max] frequency sums its first kMaxPartials partials with
+//     geometrically falling weights. Partial n is looked for at
+//     n * f0 * sqrt((1 + B n^2) / (1 + B)) (stiff string, B from
+//     set_inharmonicity), as the strongest peak within the grid's spacing
+//     of it, so the radius grows with n.
+//  3. Octave check: a winner whose double octave, twelfth or octave below
+//     explains peaks the winner's partials do not is replaced by it.
+//  4. Frequency: log-parabolic peaks of the winner's partials. With three
+//     or more, their own B is fitted (least squares of (f_n / n)^2 on n^2)
+//     and each gives an implied fundamental, averaged by level and n.
+// Confidence is the share of the spectrum's peak energy, up to the last
+// partial, that the partials account for; frames below the base clarity
+// threshold (default 0.3) are invalid.
+// ~120 us per 4096-sample frame at 48 kHz (Release, bench_harmonic_sum),
+// against ~230 us for the NSDF full tier. Zero allocations after
+// construction.
+class HarmonicSumDetector : public IPitchDetector {
+ public:
+  static constexpr int kMaxPartials = 8;
+  static constexpr int kCandidatesPerSemitone = 4;
+  static constexpr double kDefaultInharmonicity = 4e-4;  // Bass string
+
+  HarmonicSumDetector(double sample_rate, std::size_t buffer_size);
+
+  // Same, with the FFT tables and scratch buffers carved from arena (must
+  // outlive the detector; see arena_bytes())
+  HarmonicSumDetector(double sample_rate, std::size_t buffer_size,
+                      BufferArena& arena);
+
+  ~HarmonicSumDetector() override = default;
+
+  HarmonicSumDetector(const HarmonicSumDetector&) = delete;
+  HarmonicSumDetector& operator=(const HarmonicSumDetector&) = delete;
+
+  static std::size_t arena_bytes(std::size_t buffer_size) noexcept;
+
+  // Inharmonicity used to place the partials (clamped to [0, 0.05])
+  void set_inharmonicity(double inharmonicity) noexcept;
+  double get_inharmonicity() const noexcept { return inharmonicity_; }
+
+  // Analyzes the first buffer_size samples; invalid if fewer are supplied
+  DetectionResult detect_pitch_detailed(
+      const float* samples, std::size_t num_samples) noexcept override;
+
+  void set_threshold_db(double threshold_db) noexcept override;
+  // Range of the candidate fundamentals (their partials may lie above)
+  void set_min_frequency(double min_freq) noexcept override;
+  void set_max_frequency(double max_freq) noexcept override;
+  // Always Hann; ignored
+  void set_window_type(WindowType type) noexcept override;
+  void set_base_clarity_threshold(double threshold) noexcept override;
+
+  std::size_t get_buffer_length() const noexcept { return buffer_size_; }
+  // Zero-padded transform length
+  std::size_t spectrum_length() const noexcept { return 2 * fft_.size(); }
+  double get_min_frequency() const noexcept { return min_freq_; }
+  double get_max_frequency() const noexcept { return max_freq_; }
+
+ private:
+  HarmonicSumDetector(double sample_rate, std::size_t buffer_size,
+                      BufferArena* arena);
+
+  // Magnitudes of the zero-padded windowed frame into magnitude_
+  void compute_spectrum() noexcept;
+
+  // Position of partial n (1-based) of f0, in spectrum bins
+  double partial_bin(double f0, int n) const noexcept;
+  // Strongest peak within the search radius of position (-1 if none)
+  std::ptrdiff_t partial_peak(double position) const noexcept;
+  double score(double f0) const noexcept;
+  // Mean excess of the partials of f0 that the candidate ratio times
+  // higher lacks, leaving out its peaks (-1 if none is in the band)
+  double unexplained_level(double f0, int ratio,
+                           const std::ptrdiff_t* winner_peaks,
+                           int num_winner_peaks) const noexcept;
+
+  double sample_rate_;
+  std::size_t buffer_size_;
+  double threshold_db_;
+  double min_freq_;
+  double max_freq_;
+  double min_confidence_;
+  double inharmonicity_;
+  double bin_hz_;      // Spectrum bin spacing
+  std::size_t band_;   // Bins analysed (below 0.45 x sample rate)
+  // Partial n's position per Hz of f0, in bins
+  std::array<double, kMaxPartials> partial_scale_;
+
+  // Scratch in access order: window, windowed frame, the packed half-size
+  // transform with its tables, then the spectrum
+  ArenaVector<float> window_;   // Hann over buffer_size samples
+  ArenaVector<float> frame_;    // Windowed, mean-removed frame
+  ArenaVector<std::complex<double>> packed_;  // Even/odd sample pairs
+  dsp::Fft fft_;                              // Half the padded length
+  ArenaVector<std::complex<double>> rotation_;  // e^{-2 pi j k / padded}
+  ArenaVector<float> magnitude_;  // Band bins, full scale = 1
+  ArenaVector<float> excess_;     // Peaks above the median, else 0
+  ArenaVector<float> scratch_;    // Median selection
+};
+
+}  // namespace simple_tuner
+
+#endif  // SIMPLE_TUNER_ALGORITHMS_HARMONIC_SUM_DETECTOR_H_
@@ -0,0 +1,109 @@
+#ifndef SIMPLE_TUNER_ALGORITHMS_INHARMONICITY_ANALYZER_H_
+#define SIMPLE_TUNER_ALGORITHMS_INHARMONICITY_ANALYZER_H_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "simple_tuner/algorithms/InharmonicityEstimator.h"
+#include "simple_tuner/algorithms/TuningTable.h"
+#include "simple_tuner/memory/SpscQueue.h"
+
+namespace simple_tuner {
+
+// Runs InharmonicityEstimator for one key at a time on its own worker
+// thread and keeps the latest result per piano key.
+// Audio reaches it in one of two ways:
+//  - request_capture(): the worker records the next capture_seconds of the
+//    audio thread's push_audio() calls (a lock-free SPSC ring, written only
+//    while a capture is in progress), then analyzes it;
+//  - request_analysis(): a block already buffered elsewhere is copied in.
+// The audio thread only ever calls push_audio(); everything else is for the
+// UI thread. One request is in flight at a time.
+class InharmonicityAnalyzer {
+ public:
+  static constexpr double kDefaultCaptureSeconds = 0.5;
+  static constexpr std::size_t kQueueCapacity = 16384;  // Samples
+
+  explicit InharmonicityAnalyzer(
+      double sample_rate, double capture_seconds = kDefaultCaptureSeconds);
+
+  // Stops the worker (abandoning any request in flight) and joins it
+  ~InharmonicityAnalyzer();
+
+  InharmonicityAnalyzer(const InharmonicityAnalyzer&) = delete;
+  InharmonicityAnalyzer& operator=(const InharmonicityAnalyzer&) = delete;
+
+  // Audio thread: offers the callback's samples; a no-op unless a capture
+  // is in progress. A capture that overflows the ring restarts.
+  void push_audio(const float* samples, std::size_t num_samples) noexcept;
+
+  // Records the next capture window and estimates B for midi_note (a piano
+  // key) around expected_frequency. False if busy or the key is invalid.
+  bool request_capture(int midi_note, double expected_frequency);
+
+  // Estimates B for midi_note from the first capture window of samples
+  bool request_analysis(int midi_note, double expected_frequency,
+                        const float* samples, std::size_t num_samples);
+
+  bool is_busy() const;
+
+  // Blocks until no request is in flight; false on timeout
+  bool wait_until_idle(std::chrono::milliseconds timeout) const;
+
+  // Latest result for a key; false if the key has not been analyzed
+  bool get_result(int midi_note, InharmonicityResult& result) const;
+
+  // Partials per analysis (see InharmonicityEstimator::set_num_partials);
+  // takes effect from the next request
+  void set_num_partials(int num_partials);
+
+  std::size_t capture_length() const noexcept { return capture_length_; }
+
+ private:
+  struct Request {
+    int midi_note = 0;
+    double expected_frequency = 0.0;
+    std::size_t length = 0;  // Buffered samples (0 for a capture)
+    bool capture = false;
+  };
+
+  static bool is_piano_key(int midi_note) noexcept {
+    return midi_note >= TuningTable::kFirstKey &&
+           midi_note <= TuningTable::kLastKey;
+  }
+
+  bool submit(const Request& request, const float* samples);
+  void run();
+  // Worker: fills samples_ from the ring; false if stopped meanwhile
+  bool capture_audio();
+
+  std::size_t capture_length_;
+  InharmonicityEstimator estimator_;  // Worker thread only
+  std::vector<float> samples_;        // Block being analyzed
+
+  SpscQueue<float, kQueueCapacity> queue_;  // Audio thread -> worker
+  std::atomic<bool> capturing_;
+  std::atomic<bool> overrun_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable wake_;          // Worker: request or stop
+  mutable std::condition_variable idle_;  // Waiters: request finished
+  Request request_;
+  bool pending_;
+  bool stop_;
+  int num_partials_;
+  std::array<InharmonicityResult, TuningTable::kNumKeys> results_;
+  std::array<bool, TuningTable::kNumKeys> has_result_;
+
+  std::thread worker_;  // Last: starts after everything above exists
+};
+
+}  // namespace simple_tuner
+
+#endif  // SIMPLE_TUNER_ALGORITHMS_INHARMONICITY_ANALYZER_H_
@@ -0,0 +1,86 @@
+#ifndef SIMPLE_TUNER_ALGORITHMS_INHARMONICITY_ESTIMATOR_H_
+#define SIMPLE_TUNER_ALGORITHMS_INHARMONICITY_ESTIMATOR_H_
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include "simple_tuner/dsp/Fft.h"
+
+namespace simple_tuner {
+
+// Inharmonicity fit of one string: partial n sits at
+// n * fundamental * sqrt(1 + B n^2)
+struct InharmonicityResult {
+  static constexpr int kMaxPartials = 16;
+
+  double inharmonicity = 0.0;  // B
+  double fundamental = 0.0;    // Hz, of the ideal flexible string
+  int num_partials = 0;        // Partials located and fitted
+  // Measured frequency of partial n + 1 (0 if not located)
+  std::array<double, kMaxPartials> partials{};
+  bool is_valid = false;
+};
+
+// Estimates a string's inharmonicity coefficient B from a block of its
+// sound (about 0.5 s of a sustained note). Partials 1..N are located in
+// order, each with a chirp-z zoom (1/8-bin spacing) over a narrow band
+// around its predicted frequency and log-parabolic interpolation of the
+// Hann-windowed peak:
+//  - partial 1: +-kSearchCents around the expected frequency;
+//  - partial 2 (or any while only one is known): from harmonic up to the
+//    stretch of kMaxInharmonicity;
+//  - later partials: +-kTrackCents around the running fit's prediction.
+// A peak counts only if it is a local maximum inside its band and
+// kMinPeakRatio above the median of the band widened by a few bins (the
+// noise floor around it). B and the fundamental come from a weighted least
+// squares fit of (f_n / n)^2 = f0^2 + f0^2 B n^2 (weights by the frequency
+// error each partial contributes). Valid with at least kMinPartials.
+// Allocates at construction only; a call costs two FFTs of about twice the
+// block length per partial (tens of milliseconds for 8 partials of
+// 0.5 s at 48 kHz). Meant for a background thread (InharmonicityAnalyzer),
+// never the audio callback.
+class InharmonicityEstimator {
+ public:
+  static constexpr int kMaxPartials = InharmonicityResult::kMaxPartials;
+  static constexpr int kMinPartials = 3;
+  static constexpr double kMaxInharmonicity = 0.05;
+  static constexpr double kSearchCents = 60.0;
+  static constexpr double kTrackCents = 25.0;
+  static constexpr double kMinPeakRatio = 100.0;  // 20 dB
+
+  // max_samples: longest block analyzed (longer inputs use their start);
+  // it also sets the zoom resolution, so blocks should be about this long
+  InharmonicityEstimator(double sample_rate, std::size_t max_samples);
+
+  // Partials to locate, fundamental included (clamped to
+  // [kMinPartials, kMaxPartials]; default 8)
+  void set_num_partials(int num_partials) noexcept;
+  int get_num_partials() const noexcept { return num_partials_; }
+
+  std::size_t max_samples() const noexcept { return max_samples_; }
+
+  // expected_frequency: nominal fundamental of the key (e.g. its
+  // equal-tempered frequency)
+  InharmonicityResult estimate(const float* samples, std::size_t num_samples,
+                               double expected_frequency) noexcept;
+
+ private:
+  // Locates a peak in [low, high] Hz; 0 if there is no clear interior peak
+  double locate_partial(double low, double high) noexcept;
+
+  double sample_rate_;
+  std::size_t max_samples_;
+  int num_partials_;
+  double spacing_hz_;  // Zoom resolution
+
+  std::vector<float> windowed_;  // Mean-removed, Hann-windowed, zero-padded
+  dsp::ChirpZTransform zoom_;
+  std::vector<std::complex<double>> spectrum_;
+  std::vector<double> power_;
+  std::vector<double> sorted_;  // Scratch for the band median
+};
+
+}  // namespace simple_tuner
+
+#endif  // SIMPLE_TUNER_ALGORITHMS_INHARMONICITY_ESTIMATOR_H_
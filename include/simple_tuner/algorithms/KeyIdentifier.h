@@ -0,0 +1,97 @@
+#ifndef SIMPLE_TUNER_ALGORITHMS_KEY_IDENTIFIER_H_
+#define SIMPLE_TUNER_ALGORITHMS_KEY_IDENTIFIER_H_
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include "simple_tuner/dsp/ConstantQ.h"
+
+namespace simple_tuner {
+
+// Which piano key is sounding, with a coarse look at its partials
+struct KeyEstimate {
+  static constexpr int kMaxPartials = 8;
+  static constexpr double kFloorDb = -120.0;
+
+  int midi_note = 0;
+  // From the strongest of the first four partials, to a few cents: enough
+  // to pick a target, not to tune by
+  double frequency = 0.0;
+  // Share of the spectrum's peak energy the key's partials account for
+  double confidence = 0.0;
+  double level_db = kFloorDb;  // Strongest partial, dB re full scale
+  // Partial h + 1 relative to the strongest; kFloorDb above the analysis
+  // range
+  std::array<double, kMaxPartials> partial_db{};
+  int num_partials = 0;  // Partials within the analysis range
+  bool is_stable = false;  // Same key over several updates (KeyTracker)
+  bool is_valid = false;
+};
+
+// Identifies the sounding key from a keyboard-wide constant-Q spectrum:
+// three bins per semitone from A0 to C8 (the middle one of each three on
+// the key at reference_a4), windows of half the bin spacing's Q so each
+// key is resolved in about a second at A0. The input is low-passed and
+// decimated to about 16 kHz first, which keeps the frame at 16384
+// samples. Every key is scored by subharmonic summation of its first
+// kMaxPartials partials above the spectrum's median, each taken as the
+// largest bin within a third of a semitone (room for stretched partials),
+// with geometrically falling weights; a winner whose octave, twelfth or
+// double octave below explains partials it cannot is replaced by that key,
+// which catches the missing fundamentals of the bass.
+// Not for the audio thread: a call is one 16384-point FFT plus a few
+// hundred thousand multiply-adds. See KeyTracker for the threaded wrapper.
+class KeyIdentifier {
+ public:
+  static constexpr int kBinsPerSemitone = 3;
+  static constexpr double kAnalysisRate = 16000.0;  // Decimated rate floor
+  static constexpr double kWindowScale = 0.5;
+  static constexpr double kDefaultThresholdDb = -60.0;
+
+  explicit KeyIdentifier(double sample_rate, double reference_a4 = 440.0);
+
+  // Input samples one identification looks at
+  std::size_t frame_length() const noexcept { return frame_length_; }
+  int decimation() const noexcept { return decimation_; }
+
+  // Quieter spectra (strongest partial, dBFS) are not identified
+  void set_threshold_db(double threshold_db) noexcept;
+  double get_threshold_db() const noexcept { return threshold_db_; }
+
+  // Identifies the key from the last frame_length() samples (fewer are
+  // zero-padded in front)
+  KeyEstimate identify(const float* samples, std::size_t num_samples);
+
+  // The last identification's constant-Q magnitudes; key k's bin is
+  // bin_of_key(k)
+  const std::vector<float>& spectrum() const noexcept { return magnitudes_; }
+  const dsp::ConstantQTransform& transform() const noexcept { return cqt_; }
+  static int bin_of_key(int midi_note) noexcept;
+
+ private:
+  void decimate(const float* samples, std::size_t num_samples);
+  // Largest level within a bin of bin (0 beyond the spectrum)
+  float partial_level(const std::vector<float>& levels,
+                      int bin) const noexcept;
+  double score(int key) const noexcept;
+  // Mean level above the median of key's partials 2 and up that are not
+  // partials of the key ratio times higher (-1 if none is in range)
+  double unexplained_level(int key, int ratio) const noexcept;
+
+  int decimation_;
+  dsp::ConstantQTransform cqt_;
+  std::vector<float> taps_;  // Anti-aliasing low-pass (decimation > 1)
+  std::size_t frame_length_;
+  double threshold_db_;
+  std::array<int, KeyEstimate::kMaxPartials> partial_offset_;  // Bins
+  std::vector<float> input_;       // Zero-padded input frame
+  std::vector<float> decimated_;   // One constant-Q frame
+  std::vector<float> magnitudes_;  // Per bin
+  std::vector<float> excess_;      // Above the median
+  std::vector<float> scratch_;     // Median
+};
+
+}  // namespace simple_tuner
+
+#endif  // SIMPLE_TUNER_ALGORITHMS_KEY_IDENTIFIER_H_
@@ -0,0 +1,89 @@
+#ifndef SIMPLE_TUNER_ALGORITHMS_KEY_TRACKER_H_
+#define SIMPLE_TUNER_ALGORITHMS_KEY_TRACKER_H_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "simple_tuner/algorithms/KeyIdentifier.h"
+#include "simple_tuner/memory/SpscQueue.h"
+
+namespace simple_tuner {
+
+// Runs KeyIdentifier on its own worker thread at a low rate (every
+// update_seconds of audio) over the most recent frame, so the UI can pick
+// the key to tune without the full-range detector sweeping every hop:
+// once an estimate is_stable, hand its key's target frequency to
+// PitchDetectionController::set_target_frequency() and the narrow-band
+// detectors take over.
+// The audio thread only calls push_audio() (a lock-free SPSC ring the
+// worker drains every few milliseconds); a ring overrun restarts the frame.
+class KeyTracker {
+ public:
+  static constexpr double kDefaultUpdateSeconds = 0.1;
+  static constexpr int kStableUpdates = 3;  // Same key, consecutively
+  static constexpr std::size_t kQueueCapacity = 32768;  // Samples
+
+  explicit KeyTracker(double sample_rate,
+                      double update_seconds = kDefaultUpdateSeconds,
+                      double reference_a4 = 440.0);
+
+  // Stops the worker and joins it
+  ~KeyTracker();
+
+  KeyTracker(const KeyTracker&) = delete;
+  KeyTracker& operator=(const KeyTracker&) = delete;
+
+  // Audio thread
+  void push_audio(const float* samples, std::size_t num_samples) noexcept;
+
+  // Latest estimate; false before the first update
+  bool get_estimate(KeyEstimate& estimate) const;
+  std::size_t num_updates() const;
+
+  // Blocks until more than count updates have been made; false on timeout
+  bool wait_for_updates(std::size_t count,
+                        std::chrono::milliseconds timeout) const;
+
+  // See KeyIdentifier::set_threshold_db; from the next update
+  void set_threshold_db(double threshold_db);
+
+  std::size_t frame_length() const noexcept { return history_.size(); }
+
+ private:
+  void run();
+  // Worker: moves the ring into history_; true once an update is due
+  bool drain();
+  void update();
+
+  KeyIdentifier identifier_;   // Worker thread only
+  std::vector<float> history_;  // Circular, frame_length() samples
+  std::vector<float> frame_;    // history_ in order
+  std::size_t write_;
+  std::size_t filled_;
+  std::size_t since_update_;
+  std::size_t update_length_;
+  int last_note_;
+  int run_length_;  // Consecutive updates on last_note_
+
+  SpscQueue<float, kQueueCapacity> queue_;  // Audio thread -> worker
+  std::atomic<bool> overrun_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable wake_;             // Worker: stop
+  mutable std::condition_variable updated_;  // Waiters: new estimate
+  KeyEstimate estimate_;
+  std::size_t updates_;
+  double threshold_db_;
+  bool stop_;
+
+  std::thread worker_;  // Last: starts after everything above exists
+};
+
+}  // namespace simple_tuner
+
+#endif  // SIMPLE_TUNER_ALGORITHMS_KEY_TRACKER_H_
@@ -0,0 +1,129 @@
+#ifndef SIMPLE_TUNER_ALGORITHMS_MEASUREMENT_AGGREGATOR_H_
+#define SIMPLE_TUNER_ALGORITHMS_MEASUREMENT_AGGREGATOR_H_
+
+#include <array>
+#include <cstddef>
+
+#include "simple_tuner/algorithms/DetectionResult.h"
+#include "simple_tuner/algorithms/P2Quantile.h"
+#include "simple_tuner/algorithms/TuningTable.h"
+
+namespace simple_tuner {
+
+class FrequencyCalculator;
+
+// Statistics of one key's detections, in cents from its target
+struct KeySummary {
+  int midi_note = 0;
+  int segments = 0;       // Steady segments so far (see the aggregator)
+  std::size_t count = 0;  // Detections in the current segment
+  // Current segment: P² quantiles, moments and extremes
+  double median = 0.0;
+  double lower_quartile = 0.0;
+  double upper_quartile = 0.0;
+  double mean = 0.0;
+  double stddev = 0.0;
+  double minimum = 0.0;
+  double maximum = 0.0;
+  // Last kRecentSeconds (exponentially weighted): level, spread and the
+  // least-squares slope
+  double recent = 0.0;
+  double recent_stddev = 0.0;
+  double drift = 0.0;        // Cents per second
+  double start_time = 0.0;   // Seconds, first detection of the segment
+  double last_time = 0.0;    // Seconds, latest detection
+  bool is_stable = false;    // Recent spread and drift within limits
+};
+
+// Per-key running statistics of a tuning session in fixed memory (a few
+// hundred bytes per piano key, no allocation). Each detection of a key
+// updates P² estimates of the median and quartiles, Welford moments,
+// extremes and an exponentially weighted level and drift (time constant
+// kRecentSeconds) that decide whether the note is holding steady.
+// A key's segment restarts when it comes back after kSegmentGap without
+// detections, and when it settles (turns stable) after moving, so the
+// median describes the pitch the string is at now rather than its attack
+// or where it was before the pin was turned. Once the recent window holds
+// kMinStableWeight detections, an isolated reading over kOutlierCents from
+// its level goes into the quantiles but not the window (a run of
+// kMaxOutliers is taken as a real jump).
+// Detections come from PitchDetectionController::drain_detections via
+// add_detections(), or directly as key and cents through add().
+// Not thread-safe: feed and query from one (non-audio) thread.
+class MeasurementAggregator {
+ public:
+  static constexpr double kSegmentGap = 1.0;      // Seconds
+  static constexpr double kRecentSeconds = 0.5;
+  static constexpr double kStableSpread = 1.0;    // Cents, recent stddev
+  static constexpr double kStableDrift = 2.0;     // Cents per second
+  static constexpr double kMinStableWeight = 5.0;  // Recent detections
+  static constexpr double kMaxCents = 50.0;       // Beyond: another key
+  static constexpr double kOutlierCents = 10.0;
+  static constexpr int kMaxOutliers = 3;
+
+  MeasurementAggregator() noexcept;
+
+  // One detection of midi_note (a piano key) cents from its target at time
+  // (seconds, non-decreasing per key); out-of-range input is ignored
+  void add(int midi_note, double cents, double time) noexcept;
+
+  // Converts detections to keys and cents under calculator's tuning (one
+  // batched pass per chunk) and adds them in order; returns how many were
+  // used (non-positive frequencies are skipped)
+  std::size_t add_detections(const DetectionEvent* events, std::size_t count,
+                             const FrequencyCalculator& calculator) noexcept;
+
+  // False if the key has no detections since it was last reset
+  bool get_summary(int midi_note, KeySummary& summary) const noexcept;
+
+  // Most recently updated key (0 before any detection)
+  int last_key() const noexcept { return last_key_; }
+
+  void reset_key(int midi_note) noexcept;
+  void reset() noexcept;
+
+ private:
+  struct KeyState {
+    P2Quantile median{0.5};
+    P2Quantile lower_quartile{0.25};
+    P2Quantile upper_quartile{0.75};
+    int segments = 0;
+    std::size_t count = 0;
+    double mean = 0.0;
+    double m2 = 0.0;  // Welford sum of squared deviations
+    double minimum = 0.0;
+    double maximum = 0.0;
+    double start_time = 0.0;
+    double last_time = 0.0;
+    // Exponentially weighted sums over (t - origin, cents); origin is the
+    // first detection after a gap
+    double origin = 0.0;
+    double window_time = 0.0;  // Latest detection in the sums
+    double weight = 0.0;
+    double sum_t = 0.0;
+    double sum_c = 0.0;
+    double sum_tt = 0.0;
+    double sum_tc = 0.0;
+    double sum_cc = 0.0;
+    int outliers = 0;  // Consecutive readings kept out of the window
+    bool stable = false;
+  };
+
+  static bool in_range(int midi_note) noexcept {
+    return midi_note >= TuningTable::kFirstKey &&
+           midi_note <= TuningTable::kLastKey;
+  }
+
+  static void start_segment(KeyState& key, double time) noexcept;
+  static void update_recent(KeyState& key, double cents,
+                            double time) noexcept;
+  static double recent_variance(const KeyState& key) noexcept;
+  static double recent_drift(const KeyState& key) noexcept;
+
+  std::array<KeyState, TuningTable::kNumKeys> keys_;
+  int last_key_;
+};
+
+}  // namespace simple_tuner
+
+#endif  // SIMPLE_TUNER_ALGORITHMS_MEASUREMENT_AGGREGATOR_H_
@@ -0,0 +1,82 @@
+#ifndef SIMPLE_TUNER_ALGORITHMS_MPM_PEAK_PICKING_H_
+#define SIMPLE_TUNER_ALGORITHMS_MPM_PEAK_PICKING_H_
+
+#include <algorithm>
+#include <cmath>
+
+namespace simple_tuner {
+namespace mpm {
+
+// Peak picking and refinement shared by the MPM detectors
+// T is the NSDF storage type (float or double)
+
+// First local maximum of nsdf[start_lag .. end_lag) that passes the
+// adaptive clarity threshold (reads nsdf[start_lag - 1 .. end_lag])
+// Returns -1 if there is none: a lag that is not a peak (the rising edge of
+// a period longer than the search range) would be extrapolated to nonsense
+template <typename T>
+int find_highest_clarity_peak(const T* nsdf, int start_lag, int end_lag,
+                              double sample_rate,
+                              double base_clarity_threshold) noexcept {
+  // MPM algorithm: find the first peak that exceeds the adaptive clarity
+  // threshold Search from min_lag (skip DC component at lag=0) Ensure we have
+  // room for three-point test
+
+  for (int lag = start_lag; lag < end_lag; ++lag) {
+    // Three-point local maximum test
+    if (nsdf[lag] > nsdf[lag - 1] && nsdf[lag] > nsdf[lag + 1]) {
+      // Calculate adaptive threshold based on number of cycles in buffer
+      // For lower frequencies (fewer cycles), we relax the threshold
+      const double cycles = sample_rate / static_cast<double>(lag);
+      const double adaptive_threshold =
+          base_clarity_threshold / std::sqrt(std::max(cycles, 1.0));
+
+      // Return first peak that exceeds adaptive clarity threshold
+      if (nsdf[lag] >= adaptive_threshold) {
+        return lag;
+      }
+    }
+  }
+
+  return -1;
+}
+
+// Parabolic interpolation around nsdf[peak_index] for sub-sample accuracy
+// size: number of valid NSDF entries
+// The offset is clamped to one lag either way (a true peak gives at most
+// half a lag)
+template <typename T>
+double parabolic_interpolation(const T* nsdf, int size,
+                               int peak_index) noexcept {
+  constexpr double kEpsilon = 1e-10;
+
+  // Bounds check - need room for neighbors
+  if (peak_index <= 0 || peak_index >= size - 1) {
+    return static_cast<double>(peak_index);
+  }
+
+  // Three-point parabolic interpolation
+  const double alpha = nsdf[peak_index - 1];
+  const double beta = nsdf[peak_index];
+  const double gamma = nsdf[peak_index + 1];
+
+  // Calculate parabola vertex offset: delta = (alpha - gamma) / (2 * (alpha -
+  // 2*beta + gamma))
+  const double denominator = 2.0 * (alpha - 2.0 * beta + gamma);
+
+  // Avoid division by zero or near-zero (flat peak)
+  if (std::abs(denominator) < kEpsilon) {
+    return static_cast<double>(peak_index);
+  }
+
+  const double delta =
+      std::clamp((alpha - gamma) / denominator, -1.0, 1.0);
+
+  // Refined peak position (sub-sample accuracy)
+  return static_cast<double>(peak_index) + delta;
+}
+
+}  // namespace mpm
+}  // namespace simple_tuner
+
+#endif  // SIMPLE_TUNER_ALGORITHMS_MPM_PEAK_PICKING_H_
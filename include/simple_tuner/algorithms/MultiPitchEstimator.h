@@ -0,0 +1,104 @@
+#ifndef SIMPLE_TUNER_ALGORITHMS_MULTI_PITCH_ESTIMATOR_H_
+#define SIMPLE_TUNER_ALGORITHMS_MULTI_PITCH_ESTIMATOR_H_
+
+#include <array>
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+namespace simple_tuner {
+
+// One sinusoid found by MultiPitchEstimator
+struct PitchComponent {
+  double frequency = 0.0;  // Hz
+  double amplitude = 0.0;  // Mean over the window (full scale = 1)
+};
+
+// The components near a centre frequency, in ascending frequency
+struct MultiPitchResult {
+  static constexpr int kMaxComponents = 3;
+
+  std::array<PitchComponent, kMaxComponents> components{};
+  int count = 0;
+  bool is_valid = false;
+};
+
+// Resolves up to three simultaneous sinusoids within kBandwidth of a
+// centre frequency - the strings of a unison, or coincident partials of an
+// interval - where PitchDetector reports one averaged frequency.
+//  1. Baseband: the input is mixed down by the centre frequency and
+//     low-passed (windowed sinc, evaluated at the output samples only) to
+//     a complex signal at kBasebandRate, so window_seconds of audio leave
+//     about a hundred samples per second.
+//  2. ESPRIT: covariance of snapshots a third of the window long (forward
+//     only, so decaying strings stay one pole each), eigendecomposed
+//     (cyclic complex Jacobi). The number of components is the count of
+//     eigenvalues kOrderFactor above the noise eigenvalues' mean and
+//     within kDynamicRange of the largest; the rotation between the signal
+//     subspace's two shifted halves has the components' poles as
+//     eigenvalues, so their frequencies are not limited by the window's
+//     Rayleigh resolution (1 / window_seconds).
+//  3. Amplitudes: least squares fit of the poles to the baseband signal.
+// An estimate costs the low-pass (a few hundred thousand multiply-adds)
+// plus one Jacobi decomposition of a ~33 x 33 matrix: around a
+// millisecond, for a window of a second, so it fits on a worker thread at
+// several estimates per second. Not for the audio thread. Zero
+// allocations after construction.
+class MultiPitchEstimator {
+ public:
+  static constexpr double kBasebandRate = 100.0;   // Hz, complex
+  static constexpr double kBandwidth = 20.0;       // Hz either side
+  static constexpr double kDefaultWindowSeconds = 1.0;
+  static constexpr double kMinWindowSeconds = 0.25;
+  static constexpr double kMaxWindowSeconds = 4.0;
+  static constexpr double kOrderFactor = 10.0;    // 10 dB above the noise
+  static constexpr double kDynamicRange = 1e-4;  // 40 dB (power)
+  static constexpr double kDefaultThresholdDb = -60.0;
+
+  explicit MultiPitchEstimator(
+      double sample_rate, double window_seconds = kDefaultWindowSeconds);
+
+  MultiPitchEstimator(const MultiPitchEstimator&) = delete;
+  MultiPitchEstimator& operator=(const MultiPitchEstimator&) = delete;
+
+  // Input samples one estimate looks at
+  std::size_t input_length() const noexcept { return input_length_; }
+  // Baseband samples per window
+  std::size_t window_length() const noexcept { return baseband_.size(); }
+
+  // Components below this amplitude (dBFS) are not reported
+  void set_threshold_db(double threshold_db) noexcept;
+
+  // Components within kBandwidth of center_frequency in the last
+  // input_length() samples (invalid if fewer are given: a zero-padded
+  // window looks like an onset, which is no sum of sinusoids)
+  MultiPitchResult estimate(const float* samples, std::size_t num_samples,
+                            double center_frequency) noexcept;
+
+ private:
+  using Complex = std::complex<double>;
+
+  void mix_down(const float* samples, std::size_t num_samples,
+                double center_frequency) noexcept;
+  void build_covariance() noexcept;
+  // Eigenvalues of covariance_ into eigenvalues_, eigenvectors into the
+  // columns of vectors_
+  void decompose() noexcept;
+
+  double sample_rate_;
+  int decimation_;
+  std::size_t input_length_;
+  std::size_t snapshot_;  // Covariance size L
+  double threshold_db_;
+  std::vector<double> taps_;         // Low-pass
+  std::vector<Complex> mixer_;       // Taps times the mixing phasor
+  std::vector<Complex> baseband_;    // Window, kBasebandRate
+  std::vector<Complex> covariance_;  // L x L, row-major
+  std::vector<Complex> vectors_;     // L x L eigenvectors (columns)
+  std::vector<double> eigenvalues_;
+  std::vector<std::size_t> order_;   // Eigenvalue indices, descending
+};
+
+}  // namespace simple_tuner
+
+#endif  // SIMPLE_TUNER_ALGORITHMS_MULTI_PITCH_ESTIMATOR_H_
@@ -0,0 +1,42 @@
+#ifndef SIMPLE_TUNER_ALGORITHMS_P2_QUANTILE_H_
+#define SIMPLE_TUNER_ALGORITHMS_P2_QUANTILE_H_
+
+#include <cstddef>
+
+namespace simple_tuner {
+
+// Streaming quantile estimate in constant memory (Jain & Chlamtac's P²
+// algorithm): five markers track the minimum, the p/2, p and (1+p)/2
+// quantiles and the maximum, nudged toward their ideal ranks by piecewise
+// parabolic interpolation as samples arrive. Exact for the first five
+// samples; afterwards typically within a fraction of the inter-quartile
+// spread of the true quantile. O(1) per sample, no allocation.
+class P2Quantile {
+ public:
+  // probability: the quantile tracked, clamped to [0, 1] (0.5 = median)
+  explicit P2Quantile(double probability = 0.5) noexcept;
+
+  void add(double value) noexcept;
+
+  // Current estimate (0 before the first sample)
+  double value() const noexcept;
+
+  std::size_t count() const noexcept { return count_; }
+  double probability() const noexcept { return probability_; }
+
+  void reset() noexcept;
+
+ private:
+  static constexpr int kMarkers = 5;
+
+  double probability_;
+  std::size_t count_;
+  double heights_[kMarkers];    // Marker values
+  double positions_[kMarkers];  // Marker ranks (0-based)
+  double desired_[kMarkers];    // Ideal ranks
+  double increments_[kMarkers];  // Ideal rank change per sample
+};
+
+}  // namespace simple_tuner
+
+#endif  // SIMPLE_TUNER_ALGORITHMS_P2_QUANTILE_H_
@@ -4,48 +4,133 @@
 #include <cstddef>
 #include <vector>
 
+#include "simple_tuner/algorithms/DetectionResult.h"
+#include "simple_tuner/dsp/BlockOps.h"
+#include "simple_tuner/interfaces/IPitchDetector.h"
+#include "simple_tuner/memory/BufferArena.h"
+
 namespace simple_tuner {
 
-// Window types for signal pre-processing
-enum class WindowType { kRectangular, kHann, kHamming };
+// Structure-of-arrays output for batch detection
+// Each array must hold at least count_frames() elements
+struct FrameResults {
+  double* frequency;   // Detected frequency per frame in Hz (0.0 if invalid)
+  double* confidence;  // Detection confidence per frame [0.0, 1.0]
+  bool* valid;         // Validity flag per frame
+};
+
+// Preallocated limits of a reconfigurable detector. Runtime changes to the
+// frequency range, sample rate and buffer length are clamped to these, so
+// they never reallocate and never index past the scratch buffers.
+struct DetectorCapacity {
+  std::size_t max_buffer_size;  // Largest effective buffer length in samples
+  std::size_t max_lag;          // Largest autocorrelation lag in samples
+};
+
+// Precision policies for the detector's scratch buffers and NSDF sums
+// Storage: element type of the window and NSDF buffers
+// Accumulator: type used for autocorrelation and square-sum accumulation
+struct FloatPrecision {
+  using Storage = float;
+  using Accumulator = float;
+};
 
-// Pitch detection result with confidence and validity
-struct DetectionResult {
-  double frequency;   // Detected frequency in Hz (0.0 if invalid)
-  double confidence;  // Detection confidence [0.0, 1.0]
-  bool is_valid;      // True if detection meets quality thresholds
+struct DoublePrecision {
+  using Storage = double;
+  using Accumulator = double;
+};
 
-  DetectionResult() : frequency(0.0), confidence(0.0), is_valid(false) {}
-  DetectionResult(double freq, double conf, bool valid)
-      : frequency(freq), confidence(conf), is_valid(valid) {}
+// Float buffers (twice the SIMD width, half the cache footprint) with double
+// accumulation to keep the long NSDF sums accurate
+struct MixedPrecision {
+  using Storage = float;
+  using Accumulator = double;
 };
 
 // McLeod Pitch Period Method (MPM) pitch detector
 // Thread-safe for audio callbacks (zero allocations in detect methods)
-class PitchDetector {
+// Explicitly instantiated for FloatPrecision, DoublePrecision and
+// MixedPrecision in PitchDetector.cpp
+template <typename Precision>
+class BasicPitchDetector : public IPitchDetector {
  public:
+  using Storage = typename Precision::Storage;
+  using Accumulator = typename Precision::Accumulator;
+
   // Constructor pre-allocates buffers for given sample rate and buffer size
   // sample_rate: Audio sample rate (typically 44100 or 48000 Hz)
   // buffer_size: Maximum buffer size for detection (default 4096)
-  explicit PitchDetector(double sample_rate, std::size_t buffer_size = 4096);
-
-  ~PitchDetector() = default;
+  // Lag capacity covers the default minimum frequency (32.7 Hz)
+  explicit BasicPitchDetector(double sample_rate,
+                              std::size_t buffer_size = 4096);
+
+  // Same as above, but carves all scratch buffers from arena in access order
+  // (arena must outlive the detector; see arena_bytes() for the size needed)
+  BasicPitchDetector(double sample_rate, std::size_t buffer_size,
+                     BufferArena& arena);
+
+  // Reconfigurable detector: buffers are sized for capacity and the
+  // effective buffer length starts at capacity.max_buffer_size
+  BasicPitchDetector(double sample_rate, const DetectorCapacity& capacity);
+  BasicPitchDetector(double sample_rate, const DetectorCapacity& capacity,
+                     BufferArena& arena);
+
+  ~BasicPitchDetector() override = default;
+
+  // Copies own their buffers on the heap, even if the source is arena-backed
+  BasicPitchDetector(const BasicPitchDetector&) = default;
+  BasicPitchDetector& operator=(const BasicPitchDetector&) = delete;
+
+  // Capacity needed to search down to min_frequency at sample_rate with
+  // buffers of buffer_size samples
+  static DetectorCapacity capacity_for(double sample_rate,
+                                       std::size_t buffer_size,
+                                       double min_frequency) noexcept;
+
+  // Arena bytes needed by the arena-backed constructors
+  static std::size_t arena_bytes(double sample_rate,
+                                 std::size_t buffer_size) noexcept;
+  static std::size_t arena_bytes(const DetectorCapacity& capacity) noexcept;
 
   // Simple API: returns detected frequency in Hz, or 0.0 if no pitch detected
   double detect_pitch(const float* samples, std::size_t num_samples) noexcept;
 
   // Extended API: returns detailed detection result with confidence
-  DetectionResult detect_pitch_detailed(const float* samples,
-                                        std::size_t num_samples) noexcept;
+  DetectionResult detect_pitch_detailed(
+      const float* samples, std::size_t num_samples) noexcept override;
+
+  // Number of complete buffer_size frames in a signal of num_samples at the
+  // given hop size (0 if the signal is shorter than one frame)
+  std::size_t count_frames(std::size_t num_samples,
+                           std::size_t hop_size) const noexcept;
+
+  // Batch API for offline analysis: detects pitch on every buffer_size frame
+  // starting at multiples of hop_size and writes SoA results. Scratch buffers
+  // are reused across frames. num_threads > 1 splits the frames across worker
+  // threads, each with its own copy of the scratch buffers (allocates, so not
+  // for use on the audio thread). Returns the number of frames written.
+  std::size_t detect_frames(const float* signal, std::size_t num_samples,
+                            std::size_t hop_size, const FrameResults& results,
+                            unsigned int num_threads = 1) noexcept;
 
   // Configuration methods
-  void set_threshold_db(double threshold_db) noexcept;
-  void set_min_frequency(double min_freq) noexcept;
-  void set_max_frequency(double max_freq) noexcept;
-  void set_window_type(WindowType type) noexcept;
-  void set_base_clarity_threshold(double threshold) noexcept;
+  void set_threshold_db(double threshold_db) noexcept override;
+  void set_min_frequency(double min_freq) noexcept override;
+  void set_max_frequency(double max_freq) noexcept override;
+  void set_window_type(WindowType type) noexcept override;
+  void set_base_clarity_threshold(double threshold) noexcept override;
+
+  // Runtime reconfiguration within capacity (no allocation)
+  // The lag range is re-derived from the frequency limits and clamped to the
+  // lag capacity, so frequencies below capacity are not searched
+  void set_sample_rate(double sample_rate) noexcept;
+  // Effective frame length, clamped to [2, capacity().max_buffer_size]
+  void set_buffer_length(std::size_t buffer_length) noexcept;
 
   // Getters for configuration
+  double get_sample_rate() const noexcept { return sample_rate_; }
+  std::size_t get_buffer_length() const noexcept { return buffer_size_; }
+  const DetectorCapacity& capacity() const noexcept { return capacity_; }
   double get_threshold_db() const noexcept { return threshold_db_; }
   double get_min_frequency() const noexcept { return min_freq_; }
   double get_max_frequency() const noexcept { return max_freq_; }
@@ -55,6 +140,11 @@ class PitchDetector {
   }
 
  private:
+  // Runs detection on frames [first_frame, last_frame) of a batch
+  void detect_frame_range(const float* signal, std::size_t hop_size,
+                          const FrameResults& results, std::size_t first_frame,
+                          std::size_t last_frame) noexcept;
+
   // NSDF computation (Normalized Square Difference Function)
   void compute_nsdf(const float* samples, std::size_t num_samples) noexcept;
 
@@ -64,22 +154,28 @@ class PitchDetector {
   // Parabolic interpolation for sub-sample accuracy
   double parabolic_interpolation(int peak_index) const noexcept;
 
-  // Signal validation (RMS threshold check)
-  bool validate_signal(const float* samples,
+  // Signal validation (RMS threshold check on the frame statistics)
+  bool validate_signal(const dsp::BlockStats& stats,
                        std::size_t num_samples) const noexcept;
 
-  // RMS calculation
-  double calculate_rms(const float* samples,
-                       std::size_t num_samples) const noexcept;
+  // Delegated-to constructor; arena may be null (heap-backed buffers)
+  BasicPitchDetector(double sample_rate, const DetectorCapacity& capacity,
+                     BufferArena* arena);
+
+  // Maximum lag for a frequency limit, clamped to the buffer
+  static int lag_limit(double sample_rate, double frequency,
+                       std::size_t buffer_size) noexcept;
 
-  // Pre-processing helpers
+  // Re-derives min_lag_/max_lag_ from the current configuration
+  void update_lag_range() noexcept;
+
+  // Pre-computes window_ for the effective buffer length
   void compute_window() noexcept;
-  void remove_dc_offset(float* samples, std::size_t num_samples) const noexcept;
-  void apply_window(float* samples, std::size_t num_samples) const noexcept;
 
   // Configuration
   double sample_rate_;
-  std::size_t buffer_size_;
+  DetectorCapacity capacity_;  // Preallocated buffer and lag limits
+  std::size_t buffer_size_;    // Effective frame length (<= capacity)
   double threshold_db_;  // Signal threshold in dB (default -60dB)
   double min_freq_;      // Minimum detectable frequency (default 32.7 Hz, C1)
   double max_freq_;      // Maximum detectable frequency (default 4186 Hz, C8)
@@ -90,14 +186,24 @@ class PitchDetector {
   int min_lag_;
   int max_lag_;
 
-  // Pre-allocated buffers (avoid audio thread allocations)
-  std::vector<double> nsdf_;            // Normalized square difference function
-  std::vector<double> autocorr_;        // Autocorrelation values
-  std::vector<double> square_sum_;      // Running square sums for normalization
-  std::vector<double> window_;          // Pre-computed window coefficients
-  mutable std::vector<float> working_;  // Working buffer for pre-processing
+  // Pre-allocated buffers (avoid audio thread allocations), cache-line
+  // aligned and declared in the order detect_pitch_detailed touches them
+  mutable ArenaVector<float> working_;  // Working buffer for pre-processing
+  ArenaVector<float> window_;           // Pre-computed window coefficients
+  ArenaVector<Storage> autocorr_;       // Autocorrelation values
+  ArenaVector<Storage> square_sum_;  // Running square sums for normalization
+  ArenaVector<Storage> nsdf_;        // Normalized square difference function
 };
 
+extern template class BasicPitchDetector<FloatPrecision>;
+extern template class BasicPitchDetector<DoublePrecision>;
+extern template class BasicPitchDetector<MixedPrecision>;
+
+// Default detector: double precision throughout
+using PitchDetector = BasicPitchDetector<DoublePrecision>;
+using FloatPitchDetector = BasicPitchDetector<FloatPrecision>;
+using MixedPitchDetector = BasicPitchDetector<MixedPrecision>;
+
 }  // namespace simple_tuner
 
 #endif  // SIMPLE_TUNER_ALGORITHMS_PITCH_DETECTOR_H_
@@ -0,0 +1,45 @@
+#ifndef SIMPLE_TUNER_ALGORITHMS_PITCH_DETECTOR_FACTORY_H_
+#define SIMPLE_TUNER_ALGORITHMS_PITCH_DETECTOR_FACTORY_H_
+
+#include <cstddef>
+#include <memory>
+
+#include "simple_tuner/interfaces/IPitchDetector.h"
+#include "simple_tuner/memory/BufferArena.h"
+
+namespace simple_tuner {
+
+// Factory for tier detectors.
+// Returns a compile-time specialized FixedPitchDetector when one is
+// instantiated for the requested size and sample rate, otherwise the
+// runtime-sized PitchDetector.
+class PitchDetectorFactory {
+ public:
+  static std::unique_ptr<IPitchDetector> create(double sample_rate,
+                                                std::size_t buffer_size);
+
+  // Same selection, but the detector and all of its buffers are placed in
+  // arena (throws std::bad_alloc if the arena is too small)
+  static ArenaPtr<IPitchDetector> create(double sample_rate,
+                                         std::size_t buffer_size,
+                                         BufferArena& arena);
+
+  // Arena bytes the arena-backed create() consumes
+  static std::size_t arena_bytes(double sample_rate,
+                                 std::size_t buffer_size) noexcept;
+
+  // True if create() would return a FixedPitchDetector
+  static bool has_fixed_detector(double sample_rate,
+                                 std::size_t buffer_size) noexcept;
+
+  PitchDetectorFactory() = delete;
+  ~PitchDetectorFactory() = delete;
+  PitchDetectorFactory(const PitchDetectorFactory&) = delete;
+  PitchDetectorFactory& operator=(const PitchDetectorFactory&) = delete;
+  PitchDetectorFactory(PitchDetectorFactory&&) = delete;
+  PitchDetectorFactory& operator=(PitchDetectorFactory&&) = delete;
+};
+
+}  // namespace simple_tuner
+
+#endif  // SIMPLE_TUNER_ALGORITHMS_PITCH_DETECTOR_FACTORY_H_
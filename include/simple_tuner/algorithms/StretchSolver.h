@@ -0,0 +1,111 @@
+#ifndef SIMPLE_TUNER_ALGORITHMS_STRETCH_SOLVER_H_
+#define SIMPLE_TUNER_ALGORITHMS_STRETCH_SOLVER_H_
+
+#include <array>
+
+#include "simple_tuner/algorithms/InharmonicityEstimator.h"
+#include "simple_tuner/algorithms/TuningTable.h"
+
+namespace simple_tuner {
+
+// Output of StretchSolver::solve
+struct StretchCurve {
+  // Cent offset of each key from equal temperament (A4 at 0), ready for
+  // TuningTable::set_stretch_curve: cents[i] applies to MIDI kFirstKey + i
+  std::array<double, TuningTable::kNumKeys> cents{};
+  double roughness = 0.0;  // Cost of the curve (see StretchSolver)
+  // Octave types of the best starting curve at A0, A4 and C8 (1 = 2:1,
+  // 2 = 4:2, 3 = 6:3; fractions blend neighbouring types)
+  double bass_octave = 0.0;
+  double middle_octave = 0.0;
+  double treble_octave = 0.0;
+  int sweeps = 0;  // Refinement sweeps accepted
+  bool is_valid = false;
+};
+
+// Whole-piano stretch curve from per-key string measurements. Each key is
+// modelled by its partial ratios: measured where an InharmonicityResult
+// located the partial, otherwise from B (log-interpolated between measured
+// keys, held constant beyond the outermost ones), amplitudes 1/n. A curve
+// costs the summed sensory roughness (Plomp-Levelt, Sethares' fit) of all
+// partial pairs in every octave, twelfth and double octave on the keyboard,
+// weighted per interval, plus a small curvature penalty so keys with little
+// to hear (the top of the treble) follow their neighbours.
+//  1. Candidates: curves built outward from A4 by making one partial pair
+//     per octave beatless, the octave type varying linearly from the middle
+//     to each end; every (bass, middle, treble) combination of types 2:1
+//     to 6:3 in half-type steps (125 curves) is scored and the cheapest
+//     kept.
+//  2. Refinement: damped Jacobi sweeps; each key picks its best offset on
+//     a grid against the previous curve, the sweep is kept only if the
+//     total cost falls, otherwise the grid step halves.
+// Candidates and keys are spread over worker threads; every candidate and
+// key is evaluated independently into its own slot and reduced in index
+// order, so the curve does not depend on the thread count. A full solve
+// for 88 keys takes about 0.1 s on one core with 8 partials and about
+// 0.3 s with 16. Meant for a UI or background thread; solve() allocates.
+class StretchSolver {
+ public:
+  static constexpr int kReferenceKey = 69;  // A4, held at 0 cents
+  static constexpr int kMinMeasuredKeys = 2;
+  static constexpr int kMaxPartials = InharmonicityResult::kMaxPartials;
+  static constexpr int kDefaultPartials = 8;
+
+  explicit StretchSolver(double reference_a4 = 440.0) noexcept;
+
+  // Reference pitch; sets the absolute frequencies the roughness depends on
+  // (ignored if <= 0)
+  void set_reference_a4(double frequency) noexcept;
+
+  // Measurement of one piano key: its B and any located partials (ignored
+  // if invalid or outside the piano range)
+  void set_measurement(int midi_note,
+                       const InharmonicityResult& result) noexcept;
+
+  // B alone for one key (ignored if negative or outside the piano range)
+  void set_inharmonicity(int midi_note, double inharmonicity) noexcept;
+
+  void clear_key(int midi_note) noexcept;
+  void clear() noexcept;
+  int measured_keys() const noexcept;
+
+  // Partials per key in the roughness model, clamped to [2, kMaxPartials]
+  void set_num_partials(int num_partials) noexcept;
+  int get_num_partials() const noexcept { return num_partials_; }
+
+  // Relative weights of the intervals in the cost (negatives become 0;
+  // default 1, 0.5, 0.5)
+  void set_interval_weights(double octave, double twelfth,
+                            double double_octave) noexcept;
+
+  // Worker threads (0 = hardware concurrency, the default)
+  void set_num_threads(unsigned int num_threads) noexcept;
+
+  // Invalid with fewer than kMinMeasuredKeys measured keys
+  StretchCurve solve() const;
+
+ private:
+  struct Key {
+    double inharmonicity = 0.0;
+    // Measured partial n + 1 over partial 1 (0 if not measured)
+    std::array<double, kMaxPartials> ratios{};
+    bool measured = false;
+  };
+
+  static bool in_range(int midi_note) noexcept {
+    return midi_note >= TuningTable::kFirstKey &&
+           midi_note <= TuningTable::kLastKey;
+  }
+
+  double reference_a4_;
+  int num_partials_;
+  double octave_weight_;
+  double twelfth_weight_;
+  double double_octave_weight_;
+  unsigned int num_threads_;
+  std::array<Key, TuningTable::kNumKeys> keys_;
+};
+
+}  // namespace simple_tuner
+
+#endif  // SIMPLE_TUNER_ALGORITHMS_STRETCH_SOLVER_H_
@@ -0,0 +1,128 @@
+#ifndef SIMPLE_TUNER_ALGORITHMS_SUB_BASS_DETECTOR_H_
+#define SIMPLE_TUNER_ALGORITHMS_SUB_BASS_DETECTOR_H_
+
+#include <cstddef>
+
+#include "simple_tuner/algorithms/DetectionResult.h"
+#include "simple_tuner/interfaces/IPitchDetector.h"
+#include "simple_tuner/memory/BufferArena.h"
+
+namespace simple_tuner {
+
+// Pitch detector for the lowest piano octave (A0..B0, 27.5-30.9 Hz), below
+// the 32.7 Hz floor of the frame detectors.
+// Three parts keep it within the audio-thread budget:
+//  - Decimation: input is low-passed (4th-order Butterworth at 0.2 x the
+//    decimated rate) and decimated to about 4 kHz as it arrives, so a
+//    period of A0 is ~145 samples instead of ~1745 at 48 kHz.
+//  - Long window: the decimated history holds kWindowSeconds (~160 ms,
+//    7700 samples at 48 kHz) of signal, longer than the controller's
+//    accumulation buffer, at 1/12 of the storage.
+//  - Harmonic aid: piano bass strings have weak fundamentals, so the NSDF
+//    often peaks at half the period as strongly as at the period. Each
+//    candidate period T is scored on the NSDF at both T and 2T. A longer
+//    candidate replaces a shorter one only with a clearly better score,
+//    and the period is fitted to both repetitions.
+// The NSDF covers 2 x (decimated rate / min frequency) lags of the
+// decimated window (SIMD dot products, prefix-sum normalizers): ~0.12M
+// multiply-adds, against ~14M for a direct 8192-sample NSDF at 48 kHz.
+// Zero allocations after construction.
+class SubBassDetector : public IPitchDetector {
+ public:
+  static constexpr double kDefaultMinFrequency = 25.96;  // A0 - 1 semitone
+  static constexpr double kDefaultMaxFrequency = 67.3;   // C2 + 1/2 semitone
+  static constexpr double kLowestFrequency = 25.0;  // Lag capacity limit
+  static constexpr double kTargetDecimatedRate = 4000.0;
+  static constexpr double kWindowSeconds = 0.16;
+
+  explicit SubBassDetector(double sample_rate);
+
+  // Same, with the history and scratch buffers carved from arena (must
+  // outlive the detector; see arena_bytes())
+  SubBassDetector(double sample_rate, BufferArena& arena);
+
+  ~SubBassDetector() override = default;
+
+  SubBassDetector(const SubBassDetector&) = delete;
+  SubBassDetector& operator=(const SubBassDetector&) = delete;
+
+  // Arena bytes needed by the arena-backed constructor
+  static std::size_t arena_bytes(double sample_rate) noexcept;
+
+  // Audio thread: filters, decimates and appends samples to the history
+  void push_samples(const float* samples, std::size_t num_samples) noexcept;
+
+  // Detects on the most recent window of the history (invalid until a
+  // full window has been pushed)
+  DetectionResult detect() noexcept;
+
+  // Clears the history and the filter state
+  void reset() noexcept;
+
+  // Standalone frame: replaces the history with samples (which should span
+  // at least window_span() samples) and detects
+  DetectionResult detect_pitch_detailed(
+      const float* samples, std::size_t num_samples) noexcept override;
+
+  void set_threshold_db(double threshold_db) noexcept override;
+  // Clamped below to kLowestFrequency (the lag capacity)
+  void set_min_frequency(double min_freq) noexcept override;
+  void set_max_frequency(double max_freq) noexcept override;
+  // The NSDF runs unwindowed on the decimated signal; ignored
+  void set_window_type(WindowType type) noexcept override;
+  // Minimum NSDF of a candidate period (default 0.3)
+  void set_base_clarity_threshold(double threshold) noexcept override;
+
+  int decimation_factor() const noexcept { return decimation_; }
+  double decimated_rate() const noexcept { return decimated_rate_; }
+  // Input samples covered by one detection window
+  std::size_t window_span() const noexcept {
+    return window_length_ * static_cast<std::size_t>(decimation_);
+  }
+  double get_min_frequency() const noexcept { return min_freq_; }
+  double get_max_frequency() const noexcept { return max_freq_; }
+
+ private:
+  // Direct-form II transposed biquad section (low-pass)
+  struct Biquad {
+    double b0, b1, b2, a1, a2;
+    double z1, z2;
+  };
+  static constexpr int kNumSections = 2;
+
+  SubBassDetector(double sample_rate, BufferArena* arena);
+
+  static int decimation_for(double sample_rate) noexcept;
+  static std::size_t window_length_for(double sample_rate) noexcept;
+  static std::size_t history_length_for(double sample_rate) noexcept;
+  static int max_lag_for(double sample_rate) noexcept;
+
+  // Local maximum of nsdf_ nearest to lag within +-radius (-1 if none)
+  int peak_near(int lag, int radius, int last_lag) const noexcept;
+
+  double sample_rate_;
+  int decimation_;
+  double decimated_rate_;
+  std::size_t window_length_;  // Decimated samples per detection
+  std::size_t history_mask_;   // History length - 1 (power of two)
+  int lag_capacity_;           // Longest candidate period in samples
+
+  double threshold_db_;
+  double min_freq_;
+  double max_freq_;
+  double min_peak_;
+
+  Biquad sections_[kNumSections];
+  int phase_;  // Input samples since the last decimated output
+  std::size_t write_index_;
+  std::size_t filled_;  // Decimated samples pushed, saturating at window
+
+  ArenaVector<float> history_;   // Ring of decimated samples
+  ArenaVector<float> working_;   // Linearized, mean-removed window
+  ArenaVector<double> energy_;   // Prefix sums of working_ squared
+  ArenaVector<double> nsdf_;     // Lags 0 .. 2 * lag_capacity_ + 3
+};
+
+}  // namespace simple_tuner
+
+#endif  // SIMPLE_TUNER_ALGORITHMS_SUB_BASS_DETECTOR_H_
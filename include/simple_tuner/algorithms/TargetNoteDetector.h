@@ -0,0 +1,127 @@
+#ifndef SIMPLE_TUNER_ALGORITHMS_TARGET_NOTE_DETECTOR_H_
+#define SIMPLE_TUNER_ALGORITHMS_TARGET_NOTE_DETECTOR_H_
+
+#include <cstddef>
+
+#include "simple_tuner/algorithms/DetectionResult.h"
+#include "simple_tuner/interfaces/IPitchDetector.h"
+#include "simple_tuner/memory/BufferArena.h"
+
+namespace simple_tuner {
+
+// Detector for tuning a known key: instead of searching every lag, it
+// measures only the target's fundamental and first few partials with a
+// bank of Goertzel resonators, O(N x partials x grid) instead of
+// O(N x lags) (~0.2M against ~6M multiply-adds for a 4096-sample frame).
+// Per partial n (expected at n * f0 * sqrt((1 + B n^2) / (1 + B))):
+//  1. Coarse: Hann-windowed Goertzel magnitudes on a one-bin grid over
+//     +-kSearchCents around the expected frequency; the largest wins.
+//  2. Refine: the phase advance at that frequency between the first and
+//     second half of the frame gives the offset from it (unambiguous within
+//     one bin, so sub-cent for a clean partial), and the offset corrects
+//     the partial's power for the window's scalloping.
+// Every grid point of every partial runs in one interleaved resonator bank
+// per pass over the frame (as do the half-frame refinements), since a
+// single Goertzel recursion is latency-bound.
+// The fundamental is the power-weighted mean of the partials' implied
+// fundamentals. Confidence is the fraction of the frame's energy in the
+// measured partials; frames below the base clarity threshold (default 0.2)
+// are invalid, as are frames with no target set.
+// Partials closer than ~4 half-frame bins (4 * 2 * sample_rate / N) leak
+// into each other's refinement, so targets below min_target() (whose
+// partials are about that far apart) are invalid: low keys need longer
+// frames.
+// Zero allocations after construction.
+class TargetNoteDetector : public IPitchDetector {
+ public:
+  static constexpr int kMaxPartials = 6;
+  static constexpr double kSearchCents = 60.0;
+  static constexpr int kMaxGridPoints = 48;  // Per partial
+
+  TargetNoteDetector(double sample_rate, std::size_t buffer_size);
+
+  // Same, with the scratch buffers carved from arena (must outlive the
+  // detector; see arena_bytes())
+  TargetNoteDetector(double sample_rate, std::size_t buffer_size,
+                     BufferArena& arena);
+
+  ~TargetNoteDetector() override = default;
+
+  TargetNoteDetector(const TargetNoteDetector&) = delete;
+  TargetNoteDetector& operator=(const TargetNoteDetector&) = delete;
+
+  static std::size_t arena_bytes(std::size_t buffer_size) noexcept;
+
+  // Lowest target a buffer_size frame resolves (~94 Hz for 4096 samples at
+  // 48 kHz, ~23 Hz for 16384)
+  static double min_target(double sample_rate,
+                           std::size_t buffer_size) noexcept;
+
+  // Expected fundamental, e.g. FrequencyCalculator::midi_to_frequency of the
+  // key being tuned (<= 0 clears the target)
+  void set_target(double frequency) noexcept;
+  double get_target() const noexcept { return target_; }
+
+  // Inharmonicity used to place the partials (clamped to [0, 0.05])
+  void set_inharmonicity(double inharmonicity) noexcept;
+  // Partials measured, fundamental included (clamped to [1, kMaxPartials])
+  void set_num_partials(int num_partials) noexcept;
+
+  // Analyzes the first buffer_size samples; invalid if fewer are supplied
+  DetectionResult detect_pitch_detailed(
+      const float* samples, std::size_t num_samples) noexcept override;
+
+  void set_threshold_db(double threshold_db) noexcept override;
+  // Partials outside [min, max] are skipped
+  void set_min_frequency(double min_freq) noexcept override;
+  void set_max_frequency(double max_freq) noexcept override;
+  // Always Hann (the refinement depends on it); ignored
+  void set_window_type(WindowType type) noexcept override;
+  void set_base_clarity_threshold(double threshold) noexcept override;
+
+ private:
+  TargetNoteDetector(double sample_rate, std::size_t buffer_size,
+                     BufferArena* arena);
+
+  // Final Goertzel state of one resonator
+  struct State {
+    double s1;
+    double s2;
+  };
+  // Complex DFT bin
+  struct Bin {
+    double re;
+    double im;
+  };
+
+  // Runs count resonators (coefficients 2 cos(omega)) over frame[0..length)
+  // in passes of interleaved lanes
+  static void run_bank(const float* frame, std::size_t length,
+                       const double* coeff, int count,
+                       State* states) noexcept;
+
+  // Windowed DFT at omega from a resonator's final state
+  static Bin to_bin(State state, double omega, std::size_t length) noexcept;
+
+  double sample_rate_;
+  std::size_t buffer_size_;
+  double threshold_db_;
+  double min_freq_;
+  double max_freq_;
+  double min_energy_fraction_;
+  double target_;
+  double inharmonicity_;
+  int num_partials_;
+
+  // Scratch in access order: the Hann-windowed frame, then each half-frame
+  // with its own Hann window
+  ArenaVector<float> window_;       // Hann over buffer_size samples
+  ArenaVector<float> half_window_;  // Hann over buffer_size / 2 samples
+  ArenaVector<float> frame_;        // Windowed frame
+  ArenaVector<float> first_half_;   // Windowed first half
+  ArenaVector<float> second_half_;  // Windowed second half
+};
+
+}  // namespace simple_tuner
+
+#endif  // SIMPLE_TUNER_ALGORITHMS_TARGET_NOTE_DETECTOR_H_
@@ -1,23 +1,184 @@
 #ifndef SIMPLE_TUNER_ALGORITHMS_TONE_GENERATOR_H_
 #define SIMPLE_TUNER_ALGORITHMS_TONE_GENERATOR_H_
 
+#include <atomic>
 #include <cstddef>
+#include <cstdint>
+
+#include "simple_tuner/algorithms/WavetableBank.h"
+#include "simple_tuner/memory/SpscQueue.h"
 
 namespace simple_tuner {
 
-// Stub implementation for Phase 4
+// Reference tone oscillator for Sound mode
+// Double-precision phase accumulator (no drift over long sessions) feeding a
+// vectorized polynomial sine (dsp/FastSine.h); spurious components stay below
+// -120 dBc. Waveform::kPiano instead reads interpolated piano-timbre tables
+// from a WavetableBank; switching notes only selects another precomputed
+// table.
+//
+// Parameter changes travel from the control (UI) thread to the audio thread
+// as timestamped events over a lock-free SPSC queue, so generation never
+// locks or allocates. An event takes effect at its exact sample; rendering
+// is split at event boundaries. Frequency glides exponentially towards its
+// target (the phase increment ramps linearly within each rendered segment)
+// and gain ramps linearly over a few milliseconds, so note and level
+// changes do not click.
+//
+// Polyphony: besides the primary tone (voice 0, driven by the setters
+// below), note_on() plays extra reference voices for intervals, octaves and
+// unisons. All kMaxVoices voices are preallocated; their state is stored as
+// structure-of-arrays and the sine path renders every voice per sample in
+// one loop that vectorizes across voices. When all pool voices are busy the
+// oldest is stolen (phase-continuous, so it does not click).
 class ToneGenerator {
  public:
-  ToneGenerator() = default;
+  enum class Waveform { kSine, kPiano };
+  enum class Parameter { kFrequency, kAmplitude, kEnabled };
+  using VoiceId = std::uint32_t;  // 0 is never a valid id
+
+  static constexpr std::size_t kEventCapacity = 64;
+  static constexpr int kMaxVoices = 8;  // Primary tone plus 7 pool voices
+
+  ToneGenerator() noexcept;
   ~ToneGenerator() = default;
 
+  // Control thread (one producer): settings applied at the start of the
+  // next block. Getters return the last value set and are safe anywhere.
   void set_frequency(double frequency_hz) noexcept;
+  double get_frequency() const noexcept;
+  void set_amplitude(float amplitude) noexcept;  // Clamped to [0, 1]
+  float get_amplitude() const noexcept;
+  void set_enabled(bool enabled) noexcept;  // Off by default; fades in/out
+  bool is_enabled() const noexcept;
+
+  // Control thread: applies value when the output reaches sample_time (see
+  // sample_time(); times already past apply at the next block). Events
+  // should be scheduled in time order. Returns false if the queue is full.
+  bool schedule(Parameter parameter, double value,
+                std::uint64_t sample_time) noexcept;
+
+  // Control thread: starts a pool voice at sample_time (0: next block).
+  // Returns its id, or 0 if the queue is full.
+  VoiceId note_on(double frequency_hz, float amplitude,
+                  std::uint64_t sample_time = 0) noexcept;
+
+  // Control thread: fades out the voice started by note_on() (unknown or
+  // stolen ids are ignored). Returns false if the queue is full.
+  bool note_off(VoiceId voice, std::uint64_t sample_time = 0) noexcept;
+
+  // Control thread: fades out every pool voice (not the primary tone)
+  bool all_notes_off(std::uint64_t sample_time = 0) noexcept;
+
+  // Any thread: voices sounding at the end of the last block (primary
+  // included)
+  int active_voices() const noexcept;
+
+  // Any thread: samples generated so far (the clock schedule() uses)
+  std::uint64_t sample_time() const noexcept;
+
+  // Any thread: time constant of the frequency glide (0 jumps; default
+  // 10 ms). A silent generator always jumps straight to a new frequency.
+  void set_glide_time(double seconds) noexcept;
+
+  // Any thread: waveform for the next block; kPiano plays a sine until a
+  // wavetable bank is set
+  void set_waveform(Waveform waveform) noexcept;
+  Waveform get_waveform() const noexcept;
+
+  // Any thread: tables for Waveform::kPiano (not owned; must outlive the
+  // generator or be replaced first; nullptr falls back to the sine)
+  void set_wavetable_bank(const WavetableBank* bank) noexcept;
+
+  // Sample rate used by process()
+  void set_sample_rate(double sample_rate) noexcept;
+
+  // Audio thread: overwrites buffer with the next num_samples of the tone
   void generate_samples(float* buffer, std::size_t num_samples,
                         double sample_rate) noexcept;
 
+  // Audio thread: same, at the set_sample_rate() rate; matches the
+  // AudioManager output handler signature
+  void process(float* buffer, int num_samples) noexcept;
+
+  // Audio thread: restarts the waveform at phase 0 with the gain at rest
+  void reset() noexcept;
+
+  ToneGenerator(const ToneGenerator&) = delete;
+  ToneGenerator& operator=(const ToneGenerator&) = delete;
+
  private:
-  double frequency_;
-  double phase_;
+  static constexpr double kRampSeconds = 0.005;  // Gain ramp length
+
+  enum class EventType {
+    kFrequency,
+    kAmplitude,
+    kEnabled,
+    kNoteOn,
+    kNoteOff,
+    kAllNotesOff
+  };
+
+  struct ParameterEvent {
+    EventType type;
+    double value;      // Frequency, amplitude or enable flag
+    float amplitude;   // kNoteOn only
+    VoiceId voice;     // kNoteOn and kNoteOff
+    std::uint64_t sample_time;
+  };
+
+  // Control thread: posts an event; false if the queue is full
+  bool post(const ParameterEvent& event) noexcept;
+
+  // Audio thread: applies an event to the render targets
+  void apply_event(const ParameterEvent& event) noexcept;
+
+  // Audio thread: pool voice for a new note (free, else the oldest)
+  int allocate_voice() const noexcept;
+
+  // Audio thread: renders num_samples with the current targets
+  void render_segment(float* buffer, std::size_t num_samples,
+                      double sample_rate) noexcept;
+
+  // Control -> audio
+  SpscQueue<ParameterEvent, kEventCapacity> events_;
+  std::atomic<bool> resync_;  // Set when an event was dropped
+
+  // Last values set (read back by getters; snapshot used after a drop)
+  std::atomic<double> frequency_;
+  std::atomic<float> amplitude_;
+  std::atomic<bool> enabled_;
+  std::atomic<double> sample_rate_;
+  std::atomic<double> glide_seconds_;
+  std::atomic<Waveform> waveform_;
+  std::atomic<const WavetableBank*> wavetable_bank_;
+  std::atomic<std::uint64_t> sample_time_;
+  std::atomic<int> active_voices_;
+
+  // Control thread state
+  VoiceId next_voice_id_;
+
+  // Audio thread state: primary tone targets
+  float target_amplitude_;
+  bool target_enabled_;
+  std::uint64_t clock_;  // Samples generated
+
+  // Audio thread state: one lane per voice (voice 0 is the primary tone)
+  alignas(64) double phase_[kMaxVoices];  // Cycles in [0, 1)
+  alignas(64) double current_frequency_[kMaxVoices];  // Smoothed
+  alignas(64) double target_frequency_[kMaxVoices];
+  // Wavetable phase in fundamental cycles, so it carries over unchanged
+  // to a table spanning a different number of cycles
+  alignas(64) double table_phase_[kMaxVoices];
+  alignas(64) float gain_[kMaxVoices];          // Current (ramped) gain
+  alignas(64) float target_gain_[kMaxVoices];
+  // Table each voice reads, picked once per target frequency from
+  // table_bank_ (nullptr: pick again)
+  const WavetableBank::Table* table_[kMaxVoices];
+  double table_frequency_[kMaxVoices];
+  const WavetableBank* table_bank_;
+  VoiceId voice_id_[kMaxVoices];          // 0: primary or released
+  std::uint64_t start_time_[kMaxVoices];  // Note-on clock (for stealing)
 };
 
 }  // namespace simple_tuner
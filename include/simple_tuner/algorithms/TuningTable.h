@@ -0,0 +1,97 @@
+#ifndef SIMPLE_TUNER_ALGORITHMS_TUNING_TABLE_H_
+#define SIMPLE_TUNER_ALGORITHMS_TUNING_TABLE_H_
+
+#include <array>
+#include <cstddef>
+
+namespace simple_tuner {
+
+// Temperaments as cent offsets from equal temperament per pitch class
+// (C-based, then shifted so A sits at the reference pitch)
+enum class Temperament {
+  kEqual,
+  kPythagorean,            // Pure fifths, wolf between G# and Eb
+  kQuarterCommaMeantone,   // Pure major thirds, wolf between G# and Eb
+  kWerckmeisterIII,
+  kKirnbergerIII,
+  kVallotti
+};
+
+// Precomputed target frequencies for the 88 piano keys (A0..C8, MIDI
+// 21..108): reference pitch x temperament x per-key cent offsets (a stretch
+// curve). Every lookup is a table read; the table rebuilds in one pass over
+// the keys whenever any of the three inputs changes. Notes outside the
+// piano range fall back to the temperament formula (std::pow).
+// Not thread-safe: rebuild and query from one thread.
+class TuningTable {
+ public:
+  static constexpr int kFirstKey = 21;  // A0
+  static constexpr int kLastKey = 108;  // C8
+  static constexpr int kNumKeys = kLastKey - kFirstKey + 1;
+
+  explicit TuningTable(double reference_a4 = 440.0) noexcept;
+
+  // Reference pitch for A4 before any offsets (ignored if <= 0)
+  void set_reference_a4(double frequency) noexcept;
+  double get_reference_a4() const noexcept { return reference_a4_; }
+
+  void set_temperament(Temperament temperament) noexcept;
+  Temperament get_temperament() const noexcept { return temperament_; }
+
+  // Cent offset of one key on top of the temperament (ignored outside the
+  // piano range)
+  void set_key_offset(int midi_note, double cents) noexcept;
+  double get_key_offset(int midi_note) const noexcept;
+
+  // Replaces all key offsets: cents[i] applies to MIDI kFirstKey + i
+  void set_stretch_curve(const std::array<double, kNumKeys>& cents) noexcept;
+  void clear_stretch_curve() noexcept;
+
+  // Target frequency of a MIDI note
+  double target_frequency(int midi_note) const noexcept;
+
+  // Key whose target is nearest to frequency in cents (clamped to the piano
+  // range); frequency must be positive
+  int nearest_key(double frequency) const noexcept;
+
+  // nearest_key and cents_from_target for count frequencies at once, written
+  // to keys[i] and cents[i]; the log2 pass runs vectorized. Non-positive
+  // (or NaN) frequencies give kFirstKey and 0 cents.
+  void nearest_keys(const double* frequencies, std::size_t count, int* keys,
+                    double* cents) const noexcept;
+
+  // Deviation of frequency from a note's target in cents (positive is
+  // sharp), using dsp::fast_log2 (error below 1.3e-6 cents)
+  double cents_from_target(double frequency, int midi_note) const noexcept;
+
+  // Temperament offset of a pitch class (0 = C) in cents, A at 0
+  static double temperament_offset(Temperament temperament,
+                                   int pitch_class) noexcept;
+
+ private:
+  static bool in_range(int midi_note) noexcept {
+    return midi_note >= kFirstKey && midi_note <= kLastKey;
+  }
+
+  // log2 of a note's target frequency (slow path outside the range)
+  double target_log2(int midi_note) const noexcept;
+
+  // Equal-temperament key estimate (fractional, clamped to the range)
+  double equal_tempered_key(double log2_frequency) const noexcept;
+  // Nearest key by the boundary table, starting from a rounded guess
+  int key_for_log2(double log2_frequency, long guess) const noexcept;
+
+  void rebuild() noexcept;
+
+  double reference_a4_;
+  Temperament temperament_;
+  std::array<double, kNumKeys> key_offset_cents_;
+  std::array<double, kNumKeys> frequency_;  // Target per key in Hz
+  std::array<double, kNumKeys> log2_;       // log2 of frequency_
+  // Boundaries for nearest_key: midpoint (in log2) between key i and i + 1
+  std::array<double, kNumKeys> upper_boundary_;
+};
+
+}  // namespace simple_tuner
+
+#endif  // SIMPLE_TUNER_ALGORITHMS_TUNING_TABLE_H_
@@ -0,0 +1,78 @@
+#ifndef SIMPLE_TUNER_ALGORITHMS_WAVETABLE_BANK_H_
+#define SIMPLE_TUNER_ALGORITHMS_WAVETABLE_BANK_H_
+
+#include <cstddef>
+#include <vector>
+
+namespace simple_tuner {
+
+// Precomputed piano-like wavetables covering the 88 keys (A0..C8).
+// Keys are grouped into ranges of kKeysPerRange; each range has one
+// band-limited table whose partials follow the stiff-string series
+// f_n = n * f0 * sqrt((1 + B * n^2) / (1 + B)) (f_1 is the played pitch)
+// with a per-range inharmonicity B.
+// Inharmonic partials are not periodic in one fundamental cycle, so a table
+// spans `cycles` fundamental cycles and partial n completes
+// round(cycles * n * sqrt(1 + B * n^2)) cycles over it; longer tables
+// (a larger memory budget) get more cycles and smaller partial errors.
+// All tables are built in the constructor (allocates; not for the audio
+// thread) and are read-only afterwards.
+class WavetableBank {
+ public:
+  static constexpr int kFirstMidiNote = 21;  // A0
+  static constexpr int kNumKeys = 88;        // A0..C8
+  static constexpr int kKeysPerRange = 4;
+  static constexpr int kNumRanges = kNumKeys / kKeysPerRange;
+  static constexpr int kMaxPartials = 64;
+
+  static constexpr std::size_t kDefaultMemoryBudget = 1024 * 1024;
+  static constexpr std::size_t kMinTableLength = 1024;
+  static constexpr std::size_t kMaxTableLength = 65536;
+
+  // One key range's table; samples[length] repeats samples[0] so linear
+  // interpolation never wraps
+  struct Table {
+    const float* samples;
+    std::size_t length;  // Power of two
+    double cycles;       // Fundamental cycles spanned by the table
+  };
+
+  // sample_rate: Playback rate the tables are band-limited for
+  // memory_budget_bytes: Upper bound on table storage; sets the table length
+  explicit WavetableBank(
+      double sample_rate,
+      std::size_t memory_budget_bytes = kDefaultMemoryBudget);
+
+  // Table for the key nearest to frequency_hz (clamped to the piano range)
+  const Table& table_for_frequency(double frequency_hz) const noexcept;
+
+  // Table for a MIDI note (clamped to the piano range)
+  const Table& table_for_note(int midi_note) const noexcept;
+
+  // Model inharmonicity coefficient B for a MIDI note: about 4e-4 at A0,
+  // a minimum near C2, rising exponentially to about 2.4e-2 at C8
+  static double inharmonicity(int midi_note) noexcept;
+
+  // Relative amplitude of partial n: n^-1.5 roll-off (a felt hammer at
+  // moderate dynamics) shaped by striking 1/8 of the way along the string
+  // (every 8th partial vanishes)
+  static double partial_amplitude(int partial) noexcept;
+
+  double sample_rate() const noexcept { return sample_rate_; }
+  std::size_t table_length() const noexcept { return table_length_; }
+  std::size_t memory_bytes() const noexcept {
+    return samples_.size() * sizeof(float);
+  }
+
+ private:
+  void build_table(int range, const std::vector<double>& sine);
+
+  double sample_rate_;
+  std::size_t table_length_;
+  std::vector<float> samples_;  // kNumRanges tables of table_length_ + 1
+  std::vector<Table> tables_;
+};
+
+}  // namespace simple_tuner
+
+#endif  // SIMPLE_TUNER_ALGORITHMS_WAVETABLE_BANK_H_
@@ -1,6 +1,7 @@
 #ifndef SIMPLE_TUNER_CONFIG_CONFIG_MANAGER_H_
 #define SIMPLE_TUNER_CONFIG_CONFIG_MANAGER_H_
 
+#include <cstddef>
 #include <memory>
 
 #include "simple_tuner/interfaces/IConfigStorage.h"
@@ -17,12 +18,22 @@ class ConfigManager {
   bool set_reference_pitch(double frequency_hz) noexcept;
   bool reset_reference_pitch() noexcept;
 
+  // Memory budget for the piano-timbre wavetables in bytes; read at startup
+  // (a larger budget gives longer, more accurate tables)
+  std::size_t get_wavetable_memory_budget() const noexcept;
+  bool set_wavetable_memory_budget(std::size_t bytes) noexcept;
+
  private:
   static constexpr double kDefaultReferencePitch = 440.0;
   static constexpr double kMinReferencePitch = 410.0;
   static constexpr double kMaxReferencePitch = 480.0;
   static constexpr const char* kReferencePitchKey = "reference_pitch";
 
+  static constexpr double kDefaultWavetableBudget = 1024.0 * 1024.0;
+  static constexpr double kMinWavetableBudget = 128.0 * 1024.0;
+  static constexpr double kMaxWavetableBudget = 8.0 * 1024.0 * 1024.0;
+  static constexpr const char* kWavetableBudgetKey = "wavetable_memory_budget";
+
   std::unique_ptr<IConfigStorage> storage_;
 };
 
@@ -3,12 +3,21 @@
 
 #include <atomic>
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <vector>
 
+#include "simple_tuner/interfaces/IPitchDetector.h"
+#include "simple_tuner/memory/BufferArena.h"
+#include "simple_tuner/memory/SpscQueue.h"
+
 namespace simple_tuner {
 
-class PitchDetector;
+class BeatDetector;
+class HarmonicSumDetector;
+class SessionRecorder;
+class SubBassDetector;
+class TargetNoteDetector;
 
 // Detection tier for adaptive multi-tier pitch detection
 struct DetectionTier {
@@ -17,10 +26,22 @@ struct DetectionTier {
   double min_frequency;     // Minimum detectable frequency for this tier
 };
 
+// Detector the full tier runs when the fast and medium tiers find nothing
+enum class FullTierMethod : std::uint32_t {
+  kNsdf = 0,         // McLeod NSDF, like the other tiers
+  kHarmonicSum = 1,  // Spectral subharmonic summation (weak fundamentals)
+};
+
 // Thread-safe controller for pitch detection with circular buffer accumulation
 // Audio thread writes samples, UI thread reads results atomically
+// All sample buffers and tier detectors live in a single page-aligned arena,
+// laid out in the order run_tiered_detection() touches them
 class PitchDetectionController {
  public:
+  // Detections queued for drain_detections(): over 2.5 s at the fastest
+  // hop (128 samples at 48 kHz)
+  static constexpr std::size_t kDetectionQueueSize = 1024;
+
   // buffer_size: Size of accumulation buffer (e.g., 4096)
   // sample_rate: Audio sample rate in Hz
   explicit PitchDetectionController(std::size_t buffer_size,
@@ -36,30 +57,100 @@ class PitchDetectionController {
   // Returns false if no valid pitch detected
   bool get_latest_result(double& frequency, double& confidence) const noexcept;
 
+  // Called from one consumer thread (e.g. the UI timer): moves up to
+  // max_count of the oldest queued detections into out and returns how
+  // many. Every result that get_latest_result() would report is queued with
+  // its time; while the queue is full new detections are dropped.
+  std::size_t drain_detections(DetectionEvent* out,
+                               std::size_t max_count) noexcept;
+
   // Configuration
   void set_confidence_threshold(double threshold) noexcept;
   double get_confidence_threshold() const noexcept;
 
+  // Called from UI thread (one writer): requests a new tuning range for
+  // every tier
+  // The audio thread applies it before its next detection; detectors clamp
+  // it to their preallocated lag capacity, so nothing is reallocated
+  void set_frequency_range(double min_frequency, double max_frequency) noexcept;
+
+  // Called from UI thread: known-key mode. With a target (e.g. the expected
+  // frequency of the piano key being tuned) every detection measures that
+  // note's partials on the full buffer instead of running the tiers (on a
+  // longer frame for keys below ~F#2, whose partials are too close for the
+  // full buffer); frequency <= 0 returns to tiered detection. Applied like
+  // the range.
+  void set_target_frequency(double frequency) noexcept;
+
+  // Called from UI thread: beat analysis of the near-coincident partials
+  // around frequency (e.g. the shared partial of a unison or an interval),
+  // run about every kBeatInterval seconds alongside pitch detection;
+  // frequency <= 0 stops it. Applied like the range.
+  void set_beat_frequency(double frequency) noexcept;
+
+  // Called from UI thread: which detector runs on the full buffer. The
+  // harmonic sum reads bass strings whose fundamental is much weaker than
+  // their next partials without the NSDF's octave errors, at a fraction of
+  // its cost. Applied like the range.
+  void set_full_tier_method(FullTierMethod method) noexcept;
+
+  // Called from UI thread: latest beat rate (0 for a steady partial) and
+  // its clarity; false if beat analysis is off or found nothing
+  bool get_latest_beats(double& beats_per_second,
+                        double& clarity) const noexcept;
+
+  // Called from UI thread: hands every input block, applied setting and
+  // published result to recorder (while it is recording) from the next
+  // block on; nullptr detaches. Attach after recorder->start() and before
+  // the first block for a recording a replay reproduces exactly. The
+  // audio thread may still be in a block using the old recorder when this
+  // returns: keep it alive until the next block has started.
+  void set_recorder(SessionRecorder* recorder) noexcept;
+
+  // Total bytes of the buffer arena (one allocation for all tiers)
+  std::size_t memory_footprint() const noexcept { return arena_->capacity(); }
+
+  // Arena bytes a controller with these parameters carves out
+  static std::size_t required_memory(std::size_t buffer_size,
+                                     double sample_rate) noexcept;
+
   PitchDetectionController(const PitchDetectionController&) = delete;
   PitchDetectionController& operator=(const PitchDetectionController&) = delete;
 
  private:
-  // Multi-tier detectors
-  std::unique_ptr<PitchDetector> fast_detector_;    // 512 samples, C4+
-  std::unique_ptr<PitchDetector> medium_detector_;  // 1024 samples, C2+
-  std::unique_ptr<PitchDetector> full_detector_;    // 4096 samples, C1+
+  // Owns the memory behind every buffer and detector below, so it is
+  // declared first and destroyed last
+  std::unique_ptr<BufferArena> arena_;
+
+  // Circular buffer for sample accumulation (long enough for the bass
+  // target frame), followed by each tier's linear buffer and detector
+  // (compile-time specialized when the tier size and sample rate have a
+  // FixedPitchDetector, runtime-sized otherwise)
+  ArenaVector<float> accumulation_buffer_;
+  ArenaVector<float> fast_buffer_;            // 512-sample buffer
+  ArenaPtr<IPitchDetector> fast_detector_;    // 512 samples, C4+
+  ArenaVector<float> medium_buffer_;          // 1024-sample buffer
+  ArenaPtr<IPitchDetector> medium_detector_;  // 1024 samples, C2+
+  ArenaVector<float> full_buffer_;            // 4096-sample buffer
+  ArenaPtr<IPitchDetector> full_detector_;    // 4096 samples, C1+
+  ArenaPtr<HarmonicSumDetector> harmonic_detector_;  // Same, when selected
+  ArenaPtr<SubBassDetector> sub_bass_detector_;  // Decimated history, A0+
+  ArenaPtr<TargetNoteDetector> target_detector_;  // Known-key mode
+  // Known-key mode for keys whose partials a buffer_size frame cannot
+  // separate: a frame long enough for A0's (16384 samples at 48 kHz)
+  ArenaVector<float> bass_target_buffer_;
+  ArenaPtr<TargetNoteDetector> bass_target_detector_;
+  ArenaPtr<BeatDetector> beat_detector_;  // Envelope history, when enabled
 
   // Detection tiers configuration
   std::vector<DetectionTier> tiers_;
 
-  // Circular buffer for sample accumulation
-  std::vector<float> accumulation_buffer_;
-  std::vector<float> fast_buffer_;    // 512-sample buffer
-  std::vector<float> medium_buffer_;  // 1024-sample buffer
-  std::vector<float> full_buffer_;    // 4096-sample buffer
   std::size_t write_index_;
   std::size_t buffer_size_;
   std::size_t samples_since_detection_;
+  std::size_t beat_hop_;  // Samples between beat analyses
+  std::size_t samples_since_beats_;
+  static constexpr double kBeatInterval = 0.1;  // Seconds
 
   // Onset detection
   double previous_energy_;
@@ -69,17 +160,60 @@ class PitchDetectionController {
   std::atomic<double> latest_frequency_;
   std::atomic<double> latest_confidence_;
   std::atomic<bool> has_valid_result_;
+  std::atomic<double> latest_beat_rate_;
+  std::atomic<double> latest_beat_clarity_;
+  std::atomic<bool> has_beat_result_;
+
+  // Every published detection, audio thread -> consumer
+  SpscQueue<DetectionEvent, kDetectionQueueSize> detections_;
+  std::uint64_t samples_processed_;  // Audio thread clock for the events
+
+  // Tuning range handed from the UI thread to the audio thread as one
+  // unit: a sequence lock, odd while set_frequency_range() is writing the
+  // pair, so the audio thread never applies one bound without the other
+  std::atomic<std::uint32_t> range_sequence_;
+  std::atomic<double> pending_min_frequency_;
+  std::atomic<double> pending_max_frequency_;
+  std::uint32_t applied_range_sequence_;  // Audio thread
+
+  // Known-key target handed from the UI thread to the audio thread
+  std::atomic<double> pending_target_;
+  std::atomic<bool> target_pending_;
+
+  // Beat analysis frequency handed from the UI thread to the audio thread
+  std::atomic<double> pending_beat_frequency_;
+  std::atomic<bool> beat_pending_;
+
+  // Full tier method handed from the UI thread to the audio thread
+  std::atomic<FullTierMethod> pending_full_tier_method_;
+  std::atomic<bool> full_tier_pending_;
+  FullTierMethod full_tier_method_;
+
+  // Session recording: attached by the UI thread, and the recorder the
+  // audio thread is feeding during the current block (null if none)
+  std::atomic<SessionRecorder*> recorder_;
+  SessionRecorder* active_recorder_;
+  double applied_min_frequency_;  // 0 until a range is applied
+  double applied_max_frequency_;
+  double recorded_threshold_;  // Last threshold handed to the recorder
 
   // Configuration
   double confidence_threshold_;
   double sample_rate_;
 
   // Helper methods
+  void begin_recording_block() noexcept;
+  void apply_pending_range() noexcept;
+  void apply_pending_target() noexcept;
+  void apply_pending_beat_frequency() noexcept;
+  void apply_pending_full_tier_method() noexcept;
+  void run_beat_detection() noexcept;
   void run_tiered_detection() noexcept;
+  // Stores result for the UI thread if it passes the confidence threshold
+  void publish_result(const DetectionResult& result) noexcept;
   double calculate_energy(const float* samples,
                           std::size_t num_samples) const noexcept;
-  void linearize_buffer(std::vector<float>& dest,
-                        std::size_t size) const noexcept;
+  void linearize_buffer(float* dest, std::size_t size) const noexcept;
 };
 
 }  // namespace simple_tuner
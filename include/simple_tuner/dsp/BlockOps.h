@@ -0,0 +1,72 @@
+#ifndef SIMPLE_TUNER_DSP_BLOCK_OPS_H_
+#define SIMPLE_TUNER_DSP_BLOCK_OPS_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace simple_tuner {
+namespace dsp {
+
+// Block-level DSP primitives shared by the detectors and the controller.
+// Each function dispatches at runtime to the widest SIMD kernel the CPU
+// supports (AVX2 or SSE2 on x86, NEON on ARM64, scalar otherwise). Sums,
+// sums of squares and frame energies are accumulated in double in every
+// variant; dot_product accumulates in float (in several partial sums).
+// Kernels differ from the scalar reference only in summation order. None of
+// them allocate.
+
+enum class SimdLevel { kScalar, kSse2, kAvx2, kNeon };
+
+struct BlockStats {
+  double sum = 0.0;          // Sum of the samples
+  double sum_squares = 0.0;  // Sum of the squared samples
+};
+
+// Sum of x[0..n)
+double sum(const float* x, std::size_t n) noexcept;
+
+// Sum of x[i]^2 over [0, n)
+double sum_of_squares(const float* x, std::size_t n) noexcept;
+
+// Sum and sum of squares in a single pass
+BlockStats block_stats(const float* x, std::size_t n) noexcept;
+
+// x[i] -= value (mean subtraction when value is the block mean)
+void subtract(float* x, std::size_t n, float value) noexcept;
+
+// x[i] *= window[i]
+void multiply(float* x, const float* window, std::size_t n) noexcept;
+
+// Dot product of a[0..n) and b[0..n), accumulated in float
+float dot_product(const float* a, const float* b, std::size_t n) noexcept;
+
+// 16-bit PCM <-> float in [-1, 1]; float_to_int16 saturates and rounds to
+// nearest
+void int16_to_float(const std::int16_t* src, float* dst,
+                    std::size_t n) noexcept;
+void float_to_int16(const float* src, std::int16_t* dst,
+                    std::size_t n) noexcept;
+
+// Fused frame pre-processing: stats of src, then
+// dst[i] = (src[i] - mean) * window[i] in one more pass that reads src from
+// cache. window may be null (rectangular). Returns the statistics of src; if
+// processed_energy is non-null it receives the sum of squares of dst.
+BlockStats preprocess_frame(const float* src, const float* window, float* dst,
+                            std::size_t n,
+                            double* processed_energy = nullptr) noexcept;
+
+// Kernel set currently in use
+SimdLevel simd_level() noexcept;
+
+// Best kernel set this CPU supports
+SimdLevel detect_simd_level() noexcept;
+
+// Switches every primitive to the given kernel set (for tests and
+// benchmarks). Returns false, leaving the current set, if the CPU or build
+// does not support it.
+bool force_simd_level(SimdLevel level) noexcept;
+
+}  // namespace dsp
+}  // namespace simple_tuner
+
+#endif  // SIMPLE_TUNER_DSP_BLOCK_OPS_H_
@@ -0,0 +1,71 @@
+#ifndef SIMPLE_TUNER_DSP_CONSTANT_Q_H_
+#define SIMPLE_TUNER_DSP_CONSTANT_Q_H_
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "simple_tuner/dsp/Fft.h"
+
+namespace simple_tuner {
+namespace dsp {
+
+// Constant-Q transform with spectral kernels (Brown and Puckette): bin k is
+// centred on min_frequency * 2^(k / bins_per_octave) and analyses a Hann
+// window of window_scale * Q cycles of that frequency, all windows centred
+// in one frame. Each temporal kernel's FFT is computed at construction and
+// only the coefficients above sparsity times its peak are kept, so a
+// transform is one FFT of the frame plus a short sparse product per bin.
+// A window_scale below 1 shortens the windows (coarser resolution than the
+// bin spacing, which then oversamples the spectrum) and with them the
+// frame. Bins at or above 0.45 times the sample rate are dropped.
+// Kernels take a few FFTs of the frame each to build: construct off the
+// audio thread. Transforms do not allocate.
+class ConstantQTransform {
+ public:
+  static constexpr double kDefaultSparsity = 0.005;
+
+  ConstantQTransform(double sample_rate, double min_frequency, int num_bins,
+                     int bins_per_octave, double window_scale = 1.0,
+                     double sparsity = kDefaultSparsity);
+
+  // Samples per transform (a power of two)
+  std::size_t frame_length() const noexcept { return fft_.size(); }
+  int num_bins() const noexcept { return num_bins_; }
+  int bins_per_octave() const noexcept { return bins_per_octave_; }
+  double sample_rate() const noexcept { return sample_rate_; }
+  // Cycles per window: window_scale / (2^(1 / bins_per_octave) - 1)
+  double q() const noexcept { return q_; }
+  double bin_frequency(int bin) const noexcept;
+  // Window length of a bin in samples
+  std::size_t window_length(int bin) const noexcept;
+  // Kernel coefficients kept, over all bins
+  std::size_t kernel_size() const noexcept { return values_.size(); }
+
+  // out[k] for k < num_bins() from the frame_length() samples at frame;
+  // a sinusoid of amplitude A at a bin's frequency gives |out[k]| = A
+  void transform(const float* frame, std::complex<double>* out) noexcept;
+
+  // |transform| into out[0 .. num_bins())
+  void magnitudes(const float* frame, float* out) noexcept;
+
+ private:
+  double sample_rate_;
+  double min_frequency_;
+  int num_bins_;
+  int bins_per_octave_;
+  double q_;
+  Fft fft_;
+  std::vector<std::complex<double>> spectrum_;  // Frame FFT scratch
+  std::vector<std::complex<double>> bins_;      // magnitudes() scratch
+  // Sparse kernels, row per bin: FFT indices and conj(K) / N
+  std::vector<std::size_t> row_start_;
+  std::vector<std::uint32_t> columns_;
+  std::vector<std::complex<double>> values_;
+};
+
+}  // namespace dsp
+}  // namespace simple_tuner
+
+#endif  // SIMPLE_TUNER_DSP_CONSTANT_Q_H_
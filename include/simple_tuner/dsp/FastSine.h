@@ -0,0 +1,45 @@
+#ifndef SIMPLE_TUNER_DSP_FAST_SINE_H_
+#define SIMPLE_TUNER_DSP_FAST_SINE_H_
+
+namespace simple_tuner {
+namespace dsp {
+
+// Branch-free sine for oscillators, written so loops over blocks of phases
+// auto-vectorize (selects and polynomial only, no calls or table lookups).
+
+// Rounds x to the nearest integer with two double additions (valid for
+// |x| < 2^51), which vectorizes on SSE2 and NEON without a rounding
+// instruction
+inline double round_to_int(double x) noexcept {
+  constexpr double kMagic = 6755399441055744.0;  // 2^52 + 2^51
+  return (x + kMagic) - kMagic;
+}
+
+// sin(2 * pi * x) for x in [-0.5, 0.5] (one cycle)
+// Folded to a quarter cycle and evaluated with an odd degree-11 polynomial;
+// absolute error below 5e-7 including the float rounding of x, so every
+// spurious component of a generated tone is below -120 dBc.
+inline float sin_2pi(float x) noexcept {
+  constexpr float kTwoPi = 6.28318530717958647692f;
+  // sin(pi - a) = sin(a) folds |x| > 1/4 back into [-1/4, 1/4]; written as
+  // min/max selects so it compiles to blends rather than branches
+  const float upper = 0.5f - x;
+  const float lower = -0.5f - x;
+  float folded = x < upper ? x : upper;
+  folded = folded > lower ? folded : lower;
+  const float a = folded * kTwoPi;
+  const float a2 = a * a;
+  // Taylor coefficients 1/3!, 1/5!, ... with alternating signs
+  constexpr float kC3 = -1.66666666666666667e-1f;
+  constexpr float kC5 = 8.33333333333333333e-3f;
+  constexpr float kC7 = -1.98412698412698413e-4f;
+  constexpr float kC9 = 2.75573192239858907e-6f;
+  constexpr float kC11 = -2.50521083854417188e-8f;
+  return a *
+         (1.0f + a2 * (kC3 + a2 * (kC5 + a2 * (kC7 + a2 * (kC9 + a2 * kC11)))));
+}
+
+}  // namespace dsp
+}  // namespace simple_tuner
+
+#endif  // SIMPLE_TUNER_DSP_FAST_SINE_H_
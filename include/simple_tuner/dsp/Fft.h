@@ -0,0 +1,87 @@
+#ifndef SIMPLE_TUNER_DSP_FFT_H_
+#define SIMPLE_TUNER_DSP_FFT_H_
+
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+#include "simple_tuner/memory/BufferArena.h"
+
+namespace simple_tuner {
+namespace dsp {
+
+// In-place radix-2 complex FFT of a fixed power-of-two size, double
+// precision. Twiddles and the bit-reversal permutation are computed at
+// construction; transforms do not allocate. Mostly for the analysis stages
+// that run off the audio thread; the arena-backed form lets an audio-thread
+// detector keep its tables with the rest of its buffers.
+class Fft {
+ public:
+  // size is rounded up to a power of two (at least 2)
+  explicit Fft(std::size_t size);
+
+  // Same, with the tables carved from arena (must outlive the transform;
+  // see arena_bytes())
+  Fft(std::size_t size, BufferArena& arena);
+
+  // Arena bytes needed by the arena-backed constructor
+  static std::size_t arena_bytes(std::size_t size) noexcept;
+
+  std::size_t size() const noexcept { return size_; }
+
+  // X[k] = sum x[n] e^{-2 pi j n k / N}
+  void forward(std::complex<double>* data) const noexcept;
+
+  // x[n] = (1 / N) sum X[k] e^{2 pi j n k / N}
+  void inverse(std::complex<double>* data) const noexcept;
+
+  static std::size_t next_power_of_two(std::size_t value) noexcept;
+
+ private:
+  Fft(std::size_t size, BufferArena* arena);
+
+  void transform(std::complex<double>* data, bool inverse) const noexcept;
+
+  std::size_t size_;
+  ArenaVector<std::complex<double>> twiddles_;  // e^{-2 pi j k / N}, k < N/2
+  ArenaVector<std::size_t> bit_reversed_;
+};
+
+// Chirp-z transform (Bluestein): the DTFT of a real block at num_points
+// frequencies start, start + spacing, ... (radians per sample), for zooming
+// into a narrow band at a resolution finer than the block's FFT bins.
+// Two FFTs of the smallest power of two >= input_length + max_points - 1
+// per call; the chirp filter's transform is computed once per instance, as
+// it depends only on the spacing.
+class ChirpZTransform {
+ public:
+  // input_length: samples per call; max_points: largest num_points;
+  // spacing: radians per sample between output points
+  ChirpZTransform(std::size_t input_length, std::size_t max_points,
+                  double spacing);
+
+  std::size_t input_length() const noexcept { return input_length_; }
+  std::size_t max_points() const noexcept { return max_points_; }
+  double spacing() const noexcept { return spacing_; }
+
+  // out[k] = sum x[n] e^{-j (start + k spacing) n} for k < num_points
+  // (num_points is clamped to max_points)
+  void transform(const float* x, double start, std::size_t num_points,
+                 std::complex<double>* out) noexcept;
+
+ private:
+  // e^{-j spacing n^2 / 2}
+  std::complex<double> chirp(std::size_t n) const noexcept;
+
+  std::size_t input_length_;
+  std::size_t max_points_;
+  double spacing_;
+  Fft fft_;
+  std::vector<std::complex<double>> filter_;  // FFT of the inverse chirp
+  std::vector<std::complex<double>> work_;
+};
+
+}  // namespace dsp
+}  // namespace simple_tuner
+
+#endif  // SIMPLE_TUNER_DSP_FFT_H_
@@ -0,0 +1,28 @@
+#ifndef SIMPLE_TUNER_INTERFACES_IPITCH_DETECTOR_H_
+#define SIMPLE_TUNER_INTERFACES_IPITCH_DETECTOR_H_
+
+#include <cstddef>
+
+#include "simple_tuner/algorithms/DetectionResult.h"
+
+namespace simple_tuner {
+
+// Common interface for the detectors PitchDetectionController can run on a
+// tier. Implementations must not allocate in detect_pitch_detailed.
+class IPitchDetector {
+ public:
+  virtual ~IPitchDetector() = default;
+
+  virtual DetectionResult detect_pitch_detailed(
+      const float* samples, std::size_t num_samples) noexcept = 0;
+
+  virtual void set_threshold_db(double threshold_db) noexcept = 0;
+  virtual void set_min_frequency(double min_freq) noexcept = 0;
+  virtual void set_max_frequency(double max_freq) noexcept = 0;
+  virtual void set_window_type(WindowType type) noexcept = 0;
+  virtual void set_base_clarity_threshold(double threshold) noexcept = 0;
+};
+
+}  // namespace simple_tuner
+
+#endif  // SIMPLE_TUNER_INTERFACES_IPITCH_DETECTOR_H_
@@ -0,0 +1,149 @@
+#ifndef SIMPLE_TUNER_MEMORY_BUFFER_ARENA_H_
+#define SIMPLE_TUNER_MEMORY_BUFFER_ARENA_H_
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace simple_tuner {
+
+// Monotonic allocator over a single page-aligned block.
+// Every allocation starts on a cache line, so buffers carved in access order
+// sit back to back in memory. Memory is only released when the arena is
+// destroyed; objects placed in it must not outlive it.
+class BufferArena {
+ public:
+  static constexpr std::size_t kCacheLineSize = 64;
+  static constexpr std::size_t kPageSize = 4096;
+
+  // Bytes that count objects of type T occupy in the arena
+  template <typename T>
+  static constexpr std::size_t footprint(std::size_t count) noexcept {
+    return round_up(count * sizeof(T), kCacheLineSize);
+  }
+
+  // Allocates the whole block up front (throws std::bad_alloc on failure)
+  // capacity_bytes is rounded up to a whole number of pages
+  explicit BufferArena(std::size_t capacity_bytes);
+  ~BufferArena();
+
+  BufferArena(const BufferArena&) = delete;
+  BufferArena& operator=(const BufferArena&) = delete;
+
+  // Uninitialized storage for count objects of T on a cache-line boundary
+  // Returns nullptr if the arena is exhausted
+  template <typename T>
+  T* allocate(std::size_t count) noexcept {
+    static_assert(alignof(T) <= kCacheLineSize,
+                  "Arena allocations are cache-line aligned");
+    void* storage = allocate_bytes(footprint<T>(count));
+    return static_cast<T*>(storage);
+  }
+
+  std::size_t capacity() const noexcept { return capacity_; }
+  std::size_t used() const noexcept { return offset_; }
+  const void* data() const noexcept { return block_; }
+
+ private:
+  static constexpr std::size_t round_up(std::size_t value,
+                                        std::size_t alignment) noexcept {
+    return (value + alignment - 1) / alignment * alignment;
+  }
+
+  void* allocate_bytes(std::size_t bytes) noexcept;
+
+  unsigned char* block_;
+  std::size_t capacity_;
+  std::size_t offset_;
+};
+
+// Deleter for objects constructed in a BufferArena: runs the destructor
+// only, the storage is reclaimed with the arena
+struct ArenaDeleter {
+  template <typename T>
+  void operator()(T* object) const noexcept {
+    object->~T();
+  }
+};
+
+template <typename T>
+using ArenaPtr = std::unique_ptr<T, ArenaDeleter>;
+
+// Constructs a T inside the arena (throws std::bad_alloc if exhausted)
+template <typename T, typename... Args>
+ArenaPtr<T> make_in_arena(BufferArena& arena, Args&&... args) {
+  T* storage = arena.allocate<T>(1);
+  if (storage == nullptr) {
+    throw std::bad_alloc();
+  }
+  return ArenaPtr<T>(new (storage) T(std::forward<Args>(args)...));
+}
+
+// Standard allocator that carves from a BufferArena, or from the heap with
+// cache-line alignment when no arena is given. Copies of a container get a
+// heap allocator, so copying an arena-backed object never touches the arena.
+template <typename T>
+class ArenaAllocator {
+ public:
+  using value_type = T;
+  using propagate_on_container_copy_assignment = std::false_type;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+
+  ArenaAllocator() noexcept = default;
+  explicit ArenaAllocator(BufferArena* arena) noexcept : arena_(arena) {}
+
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U>& other) noexcept  // NOLINT
+      : arena_(other.arena()) {}
+
+  T* allocate(std::size_t count) {
+    if (arena_ != nullptr) {
+      T* storage = arena_->allocate<T>(count);
+      if (storage == nullptr) {
+        throw std::bad_alloc();
+      }
+      return storage;
+    }
+    return static_cast<T*>(::operator new(
+        count * sizeof(T), std::align_val_t(BufferArena::kCacheLineSize)));
+  }
+
+  void deallocate(T* storage, std::size_t count) noexcept {
+    if (arena_ == nullptr) {
+      ::operator delete(storage, count * sizeof(T),
+                        std::align_val_t(BufferArena::kCacheLineSize));
+    }
+  }
+
+  ArenaAllocator select_on_container_copy_construction() const noexcept {
+    return ArenaAllocator();
+  }
+
+  BufferArena* arena() const noexcept { return arena_; }
+
+ private:
+  BufferArena* arena_ = nullptr;
+};
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T>& lhs,
+                const ArenaAllocator<U>& rhs) noexcept {
+  return lhs.arena() == rhs.arena();
+}
+
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& lhs,
+                const ArenaAllocator<U>& rhs) noexcept {
+  return !(lhs == rhs);
+}
+
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+}  // namespace simple_tuner
+
+#endif  // SIMPLE_TUNER_MEMORY_BUFFER_ARENA_H_
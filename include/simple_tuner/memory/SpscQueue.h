@@ -0,0 +1,101 @@
+#ifndef SIMPLE_TUNER_MEMORY_SPSC_QUEUE_H_
+#define SIMPLE_TUNER_MEMORY_SPSC_QUEUE_H_
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+namespace simple_tuner {
+
+// Bounded single-producer single-consumer ring buffer.
+// Exactly one thread may push and exactly one other thread may pop; neither
+// side ever blocks, locks or allocates, so either may be the audio thread.
+// Storage is inline; Capacity must be a power of two. The producer and
+// consumer indices sit on separate cache lines so the two threads do not
+// false-share.
+template <typename T, std::size_t Capacity>
+class SpscQueue {
+  static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                "Capacity must be a power of two");
+  static_assert(std::is_trivially_copyable<T>::value,
+                "Elements are copied in and out of the ring");
+
+ public:
+  SpscQueue() noexcept : head_(0), tail_(0) {}
+
+  SpscQueue(const SpscQueue&) = delete;
+  SpscQueue& operator=(const SpscQueue&) = delete;
+
+  static constexpr std::size_t capacity() noexcept { return Capacity; }
+
+  // Producer: appends value; returns false (dropping it) if the queue is full
+  bool try_push(const T& value) noexcept { return push(&value, 1) == 1; }
+
+  // Producer: appends up to count values in order; returns how many fit
+  std::size_t push(const T* values, std::size_t count) noexcept {
+    const std::size_t tail = tail_.load(std::memory_order_relaxed);
+    const std::size_t head = head_.load(std::memory_order_acquire);
+    const std::size_t n = std::min(count, Capacity - (tail - head));
+    for (std::size_t i = 0; i < n; ++i) {
+      slots_[(tail + i) & kMask] = values[i];
+    }
+    tail_.store(tail + n, std::memory_order_release);
+    return n;
+  }
+
+  // Consumer: removes the oldest value into out; false if the queue is empty
+  bool try_pop(T& out) noexcept { return pop(&out, 1) == 1; }
+
+  // Consumer: removes up to max_count values in order; returns how many
+  std::size_t pop(T* out, std::size_t max_count) noexcept {
+    const std::size_t head = head_.load(std::memory_order_relaxed);
+    const std::size_t tail = tail_.load(std::memory_order_acquire);
+    const std::size_t n = std::min(max_count, tail - head);
+    for (std::size_t i = 0; i < n; ++i) {
+      out[i] = slots_[(head + i) & kMask];
+    }
+    head_.store(head + n, std::memory_order_release);
+    return n;
+  }
+
+  // Consumer: oldest value without removing it (nullptr if empty); valid
+  // until the consumer next pops
+  const T* front() const noexcept {
+    const std::size_t head = head_.load(std::memory_order_relaxed);
+    if (tail_.load(std::memory_order_acquire) == head) {
+      return nullptr;
+    }
+    return &slots_[head & kMask];
+  }
+
+  // Consumer: discards the oldest value (no-op if empty)
+  void discard() noexcept {
+    const std::size_t head = head_.load(std::memory_order_relaxed);
+    if (tail_.load(std::memory_order_acquire) != head) {
+      head_.store(head + 1, std::memory_order_release);
+    }
+  }
+
+  // Either side: element count at some instant during the call
+  std::size_t size() const noexcept {
+    const std::size_t head = head_.load(std::memory_order_acquire);
+    return tail_.load(std::memory_order_acquire) - head;
+  }
+
+  bool empty() const noexcept { return size() == 0; }
+
+ private:
+  static constexpr std::size_t kMask = Capacity - 1;
+  static constexpr std::size_t kCacheLineSize = 64;
+
+  // Free-running indices; only their difference and low bits are used
+  alignas(kCacheLineSize) std::atomic<std::size_t> head_;  // Consumer
+  alignas(kCacheLineSize) std::atomic<std::size_t> tail_;  // Producer
+  alignas(kCacheLineSize) std::array<T, Capacity> slots_;
+};
+
+}  // namespace simple_tuner
+
+#endif  // SIMPLE_TUNER_MEMORY_SPSC_QUEUE_H_
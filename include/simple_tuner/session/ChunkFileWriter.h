@@ -0,0 +1,62 @@
+#ifndef SIMPLE_TUNER_SESSION_CHUNK_FILE_WRITER_H_
+#define SIMPLE_TUNER_SESSION_CHUNK_FILE_WRITER_H_
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "simple_tuner/session/SessionLog.h"
+
+namespace simple_tuner {
+namespace session_log {
+
+// Appends chunks to a session file (see SessionLog.h) and indexes them:
+// open() writes the file header, write_chunk() appends one chunk, close()
+// appends the index chunk and patches its offset into the file header.
+// After a failed write nothing more is appended (the tail of the file is
+// unknown) and close() leaves the file without an index, so readers
+// recover whatever chunks are whole. Blocking file I/O: used by the
+// session workers, one thread at a time.
+class ChunkFileWriter {
+ public:
+  ChunkFileWriter() noexcept;
+
+  // Closes the file if open
+  ~ChunkFileWriter();
+
+  ChunkFileWriter(const ChunkFileWriter&) = delete;
+  ChunkFileWriter& operator=(const ChunkFileWriter&) = delete;
+
+  // Creates (truncates) path and writes the file header; false if already
+  // open or the file cannot be written
+  bool open(const std::string& path);
+
+  // Appends header and its header.payload_bytes of payload; false if the
+  // write failed now or earlier
+  bool write_chunk(const ChunkHeader& header, const unsigned char* payload);
+
+  // Pushes written chunks to the OS
+  bool flush();
+
+  // Writes the index and closes; false if any write failed (no-op if not
+  // open)
+  bool close();
+
+  bool is_open() const noexcept { return file_ != nullptr; }
+  bool failed() const noexcept { return failed_; }
+
+ private:
+  bool write_bytes(const unsigned char* data, std::size_t bytes) noexcept;
+
+  std::FILE* file_;
+  std::uint64_t offset_;  // End of the file
+  std::vector<IndexEntry> index_;
+  std::vector<unsigned char> payload_;  // Index chunk
+  bool failed_;
+};
+
+}  // namespace session_log
+}  // namespace simple_tuner
+
+#endif  // SIMPLE_TUNER_SESSION_CHUNK_FILE_WRITER_H_
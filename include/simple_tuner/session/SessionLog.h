@@ -0,0 +1,139 @@
+#ifndef SIMPLE_TUNER_SESSION_SESSION_LOG_H_
+#define SIMPLE_TUNER_SESSION_SESSION_LOG_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "simple_tuner/algorithms/MeasurementAggregator.h"
+
+namespace simple_tuner {
+
+// One detection as kept in a session log
+struct LoggedDetection {
+  double time = 0.0;  // Seconds (DetectionEvent::time)
+  double frequency = 0.0;
+  double confidence = 0.0;
+  double cents = 0.0;  // From midi_note's target when it was detected
+  int midi_note = 0;
+};
+
+// A key's MeasurementAggregator summary at some point of the session
+struct LoggedSummary {
+  double time = 0.0;  // Seconds
+  KeySummary summary;
+};
+
+// Binary session log layout. Append-only: a file header, then chunks of up
+// to a few thousand records each, then (once the writer closes) an index
+// chunk whose offset is patched into the file header. All integers and
+// floats are little-endian.
+//
+//  file header   magic, version, offset of the index chunk (0 = none)
+//  chunk header  type, flags, record count, payload bytes, time range of
+//                the records and the set of keys they touch
+//  payload       columnar:
+//                - detections: frequency, confidence and cents as f32
+//                  columns, midi note as u8, then time as f64 or, with
+//                  kDeltaTimes, zigzag varints of whole-microsecond deltas
+//                  (2 to 3 bytes each at detection rates)
+//                - summaries: time, then one column per KeySummary field
+//                - index: offset and header of every data chunk
+//                - recordings: see SessionRecording.h
+//
+// A reader finds any key or time range from the index alone and decodes
+// only the chunks that overlap it; a log whose writer never closed (no
+// index) is recovered by walking the chunk headers.
+namespace session_log {
+
+constexpr unsigned char kMagic[8] = {'S', 'T', 'S', 'L', 'O', 'G', 0, 1};
+constexpr std::uint32_t kVersion = 1;
+constexpr std::size_t kFileHeaderBytes = 32;
+constexpr std::size_t kChunkHeaderBytes = 48;
+constexpr std::uint32_t kChunkMagic = 0x4B434853;  // "SHCK"
+
+enum class ChunkType : std::uint16_t {
+  kDetections = 1,
+  kSummaries = 2,
+  kIndex = 3,
+  // Session recordings (see SessionRecording.h)
+  kRecordingInfo = 4,
+  kAudioBlocks = 5,
+  kResults = 6,
+  kControls = 7,
+};
+
+// Chunk flags
+constexpr std::uint16_t kDeltaTimes = 1;
+
+struct ChunkHeader {
+  ChunkType type = ChunkType::kDetections;
+  std::uint16_t flags = 0;
+  std::uint32_t count = 0;
+  std::uint32_t payload_bytes = 0;
+  double first_time = 0.0;
+  double last_time = 0.0;
+  std::uint64_t key_mask_low = 0;   // Piano keys 0..63 (from A0)
+  std::uint32_t key_mask_high = 0;  // Piano keys 64..87
+
+  void add_key(int midi_note) noexcept;
+  // midi_note 0 matches any chunk
+  bool has_key(int midi_note) const noexcept;
+};
+
+// One data chunk as listed in the index chunk
+struct IndexEntry {
+  std::uint64_t offset = 0;  // File offset of the chunk header
+  ChunkHeader header;
+};
+
+// Little-endian field access for the chunk codecs
+void put_u16(unsigned char* out, std::uint16_t value) noexcept;
+void put_u32(unsigned char* out, std::uint32_t value) noexcept;
+void put_u64(unsigned char* out, std::uint64_t value) noexcept;
+void put_f32(unsigned char* out, float value) noexcept;
+void put_f64(unsigned char* out, double value) noexcept;
+std::uint16_t get_u16(const unsigned char* in) noexcept;
+std::uint32_t get_u32(const unsigned char* in) noexcept;
+std::uint64_t get_u64(const unsigned char* in) noexcept;
+float get_f32(const unsigned char* in) noexcept;
+double get_f64(const unsigned char* in) noexcept;
+
+void encode_file_header(std::uint64_t index_offset,
+                        unsigned char* out) noexcept;
+// False unless bytes holds a file header of a supported version
+bool decode_file_header(const unsigned char* in, std::size_t bytes,
+                        std::uint64_t& index_offset) noexcept;
+
+void encode_chunk_header(const ChunkHeader& header,
+                         unsigned char* out) noexcept;
+bool decode_chunk_header(const unsigned char* in,
+                         ChunkHeader& header) noexcept;
+
+// Appends the payload of count records to out and fills in header (the
+// caller sets header.flags for detections beforehand)
+void encode_detections(const LoggedDetection* detections, std::size_t count,
+                       ChunkHeader& header, std::vector<unsigned char>& out);
+void encode_summaries(const LoggedSummary* summaries, std::size_t count,
+                      ChunkHeader& header, std::vector<unsigned char>& out);
+
+// Appends the records of a payload with time in [start_time, end_time) and
+// of midi_note (0 = any) to out; false if the payload is malformed
+bool decode_detections(const unsigned char* payload,
+                       const ChunkHeader& header, double start_time,
+                       double end_time, int midi_note,
+                       std::vector<LoggedDetection>& out);
+bool decode_summaries(const unsigned char* payload,
+                      const ChunkHeader& header, int midi_note,
+                      std::vector<LoggedSummary>& out);
+
+void encode_index(const IndexEntry* entries, std::size_t count,
+                  ChunkHeader& header, std::vector<unsigned char>& out);
+// Entries whose chunk headers do not decode make the whole index invalid
+bool decode_index(const unsigned char* payload, const ChunkHeader& header,
+                  std::vector<IndexEntry>& out);
+
+}  // namespace session_log
+}  // namespace simple_tuner
+
+#endif  // SIMPLE_TUNER_SESSION_SESSION_LOG_H_
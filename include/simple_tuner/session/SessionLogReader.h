@@ -0,0 +1,75 @@
+#ifndef SIMPLE_TUNER_SESSION_SESSION_LOG_READER_H_
+#define SIMPLE_TUNER_SESSION_SESSION_LOG_READER_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "simple_tuner/session/SessionLog.h"
+
+namespace simple_tuner {
+
+// Random access to a session log written by SessionLogWriter. open()
+// memory-maps the file (reads it whole where mmap is unavailable) and
+// loads only the index chunk; each query decodes just the chunks whose
+// time range and key set overlap it, straight from the mapping. A log
+// without an index (the writer never closed) is recovered by walking the
+// chunk headers up to the first truncated or corrupt one.
+// Queries are const and may run concurrently once open() has returned.
+class SessionLogReader {
+ public:
+  SessionLogReader() noexcept;
+  ~SessionLogReader();
+
+  SessionLogReader(const SessionLogReader&) = delete;
+  SessionLogReader& operator=(const SessionLogReader&) = delete;
+
+  // False if the file cannot be mapped or is not a session log
+  bool open(const std::string& path);
+  void close() noexcept;
+  bool is_open() const noexcept { return data_ != nullptr; }
+
+  // True if the index was missing or unusable and the chunks were scanned
+  bool recovered() const noexcept { return recovered_; }
+
+  std::size_t num_chunks() const noexcept { return chunks_.size(); }
+  std::size_t detection_count() const noexcept { return detection_count_; }
+  std::size_t summary_count() const noexcept { return summary_count_; }
+
+  // Detections with time in [start_time, end_time) of midi_note (0 = any
+  // key), appended to out in log order; false if a chunk is corrupt (the
+  // others are still read)
+  bool read_detections(double start_time, double end_time, int midi_note,
+                       std::vector<LoggedDetection>& out) const;
+
+  // Summaries of midi_note (0 = any key), appended to out in log order
+  bool read_summaries(int midi_note, std::vector<LoggedSummary>& out) const;
+
+  // Every data chunk in log order, and a chunk's payload in the mapping
+  // (valid until close), for the other chunk types (SessionRecording.h)
+  const std::vector<session_log::IndexEntry>& chunks() const noexcept {
+    return chunks_;
+  }
+  const unsigned char* payload(
+      const session_log::IndexEntry& chunk) const noexcept {
+    return data_ + chunk.offset + session_log::kChunkHeaderBytes;
+  }
+
+ private:
+  bool load_index(std::size_t index_offset);
+  void scan_chunks();
+
+  const unsigned char* data_;
+  std::size_t size_;
+#if defined(_WIN32)
+  std::vector<unsigned char> contents_;
+#endif
+  std::vector<session_log::IndexEntry> chunks_;  // Data chunks only
+  std::size_t detection_count_;
+  std::size_t summary_count_;
+  bool recovered_;
+};
+
+}  // namespace simple_tuner
+
+#endif  // SIMPLE_TUNER_SESSION_SESSION_LOG_READER_H_
@@ -0,0 +1,106 @@
+#ifndef SIMPLE_TUNER_SESSION_SESSION_LOG_WRITER_H_
+#define SIMPLE_TUNER_SESSION_SESSION_LOG_WRITER_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "simple_tuner/memory/SpscQueue.h"
+#include "simple_tuner/session/ChunkFileWriter.h"
+#include "simple_tuner/session/SessionLog.h"
+
+namespace simple_tuner {
+
+// Writes a session log (see SessionLog.h) on its own worker thread.
+// append() only copies the record into a lock-free SPSC ring, so it can be
+// called at detection rate from the UI thread (or the thread draining
+// PitchDetectionController) without touching the file; a full ring drops
+// the record and counts it. The worker wakes every kPollInterval, moves
+// the rings into staging buffers and writes a chunk each time kChunkRecords
+// detections (kSummaryChunkRecords summaries) have accumulated; flush() and
+// close() write the partial chunks too. close() appends the index and
+// patches its offset into the file header, so a log cut short by a crash
+// lacks only the index and the records still in flight.
+// open, append, flush and close must all be called from one thread. The
+// rings are inline (~200 KB): allocate the writer on the heap.
+class SessionLogWriter {
+ public:
+  static constexpr std::size_t kDetectionQueueSize = 4096;
+  static constexpr std::size_t kSummaryQueueSize = 256;
+  static constexpr std::size_t kChunkRecords = 4096;
+  static constexpr std::size_t kSummaryChunkRecords = 256;
+  static constexpr int kPollIntervalMs = 100;
+
+  // delta_encode_times: store detection times as varint deltas (smaller,
+  // microsecond resolution) rather than raw doubles
+  explicit SessionLogWriter(bool delta_encode_times = true);
+
+  // Closes the log if open
+  ~SessionLogWriter();
+
+  SessionLogWriter(const SessionLogWriter&) = delete;
+  SessionLogWriter& operator=(const SessionLogWriter&) = delete;
+
+  // Creates (truncates) path, writes the file header and starts the worker;
+  // false if already open or the file or thread cannot be created
+  bool open(const std::string& path);
+
+  // Writes everything appended so far plus the index, closes the file and
+  // joins the worker; false if any write failed (no-op if not open)
+  bool close();
+
+  bool is_open() const noexcept { return open_; }
+
+  // Queue a record; false (and counted in dropped()) if not open or the
+  // ring is full
+  bool append(const LoggedDetection& detection) noexcept;
+  bool append(const LoggedSummary& summary) noexcept;
+
+  // Blocks until everything appended so far is written and flushed to the
+  // OS; false if not open or a write failed
+  bool flush();
+
+  // Records lost to full rings since open()
+  std::size_t dropped() const noexcept {
+    return dropped_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  void run();
+  // Worker: empties the rings into chunks; force writes partial chunks
+  void drain(bool force);
+  void write_detections();
+  void write_summaries();
+
+  const bool delta_encode_times_;
+  bool open_;  // Producer thread only
+
+  SpscQueue<LoggedDetection, kDetectionQueueSize> detections_;
+  SpscQueue<LoggedSummary, kSummaryQueueSize> summaries_;
+  std::atomic<std::size_t> dropped_;
+
+  // Worker only while it runs; the closing thread's after the join
+  session_log::ChunkFileWriter file_;
+  std::vector<LoggedDetection> pending_detections_;
+  std::vector<LoggedSummary> pending_summaries_;
+  std::vector<unsigned char> payload_;
+  std::atomic<bool> failed_;  // Mirrors file_.failed() for flush()
+
+  std::mutex mutex_;
+  std::condition_variable wake_;     // Worker: flush or stop
+  std::condition_variable flushed_;  // flush(): request done
+  std::uint64_t flush_requested_;
+  std::uint64_t flush_done_;
+  bool stop_;
+
+  std::thread worker_;
+};
+
+}  // namespace simple_tuner
+
+#endif  // SIMPLE_TUNER_SESSION_SESSION_LOG_WRITER_H_
@@ -0,0 +1,131 @@
+#ifndef SIMPLE_TUNER_SESSION_SESSION_RECORDER_H_
+#define SIMPLE_TUNER_SESSION_SESSION_RECORDER_H_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "simple_tuner/memory/SpscQueue.h"
+#include "simple_tuner/session/ChunkFileWriter.h"
+#include "simple_tuner/session/SessionRecording.h"
+
+namespace simple_tuner {
+
+// Records everything PitchDetectionController::process_audio() sees and
+// does into a session file (SessionRecording.h) for SessionReplay: every
+// input block with its callback time and size, every setting applied
+// before a block and every result published while processing one.
+// The audio thread only copies into lock-free SPSC rings (no locks, no
+// allocation, no I/O); a worker thread wakes every kPollIntervalMs and
+// spills whole chunks to disk. A block that does not fit the rings is
+// dropped whole and the next recorded block is flagged kGapBefore, so a
+// replay knows it cannot be exact past that point.
+// start() and stop() are for the UI thread; the record_*() calls come
+// from the controller on the audio thread (see
+// PitchDetectionController::set_recorder). The rings are inline (~1.5 MB):
+// allocate the recorder on the heap.
+class SessionRecorder {
+ public:
+  static constexpr std::size_t kSampleQueueSize = 262144;  // ~5 s at 48 kHz
+  static constexpr std::size_t kBlockQueueSize = 8192;
+  static constexpr std::size_t kResultQueueSize = 4096;
+  static constexpr std::size_t kControlQueueSize = 256;
+  static constexpr std::size_t kChunkSamples = 65536;
+  static constexpr int kPollIntervalMs = 20;
+
+  SessionRecorder();
+
+  // Stops recording if started
+  ~SessionRecorder();
+
+  SessionRecorder(const SessionRecorder&) = delete;
+  SessionRecorder& operator=(const SessionRecorder&) = delete;
+
+  // Creates path, writes the controller's parameters and starts the
+  // worker; false if already recording or the file cannot be written
+  bool start(const std::string& path, double sample_rate,
+             std::size_t buffer_size);
+
+  // Writes what is still queued plus the index and closes the file; false
+  // if any write failed (no-op if not recording). Detach the recorder from
+  // the controller first, or the last blocks before stop() are lost.
+  bool stop();
+
+  bool is_recording() const noexcept {
+    return recording_.load(std::memory_order_acquire);
+  }
+
+  // Audio thread, once per block before anything else: true if this is the
+  // first block since start() (the caller then records its settings)
+  bool begin_block() noexcept;
+
+  // Audio thread: a setting applied before the next recorded block
+  void record_control(RecordedControl::Kind kind, double a,
+                      double b = 0.0) noexcept;
+
+  // Audio thread: the block about to be processed; first_sample is the
+  // controller's sample clock at its first sample
+  void record_block(const float* samples, std::size_t num_samples,
+                    std::uint64_t first_sample) noexcept;
+
+  // Audio thread: a result published while processing the last block
+  void record_result(RecordedResult::Kind kind, double time, double value,
+                     double confidence, bool valid) noexcept;
+
+  // Blocks, and results or controls, lost to full rings since start()
+  std::size_t dropped_blocks() const noexcept {
+    return dropped_blocks_.load(std::memory_order_relaxed);
+  }
+  std::size_t dropped_events() const noexcept {
+    return dropped_events_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  void run();
+  // Worker: empties the rings; force writes partial chunks
+  void drain(bool force);
+  void write_blocks();
+  void write_results();
+  void write_controls();
+
+  double sample_rate_;
+  std::atomic<bool> recording_;
+  std::atomic<std::uint32_t> generation_;  // Bumped by start()
+  std::atomic<std::int64_t> start_ticks_;  // steady_clock at start()
+
+  // Audio thread only
+  std::uint32_t audio_generation_;
+  std::uint64_t blocks_;  // Blocks recorded so far
+  bool gap_;
+
+  SpscQueue<float, kSampleQueueSize> samples_;
+  SpscQueue<RecordedBlock, kBlockQueueSize> blocks_queue_;
+  SpscQueue<RecordedResult, kResultQueueSize> results_;
+  SpscQueue<RecordedControl, kControlQueueSize> controls_;
+  std::atomic<std::size_t> dropped_blocks_;
+  std::atomic<std::size_t> dropped_events_;
+
+  // Worker only while it runs; stop()'s after the join
+  session_log::ChunkFileWriter file_;
+  std::vector<RecordedBlock> pending_blocks_;
+  std::vector<float> pending_samples_;
+  std::vector<RecordedResult> pending_results_;
+  std::vector<RecordedControl> pending_controls_;
+  std::vector<unsigned char> payload_;
+
+  std::mutex mutex_;
+  std::condition_variable wake_;  // Worker: stop
+  bool stop_;
+
+  std::thread worker_;
+};
+
+}  // namespace simple_tuner
+
+#endif  // SIMPLE_TUNER_SESSION_SESSION_RECORDER_H_
@@ -0,0 +1,94 @@
+#ifndef SIMPLE_TUNER_SESSION_SESSION_RECORDING_H_
+#define SIMPLE_TUNER_SESSION_SESSION_RECORDING_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "simple_tuner/session/SessionLog.h"
+
+namespace simple_tuner {
+
+// One PitchDetectionController::process_audio() call
+struct RecordedBlock {
+  double callback_time = 0.0;      // Seconds since recording started
+  std::uint64_t first_sample = 0;  // Controller's sample clock at the block
+  std::uint32_t size = 0;          // Samples
+  std::uint32_t flags = 0;         // kGapBefore
+  static constexpr std::uint32_t kGapBefore = 1;  // Blocks were dropped
+};
+
+// A result the controller published while processing a block
+struct RecordedResult {
+  enum class Kind : std::uint32_t {
+    kPitch = 1,  // Accepted detection: frequency, confidence
+    kBeats = 2,  // Beat analysis: rate, clarity (valid or not)
+  };
+  std::uint64_t block = 0;  // Index of the block it came out of
+  double time = 0.0;        // Controller's sample clock, seconds
+  double value = 0.0;
+  double confidence = 0.0;
+  Kind kind = Kind::kPitch;
+  std::uint32_t valid = 1;
+};
+
+// A setting the audio thread applied before a block
+struct RecordedControl {
+  enum class Kind : std::uint32_t {
+    kRange = 1,                // a = min, b = max frequency
+    kTarget = 2,               // a = target frequency (0 = off)
+    kBeatFrequency = 3,        // a = frequency (0 = off)
+    kConfidenceThreshold = 4,  // a = threshold
+    kFullTierMethod = 5,       // a = FullTierMethod
+  };
+  std::uint64_t block = 0;  // Applies before this block
+  Kind kind = Kind::kRange;
+  double a = 0.0;
+  double b = 0.0;
+};
+
+// Controller parameters a replay rebuilds
+struct RecordingInfo {
+  double sample_rate = 0.0;
+  std::uint64_t buffer_size = 0;
+};
+
+// Session recording chunks, in the session log container (SessionLog.h):
+//  info          sample rate and buffer size (one record, first chunk)
+//  audio blocks  columns callback time f64, first sample u64, size u32,
+//                flags u32, then every block's samples as f32
+//  results       columns block u64, time f64, value f64, confidence f64,
+//                kind u8, valid u8
+//  controls      columns block u64, kind u8, a f64, b f64
+// Audio and result chunks carry their time range on the controller's
+// sample clock.
+namespace session_log {
+
+void encode_recording_info(const RecordingInfo& info, ChunkHeader& header,
+                           std::vector<unsigned char>& out);
+bool decode_recording_info(const unsigned char* payload,
+                           const ChunkHeader& header, RecordingInfo& info);
+
+// samples holds the blocks' samples back to back
+void encode_audio_blocks(const RecordedBlock* blocks, std::size_t count,
+                         const float* samples, double sample_rate,
+                         ChunkHeader& header, std::vector<unsigned char>& out);
+bool decode_audio_blocks(const unsigned char* payload,
+                         const ChunkHeader& header,
+                         std::vector<RecordedBlock>& blocks,
+                         std::vector<float>& samples);
+
+void encode_results(const RecordedResult* results, std::size_t count,
+                    ChunkHeader& header, std::vector<unsigned char>& out);
+bool decode_results(const unsigned char* payload, const ChunkHeader& header,
+                    std::vector<RecordedResult>& out);
+
+void encode_controls(const RecordedControl* controls, std::size_t count,
+                     ChunkHeader& header, std::vector<unsigned char>& out);
+bool decode_controls(const unsigned char* payload, const ChunkHeader& header,
+                     std::vector<RecordedControl>& out);
+
+}  // namespace session_log
+}  // namespace simple_tuner
+
+#endif  // SIMPLE_TUNER_SESSION_SESSION_RECORDING_H_
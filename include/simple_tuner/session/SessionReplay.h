@@ -0,0 +1,87 @@
+#ifndef SIMPLE_TUNER_SESSION_SESSION_REPLAY_H_
+#define SIMPLE_TUNER_SESSION_SESSION_REPLAY_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "simple_tuner/session/SessionLogReader.h"
+#include "simple_tuner/session/SessionRecording.h"
+
+namespace simple_tuner {
+
+class PitchDetectionController;
+
+// Outcome of SessionReplay::run
+struct ReplayReport {
+  std::size_t blocks = 0;
+  std::size_t samples = 0;
+  std::size_t gaps = 0;  // Blocks the recorder dropped before (kGapBefore)
+  std::size_t recorded_results = 0;
+  std::size_t replayed_results = 0;  // Pitch detections the replay made
+  // Recorded results the replay did not reproduce within tolerance, plus
+  // replayed detections with no recorded counterpart
+  std::size_t mismatches = 0;
+  std::int64_t first_mismatch_block = -1;
+  double max_frequency_error = 0.0;  // Hz (beats per second for beats)
+  double max_confidence_error = 0.0;
+  // Wall time inside process_audio(), in total and for the slowest block
+  double process_seconds = 0.0;
+  double worst_block_seconds = 0.0;
+  bool cold_start = false;  // Recording began at the controller's first block
+  bool is_valid = false;    // Recording readable end to end
+
+  bool matches() const noexcept { return is_valid && mismatches == 0; }
+};
+
+// Replays a SessionRecorder recording through a PitchDetectionController:
+// the recorded blocks in order with their original sizes, each preceded by
+// the settings applied before it, comparing after every block what the
+// controller published against what it published when recording. Results
+// are matched per block: pitch detections in order (frequency and
+// confidence), beat analyses against get_latest_beats(). With the same
+// build and a recording that started cold the replay is bit-exact, so any
+// mismatch is a change in behaviour; process_audio() is timed per block,
+// which makes a recording a profiling workload too.
+// The recording is memory-mapped; audio chunks are decoded one at a time.
+class SessionReplay {
+ public:
+  SessionReplay() noexcept;
+
+  // False if path is not a readable recording
+  bool open(const std::string& path);
+  void close() noexcept;
+  bool is_open() const noexcept { return reader_.is_open(); }
+
+  const RecordingInfo& info() const noexcept { return info_; }
+  std::size_t num_blocks() const noexcept { return num_blocks_; }
+
+  // Largest differences still counted as the same result (default 0:
+  // bit-exact)
+  void set_tolerance(double frequency, double confidence) noexcept;
+
+  // Replays into a new controller built with the recorded parameters
+  ReplayReport run() const;
+
+  // Replays into controller, which should be fresh (nothing processed, no
+  // recorder attached) and built with info()'s parameters
+  ReplayReport run(PitchDetectionController& controller) const;
+
+ private:
+  void apply_control(const RecordedControl& control,
+                     PitchDetectionController& controller) const noexcept;
+
+  SessionLogReader reader_;
+  RecordingInfo info_;
+  std::size_t num_blocks_;
+  std::vector<RecordedControl> controls_;  // Ordered by block
+  std::vector<RecordedResult> results_;    // Ordered by block
+  bool intact_;  // Every control and result chunk decoded
+  double frequency_tolerance_;
+  double confidence_tolerance_;
+};
+
+}  // namespace simple_tuner
+
+#endif  // SIMPLE_TUNER_SESSION_SESSION_REPLAY_H_
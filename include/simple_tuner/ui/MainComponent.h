@@ -3,6 +3,7 @@
 
 #include <memory>
 
+#include "simple_tuner/algorithms/MeasurementAggregator.h"
 #include "simple_tuner/ui/ModeSelector.h"
 
 #include <juce_gui_basics/juce_gui_basics.h>
@@ -11,6 +12,7 @@ namespace simple_tuner {
 
 class PitchDetectionController;
 class FrequencyCalculator;
+class ToneGenerator;
 class NoteDisplayComponent;
 class TuningMeterComponent;
 class StatusIndicatorComponent;
@@ -28,6 +30,9 @@ class MainComponent : public juce::Component, private juce::Timer {
   // Set controller for pitch detection results
   void set_pitch_controller(PitchDetectionController* controller) noexcept;
 
+  // Set generator for the Sound mode reference tone
+  void set_tone_generator(ToneGenerator* generator) noexcept;
+
  private:
   // UI Components
   std::unique_ptr<NoteDisplayComponent> note_display_;
@@ -38,16 +43,20 @@ class MainComponent : public juce::Component, private juce::Timer {
 
   // Controllers and calculators
   PitchDetectionController* pitch_controller_;
+  ToneGenerator* tone_generator_;
   std::shared_ptr<FrequencyCalculator> frequency_calculator_;
 
   // State
   AppMode current_mode_;
+  int last_midi_note_;  // Most recently detected note (Sound mode plays it)
+  MeasurementAggregator measurements_;  // Per-key stats of the session
 
   // Helpers
   void initialize_ui() noexcept;
   void timerCallback() override;
+  // Moves the controller's queued detections into measurements_
+  void drain_measurements() noexcept;
   void handle_mode_change(ModeSelector::Mode mode) noexcept;
-  juce::String format_cents(double cents) const noexcept;
 
   JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MainComponent)
 };
@@ -3,6 +3,8 @@
 
 #include <memory>
 
+#include "simple_tuner/algorithms/DisplayTextCache.h"
+
 #include <juce_gui_basics/juce_gui_basics.h>
 
 namespace simple_tuner {
@@ -34,7 +36,9 @@ class NoteDisplayComponent : public juce::Component {
   juce::String note_letter_;
   juce::String accidental_;
   juce::String reference_freq_;
-  int current_midi_note_;
+  DisplayTextCache text_cache_;
+  int current_midi_note_;       // Note the texts were built for (0 = none)
+  double current_reference_hz_;  // Its target frequency at that time
   float current_cents_;
   bool has_signal_;
 
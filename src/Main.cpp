@@ -1,4 +1,7 @@
 #include "simple_tuner/algorithms/FrequencyCalculator.h"
+#include "simple_tuner/algorithms/ToneGenerator.h"
+#include "simple_tuner/algorithms/WavetableBank.h"
+#include "simple_tuner/config/ConfigManager.h"
 #include "simple_tuner/controllers/PitchDetectionController.h"
 #include "simple_tuner/platform/mobile/AudioManager.h"
 #include "simple_tuner/platform/PlatformFactory.h"
@@ -51,6 +54,8 @@ class SimpleTunerApplication : public juce::JUCEApplication {
  private:
   std::unique_ptr<juce::DocumentWindow> main_window_;
   std::unique_ptr<simple_tuner::PitchDetectionController> pitch_controller_;
+  std::unique_ptr<simple_tuner::WavetableBank> wavetable_bank_;
+  std::unique_ptr<simple_tuner::ToneGenerator> tone_generator_;
   std::unique_ptr<simple_tuner::IPermissions> permissions_;
 
   void request_permissions() {
@@ -103,6 +108,26 @@ class SimpleTunerApplication : public juce::JUCEApplication {
             }
           });
 
+      // Piano-timbre tables for all 88 keys, built once within the
+      // configured memory budget (declared before tone_generator_, so it
+      // outlives the generator that reads it)
+      simple_tuner::ConfigManager config(
+          simple_tuner::PlatformFactory::create_config_storage());
+      wavetable_bank_ = std::make_unique<simple_tuner::WavetableBank>(
+          sample_rate, config.get_wavetable_memory_budget());
+
+      // Reference tone for Sound mode (silent until enabled by the UI)
+      tone_generator_ = std::make_unique<simple_tuner::ToneGenerator>();
+      tone_generator_->set_sample_rate(sample_rate);
+      tone_generator_->set_wavetable_bank(wavetable_bank_.get());
+      tone_generator_->set_waveform(
+          simple_tuner::ToneGenerator::Waveform::kPiano);
+      audio_manager.set_output_handler([this](float* samples, int num_samples) {
+        if (tone_generator_) {
+          tone_generator_->process(samples, num_samples);
+        }
+      });
+
       if (!audio_manager.start()) {
         DBG("Failed to start audio");
         show_audio_error_message();
@@ -124,6 +149,7 @@ class SimpleTunerApplication : public juce::JUCEApplication {
       auto* main_component =
           new simple_tuner::MainComponent(frequency_calculator);
       main_component->set_pitch_controller(pitch_controller_.get());
+      main_component->set_tone_generator(tone_generator_.get());
       main_window_->setContentOwned(main_component, true);
 
 #if JUCE_IOS || JUCE_ANDROID
@@ -1,28 +1,106 @@
 #include "simple_tuner/controllers/PitchDetectionController.h"
 
 #include <algorithm>
+#include <cmath>
 #include <cstring>
+#include <initializer_list>
 
-#include "simple_tuner/algorithms/PitchDetector.h"
+#include "simple_tuner/algorithms/BeatDetector.h"
+#include "simple_tuner/algorithms/HarmonicSumDetector.h"
+#include "simple_tuner/algorithms/PitchDetectorFactory.h"
+#include "simple_tuner/algorithms/SubBassDetector.h"
+#include "simple_tuner/algorithms/TargetNoteDetector.h"
+#include "simple_tuner/dsp/BlockOps.h"
+#include "simple_tuner/session/SessionRecorder.h"
 
 namespace simple_tuner {
 
+namespace {
+constexpr std::size_t kFastSize = 512;
+constexpr std::size_t kMediumSize = 1024;
+// Results below this may be the second partial of A0..B0 (an octave-up
+// reading of a weak fundamental), so the sub-bass tier is consulted
+constexpr double kSubBassCheckFrequency = 65.4;  // C2
+// Up to here a frame too short for a sub-bass period can still produce a
+// confident reading, so a sub-bass result also wins over any tier result
+// that is not one of its harmonics
+constexpr double kHarmonicCheckFrequency = 130.8;  // C3
+constexpr double kHarmonicTolerance = 0.006;      // Ratio, ~10 cents
+// Range every result must fall in until set_frequency_range() is called,
+// and the slack at its ends (a note at the edge may read a little outside)
+constexpr double kDefaultMinFrequency = 27.5;    // A0
+constexpr double kDefaultMaxFrequency = 4186.0;  // C8
+constexpr double kRangeSlack = 1.03;             // ~Quarter tone
+
+// Frame of the bass target detector: the shortest power-of-two multiple of
+// buffer_size whose partial spacing TargetNoteDetector resolves from A0 up
+std::size_t bass_target_size(std::size_t buffer_size,
+                             double sample_rate) noexcept {
+  std::size_t size = std::max<std::size_t>(buffer_size, 4);
+  while (TargetNoteDetector::min_target(sample_rate, size) >
+         kDefaultMinFrequency) {
+    size *= 2;
+  }
+  return size;
+}
+}  // namespace
+
 PitchDetectionController::PitchDetectionController(std::size_t buffer_size,
                                                    double sample_rate)
-    : fast_detector_(std::make_unique<PitchDetector>(sample_rate, 512)),
-      medium_detector_(std::make_unique<PitchDetector>(sample_rate, 1024)),
-      full_detector_(std::make_unique<PitchDetector>(sample_rate, buffer_size)),
-      accumulation_buffer_(buffer_size, 0.0f),
-      fast_buffer_(512, 0.0f),
-      medium_buffer_(1024, 0.0f),
-      full_buffer_(buffer_size, 0.0f),
+    : arena_(std::make_unique<BufferArena>(
+          required_memory(buffer_size, sample_rate))),
+      accumulation_buffer_(bass_target_size(buffer_size, sample_rate), 0.0f,
+                           ArenaAllocator<float>(arena_.get())),
+      fast_buffer_(kFastSize, 0.0f, ArenaAllocator<float>(arena_.get())),
+      fast_detector_(
+          PitchDetectorFactory::create(sample_rate, kFastSize, *arena_)),
+      medium_buffer_(kMediumSize, 0.0f, ArenaAllocator<float>(arena_.get())),
+      medium_detector_(
+          PitchDetectorFactory::create(sample_rate, kMediumSize, *arena_)),
+      full_buffer_(buffer_size, 0.0f, ArenaAllocator<float>(arena_.get())),
+      full_detector_(
+          PitchDetectorFactory::create(sample_rate, buffer_size, *arena_)),
+      harmonic_detector_(make_in_arena<HarmonicSumDetector>(
+          *arena_, sample_rate, buffer_size, *arena_)),
+      sub_bass_detector_(
+          make_in_arena<SubBassDetector>(*arena_, sample_rate, *arena_)),
+      target_detector_(make_in_arena<TargetNoteDetector>(
+          *arena_, sample_rate, buffer_size, *arena_)),
+      bass_target_buffer_(bass_target_size(buffer_size, sample_rate), 0.0f,
+                          ArenaAllocator<float>(arena_.get())),
+      bass_target_detector_(make_in_arena<TargetNoteDetector>(
+          *arena_, sample_rate, bass_target_buffer_.size(), *arena_)),
+      beat_detector_(
+          make_in_arena<BeatDetector>(*arena_, sample_rate, *arena_)),
       write_index_(0),
       buffer_size_(buffer_size),
       samples_since_detection_(0),
+      beat_hop_(static_cast<std::size_t>(kBeatInterval * sample_rate)),
+      samples_since_beats_(0),
       previous_energy_(0.0),
       latest_frequency_(0.0),
       latest_confidence_(0.0),
       has_valid_result_(false),
+      latest_beat_rate_(0.0),
+      latest_beat_clarity_(0.0),
+      has_beat_result_(false),
+      samples_processed_(0),
+      range_sequence_(0),
+      pending_min_frequency_(0.0),
+      pending_max_frequency_(0.0),
+      applied_range_sequence_(0),
+      pending_target_(0.0),
+      target_pending_(false),
+      pending_beat_frequency_(0.0),
+      beat_pending_(false),
+      pending_full_tier_method_(FullTierMethod::kNsdf),
+      full_tier_pending_(false),
+      full_tier_method_(FullTierMethod::kNsdf),
+      recorder_(nullptr),
+      active_recorder_(nullptr),
+      applied_min_frequency_(0.0),
+      applied_max_frequency_(0.0),
+      recorded_threshold_(0.0),
       confidence_threshold_(0.5),
       sample_rate_(sample_rate) {
   // Configure detection tiers
@@ -32,20 +110,66 @@ PitchDetectionController::PitchDetectionController(std::size_t buffer_size,
   tiers_.push_back({1024, 256, 43.0});
   // Full: 4096 samples, 32.7Hz min (C1), 1024-sample hop (~23ms @ 48kHz)
   tiers_.push_back({buffer_size, 1024, 32.7});
+  // Sub-bass: ~160 ms decimated history, 27.5Hz min (A0), fed every
+  // callback; consulted (~11us) on any detection that finds nothing or a
+  // note below C3, so it shares the fast tier's hop
+  tiers_.push_back({sub_bass_detector_->window_span(), 128, 27.5});
 }
 
 PitchDetectionController::~PitchDetectionController() = default;
 
+std::size_t PitchDetectionController::required_memory(
+    std::size_t buffer_size, double sample_rate) noexcept {
+  const std::size_t bass_size = bass_target_size(buffer_size, sample_rate);
+  return 2 * BufferArena::footprint<float>(bass_size) +
+         BufferArena::footprint<float>(buffer_size) +
+         BufferArena::footprint<float>(kFastSize) +
+         BufferArena::footprint<float>(kMediumSize) +
+         PitchDetectorFactory::arena_bytes(sample_rate, kFastSize) +
+         PitchDetectorFactory::arena_bytes(sample_rate, kMediumSize) +
+         PitchDetectorFactory::arena_bytes(sample_rate, buffer_size) +
+         BufferArena::footprint<HarmonicSumDetector>(1) +
+         HarmonicSumDetector::arena_bytes(buffer_size) +
+         BufferArena::footprint<SubBassDetector>(1) +
+         SubBassDetector::arena_bytes(sample_rate) +
+         2 * BufferArena::footprint<TargetNoteDetector>(1) +
+         TargetNoteDetector::arena_bytes(buffer_size) +
+         TargetNoteDetector::arena_bytes(bass_size) +
+         BufferArena::footprint<BeatDetector>(1) +
+         BeatDetector::arena_bytes(sample_rate);
+}
+
 void PitchDetectionController::process_audio(const float* samples,
                                              std::size_t num_samples) noexcept {
   if (samples == nullptr || num_samples == 0) {
     return;
   }
 
+  begin_recording_block();
+  apply_pending_range();
+  apply_pending_target();
+  apply_pending_beat_frequency();
+  apply_pending_full_tier_method();
+  if (active_recorder_ != nullptr) {
+    active_recorder_->record_block(samples, num_samples, samples_processed_);
+  }
+  samples_processed_ += num_samples;
+
   // Copy samples into circular buffer
+  const std::size_t history = accumulation_buffer_.size();
   for (std::size_t i = 0; i < num_samples; ++i) {
     accumulation_buffer_[write_index_] = samples[i];
-    write_index_ = (write_index_ + 1) % buffer_size_;
+    write_index_ = (write_index_ + 1) % history;
+  }
+
+  sub_bass_detector_->push_samples(samples, num_samples);
+  if (beat_detector_->get_frequency() > 0.0) {
+    beat_detector_->push_samples(samples, num_samples);
+    samples_since_beats_ += num_samples;
+    if (samples_since_beats_ >= beat_hop_) {
+      samples_since_beats_ = 0;
+      run_beat_detection();
+    }
   }
 
   samples_since_detection_ += num_samples;
@@ -65,38 +189,223 @@ void PitchDetectionController::process_audio(const float* samples,
   }
 }
 
-void PitchDetectionController::run_tiered_detection() noexcept {
-  // Phase 1: Try fast tier first (512 samples for C4+)
-  linearize_buffer(fast_buffer_, 512);
-  auto result = fast_detector_->detect_pitch_detailed(fast_buffer_.data(), 512);
+void PitchDetectionController::begin_recording_block() noexcept {
+  SessionRecorder* recorder = recorder_.load(std::memory_order_acquire);
+  active_recorder_ =
+      recorder != nullptr && recorder->is_recording() ? recorder : nullptr;
+  if (active_recorder_ == nullptr) {
+    return;
+  }
+  using Kind = RecordedControl::Kind;
+  if (active_recorder_->begin_block()) {
+    // A new recording starts from the settings in effect now
+    if (applied_min_frequency_ > 0.0) {
+      active_recorder_->record_control(Kind::kRange, applied_min_frequency_,
+                                       applied_max_frequency_);
+    }
+    active_recorder_->record_control(Kind::kTarget,
+                                     target_detector_->get_target());
+    active_recorder_->record_control(Kind::kBeatFrequency,
+                                     beat_detector_->get_frequency());
+    active_recorder_->record_control(
+        Kind::kFullTierMethod, static_cast<double>(full_tier_method_));
+    recorded_threshold_ = -1.0;
+  }
+  // The threshold is set directly rather than handed over like the others
+  if (confidence_threshold_ != recorded_threshold_) {
+    recorded_threshold_ = confidence_threshold_;
+    active_recorder_->record_control(Kind::kConfidenceThreshold,
+                                     recorded_threshold_);
+  }
+}
 
-  if (result.is_valid && result.confidence >= confidence_threshold_) {
-    latest_frequency_.store(result.frequency, std::memory_order_release);
-    latest_confidence_.store(result.confidence, std::memory_order_release);
-    has_valid_result_.store(true, std::memory_order_release);
+void PitchDetectionController::apply_pending_range() noexcept {
+  // Nothing new, or a pair half written: look again next block
+  const std::uint32_t sequence =
+      range_sequence_.load(std::memory_order_acquire);
+  if (sequence == applied_range_sequence_ || (sequence & 1u) != 0) {
+    return;
+  }
+  // Acquire loads: seeing a bound from a newer write means seeing its odd
+  // sequence number below
+  const double min_frequency =
+      pending_min_frequency_.load(std::memory_order_acquire);
+  const double max_frequency =
+      pending_max_frequency_.load(std::memory_order_acquire);
+  if (range_sequence_.load(std::memory_order_relaxed) != sequence) {
+    return;  // Rewritten while reading
+  }
+  applied_range_sequence_ = sequence;
+  applied_min_frequency_ = min_frequency;
+  applied_max_frequency_ = max_frequency;
+  if (active_recorder_ != nullptr) {
+    active_recorder_->record_control(RecordedControl::Kind::kRange,
+                                     min_frequency, max_frequency);
+  }
+  for (IPitchDetector* detector :
+       {fast_detector_.get(), medium_detector_.get(), full_detector_.get(),
+        static_cast<IPitchDetector*>(harmonic_detector_.get())}) {
+    detector->set_min_frequency(min_frequency);
+    detector->set_max_frequency(max_frequency);
+  }
+  // The sub-bass tier keeps its own upper limit (it only resolves the
+  // lowest octave)
+  sub_bass_detector_->set_min_frequency(min_frequency);
+  for (TargetNoteDetector* detector :
+       {target_detector_.get(), bass_target_detector_.get()}) {
+    detector->set_min_frequency(min_frequency);
+    detector->set_max_frequency(max_frequency);
+  }
+}
+
+void PitchDetectionController::apply_pending_target() noexcept {
+  if (!target_pending_.exchange(false, std::memory_order_acq_rel)) {
     return;
   }
+  const double target = pending_target_.load(std::memory_order_relaxed);
+  target_detector_->set_target(target);
+  bass_target_detector_->set_target(target);
+  if (active_recorder_ != nullptr) {
+    active_recorder_->record_control(RecordedControl::Kind::kTarget, target);
+  }
+}
 
-  // Fast tier failed, try medium tier (1024 samples for C2+)
-  linearize_buffer(medium_buffer_, 1024);
-  result = medium_detector_->detect_pitch_detailed(medium_buffer_.data(), 1024);
+void PitchDetectionController::apply_pending_beat_frequency() noexcept {
+  if (!beat_pending_.exchange(false, std::memory_order_acq_rel)) {
+    return;
+  }
+  const double frequency =
+      pending_beat_frequency_.load(std::memory_order_relaxed);
+  beat_detector_->set_frequency(frequency);
+  samples_since_beats_ = 0;
+  if (active_recorder_ != nullptr) {
+    active_recorder_->record_control(RecordedControl::Kind::kBeatFrequency,
+                                     frequency);
+  }
+  has_beat_result_.store(false, std::memory_order_release);
+}
 
-  if (result.is_valid && result.confidence >= confidence_threshold_) {
-    latest_frequency_.store(result.frequency, std::memory_order_release);
-    latest_confidence_.store(result.confidence, std::memory_order_release);
-    has_valid_result_.store(true, std::memory_order_release);
+void PitchDetectionController::apply_pending_full_tier_method() noexcept {
+  if (!full_tier_pending_.exchange(false, std::memory_order_acq_rel)) {
+    return;
+  }
+  full_tier_method_ =
+      pending_full_tier_method_.load(std::memory_order_relaxed);
+  if (active_recorder_ != nullptr) {
+    active_recorder_->record_control(RecordedControl::Kind::kFullTierMethod,
+                                     static_cast<double>(full_tier_method_));
+  }
+}
+
+void PitchDetectionController::run_beat_detection() noexcept {
+  const BeatResult beats = beat_detector_->detect();
+  if (beats.is_valid) {
+    latest_beat_rate_.store(beats.rate, std::memory_order_release);
+    latest_beat_clarity_.store(beats.clarity, std::memory_order_release);
+  }
+  has_beat_result_.store(beats.is_valid, std::memory_order_release);
+  if (active_recorder_ != nullptr) {
+    active_recorder_->record_result(
+        RecordedResult::Kind::kBeats,
+        static_cast<double>(samples_processed_) / sample_rate_, beats.rate,
+        beats.clarity, beats.is_valid);
+  }
+}
+
+void PitchDetectionController::run_tiered_detection() noexcept {
+  // A reading outside the tuning range (or above Nyquist) is a failed
+  // detection, however confident
+  const double min_frequency = (applied_min_frequency_ > 0.0
+                                    ? applied_min_frequency_
+                                    : kDefaultMinFrequency) /
+                               kRangeSlack;
+  const double max_frequency =
+      std::min((applied_max_frequency_ > 0.0 ? applied_max_frequency_
+                                             : kDefaultMaxFrequency) *
+                   kRangeSlack,
+               0.5 * sample_rate_);
+  const auto accepted = [&](const DetectionResult& result) {
+    return result.is_valid && result.confidence >= confidence_threshold_ &&
+           result.frequency >= min_frequency &&
+           result.frequency <= max_frequency;
+  };
+
+  DetectionResult result;
+  if (target_detector_->get_target() > 0.0) {
+    // Known-key mode: only the target's partials, on the full buffer, or
+    // on the longer bass frame for a key whose partials it cannot separate
+    if (target_detector_->get_target() >=
+        TargetNoteDetector::min_target(sample_rate_, buffer_size_)) {
+      linearize_buffer(full_buffer_.data(), buffer_size_);
+      result = target_detector_->detect_pitch_detailed(full_buffer_.data(),
+                                                       buffer_size_);
+    } else {
+      const std::size_t size = bass_target_buffer_.size();
+      linearize_buffer(bass_target_buffer_.data(), size);
+      result = bass_target_detector_->detect_pitch_detailed(
+          bass_target_buffer_.data(), size);
+    }
+    publish_result(result);
     return;
   }
 
-  // Medium tier failed, use full tier (4096 samples for C1+)
-  linearize_buffer(full_buffer_, buffer_size_);
-  result =
-      full_detector_->detect_pitch_detailed(full_buffer_.data(), buffer_size_);
+  // Phase 1: Try fast tier first (512 samples for C4+)
+  linearize_buffer(fast_buffer_.data(), 512);
+  result = fast_detector_->detect_pitch_detailed(fast_buffer_.data(), 512);
+
+  if (!accepted(result)) {
+    // Fast tier failed, try medium tier (1024 samples for C2+)
+    linearize_buffer(medium_buffer_.data(), 1024);
+    result =
+        medium_detector_->detect_pitch_detailed(medium_buffer_.data(), 1024);
+  }
+
+  if (!accepted(result)) {
+    // Medium tier failed, use full tier (4096 samples for C1+)
+    IPitchDetector* full = full_tier_method_ == FullTierMethod::kHarmonicSum
+                               ? harmonic_detector_.get()
+                               : full_detector_.get();
+    linearize_buffer(full_buffer_.data(), buffer_size_);
+    result = full->detect_pitch_detailed(full_buffer_.data(), buffer_size_);
+  }
 
+  // Nothing found, a bass note that may be A0..B0 read an octave up, or a
+  // low reading that is no harmonic of the sub-bass pitch: the sub-bass
+  // tier (decimated, already up to date) has the final say
+  if (!accepted(result) || result.frequency < kHarmonicCheckFrequency) {
+    const DetectionResult sub_bass = sub_bass_detector_->detect();
+    if (accepted(sub_bass)) {
+      const double ratio = result.frequency / sub_bass.frequency;
+      const bool harmonic =
+          ratio >= 1.0 - kHarmonicTolerance &&
+          std::abs(ratio - std::round(ratio)) <=
+              kHarmonicTolerance * std::round(ratio);
+      if (!accepted(result) || result.frequency < kSubBassCheckFrequency ||
+          !harmonic) {
+        result = sub_bass;
+      }
+    }
+  }
+
+  publish_result(accepted(result) ? result : DetectionResult(0.0, 0.0, false));
+}
+
+void PitchDetectionController::publish_result(
+    const DetectionResult& result) noexcept {
   if (result.is_valid && result.confidence >= confidence_threshold_) {
     latest_frequency_.store(result.frequency, std::memory_order_release);
     latest_confidence_.store(result.confidence, std::memory_order_release);
     has_valid_result_.store(true, std::memory_order_release);
+    DetectionEvent event;
+    event.frequency = result.frequency;
+    event.confidence = result.confidence;
+    event.time = static_cast<double>(samples_processed_) / sample_rate_;
+    detections_.try_push(event);
+    if (active_recorder_ != nullptr) {
+      active_recorder_->record_result(RecordedResult::Kind::kPitch,
+                                      event.time, event.frequency,
+                                      event.confidence, true);
+    }
   } else {
     has_valid_result_.store(false, std::memory_order_release);
   }
@@ -108,19 +417,17 @@ double PitchDetectionController::calculate_energy(
     return 0.0;
   }
 
-  double sum = 0.0;
-  for (std::size_t i = 0; i < num_samples; ++i) {
-    sum += samples[i] * samples[i];
-  }
-  return sum / static_cast<double>(num_samples);
+  return dsp::sum_of_squares(samples, num_samples) /
+         static_cast<double>(num_samples);
 }
 
 void PitchDetectionController::linearize_buffer(
-    std::vector<float>& dest, std::size_t size) const noexcept {
+    float* dest, std::size_t size) const noexcept {
   // Copy most recent 'size' samples from circular buffer to linear buffer
+  const std::size_t history = accumulation_buffer_.size();
   for (std::size_t i = 0; i < size; ++i) {
-    dest[i] = accumulation_buffer_[(write_index_ + buffer_size_ - size + i) %
-                                   buffer_size_];
+    dest[i] = accumulation_buffer_[(write_index_ + history - size + i) %
+                                   history];
   }
 }
 
@@ -134,6 +441,21 @@ bool PitchDetectionController::get_latest_result(
   return valid;
 }
 
+std::size_t PitchDetectionController::drain_detections(
+    DetectionEvent* out, std::size_t max_count) noexcept {
+  return out != nullptr ? detections_.pop(out, max_count) : 0;
+}
+
+bool PitchDetectionController::get_latest_beats(
+    double& beats_per_second, double& clarity) const noexcept {
+  const bool valid = has_beat_result_.load(std::memory_order_acquire);
+  if (valid) {
+    beats_per_second = latest_beat_rate_.load(std::memory_order_acquire);
+    clarity = latest_beat_clarity_.load(std::memory_order_acquire);
+  }
+  return valid;
+}
+
 void PitchDetectionController::set_confidence_threshold(
     double threshold) noexcept {
   confidence_threshold_ = std::clamp(threshold, 0.0, 1.0);
@@ -143,4 +465,41 @@ double PitchDetectionController::get_confidence_threshold() const noexcept {
   return confidence_threshold_;
 }
 
+void PitchDetectionController::set_target_frequency(
+    double frequency) noexcept {
+  pending_target_.store(frequency > 0.0 ? frequency : 0.0,
+                        std::memory_order_relaxed);
+  target_pending_.store(true, std::memory_order_release);
+}
+
+void PitchDetectionController::set_beat_frequency(double frequency) noexcept {
+  pending_beat_frequency_.store(frequency > 0.0 ? frequency : 0.0,
+                                std::memory_order_relaxed);
+  beat_pending_.store(true, std::memory_order_release);
+}
+
+void PitchDetectionController::set_full_tier_method(
+    FullTierMethod method) noexcept {
+  pending_full_tier_method_.store(method, std::memory_order_relaxed);
+  full_tier_pending_.store(true, std::memory_order_release);
+}
+
+void PitchDetectionController::set_recorder(
+    SessionRecorder* recorder) noexcept {
+  recorder_.store(recorder, std::memory_order_release);
+}
+
+void PitchDetectionController::set_frequency_range(
+    double min_frequency, double max_frequency) noexcept {
+  if (min_frequency <= 0.0 || max_frequency <= min_frequency) {
+    return;
+  }
+  const std::uint32_t sequence =
+      range_sequence_.load(std::memory_order_relaxed);
+  range_sequence_.store(sequence + 1, std::memory_order_relaxed);
+  pending_min_frequency_.store(min_frequency, std::memory_order_release);
+  pending_max_frequency_.store(max_frequency, std::memory_order_release);
+  range_sequence_.store(sequence + 2, std::memory_order_release);
+}
+
 }  // namespace simple_tuner
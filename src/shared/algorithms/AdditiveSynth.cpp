@@ -0,0 +1,212 @@
+#include "simple_tuner/algorithms/AdditiveSynth.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace simple_tuner {
+
+namespace {
+constexpr double kPi = 3.14159265358979323846;
+constexpr double kMaxInharmonicity = 0.1;
+constexpr double kBandLimit = 0.45;  // Fraction of the sample rate
+constexpr double kDecay60dB = 6.907755278982137;  // ln(1000)
+// Partials below -100 dB (squared magnitude) stop rendering
+constexpr double kSilentPower = 1e-10;
+
+// (re, im) = (re, im) * (mul_re, mul_im)
+inline void complex_multiply(double& re, double& im, double mul_re,
+                             double mul_im) noexcept {
+  const double new_re = re * mul_re - im * mul_im;
+  im = re * mul_im + im * mul_re;
+  re = new_re;
+}
+}  // namespace
+
+AdditiveSynth::AdditiveSynth(double sample_rate) noexcept
+    : sample_rate_(sample_rate > 0.0 ? sample_rate : 44100.0),
+      inharmonicity_(0.0),
+      num_partials_(kMaxPartials),
+      num_active_(0),
+      block_size_(0) {
+  set_default_spectrum(16, 4.0);
+}
+
+void AdditiveSynth::set_sample_rate(double sample_rate) noexcept {
+  if (sample_rate > 0.0) {
+    sample_rate_ = sample_rate;
+  }
+}
+
+void AdditiveSynth::set_inharmonicity(double inharmonicity) noexcept {
+  inharmonicity_ = std::clamp(inharmonicity, 0.0, kMaxInharmonicity);
+}
+
+void AdditiveSynth::set_partial(int partial, float amplitude,
+                                double decay_seconds) noexcept {
+  if (partial < 1 || partial > kMaxPartials) {
+    return;
+  }
+  amplitude_[partial - 1] = std::max(amplitude, 0.0f);
+  decay_seconds_[partial - 1] = decay_seconds;
+}
+
+void AdditiveSynth::set_num_partials(int num_partials) noexcept {
+  num_partials_ = std::clamp(num_partials, 1, kMaxPartials);
+}
+
+void AdditiveSynth::set_default_spectrum(int num_partials,
+                                         double decay_seconds) noexcept {
+  set_num_partials(num_partials);
+  double harmonic_sum = 0.0;
+  for (int n = 1; n <= num_partials_; ++n) {
+    harmonic_sum += 1.0 / n;
+  }
+  for (int n = 1; n <= kMaxPartials; ++n) {
+    const auto amplitude = static_cast<float>(1.0 / (n * harmonic_sum));
+    set_partial(n, n <= num_partials_ ? amplitude : 0.0f,
+                decay_seconds / std::sqrt(static_cast<double>(n)));
+  }
+}
+
+double AdditiveSynth::partial_frequency(double fundamental_hz, int partial,
+                                        double inharmonicity) noexcept {
+  const double n = partial;
+  return n * fundamental_hz * std::sqrt(1.0 + inharmonicity * n * n);
+}
+
+void AdditiveSynth::note_on(double frequency_hz) noexcept {
+  num_active_ = 0;
+  block_size_ = 0;
+  if (frequency_hz <= 0.0) {
+    return;
+  }
+
+  // Oscillator setup is the only place that evaluates sin/cos
+  for (int n = 1; n <= num_partials_; ++n) {
+    const double frequency =
+        partial_frequency(frequency_hz, n, inharmonicity_);
+    const float amplitude = amplitude_[n - 1];
+    if (frequency >= kBandLimit * sample_rate_) {
+      break;  // Higher partials are higher still
+    }
+    if (amplitude <= 0.0f) {
+      continue;
+    }
+
+    const double omega = 2.0 * kPi * frequency / sample_rate_;
+    const double decay_seconds = decay_seconds_[n - 1];
+    const double decay =
+        decay_seconds > 0.0
+            ? std::exp(-kDecay60dB / (decay_seconds * sample_rate_))
+            : 1.0;
+
+    const int p = num_active_++;
+    phasor_re_[p] = amplitude;
+    phasor_im_[p] = 0.0;
+    step_re_[p] = decay * std::cos(omega);
+    step_im_[p] = decay * std::sin(omega);
+
+    double re = 1.0;
+    double im = 0.0;
+    for (int k = 0; k < kLanes; ++k) {
+      lane_re_[p][k] = re;
+      lane_im_[p][k] = im;
+      complex_multiply(re, im, step_re_[p], step_im_[p]);
+    }
+    lane_step_re_[p] = static_cast<float>(re);
+    lane_step_im_[p] = static_cast<float>(im);
+  }
+}
+
+void AdditiveSynth::reset() noexcept { num_active_ = 0; }
+
+void AdditiveSynth::update_block_rotation(std::size_t num_samples) noexcept {
+  // step^num_samples by repeated squaring (exact to double rounding)
+  for (int p = 0; p < num_active_; ++p) {
+    double result_re = 1.0;
+    double result_im = 0.0;
+    double base_re = step_re_[p];
+    double base_im = step_im_[p];
+    for (std::size_t e = num_samples; e > 0; e >>= 1) {
+      if (e & 1) {
+        complex_multiply(result_re, result_im, base_re, base_im);
+      }
+      complex_multiply(base_re, base_im, base_re, base_im);
+    }
+    block_re_[p] = result_re;
+    block_im_[p] = result_im;
+  }
+  block_size_ = num_samples;
+}
+
+void AdditiveSynth::render(float* out, std::size_t num_samples) noexcept {
+  if (out == nullptr || num_samples == 0) {
+    return;
+  }
+  if (num_active_ == 0) {
+    std::fill(out, out + num_samples, 0.0f);
+    return;
+  }
+  if (num_samples != block_size_) {
+    update_block_rotation(num_samples);
+  }
+
+  std::fill(out, out + num_samples, 0.0f);
+  const std::size_t full = num_samples - num_samples % kLanes;
+  for (int p = 0; p < num_active_; ++p) {
+    // Lane k starts k samples into the block
+    float re[kLanes];
+    float im[kLanes];
+    for (int k = 0; k < kLanes; ++k) {
+      re[k] = static_cast<float>(phasor_re_[p] * lane_re_[p][k] -
+                                 phasor_im_[p] * lane_im_[p][k]);
+      im[k] = static_cast<float>(phasor_re_[p] * lane_im_[p][k] +
+                                 phasor_im_[p] * lane_re_[p][k]);
+    }
+    const float step_re = lane_step_re_[p];
+    const float step_im = lane_step_im_[p];
+
+    std::size_t i = 0;
+    for (; i < full; i += kLanes) {
+      float* block = out + i;
+      for (int k = 0; k < kLanes; ++k) {
+        block[k] += im[k];
+        const float new_re = re[k] * step_re - im[k] * step_im;
+        im[k] = re[k] * step_im + im[k] * step_re;
+        re[k] = new_re;
+      }
+    }
+    for (int k = 0; i < num_samples; ++i, ++k) {
+      out[i] += im[k];
+    }
+
+    complex_multiply(phasor_re_[p], phasor_im_[p], block_re_[p],
+                     block_im_[p]);
+  }
+
+  // Drop partials that have decayed to silence, keeping the arrays compact
+  int kept = 0;
+  for (int p = 0; p < num_active_; ++p) {
+    const double power =
+        phasor_re_[p] * phasor_re_[p] + phasor_im_[p] * phasor_im_[p];
+    if (power < kSilentPower) {
+      continue;
+    }
+    if (kept != p) {
+      phasor_re_[kept] = phasor_re_[p];
+      phasor_im_[kept] = phasor_im_[p];
+      step_re_[kept] = step_re_[p];
+      step_im_[kept] = step_im_[p];
+      lane_step_re_[kept] = lane_step_re_[p];
+      lane_step_im_[kept] = lane_step_im_[p];
+      block_re_[kept] = block_re_[p];
+      block_im_[kept] = block_im_[p];
+      std::copy(lane_re_[p], lane_re_[p] + kLanes, lane_re_[kept]);
+      std::copy(lane_im_[p], lane_im_[p] + kLanes, lane_im_[kept]);
+    }
+    ++kept;
+  }
+  num_active_ = kept;
+}
+
+}  // namespace simple_tuner
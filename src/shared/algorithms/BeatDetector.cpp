@@ -0,0 +1,252 @@
+#include "simple_tuner/algorithms/BeatDetector.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "simple_tuner/algorithms/MpmPeakPicking.h"
+#include "simple_tuner/dsp/BlockOps.h"
+
+namespace simple_tuner {
+
+namespace {
+constexpr double kPi = 3.14159265358979323846;
+constexpr double kDefaultThresholdDb = -60.0;
+constexpr double kBandLimit = 0.45;    // Fraction of the sample rate
+constexpr double kMinClarity = 0.3;    // Envelope NSDF of a valid beat
+constexpr double kMinQ = 0.5;
+// Envelope smoothing ahead of the block average: suppresses the squared
+// signal's 2f component, which would otherwise alias into the envelope
+constexpr double kSmoothingCutoff = 30.0;  // Hz
+// Envelope dropped after a reset while the band-pass rings up (its time
+// constant is 1 / (pi * kBandwidth) whatever the center frequency)
+constexpr double kSettleSeconds = 0.05;
+constexpr double kEpsilon = 1e-20;
+
+std::size_t next_power_of_two(std::size_t value) noexcept {
+  std::size_t result = 1;
+  while (result < value) {
+    result <<= 1;
+  }
+  return result;
+}
+}  // namespace
+
+BeatDetector::BeatDetector(double sample_rate)
+    : BeatDetector(sample_rate, nullptr) {}
+
+BeatDetector::BeatDetector(double sample_rate, BufferArena& arena)
+    : BeatDetector(sample_rate, &arena) {}
+
+BeatDetector::BeatDetector(double sample_rate, BufferArena* arena)
+    : sample_rate_(sample_rate > 0.0 ? sample_rate : 48000.0),
+      decimation_(decimation_for(sample_rate_)),
+      envelope_rate_(sample_rate_ / decimation_),
+      window_length_(window_length_for(sample_rate_)),
+      history_mask_(history_length_for(sample_rate_) - 1),
+      lag_capacity_(max_lag_for(sample_rate_)),
+      frequency_(0.0),
+      threshold_db_(kDefaultThresholdDb),
+      sections_(),
+      smoothing_(1.0 -
+                 std::exp(-2.0 * kPi * kSmoothingCutoff / sample_rate_)),
+      smoothed_(0.0),
+      block_sum_(0.0),
+      phase_(0),
+      settling_(0),
+      write_index_(0),
+      filled_(0),
+      history_(ArenaAllocator<float>(arena)),
+      working_(ArenaAllocator<float>(arena)),
+      energy_(ArenaAllocator<double>(arena)),
+      nsdf_(ArenaAllocator<double>(arena)) {
+  // Buffers in the order detect() touches them
+  history_.resize(history_mask_ + 1, 0.0f);
+  working_.resize(window_length_, 0.0f);
+  energy_.resize(window_length_ + 1, 0.0);
+  nsdf_.resize(static_cast<std::size_t>(lag_capacity_ + 2), 0.0);
+}
+
+int BeatDetector::decimation_for(double sample_rate) noexcept {
+  return std::max(
+      1, static_cast<int>(std::lround(sample_rate / kEnvelopeRate)));
+}
+
+std::size_t BeatDetector::window_length_for(double sample_rate) noexcept {
+  const double envelope_rate = sample_rate / decimation_for(sample_rate);
+  return static_cast<std::size_t>(
+      std::lround(kHistorySeconds * envelope_rate));
+}
+
+std::size_t BeatDetector::history_length_for(double sample_rate) noexcept {
+  return next_power_of_two(window_length_for(sample_rate));
+}
+
+int BeatDetector::max_lag_for(double sample_rate) noexcept {
+  // Two periods of the slowest beat must fit in the window
+  return static_cast<int>(window_length_for(sample_rate) / 2);
+}
+
+std::size_t BeatDetector::arena_bytes(double sample_rate) noexcept {
+  if (!(sample_rate > 0.0)) {
+    sample_rate = 48000.0;
+  }
+  return BufferArena::footprint<float>(history_length_for(sample_rate)) +
+         BufferArena::footprint<float>(window_length_for(sample_rate)) +
+         BufferArena::footprint<double>(window_length_for(sample_rate) + 1) +
+         BufferArena::footprint<double>(
+             static_cast<std::size_t>(max_lag_for(sample_rate) + 2));
+}
+
+void BeatDetector::set_frequency(double frequency) noexcept {
+  frequency_ =
+      frequency > 0.0 && frequency < kBandLimit * sample_rate_ ? frequency
+                                                                : 0.0;
+  if (frequency_ > 0.0) {
+    // RBJ band-pass with 0 dB peak gain
+    const double omega = 2.0 * kPi * frequency_ / sample_rate_;
+    const double q = std::max(frequency_ / kBandwidth, kMinQ);
+    const double alpha = std::sin(omega) / (2.0 * q);
+    const double a0 = 1.0 + alpha;
+    for (Biquad& section : sections_) {
+      section.b0 = alpha / a0;
+      section.b2 = -alpha / a0;
+      section.a1 = -2.0 * std::cos(omega) / a0;
+      section.a2 = (1.0 - alpha) / a0;
+    }
+  }
+  reset();
+}
+
+void BeatDetector::reset() noexcept {
+  for (Biquad& section : sections_) {
+    section.z1 = 0.0;
+    section.z2 = 0.0;
+  }
+  smoothed_ = 0.0;
+  block_sum_ = 0.0;
+  phase_ = 0;
+  settling_ = static_cast<int>(std::ceil(kSettleSeconds * envelope_rate_));
+  write_index_ = 0;
+  filled_ = 0;
+}
+
+void BeatDetector::set_threshold_db(double threshold_db) noexcept {
+  threshold_db_ = threshold_db;
+}
+
+void BeatDetector::push_samples(const float* samples,
+                                std::size_t num_samples) noexcept {
+  if (samples == nullptr || frequency_ <= 0.0) {
+    return;
+  }
+  for (std::size_t i = 0; i < num_samples; ++i) {
+    double y = samples[i];
+    for (Biquad& s : sections_) {
+      const double out = s.b0 * y + s.z1;
+      s.z1 = -s.a1 * out + s.z2;
+      s.z2 = s.b2 * y - s.a2 * out;
+      y = out;
+    }
+    smoothed_ += smoothing_ * (y * y - smoothed_);
+    block_sum_ += smoothed_;
+    if (++phase_ == decimation_) {
+      if (settling_ > 0) {
+        --settling_;
+      } else {
+        history_[write_index_] = static_cast<float>(block_sum_ / decimation_);
+        write_index_ = (write_index_ + 1) & history_mask_;
+        filled_ = std::min(filled_ + 1, window_length_);
+      }
+      block_sum_ = 0.0;
+      phase_ = 0;
+    }
+  }
+}
+
+BeatResult BeatDetector::detect() noexcept {
+  BeatResult result;
+  const std::size_t n = filled_;
+  if (frequency_ <= 0.0 ||
+      static_cast<double>(n) < kMinSeconds * envelope_rate_) {
+    return result;
+  }
+
+  // Linearize the newest envelope; level and modulation depth
+  const std::size_t start = (write_index_ - n) & history_mask_;
+  for (std::size_t i = 0; i < n; ++i) {
+    working_[i] = history_[(start + i) & history_mask_];
+  }
+  const dsp::BlockStats stats = dsp::block_stats(working_.data(), n);
+  const double mean = stats.sum / static_cast<double>(n);
+  if (std::sqrt(std::max(mean, 0.0)) < std::pow(10.0, threshold_db_ / 20.0)) {
+    return result;
+  }
+  const double variance =
+      std::max(stats.sum_squares / static_cast<double>(n) - mean * mean, 0.0);
+  result.depth = std::sqrt(variance) / mean;
+  if (result.depth < kMinDepth) {
+    // Steady partial: no beating
+    result.clarity = 1.0;
+    result.is_valid = true;
+    return result;
+  }
+  dsp::subtract(working_.data(), n, static_cast<float>(mean));
+
+  // NSDF up to the longest beat period (normalizer from prefix energies)
+  energy_[0] = 0.0;
+  for (std::size_t i = 0; i < n; ++i) {
+    energy_[i + 1] =
+        energy_[i] + static_cast<double>(working_[i]) * working_[i];
+  }
+  const int max_lag = std::min(
+      {lag_capacity_, static_cast<int>(n / 2),
+       static_cast<int>(std::ceil(envelope_rate_ / kMinBeatRate))});
+  const int min_lag =
+      std::max(2, static_cast<int>(envelope_rate_ / kMaxBeatRate));
+  if (max_lag <= min_lag) {
+    return result;
+  }
+  const float* x = working_.data();
+  for (int lag = 1; lag <= max_lag + 1; ++lag) {
+    const auto offset = static_cast<std::size_t>(lag);
+    const double r = dsp::dot_product(x, x + offset, n - offset);
+    const double m = energy_[n - offset] + (energy_[n] - energy_[offset]);
+    nsdf_[offset] = m > kEpsilon ? 2.0 * r / m : 0.0;
+  }
+
+  // Key maxima as in MPM: only peaks after the NSDF first goes negative
+  // (a slow beat keeps it near 1 over the shortest lags), then the first
+  // within kPeakRatio of the highest (the beat period, not a multiple).
+  // The lobe is sought from lag 1: a fast beat's lies below min_lag
+  const double* nsdf = nsdf_.data();
+  int first_lag = 1;
+  while (first_lag <= max_lag && nsdf[first_lag] >= 0.0) {
+    ++first_lag;
+  }
+  first_lag = std::max(first_lag, min_lag);
+  const auto is_peak = [nsdf](int lag) {
+    return nsdf[lag] > nsdf[lag - 1] && nsdf[lag] >= nsdf[lag + 1];
+  };
+  double highest = 0.0;
+  for (int lag = first_lag; lag <= max_lag; ++lag) {
+    if (is_peak(lag)) {
+      highest = std::max(highest, nsdf[lag]);
+    }
+  }
+  if (highest < kMinClarity) {
+    return result;
+  }
+  for (int lag = first_lag; lag <= max_lag; ++lag) {
+    if (is_peak(lag) && nsdf[lag] >= kPeakRatio * highest) {
+      const double period =
+          mpm::parabolic_interpolation(nsdf, max_lag + 2, lag);
+      result.rate = envelope_rate_ / period;
+      result.clarity = std::clamp(nsdf[lag], 0.0, 1.0);
+      result.is_valid = true;
+      break;
+    }
+  }
+  return result;
+}
+
+}  // namespace simple_tuner
@@ -0,0 +1,83 @@
+#include "simple_tuner/algorithms/DisplayTextCache.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace simple_tuner {
+
+namespace {
+constexpr std::string_view kPlaceholder = "--";
+constexpr std::string_view kHertzSuffix = " Hz";
+constexpr double kMaxFrequency = 1e9;  // Keeps the centihertz value in range
+constexpr long long kInvalidCentihertz = -1;
+
+// Writes value / 10^decimals in fixed point (digits only, no locale) plus
+// suffix, truncating to the capacity
+std::size_t format_fixed(char* out, std::size_t capacity, long long value,
+                         int decimals, std::string_view suffix) noexcept {
+  char digits[24];
+  int num_digits = 0;
+  const bool negative = value < 0;
+  unsigned long long magnitude =
+      negative ? 0ULL - static_cast<unsigned long long>(value)
+               : static_cast<unsigned long long>(value);
+  do {
+    digits[num_digits++] = static_cast<char>('0' + magnitude % 10);
+    magnitude /= 10;
+  } while (magnitude > 0 || num_digits <= decimals);
+
+  std::size_t length = 0;
+  auto put = [&](char c) {
+    if (length < capacity) {
+      out[length++] = c;
+    }
+  };
+  if (negative) {
+    put('-');
+  }
+  for (int i = num_digits - 1; i >= 0; --i) {
+    put(digits[i]);
+    if (i == decimals && decimals > 0) {
+      put('.');
+    }
+  }
+  for (char c : suffix) {
+    put(c);
+  }
+  return length;
+}
+}  // namespace
+
+DisplayTextCache::DisplayTextCache() noexcept {
+  for (ReferenceEntry& entry : reference_) {
+    entry.centihertz = kInvalidCentihertz;
+    entry.text.length = kPlaceholder.copy(entry.text.chars.data(),
+                                          kTextCapacity);
+  }
+}
+
+std::string_view DisplayTextCache::reference_text(
+    int midi_note, double frequency_hz) noexcept {
+  const bool in_range = midi_note >= TuningTable::kFirstKey &&
+                        midi_note <= TuningTable::kLastKey;
+  ReferenceEntry& entry =
+      reference_[static_cast<std::size_t>(
+          in_range ? midi_note - TuningTable::kFirstKey
+                   : TuningTable::kNumKeys)];
+
+  const long long centihertz =
+      frequency_hz >= 0.0
+          ? std::llround(std::min(frequency_hz, kMaxFrequency) * 100.0)
+          : kInvalidCentihertz;  // Negative or NaN
+  if (centihertz != entry.centihertz) {
+    entry.centihertz = centihertz;
+    entry.text.length =
+        centihertz == kInvalidCentihertz
+            ? kPlaceholder.copy(entry.text.chars.data(), kTextCapacity)
+            : format_fixed(entry.text.chars.data(), kTextCapacity,
+                           centihertz, 2, kHertzSuffix);
+  }
+  return std::string_view(entry.text.chars.data(), entry.text.length);
+}
+
+}  // namespace simple_tuner
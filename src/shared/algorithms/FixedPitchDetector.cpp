@@ -0,0 +1,205 @@
+#include "simple_tuner/algorithms/FixedPitchDetector.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "simple_tuner/algorithms/MpmPeakPicking.h"
+#include "simple_tuner/dsp/BlockOps.h"
+
+namespace simple_tuner {
+
+namespace {
+// Constants (shared defaults with PitchDetector)
+constexpr double kDefaultThresholdDb = -50.0;
+constexpr double kDefaultMinFrequency = 32.7;    // C1
+constexpr double kDefaultMaxFrequency = 4186.0;  // C8
+constexpr double kBaseClarity = 0.01;            // Base clarity threshold
+constexpr double kEpsilon = 1e-10;               // Numerical stability
+// Lags searched past the lowest period: with few cycles in the frame the
+// NSDF peak sits a little long, and must still test as a local maximum
+constexpr double kLagSlack = 1.03;  // ~Quarter tone
+constexpr double kPi = 3.14159265358979323846;
+
+// Taylor-series cosine for constant expressions (std::cos is not constexpr
+// in C++17). Accurate to double rounding on [0, 2*pi].
+constexpr double constexpr_cos(double x) {
+  // cos(x) = cos(2*pi - x) folds the argument into [0, pi]
+  if (x > kPi) {
+    x = 2.0 * kPi - x;
+  }
+  const double x2 = x * x;
+  double term = 1.0;
+  double sum = 1.0;
+  for (int n = 1; n <= 20; ++n) {
+    term *= -x2 / static_cast<double>((2 * n - 1) * (2 * n));
+    sum += term;
+  }
+  return sum;
+}
+
+template <std::size_t N>
+constexpr std::array<float, N> make_window(WindowType type) {
+  std::array<float, N> window{};
+  for (std::size_t i = 0; i < N; ++i) {
+    const double c = constexpr_cos(2.0 * kPi * static_cast<double>(i) /
+                                   static_cast<double>(N - 1));
+    double value = 1.0;
+    if (type == WindowType::kHann) {
+      value = 0.5 * (1.0 - c);
+    } else if (type == WindowType::kHamming) {
+      value = 0.54 - 0.46 * c;
+    }
+    window[i] = static_cast<float>(value);
+  }
+  return window;
+}
+
+template <std::size_t N>
+constexpr std::array<float, N> kHannWindow = make_window<N>(WindowType::kHann);
+
+template <std::size_t N>
+constexpr std::array<float, N> kHammingWindow =
+    make_window<N>(WindowType::kHamming);
+}  // namespace
+
+template <std::size_t N, int SampleRate>
+FixedPitchDetector<N, SampleRate>::FixedPitchDetector() noexcept
+    : threshold_db_(kDefaultThresholdDb),
+      threshold_linear_(std::pow(10.0, kDefaultThresholdDb / 20.0)),
+      min_freq_(kDefaultMinFrequency),
+      max_freq_(kDefaultMaxFrequency),
+      window_type_(WindowType::kRectangular),
+      base_clarity_threshold_(kBaseClarity),
+      min_lag_(1),
+      max_lag_(static_cast<int>(N) - 1),
+      working_{},
+      nsdf_{} {
+  set_min_frequency(kDefaultMinFrequency);
+  set_max_frequency(kDefaultMaxFrequency);
+}
+
+template <std::size_t N, int SampleRate>
+double FixedPitchDetector<N, SampleRate>::detect_pitch(
+    const float* samples, std::size_t num_samples) noexcept {
+  return detect_pitch_detailed(samples, num_samples).frequency;
+}
+
+template <std::size_t N, int SampleRate>
+DetectionResult FixedPitchDetector<N, SampleRate>::detect_pitch_detailed(
+    const float* samples, std::size_t num_samples) noexcept {
+  if (samples == nullptr || num_samples < N) {
+    return DetectionResult(0.0, 0.0, false);
+  }
+
+  // Level statistics, DC removal, windowing and the energy of the processed
+  // frame from one fused kernel
+  const float* window = nullptr;
+  if (window_type_ == WindowType::kHann) {
+    window = kHannWindow<N>.data();
+  } else if (window_type_ == WindowType::kHamming) {
+    window = kHammingWindow<N>.data();
+  }
+  double energy = 0.0;
+  const dsp::BlockStats stats =
+      dsp::preprocess_frame(samples, window, working_.data(), N, &energy);
+
+  const double rms = std::sqrt(stats.sum_squares / static_cast<double>(N));
+  if (rms < threshold_linear_) {
+    return DetectionResult(0.0, 0.0, false);
+  }
+
+  // Peak picking reads one lag below the search start
+  const int start_lag = std::max(min_lag_, 1);
+  compute_nsdf(start_lag - 1, energy);
+
+  const int peak_index = mpm::find_highest_clarity_peak(
+      nsdf_.data(), start_lag, max_lag_, kSampleRate, base_clarity_threshold_);
+  if (peak_index < 0) {
+    return DetectionResult(0.0, 0.0, false);
+  }
+
+  const double refined_period =
+      mpm::parabolic_interpolation(nsdf_.data(), max_lag_ + 1, peak_index);
+
+  return DetectionResult(kSampleRate / refined_period,
+                         static_cast<double>(nsdf_[peak_index]), true);
+}
+
+template <std::size_t N, int SampleRate>
+void FixedPitchDetector<N, SampleRate>::compute_nsdf(int first_lag,
+                                                     double energy) noexcept {
+  // Square sum m(tau) = sum_{i < N - tau} (x_i^2 + x_{i+tau}^2) is updated
+  // incrementally: m(0) = 2E, m(tau) = m(tau - 1) - x_{tau-1}^2 - x_{N-tau}^2
+  // so only the autocorrelation needs an O(N) pass per lag
+  const float* x = working_.data();
+  double m = 2.0 * energy;
+
+  for (int lag = 0; lag <= max_lag_; ++lag) {
+    if (lag > 0) {
+      const double head = x[lag - 1];
+      const double tail = x[N - static_cast<std::size_t>(lag)];
+      m -= head * head + tail * tail;
+    }
+    if (lag < first_lag) {
+      continue;
+    }
+
+    const std::size_t offset = static_cast<std::size_t>(lag);
+    const double r = dsp::dot_product(x, x + offset, N - offset);
+
+    // NSDF(tau) = 2 * r(tau) / m(tau)
+    nsdf_[offset] = m > kEpsilon ? static_cast<float>(2.0 * r / m) : 0.0f;
+  }
+}
+
+template <std::size_t N, int SampleRate>
+void FixedPitchDetector<N, SampleRate>::set_threshold_db(
+    double threshold_db) noexcept {
+  threshold_db_ = threshold_db;
+  threshold_linear_ = std::pow(10.0, threshold_db_ / 20.0);
+}
+
+template <std::size_t N, int SampleRate>
+void FixedPitchDetector<N, SampleRate>::set_min_frequency(
+    double min_freq) noexcept {
+  if (min_freq <= 0.0) {
+    return;
+  }
+  min_freq_ = min_freq;
+  const double lag =
+      std::min(kLagSlack * kSampleRate / min_freq_, static_cast<double>(N));
+  max_lag_ = std::min(static_cast<int>(lag) + 1, static_cast<int>(N) - 1);
+}
+
+template <std::size_t N, int SampleRate>
+void FixedPitchDetector<N, SampleRate>::set_max_frequency(
+    double max_freq) noexcept {
+  if (max_freq <= 0.0) {
+    return;
+  }
+  max_freq_ = max_freq;
+  const double lag = std::min(kSampleRate / max_freq_, static_cast<double>(N));
+  min_lag_ = std::max(static_cast<int>(lag), 1);
+}
+
+template <std::size_t N, int SampleRate>
+void FixedPitchDetector<N, SampleRate>::set_window_type(
+    WindowType type) noexcept {
+  window_type_ = type;
+}
+
+template <std::size_t N, int SampleRate>
+void FixedPitchDetector<N, SampleRate>::set_base_clarity_threshold(
+    double threshold) noexcept {
+  base_clarity_threshold_ = threshold;
+}
+
+// Controller tier sizes at the common device sample rates
+template class FixedPitchDetector<512, 44100>;
+template class FixedPitchDetector<1024, 44100>;
+template class FixedPitchDetector<4096, 44100>;
+template class FixedPitchDetector<512, 48000>;
+template class FixedPitchDetector<1024, 48000>;
+template class FixedPitchDetector<4096, 48000>;
+
+}  // namespace simple_tuner
@@ -1,47 +1,39 @@
 #include "simple_tuner/algorithms/FrequencyCalculator.h"
 
-#include <array>
-#include <cmath>
-
 namespace simple_tuner {
 
 namespace {
-constexpr int kMidiNoteA4 = 69;
 constexpr int kNotesPerOctave = 12;
 constexpr int kOctaveOffset = 1;
-constexpr double kCentsPerOctave = 1200.0;
-
-const std::array<const char*, 12> kNoteNames = {
-    "C", "C#", "D", "D#", "E", "F", "F#", "G", "G#", "A", "A#", "B"};
 }  // namespace
 
-FrequencyCalculator::FrequencyCalculator() : reference_a4_(440.0) {}
+FrequencyCalculator::FrequencyCalculator() : tuning_table_(440.0) {}
 
 FrequencyCalculator::FrequencyCalculator(double reference_a4_hz)
-    : reference_a4_(reference_a4_hz) {}
+    : tuning_table_(reference_a4_hz) {}
 
 double FrequencyCalculator::midi_to_frequency(int midi_note) const noexcept {
-  // f(n) = f_A4 * 2^((n - 69) / 12)
-  return reference_a4_ * std::pow(2.0, (midi_note - kMidiNoteA4) / 12.0);
+  return tuning_table_.target_frequency(midi_note);
 }
 
 int FrequencyCalculator::frequency_to_midi(double frequency) const noexcept {
-  // n = 69 + 12 * log2(f / f_A4)
-  return static_cast<int>(std::round(
-      kMidiNoteA4 + (kNotesPerOctave * std::log2(frequency / reference_a4_))));
+  if (!(frequency > 0.0)) {
+    return TuningTable::kFirstKey;
+  }
+  return tuning_table_.nearest_key(frequency);
 }
 
 double FrequencyCalculator::calculate_cents(double frequency,
                                             int target_midi) const noexcept {
-  double target_frequency = midi_to_frequency(target_midi);
   // cents = 1200 * log2(f_detected / f_target)
-  return kCentsPerOctave * std::log2(frequency / target_frequency);
+  return tuning_table_.cents_from_target(frequency, target_midi);
 }
 
-std::string FrequencyCalculator::midi_to_note_name(
-    int midi_note) const noexcept {
-  int note_index = midi_note % kNotesPerOctave;
-  return kNoteNames[note_index];
+void FrequencyCalculator::convert_batch(
+    const double* frequencies, std::size_t count,
+    const NoteResults& results) const noexcept {
+  tuning_table_.nearest_keys(frequencies, count, results.midi_note,
+                             results.cents);
 }
 
 int FrequencyCalculator::midi_to_octave(int midi_note) const noexcept {
@@ -50,11 +42,11 @@ int FrequencyCalculator::midi_to_octave(int midi_note) const noexcept {
 }
 
 void FrequencyCalculator::set_reference_a4(double frequency) noexcept {
-  reference_a4_ = frequency;
+  tuning_table_.set_reference_a4(frequency);
 }
 
 double FrequencyCalculator::get_reference_a4() const noexcept {
-  return reference_a4_;
+  return tuning_table_.get_reference_a4();
 }
 
 }  // namespace simple_tuner
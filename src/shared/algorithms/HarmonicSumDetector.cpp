@@ -0,0 +1,447 @@
+#include "simple_tuner/algorithms/HarmonicSumDetector.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "simple_tuner/dsp/BlockOps.h"
+
+namespace simple_tuner {
+
+namespace {
+constexpr double kPi = 3.14159265358979323846;
+constexpr double kTwoPi = 2.0 * kPi;
+constexpr double kDefaultThresholdDb = -60.0;
+constexpr double kDefaultMinFrequency = 27.5;    // A0
+constexpr double kDefaultMaxFrequency = 4186.0;  // C8
+constexpr double kDefaultConfidence = 0.3;
+constexpr double kMaxInharmonicity = 0.05;
+constexpr double kBandLimit = 0.45;  // Fraction of the sample rate
+constexpr double kPartialWeight = 0.84;  // Per partial number
+// Partials weaker than this fraction of the strongest (window sidelobes
+// among them) do not measure the frequency
+constexpr double kMinRelativeLevel = 0.1;
+// A candidate below the winner that explains this much of the winner's
+// level with partials the winner lacks is the one sounding
+constexpr double kSubharmonicEvidence = 0.2;
+// Half the candidate grid's spacing, as a frequency ratio minus one: how
+// far the nearest grid point's partials can sit from the true ones
+const double kGridTolerance =
+    std::exp2(1.0 / (24.0 * HarmonicSumDetector::kCandidatesPerSemitone)) -
+    1.0;
+
+std::size_t frame_length_for(std::size_t buffer_size) noexcept {
+  return std::max<std::size_t>(buffer_size & ~std::size_t{1}, 4);
+}
+
+// Bins below kBandLimit of the sample rate, in a transform of padded
+// points (at any sample rate)
+std::size_t band_for(std::size_t padded) noexcept {
+  const auto bins = static_cast<std::size_t>(
+      kBandLimit * static_cast<double>(padded)) + 1;
+  return std::min(bins, padded / 2);
+}
+
+// Bins either side of position searched for a partial there
+int search_radius(double position) noexcept {
+  return std::max(1, static_cast<int>(std::ceil(position * kGridTolerance)));
+}
+}  // namespace
+
+HarmonicSumDetector::HarmonicSumDetector(double sample_rate,
+                                         std::size_t buffer_size)
+    : HarmonicSumDetector(sample_rate, buffer_size, nullptr) {}
+
+HarmonicSumDetector::HarmonicSumDetector(double sample_rate,
+                                         std::size_t buffer_size,
+                                         BufferArena& arena)
+    : HarmonicSumDetector(sample_rate, buffer_size, &arena) {}
+
+HarmonicSumDetector::HarmonicSumDetector(double sample_rate,
+                                         std::size_t buffer_size,
+                                         BufferArena* arena)
+    : sample_rate_(sample_rate > 0.0 ? sample_rate : 48000.0),
+      buffer_size_(frame_length_for(buffer_size)),
+      threshold_db_(kDefaultThresholdDb),
+      min_freq_(kDefaultMinFrequency),
+      max_freq_(kDefaultMaxFrequency),
+      min_confidence_(kDefaultConfidence),
+      inharmonicity_(0.0),
+      bin_hz_(0.0),
+      band_(0),
+      partial_scale_(),
+      window_(buffer_size_, 0.0f, ArenaAllocator<float>(arena)),
+      frame_(buffer_size_, 0.0f, ArenaAllocator<float>(arena)),
+      packed_(dsp::Fft::next_power_of_two(buffer_size_),
+              std::complex<double>(),
+              ArenaAllocator<std::complex<double>>(arena)),
+      fft_(arena != nullptr ? dsp::Fft(packed_.size(), *arena)
+                            : dsp::Fft(packed_.size())),
+      rotation_(ArenaAllocator<std::complex<double>>(arena)),
+      magnitude_(ArenaAllocator<float>(arena)),
+      excess_(ArenaAllocator<float>(arena)),
+      scratch_(ArenaAllocator<float>(arena)) {
+  const std::size_t padded = spectrum_length();
+  bin_hz_ = sample_rate_ / static_cast<double>(padded);
+  band_ = band_for(padded);
+  set_inharmonicity(kDefaultInharmonicity);
+  rotation_.resize(band_);
+  magnitude_.resize(band_);
+  excess_.resize(band_);
+  scratch_.resize(band_);
+  for (std::size_t i = 0; i < buffer_size_; ++i) {
+    window_[i] = static_cast<float>(
+        0.5 * (1.0 - std::cos(kTwoPi * (static_cast<double>(i) + 0.5) /
+                              static_cast<double>(buffer_size_))));
+  }
+  for (std::size_t k = 0; k < band_; ++k) {
+    rotation_[k] = std::polar(1.0, -kTwoPi * static_cast<double>(k) /
+                                       static_cast<double>(padded));
+  }
+}
+
+std::size_t HarmonicSumDetector::arena_bytes(
+    std::size_t buffer_size) noexcept {
+  const std::size_t length = frame_length_for(buffer_size);
+  const std::size_t half = dsp::Fft::next_power_of_two(length);
+  const std::size_t band = band_for(2 * half);
+  return 2 * BufferArena::footprint<float>(length) +
+         BufferArena::footprint<std::complex<double>>(half) +
+         dsp::Fft::arena_bytes(half) +
+         BufferArena::footprint<std::complex<double>>(band) +
+         3 * BufferArena::footprint<float>(band);
+}
+
+void HarmonicSumDetector::set_inharmonicity(double inharmonicity) noexcept {
+  inharmonicity_ = std::clamp(inharmonicity, 0.0, kMaxInharmonicity);
+  for (int n = 1; n <= kMaxPartials; ++n) {
+    partial_scale_[static_cast<std::size_t>(n - 1)] =
+        n * std::sqrt((1.0 + inharmonicity_ * n * n) /
+                      (1.0 + inharmonicity_)) /
+        bin_hz_;
+  }
+}
+
+void HarmonicSumDetector::compute_spectrum() noexcept {
+  // The zero-padded real frame x as a half-length complex sequence
+  // z[m] = x[2m] + j x[2m + 1]; with Z its transform, the even and odd
+  // halves of X are (Z[k] + conj Z[-k]) / 2 and (Z[k] - conj Z[-k]) / 2j
+  const std::size_t half = packed_.size();
+  const std::size_t pairs = buffer_size_ / 2;
+  for (std::size_t m = 0; m < pairs; ++m) {
+    packed_[m] = std::complex<double>(frame_[2 * m], frame_[2 * m + 1]);
+  }
+  std::fill(packed_.begin() + static_cast<std::ptrdiff_t>(pairs),
+            packed_.end(), std::complex<double>());
+  fft_.forward(packed_.data());
+
+  // Hann's mean is 1/2: a sinusoid of amplitude A peaks at A N / 4
+  const double gain = 4.0 / static_cast<double>(buffer_size_);
+  // (Written out: std::complex's product and abs check for NaN and
+  // overflow, at several times the cost)
+  for (std::size_t k = 0; k < band_; ++k) {
+    const std::complex<double> z = packed_[k];
+    const std::complex<double> mirror = packed_[(half - k) % half];
+    const double even_re = 0.5 * (z.real() + mirror.real());
+    const double even_im = 0.5 * (z.imag() - mirror.imag());
+    const double odd_re = 0.5 * (z.imag() + mirror.imag());
+    const double odd_im = -0.5 * (z.real() - mirror.real());
+    const double w_re = rotation_[k].real();
+    const double w_im = rotation_[k].imag();
+    const double re = even_re + w_re * odd_re - w_im * odd_im;
+    const double im = even_im + w_re * odd_im + w_im * odd_re;
+    magnitude_[k] = static_cast<float>(gain * std::sqrt(re * re + im * im));
+  }
+
+  // Levels above the median, which stands in for the noise floor
+  std::copy(magnitude_.begin(), magnitude_.end(), scratch_.begin());
+  const auto middle = scratch_.begin() + static_cast<std::ptrdiff_t>(
+                                             scratch_.size() / 2);
+  std::nth_element(scratch_.begin(), middle, scratch_.end());
+  const float floor = scratch_.empty() ? 0.0f : *middle;
+  // Only at the peaks: the main lobe (four bins either side) would let
+  // one partial answer for several of a low candidate's
+  std::fill(excess_.begin(), excess_.end(), 0.0f);
+  for (std::size_t k = 1; k + 1 < band_; ++k) {
+    const float value = magnitude_[k];
+    if (value > floor && value > magnitude_[k - 1] &&
+        value >= magnitude_[k + 1]) {
+      excess_[k] = value - floor;
+    }
+  }
+}
+
+double HarmonicSumDetector::partial_bin(double f0, int n) const noexcept {
+  return f0 * partial_scale_[static_cast<std::size_t>(n - 1)];
+}
+
+std::ptrdiff_t HarmonicSumDetector::partial_peak(
+    double position) const noexcept {
+  const auto centre = static_cast<std::ptrdiff_t>(std::lround(position));
+  const auto band = static_cast<std::ptrdiff_t>(band_);
+  const std::ptrdiff_t radius = search_radius(position);
+  std::ptrdiff_t peak = -1;
+  float level = 0.0f;
+  for (std::ptrdiff_t b = std::max<std::ptrdiff_t>(centre - radius, 1);
+       b <= std::min(centre + radius, band - 2); ++b) {
+    if (excess_[static_cast<std::size_t>(b)] > level) {
+      level = excess_[static_cast<std::size_t>(b)];
+      peak = b;
+    }
+  }
+  return peak;
+}
+
+double HarmonicSumDetector::score(double f0) const noexcept {
+  double sum = 0.0;
+  double weight = 1.0;
+  std::ptrdiff_t previous = -1;
+  for (int n = 1; n <= kMaxPartials; ++n) {
+    const double position = partial_bin(f0, n);
+    if (position >= static_cast<double>(band_)) {
+      break;
+    }
+    // A peak counts once: low candidates' partials are closer together
+    // than the search radius allows for
+    const std::ptrdiff_t peak = partial_peak(position);
+    if (peak >= 0 && peak != previous) {
+      sum += weight * excess_[static_cast<std::size_t>(peak)];
+      previous = peak;
+    }
+    weight *= kPartialWeight;
+  }
+  return sum;
+}
+
+double HarmonicSumDetector::unexplained_level(
+    double f0, int ratio, const std::ptrdiff_t* winner_peaks,
+    int num_winner_peaks) const noexcept {
+  double sum = 0.0;
+  int count = 0;
+  // Partial 1 is left out: it is the one most often missing
+  for (int n = 2; n <= kMaxPartials; ++n) {
+    const double position = partial_bin(f0, n);
+    if (position >= static_cast<double>(band_)) {
+      break;
+    }
+    if (n % ratio == 0) {
+      continue;
+    }
+    ++count;
+    // A stretched series can land on the winner's own partials
+    const std::ptrdiff_t peak = partial_peak(position);
+    if (peak >= 0 && std::find(winner_peaks, winner_peaks + num_winner_peaks,
+                               peak) == winner_peaks + num_winner_peaks) {
+      sum += excess_[static_cast<std::size_t>(peak)];
+    }
+  }
+  return count > 0 ? sum / count : -1.0;
+}
+
+DetectionResult HarmonicSumDetector::detect_pitch_detailed(
+    const float* samples, std::size_t num_samples) noexcept {
+  if (samples == nullptr || num_samples < buffer_size_ ||
+      max_freq_ <= min_freq_) {
+    return DetectionResult(0.0, 0.0, false);
+  }
+
+  const dsp::BlockStats stats = dsp::preprocess_frame(
+      samples, window_.data(), frame_.data(), buffer_size_);
+  const double length = static_cast<double>(buffer_size_);
+  const double mean = stats.sum / length;
+  const double mean_square =
+      std::max(stats.sum_squares / length - mean * mean, 0.0);
+  if (std::sqrt(mean_square) < std::pow(10.0, threshold_db_ / 20.0)) {
+    return DetectionResult(0.0, 0.0, false);
+  }
+  compute_spectrum();
+
+  // Subharmonic summation over the candidate grid
+  const double step = std::exp2(1.0 / (12.0 * kCandidatesPerSemitone));
+  double best = 0.0;
+  double best_score = 0.0;
+  for (double f0 = min_freq_; f0 <= max_freq_; f0 *= step) {
+    const double value = score(f0);
+    if (value > best_score) {
+      best_score = value;
+      best = f0;
+    }
+  }
+  if (best <= 0.0) {
+    return DetectionResult(0.0, 0.0, false);
+  }
+
+  // Missing fundamentals: prefer the lowest candidate below whose extra
+  // partials are clearly there (double octave, twelfth, octave)
+  std::ptrdiff_t winner_peaks[kMaxPartials];
+  int num_winner_peaks = 0;
+  double reference = 0.0;
+  int counted = 0;
+  for (int n = 1; n <= kMaxPartials; ++n) {
+    const double position = partial_bin(best, n);
+    if (position >= static_cast<double>(band_)) {
+      break;
+    }
+    const std::ptrdiff_t peak = partial_peak(position);
+    if (peak >= 0) {
+      winner_peaks[num_winner_peaks++] = peak;
+    }
+    if (n <= 4) {
+      reference += peak >= 0 ? excess_[static_cast<std::size_t>(peak)] : 0.0f;
+      ++counted;
+    }
+  }
+  reference /= std::max(counted, 1);
+  static constexpr int kRatios[] = {4, 3, 2};
+  for (int ratio : kRatios) {
+    const double below = best / ratio;
+    if (below >= min_freq_ && reference > 0.0 &&
+        unexplained_level(below, ratio, winner_peaks, num_winner_peaks) >=
+            kSubharmonicEvidence * reference) {
+      best = below;
+      break;
+    }
+  }
+
+  // The winner's partials: log-parabolic peak frequencies, and their
+  // energy against all the peaks' up to the last partial for the
+  // confidence
+  const auto at = [this](std::ptrdiff_t b) {
+    return std::log(std::max(
+        static_cast<double>(magnitude_[static_cast<std::size_t>(b)]),
+        1e-20));
+  };
+  int numbers[kMaxPartials];
+  double frequencies[kMaxPartials];
+  double levels[kMaxPartials];
+  int measured = 0;
+  double explained = 0.0;
+  std::ptrdiff_t last_bin = 0;
+  std::ptrdiff_t previous = -1;
+  for (int n = 1; n <= kMaxPartials; ++n) {
+    const double position = partial_bin(best, n);
+    if (position >= static_cast<double>(band_)) {
+      break;
+    }
+    last_bin = std::min(static_cast<std::ptrdiff_t>(std::lround(position)) +
+                            search_radius(position),
+                        static_cast<std::ptrdiff_t>(band_) - 1);
+    const std::ptrdiff_t peak = partial_peak(position);
+    if (peak < 0 || peak == previous) {
+      continue;
+    }
+    previous = peak;
+    const double left = at(peak - 1);
+    const double middle = at(peak);
+    const double right = at(peak + 1);
+    const double curvature = left - 2.0 * middle + right;
+    const double offset =
+        curvature < 0.0
+            ? std::clamp(0.5 * (left - right) / curvature, -0.5, 0.5)
+            : 0.0;
+    const double level = excess_[static_cast<std::size_t>(peak)];
+    numbers[measured] = n;
+    frequencies[measured] = (static_cast<double>(peak) + offset) * bin_hz_;
+    levels[measured] = level;
+    ++measured;
+    explained += level * level;
+  }
+  if (measured == 0) {
+    return DetectionResult(0.0, 0.0, false);
+  }
+  const double strongest = *std::max_element(levels, levels + measured);
+  int kept = 0;
+  for (int m = 0; m < measured; ++m) {
+    if (levels[m] >= kMinRelativeLevel * strongest) {
+      numbers[kept] = numbers[m];
+      frequencies[kept] = frequencies[m];
+      levels[kept] = levels[m];
+      ++kept;
+    }
+  }
+  measured = kept;
+
+  // The partials' own stretch: (f_n / n)^2 = f0^2 + f0^2 B n^2 is a line
+  // in n^2, fitted by level. With fewer than three partials the assumed
+  // inharmonicity stands.
+  double inharmonicity = inharmonicity_;
+  if (measured >= 3) {
+    double w_sum = 0.0;
+    double x_mean = 0.0;
+    double y_mean = 0.0;
+    for (int m = 0; m < measured; ++m) {
+      const double n = numbers[m];
+      const double ratio = frequencies[m] / n;
+      w_sum += levels[m];
+      x_mean += levels[m] * n * n;
+      y_mean += levels[m] * ratio * ratio;
+    }
+    x_mean /= w_sum;
+    y_mean /= w_sum;
+    double sxy = 0.0;
+    double sxx = 0.0;
+    for (int m = 0; m < measured; ++m) {
+      const double n = numbers[m];
+      const double ratio = frequencies[m] / n;
+      const double dx = n * n - x_mean;
+      sxy += levels[m] * dx * (ratio * ratio - y_mean);
+      sxx += levels[m] * dx * dx;
+    }
+    if (sxx > 0.0) {
+      const double slope = sxy / sxx;
+      const double intercept = y_mean - slope * x_mean;
+      if (intercept > 0.0) {
+        inharmonicity =
+            std::clamp(slope / intercept, 0.0, kMaxInharmonicity);
+      }
+    }
+  }
+
+  // Each partial's implied fundamental; the ones measured best (strong,
+  // and high, where a bin is a smaller fraction of f0) count most
+  double weighted = 0.0;
+  double weights = 0.0;
+  for (int m = 0; m < measured; ++m) {
+    const double n = numbers[m];
+    const double stretch = std::sqrt((1.0 + inharmonicity * n * n) /
+                                     (1.0 + inharmonicity));
+    weighted += levels[m] * n * frequencies[m] / (n * stretch);
+    weights += levels[m] * n;
+  }
+
+  double peaks = 0.0;
+  for (std::ptrdiff_t b = 1; b <= last_bin; ++b) {
+    const double value = excess_[static_cast<std::size_t>(b)];
+    peaks += value * value;
+  }
+  const double confidence =
+      peaks > 0.0 ? std::min(explained / peaks, 1.0) : 0.0;
+  return DetectionResult(weighted / weights, confidence,
+                         confidence >= min_confidence_);
+}
+
+void HarmonicSumDetector::set_threshold_db(double threshold_db) noexcept {
+  threshold_db_ = threshold_db;
+}
+
+void HarmonicSumDetector::set_min_frequency(double min_freq) noexcept {
+  if (min_freq > 0.0) {
+    min_freq_ = min_freq;
+  }
+}
+
+void HarmonicSumDetector::set_max_frequency(double max_freq) noexcept {
+  if (max_freq > 0.0) {
+    max_freq_ = max_freq;
+  }
+}
+
+void HarmonicSumDetector::set_window_type(WindowType type) noexcept {
+  (void)type;
+}
+
+void HarmonicSumDetector::set_base_clarity_threshold(
+    double threshold) noexcept {
+  min_confidence_ = threshold;
+}
+
+}  // namespace simple_tuner
@@ -0,0 +1,197 @@
+#include "simple_tuner/algorithms/InharmonicityAnalyzer.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace simple_tuner {
+
+namespace {
+// Worker wake-up interval while capturing (the ring holds ~340 ms at 48 kHz)
+constexpr std::chrono::milliseconds kCapturePoll(5);
+
+std::size_t capture_length_for(double sample_rate, double seconds) noexcept {
+  if (!(sample_rate > 0.0)) {
+    sample_rate = 48000.0;
+  }
+  if (!(seconds > 0.0)) {
+    seconds = InharmonicityAnalyzer::kDefaultCaptureSeconds;
+  }
+  return std::max<std::size_t>(
+      static_cast<std::size_t>(std::lround(sample_rate * seconds)), 1024);
+}
+}  // namespace
+
+InharmonicityAnalyzer::InharmonicityAnalyzer(double sample_rate,
+                                             double capture_seconds)
+    : capture_length_(capture_length_for(sample_rate, capture_seconds)),
+      estimator_(sample_rate, capture_length_),
+      samples_(capture_length_, 0.0f),
+      capturing_(false),
+      overrun_(false),
+      pending_(false),
+      stop_(false),
+      num_partials_(estimator_.get_num_partials()),
+      results_(),
+      has_result_(),
+      worker_(&InharmonicityAnalyzer::run, this) {}
+
+InharmonicityAnalyzer::~InharmonicityAnalyzer() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  wake_.notify_all();
+  worker_.join();
+}
+
+void InharmonicityAnalyzer::push_audio(const float* samples,
+                                       std::size_t num_samples) noexcept {
+  if (samples == nullptr || !capturing_.load(std::memory_order_acquire)) {
+    return;
+  }
+  if (queue_.push(samples, num_samples) < num_samples) {
+    overrun_.store(true, std::memory_order_release);
+  }
+}
+
+bool InharmonicityAnalyzer::request_capture(int midi_note,
+                                            double expected_frequency) {
+  Request request;
+  request.midi_note = midi_note;
+  request.expected_frequency = expected_frequency;
+  request.capture = true;
+  return submit(request, nullptr);
+}
+
+bool InharmonicityAnalyzer::request_analysis(int midi_note,
+                                             double expected_frequency,
+                                             const float* samples,
+                                             std::size_t num_samples) {
+  if (samples == nullptr || num_samples == 0) {
+    return false;
+  }
+  Request request;
+  request.midi_note = midi_note;
+  request.expected_frequency = expected_frequency;
+  request.length = std::min(num_samples, capture_length_);
+  return submit(request, samples);
+}
+
+bool InharmonicityAnalyzer::submit(const Request& request,
+                                   const float* samples) {
+  if (!is_piano_key(request.midi_note) ||
+      !(request.expected_frequency > 0.0)) {
+    return false;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (pending_ || stop_) {
+      return false;
+    }
+    // The worker is idle, so samples_ is free
+    if (samples != nullptr) {
+      std::copy(samples, samples + request.length, samples_.begin());
+    }
+    request_ = request;
+    pending_ = true;
+  }
+  wake_.notify_one();
+  return true;
+}
+
+bool InharmonicityAnalyzer::is_busy() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return pending_;
+}
+
+bool InharmonicityAnalyzer::wait_until_idle(
+    std::chrono::milliseconds timeout) const {
+  std::unique_lock<std::mutex> lock(mutex_);
+  return idle_.wait_for(lock, timeout, [this]() { return !pending_; });
+}
+
+bool InharmonicityAnalyzer::get_result(int midi_note,
+                                       InharmonicityResult& result) const {
+  if (!is_piano_key(midi_note)) {
+    return false;
+  }
+  const auto index =
+      static_cast<std::size_t>(midi_note - TuningTable::kFirstKey);
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!has_result_[index]) {
+    return false;
+  }
+  result = results_[index];
+  return true;
+}
+
+void InharmonicityAnalyzer::set_num_partials(int num_partials) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  num_partials_ = num_partials;
+}
+
+void InharmonicityAnalyzer::run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    wake_.wait(lock, [this]() { return stop_ || pending_; });
+    if (stop_) {
+      return;
+    }
+    const Request request = request_;
+    estimator_.set_num_partials(num_partials_);
+    lock.unlock();
+
+    bool complete = true;
+    std::size_t length = request.length;
+    if (request.capture) {
+      complete = capture_audio();
+      length = capture_length_;
+    }
+    InharmonicityResult result;
+    if (complete) {
+      result = estimator_.estimate(samples_.data(), length,
+                                   request.expected_frequency);
+    }
+
+    lock.lock();
+    if (complete) {
+      const auto index = static_cast<std::size_t>(request.midi_note -
+                                                  TuningTable::kFirstKey);
+      results_[index] = result;
+      has_result_[index] = true;
+    }
+    pending_ = false;
+    idle_.notify_all();
+  }
+}
+
+bool InharmonicityAnalyzer::capture_audio() {
+  // Drop whatever an earlier capture's last callback left in the ring
+  const auto drain = [this]() {
+    float stale[256];
+    while (queue_.pop(stale, 256) > 0) {
+    }
+  };
+  drain();
+  overrun_.store(false, std::memory_order_relaxed);
+  capturing_.store(true, std::memory_order_release);
+
+  std::size_t filled = 0;
+  bool stopped = false;
+  while (filled < capture_length_ && !stopped) {
+    if (overrun_.exchange(false, std::memory_order_acq_rel)) {
+      // A gap in the audio: discard everything before it and start over
+      drain();
+      filled = 0;
+    }
+    filled += queue_.pop(samples_.data() + filled, capture_length_ - filled);
+    if (filled < capture_length_) {
+      std::unique_lock<std::mutex> lock(mutex_);
+      stopped = wake_.wait_for(lock, kCapturePoll, [this]() { return stop_; });
+    }
+  }
+  capturing_.store(false, std::memory_order_release);
+  return !stopped;
+}
+
+}  // namespace simple_tuner
@@ -0,0 +1,222 @@
+#include "simple_tuner/algorithms/InharmonicityEstimator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace simple_tuner {
+
+namespace {
+constexpr double kPi = 3.14159265358979323846;
+constexpr double kTwoPi = 2.0 * kPi;
+constexpr double kBandLimit = 0.45;  // Fraction of the sample rate
+constexpr double kZoomFactor = 8.0;  // Zoom points per FFT bin
+// FFT bins zoomed beyond each side of a band for its noise floor
+constexpr double kNoiseMarginBins = 6.0;
+constexpr int kDefaultPartials = 8;
+
+double cents_ratio(double cents) noexcept { return std::exp2(cents / 1200.0); }
+
+// Upper stretch of partial n relative to n x partial 1 at the largest B
+double max_stretch(int n) noexcept {
+  constexpr double kB = InharmonicityEstimator::kMaxInharmonicity;
+  return std::sqrt((1.0 + kB * n * n) / (1.0 + kB));
+}
+
+// Weighted least squares of (f_n / n)^2 = f0^2 + f0^2 B n^2 over the located
+// partials; false if fewer than two or the fit is degenerate
+bool fit_string(const std::array<double, InharmonicityResult::kMaxPartials>&
+                    partials,
+                int count, double& fundamental, double& inharmonicity) {
+  double sw = 0.0;
+  double sx = 0.0;
+  double sy = 0.0;
+  double sxx = 0.0;
+  double sxy = 0.0;
+  int used = 0;
+  for (int i = 0; i < count; ++i) {
+    const double f = partials[static_cast<std::size_t>(i)];
+    if (f <= 0.0) {
+      continue;
+    }
+    const double n = i + 1.0;
+    const double x = n * n;
+    const double y = (f / n) * (f / n);
+    // A frequency error e moves y by 2 f e / n^2
+    const double w = (x / f) * (x / f);
+    sw += w;
+    sx += w * x;
+    sy += w * y;
+    sxx += w * x * x;
+    sxy += w * x * y;
+    ++used;
+  }
+  const double det = sw * sxx - sx * sx;
+  if (used < 2 || det <= 0.0) {
+    return false;
+  }
+  const double slope = (sw * sxy - sx * sy) / det;
+  const double intercept = (sy - slope * sx) / sw;
+  if (intercept <= 0.0) {
+    return false;
+  }
+  fundamental = std::sqrt(intercept);
+  inharmonicity = std::clamp(slope / intercept, 0.0,
+                             InharmonicityEstimator::kMaxInharmonicity);
+  return true;
+}
+}  // namespace
+
+InharmonicityEstimator::InharmonicityEstimator(double sample_rate,
+                                               std::size_t max_samples)
+    : sample_rate_(sample_rate > 0.0 ? sample_rate : 48000.0),
+      max_samples_(std::max<std::size_t>(max_samples, 16)),
+      num_partials_(kDefaultPartials),
+      spacing_hz_(sample_rate_ /
+                  (kZoomFactor * static_cast<double>(max_samples_))),
+      windowed_(max_samples_, 0.0f),
+      // The widest band is partial 2 searched from partial 1 alone, at the
+      // band limit
+      zoom_(max_samples_,
+            static_cast<std::size_t>(std::ceil(
+                kBandLimit * sample_rate_ *
+                (1.0 - cents_ratio(-2.0 * kTrackCents) / max_stretch(2)) /
+                spacing_hz_ +
+                2.0 * kNoiseMarginBins * kZoomFactor)) +
+                3,
+            kTwoPi * spacing_hz_ / sample_rate_),
+      spectrum_(zoom_.max_points()),
+      power_(zoom_.max_points()),
+      sorted_(zoom_.max_points()) {}
+
+void InharmonicityEstimator::set_num_partials(int num_partials) noexcept {
+  num_partials_ = std::clamp(num_partials, kMinPartials, kMaxPartials);
+}
+
+InharmonicityResult InharmonicityEstimator::estimate(
+    const float* samples, std::size_t num_samples,
+    double expected_frequency) noexcept {
+  InharmonicityResult result;
+  const std::size_t length = std::min(num_samples, max_samples_);
+  if (samples == nullptr || length < 16 || !(expected_frequency > 0.0)) {
+    return result;
+  }
+
+  // Mean-removed, Hann-windowed block; the zoom zero-pads it
+  double mean = 0.0;
+  for (std::size_t i = 0; i < length; ++i) {
+    mean += samples[i];
+  }
+  mean /= static_cast<double>(length);
+  for (std::size_t i = 0; i < length; ++i) {
+    const double window =
+        0.5 * (1.0 - std::cos(kTwoPi * static_cast<double>(i) /
+                              static_cast<double>(length)));
+    windowed_[i] = static_cast<float>((samples[i] - mean) * window);
+  }
+  std::fill(windowed_.begin() + static_cast<std::ptrdiff_t>(length),
+            windowed_.end(), 0.0f);
+
+  const double band_limit = kBandLimit * sample_rate_;
+  const double track = cents_ratio(kTrackCents);
+  double fundamental = 0.0;
+  double inharmonicity = 0.0;
+  int located = 0;
+  double first = 0.0;  // Partial 1, or the first located partial / n
+  for (int i = 0; i < num_partials_; ++i) {
+    const int n = i + 1;
+    double low;
+    double high;
+    if (located == 0) {
+      // Nothing known yet: the nominal note, mistuned by up to kSearchCents,
+      // stretched by up to the largest B
+      const double nominal = n * expected_frequency;
+      low = nominal / cents_ratio(kSearchCents);
+      high = nominal * cents_ratio(kSearchCents) * max_stretch(n);
+    } else if (located == 1) {
+      // One partial: harmonic up to the largest stretch from it
+      const double nominal = n * first;
+      low = nominal / track;
+      high = nominal * max_stretch(n) * track;
+    } else {
+      const double predicted =
+          n * fundamental * std::sqrt(1.0 + inharmonicity * n * n);
+      low = predicted / track;
+      high = predicted * track;
+    }
+    if (low >= band_limit) {
+      break;
+    }
+    const double frequency = locate_partial(low, std::min(high, band_limit));
+    if (frequency <= 0.0) {
+      continue;
+    }
+    result.partials[static_cast<std::size_t>(i)] = frequency;
+    if (++located == 1) {
+      first = frequency / n;
+    } else {
+      fit_string(result.partials, n, fundamental, inharmonicity);
+    }
+  }
+
+  result.num_partials = located;
+  if (located >= kMinPartials &&
+      fit_string(result.partials, num_partials_, fundamental,
+                 inharmonicity)) {
+    result.fundamental = fundamental;
+    result.inharmonicity = inharmonicity;
+    result.is_valid = true;
+  }
+  return result;
+}
+
+double InharmonicityEstimator::locate_partial(double low,
+                                              double high) noexcept {
+  // The zoom spans the band plus kNoiseMarginBins on each side, so the
+  // median below sees more than the peak's main lobe
+  const double margin = kNoiseMarginBins * kZoomFactor * spacing_hz_;
+  const double start = std::max(low - margin, spacing_hz_);
+  const auto first = static_cast<std::size_t>((low - start) / spacing_hz_);
+  const std::size_t points = std::min(
+      static_cast<std::size_t>((high + margin - start) / spacing_hz_) + 1,
+      zoom_.max_points());
+  const std::size_t last = std::min(
+      static_cast<std::size_t>((high - start) / spacing_hz_), points - 2);
+  if (first < 1 || last <= first) {
+    return 0.0;
+  }
+  zoom_.transform(windowed_.data(), kTwoPi * start / sample_rate_, points,
+                  spectrum_.data());
+  for (std::size_t k = 0; k < points; ++k) {
+    power_[k] = std::norm(spectrum_[k]);
+  }
+  std::size_t peak = first;
+  for (std::size_t k = first; k <= last; ++k) {
+    if (power_[k] > power_[peak]) {
+      peak = k;
+    }
+  }
+  if (power_[peak - 1] > power_[peak] || power_[peak + 1] > power_[peak]) {
+    return 0.0;  // Rising into the band edge: not this partial's peak
+  }
+
+  const auto count = static_cast<std::ptrdiff_t>(points);
+  std::copy(power_.begin(), power_.begin() + count, sorted_.begin());
+  const auto middle = sorted_.begin() + count / 2;
+  std::nth_element(sorted_.begin(), middle, sorted_.begin() + count);
+  if (!(power_[peak] > kMinPeakRatio * *middle)) {
+    return 0.0;
+  }
+
+  // Log-parabolic interpolation (exact for a Gaussian; the Hann main lobe
+  // is close to one over the +-1/8 bin used)
+  const double left = std::log(std::max(power_[peak - 1], 1e-300));
+  const double center = std::log(std::max(power_[peak], 1e-300));
+  const double right = std::log(std::max(power_[peak + 1], 1e-300));
+  const double curvature = left - 2.0 * center + right;
+  const double offset =
+      curvature < 0.0 ? std::clamp(0.5 * (left - right) / curvature, -0.5, 0.5)
+                      : 0.0;
+  return start + (static_cast<double>(peak) + offset) * spacing_hz_;
+}
+
+}  // namespace simple_tuner
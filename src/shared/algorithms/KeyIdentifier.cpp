@@ -0,0 +1,306 @@
+#include "simple_tuner/algorithms/KeyIdentifier.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "simple_tuner/algorithms/TuningTable.h"
+
+namespace simple_tuner {
+
+namespace {
+constexpr double kPi = 3.14159265358979323846;
+constexpr int kBinsPerOctave = 12 * KeyIdentifier::kBinsPerSemitone;
+constexpr int kNumBins =
+    TuningTable::kNumKeys * KeyIdentifier::kBinsPerSemitone;
+// Low-pass cutoff as a fraction of the decimated rate, and taps per unit
+// of decimation (Blackman window: ~5.5 / taps transition)
+constexpr double kCutoff = 0.3125;
+constexpr int kTapsPerFactor = 32;
+constexpr double kPartialWeight = 0.84;  // Per partial number
+// A key below the winner that explains this much of the winner's level
+// with partials the winner lacks is the one sounding
+constexpr double kSubharmonicEvidence = 0.2;
+
+int decimation_for(double sample_rate) noexcept {
+  if (!(sample_rate > 0.0)) {
+    return 1;
+  }
+  return std::max(1, static_cast<int>(sample_rate /
+                                      KeyIdentifier::kAnalysisRate));
+}
+
+double lowest_bin_frequency(double reference_a4) noexcept {
+  if (!(reference_a4 > 0.0)) {
+    reference_a4 = 440.0;
+  }
+  // One bin below A0
+  return reference_a4 *
+         std::exp2((TuningTable::kFirstKey - 69) / 12.0 -
+                   1.0 / static_cast<double>(kBinsPerOctave));
+}
+
+std::vector<float> low_pass(int decimation) {
+  if (decimation <= 1) {
+    return std::vector<float>();
+  }
+  const int count = kTapsPerFactor * decimation + 1;
+  const double cutoff = kCutoff / static_cast<double>(decimation);
+  std::vector<float> taps(static_cast<std::size_t>(count));
+  double sum = 0.0;
+  for (int i = 0; i < count; ++i) {
+    const double n = i - 0.5 * (count - 1);
+    const double sinc =
+        n == 0.0 ? 2.0 * cutoff
+                 : std::sin(2.0 * kPi * cutoff * n) / (kPi * n);
+    const double phase = 2.0 * kPi * i / (count - 1);
+    const double window =
+        0.42 - 0.5 * std::cos(phase) + 0.08 * std::cos(2.0 * phase);
+    taps[static_cast<std::size_t>(i)] = static_cast<float>(sinc * window);
+    sum += sinc * window;
+  }
+  for (float& tap : taps) {
+    tap = static_cast<float>(tap / sum);
+  }
+  return taps;
+}
+
+double to_db(double amplitude) noexcept {
+  return amplitude > 0.0
+             ? std::max(20.0 * std::log10(amplitude), KeyEstimate::kFloorDb)
+             : KeyEstimate::kFloorDb;
+}
+}  // namespace
+
+KeyIdentifier::KeyIdentifier(double sample_rate, double reference_a4)
+    : decimation_(decimation_for(sample_rate)),
+      cqt_((sample_rate > 0.0 ? sample_rate : 48000.0) / decimation_,
+           lowest_bin_frequency(reference_a4), kNumBins, kBinsPerOctave,
+           kWindowScale),
+      taps_(low_pass(decimation_)),
+      frame_length_((cqt_.frame_length() - 1) *
+                        static_cast<std::size_t>(decimation_) +
+                    std::max<std::size_t>(taps_.size(), 1)),
+      threshold_db_(kDefaultThresholdDb),
+      partial_offset_(),
+      input_(frame_length_, 0.0f),
+      decimated_(cqt_.frame_length(), 0.0f),
+      magnitudes_(static_cast<std::size_t>(cqt_.num_bins()), 0.0f),
+      excess_(magnitudes_.size(), 0.0f),
+      scratch_(magnitudes_.size(), 0.0f) {
+  for (int h = 0; h < KeyEstimate::kMaxPartials; ++h) {
+    partial_offset_[static_cast<std::size_t>(h)] = static_cast<int>(
+        std::lround(kBinsPerOctave * std::log2(static_cast<double>(h + 1))));
+  }
+}
+
+void KeyIdentifier::set_threshold_db(double threshold_db) noexcept {
+  threshold_db_ = threshold_db;
+}
+
+int KeyIdentifier::bin_of_key(int midi_note) noexcept {
+  return kBinsPerSemitone * (midi_note - TuningTable::kFirstKey) + 1;
+}
+
+KeyEstimate KeyIdentifier::identify(const float* samples,
+                                    std::size_t num_samples) {
+  KeyEstimate estimate;
+  if (samples == nullptr) {
+    num_samples = 0;
+  }
+  decimate(samples, num_samples);
+  cqt_.magnitudes(decimated_.data(), magnitudes_.data());
+
+  // Levels above the median, which stands in for the noise floor
+  std::copy(magnitudes_.begin(), magnitudes_.end(), scratch_.begin());
+  const auto middle = scratch_.begin() + scratch_.size() / 2;
+  std::nth_element(scratch_.begin(), middle, scratch_.end());
+  const float floor = scratch_.empty() ? 0.0f : *middle;
+  for (std::size_t i = 0; i < magnitudes_.size(); ++i) {
+    excess_[i] = std::max(magnitudes_[i] - floor, 0.0f);
+  }
+
+  int best = -1;
+  double best_score = 0.0;
+  for (int key = 0; key < TuningTable::kNumKeys; ++key) {
+    const double value = score(key);
+    if (value > best_score) {
+      best_score = value;
+      best = key;
+    }
+  }
+  if (best < 0) {
+    return estimate;
+  }
+
+  // Missing fundamentals: prefer the lowest key below whose extra
+  // partials are clearly there (double octave, twelfth, octave)
+  double reference = 0.0;
+  int counted = 0;
+  for (int h = 0; h < 4; ++h) {
+    const int bin = bin_of_key(best + TuningTable::kFirstKey) +
+                    partial_offset_[static_cast<std::size_t>(h)];
+    if (bin < cqt_.num_bins()) {
+      reference += partial_level(excess_, bin);
+      ++counted;
+    }
+  }
+  reference /= std::max(counted, 1);
+  static constexpr int kRatios[] = {4, 3, 2};
+  for (int ratio : kRatios) {
+    const int below =
+        best - static_cast<int>(std::lround(12.0 * std::log2(ratio)));
+    if (below >= 0 && reference > 0.0 &&
+        unexplained_level(below, ratio) >= kSubharmonicEvidence * reference) {
+      best = below;
+      break;
+    }
+  }
+
+  // The key's partials: levels, coverage of the spectrum's peaks, and the
+  // strongest low partial for the frequency
+  const int key_bin = bin_of_key(best + TuningTable::kFirstKey);
+  std::array<double, KeyEstimate::kMaxPartials> levels{};
+  double strongest = 0.0;
+  double explained = 0.0;
+  int frequency_bin = -1;
+  double frequency_level = 0.0;
+  int frequency_partial = 1;
+  for (int h = 0; h < KeyEstimate::kMaxPartials; ++h) {
+    const int bin = key_bin + partial_offset_[static_cast<std::size_t>(h)];
+    if (bin >= cqt_.num_bins()) {
+      break;
+    }
+    ++estimate.num_partials;
+    int peak = bin;
+    for (int b = std::max(bin - 1, 0);
+         b <= std::min(bin + 1, cqt_.num_bins() - 1); ++b) {
+      if (magnitudes_[static_cast<std::size_t>(b)] >
+          magnitudes_[static_cast<std::size_t>(peak)]) {
+        peak = b;
+      }
+    }
+    const double level = magnitudes_[static_cast<std::size_t>(peak)];
+    levels[static_cast<std::size_t>(h)] = level;
+    strongest = std::max(strongest, level);
+    explained += excess_[static_cast<std::size_t>(peak)];
+    if (h < 4 && level > frequency_level) {
+      frequency_level = level;
+      frequency_bin = peak;
+      frequency_partial = h + 1;
+    }
+  }
+  double peaks = 0.0;
+  for (int b = 1; b + 1 < cqt_.num_bins(); ++b) {
+    const float value = excess_[static_cast<std::size_t>(b)];
+    if (value > excess_[static_cast<std::size_t>(b - 1)] &&
+        value >= excess_[static_cast<std::size_t>(b + 1)]) {
+      peaks += value;
+    }
+  }
+
+  estimate.midi_note = best + TuningTable::kFirstKey;
+  estimate.level_db = to_db(strongest);
+  estimate.confidence = peaks > 0.0 ? std::min(explained / peaks, 1.0) : 0.0;
+  for (int h = 0; h < KeyEstimate::kMaxPartials; ++h) {
+    estimate.partial_db[static_cast<std::size_t>(h)] =
+        h < estimate.num_partials && strongest > 0.0
+            ? to_db(levels[static_cast<std::size_t>(h)] / strongest)
+            : KeyEstimate::kFloorDb;
+  }
+  if (frequency_bin >= 0) {
+    // Parabola through the peak's log magnitudes
+    double offset = 0.0;
+    if (frequency_bin > 0 && frequency_bin + 1 < cqt_.num_bins()) {
+      const auto at = [this](int b) {
+        return std::log(std::max(
+            magnitudes_[static_cast<std::size_t>(b)], 1e-20f));
+      };
+      const double left = at(frequency_bin - 1);
+      const double centre = at(frequency_bin);
+      const double right = at(frequency_bin + 1);
+      const double curvature = left - 2.0 * centre + right;
+      if (curvature < 0.0) {
+        offset = std::clamp(0.5 * (left - right) / curvature, -0.5, 0.5);
+      }
+    }
+    estimate.frequency =
+        cqt_.bin_frequency(frequency_bin) *
+        std::exp2(offset / static_cast<double>(kBinsPerOctave)) /
+        frequency_partial;
+  }
+  estimate.is_valid = estimate.level_db >= threshold_db_;
+  return estimate;
+}
+
+void KeyIdentifier::decimate(const float* samples, std::size_t num_samples) {
+  // Right-align the most recent samples in the input frame
+  const std::size_t count = std::min(num_samples, frame_length_);
+  const std::size_t pad = frame_length_ - count;
+  std::fill(input_.begin(), input_.begin() + pad, 0.0f);
+  if (count > 0) {
+    std::copy(samples + (num_samples - count), samples + num_samples,
+              input_.begin() + pad);
+  }
+  if (taps_.empty()) {
+    std::copy(input_.begin(), input_.begin() + decimated_.size(),
+              decimated_.begin());
+    return;
+  }
+  const std::size_t step = static_cast<std::size_t>(decimation_);
+  for (std::size_t m = 0; m < decimated_.size(); ++m) {
+    const float* x = input_.data() + m * step;
+    float sum = 0.0f;
+    for (std::size_t t = 0; t < taps_.size(); ++t) {
+      sum += taps_[t] * x[t];
+    }
+    decimated_[m] = sum;
+  }
+}
+
+float KeyIdentifier::partial_level(const std::vector<float>& levels,
+                                   int bin) const noexcept {
+  const int last = cqt_.num_bins() - 1;
+  if (bin > last) {
+    return 0.0f;
+  }
+  float level = levels[static_cast<std::size_t>(bin)];
+  if (bin > 0) {
+    level = std::max(level, levels[static_cast<std::size_t>(bin - 1)]);
+  }
+  if (bin < last) {
+    level = std::max(level, levels[static_cast<std::size_t>(bin + 1)]);
+  }
+  return level;
+}
+
+double KeyIdentifier::score(int key) const noexcept {
+  const int bin = bin_of_key(key + TuningTable::kFirstKey);
+  double sum = 0.0;
+  double weight = 1.0;
+  for (int offset : partial_offset_) {
+    if (bin + offset >= cqt_.num_bins()) {
+      break;
+    }
+    sum += weight * partial_level(excess_, bin + offset);
+    weight *= kPartialWeight;
+  }
+  return sum;
+}
+
+double KeyIdentifier::unexplained_level(int key, int ratio) const noexcept {
+  const int bin = bin_of_key(key + TuningTable::kFirstKey);
+  double sum = 0.0;
+  int count = 0;
+  // Partial 1 is left out: it is the one most often missing
+  for (int h = 2; h <= KeyEstimate::kMaxPartials; ++h) {
+    const int partial = bin + partial_offset_[static_cast<std::size_t>(h - 1)];
+    if (h % ratio == 0 || partial >= cqt_.num_bins()) {
+      continue;
+    }
+    sum += partial_level(excess_, partial);
+    ++count;
+  }
+  return count > 0 ? sum / count : -1.0;
+}
+
+}  // namespace simple_tuner
@@ -0,0 +1,145 @@
+#include "simple_tuner/algorithms/KeyTracker.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace simple_tuner {
+
+namespace {
+// Worker wake-up interval (the ring holds ~680 ms at 48 kHz)
+constexpr std::chrono::milliseconds kPoll(20);
+
+std::size_t update_length_for(double sample_rate, double seconds) noexcept {
+  if (!(sample_rate > 0.0)) {
+    sample_rate = 48000.0;
+  }
+  if (!(seconds > 0.0)) {
+    seconds = KeyTracker::kDefaultUpdateSeconds;
+  }
+  return std::max<std::size_t>(
+      static_cast<std::size_t>(std::lround(sample_rate * seconds)), 256);
+}
+}  // namespace
+
+KeyTracker::KeyTracker(double sample_rate, double update_seconds,
+                       double reference_a4)
+    : identifier_(sample_rate, reference_a4),
+      history_(identifier_.frame_length(), 0.0f),
+      frame_(identifier_.frame_length(), 0.0f),
+      write_(0),
+      filled_(0),
+      since_update_(0),
+      update_length_(update_length_for(sample_rate, update_seconds)),
+      last_note_(0),
+      run_length_(0),
+      overrun_(false),
+      updates_(0),
+      threshold_db_(identifier_.get_threshold_db()),
+      stop_(false),
+      worker_(&KeyTracker::run, this) {}
+
+KeyTracker::~KeyTracker() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  wake_.notify_all();
+  worker_.join();
+}
+
+void KeyTracker::push_audio(const float* samples,
+                            std::size_t num_samples) noexcept {
+  if (samples == nullptr) {
+    return;
+  }
+  if (queue_.push(samples, num_samples) < num_samples) {
+    overrun_.store(true, std::memory_order_release);
+  }
+}
+
+bool KeyTracker::get_estimate(KeyEstimate& estimate) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (updates_ == 0) {
+    return false;
+  }
+  estimate = estimate_;
+  return true;
+}
+
+std::size_t KeyTracker::num_updates() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return updates_;
+}
+
+bool KeyTracker::wait_for_updates(std::size_t count,
+                                  std::chrono::milliseconds timeout) const {
+  std::unique_lock<std::mutex> lock(mutex_);
+  return updated_.wait_for(lock, timeout,
+                           [this, count]() { return updates_ > count; });
+}
+
+void KeyTracker::set_threshold_db(double threshold_db) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  threshold_db_ = threshold_db;
+}
+
+void KeyTracker::run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    if (wake_.wait_for(lock, kPoll, [this]() { return stop_; })) {
+      return;
+    }
+    identifier_.set_threshold_db(threshold_db_);
+    lock.unlock();
+    // One update per wake-up at most: a backlog means the worker is behind
+    if (drain()) {
+      update();
+    }
+    lock.lock();
+  }
+}
+
+bool KeyTracker::drain() {
+  if (overrun_.exchange(false, std::memory_order_acq_rel)) {
+    // A gap in the audio: start the frame over
+    write_ = 0;
+    filled_ = 0;
+  }
+  const std::size_t size = history_.size();
+  std::size_t popped = 0;
+  do {
+    popped = queue_.pop(history_.data() + write_, size - write_);
+    write_ = (write_ + popped) % size;
+    filled_ = std::min(filled_ + popped, size);
+    since_update_ += popped;
+  } while (popped > 0);
+  return since_update_ >= update_length_;
+}
+
+void KeyTracker::update() {
+  since_update_ = 0;
+  // Oldest first; before the ring has wrapped only filled_ samples exist
+  const std::size_t size = history_.size();
+  const std::size_t start = filled_ < size ? 0 : write_;
+  for (std::size_t i = 0; i < filled_; ++i) {
+    frame_[i] = history_[(start + i) % size];
+  }
+  KeyEstimate estimate = identifier_.identify(frame_.data(), filled_);
+
+  if (estimate.is_valid && estimate.midi_note == last_note_) {
+    ++run_length_;
+  } else {
+    last_note_ = estimate.is_valid ? estimate.midi_note : 0;
+    run_length_ = estimate.is_valid ? 1 : 0;
+  }
+  estimate.is_stable = run_length_ >= kStableUpdates;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    estimate_ = estimate;
+    ++updates_;
+  }
+  updated_.notify_all();
+}
+
+}  // namespace simple_tuner
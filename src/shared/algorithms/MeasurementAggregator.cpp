@@ -0,0 +1,193 @@
+#include "simple_tuner/algorithms/MeasurementAggregator.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "simple_tuner/algorithms/FrequencyCalculator.h"
+
+namespace simple_tuner {
+
+namespace {
+constexpr std::size_t kBatchSize = 64;  // Detections converted per pass
+constexpr double kEpsilon = 1e-12;
+}  // namespace
+
+MeasurementAggregator::MeasurementAggregator() noexcept
+    : keys_(), last_key_(0) {}
+
+void MeasurementAggregator::start_segment(KeyState& key,
+                                          double time) noexcept {
+  ++key.segments;
+  key.median.reset();
+  key.lower_quartile.reset();
+  key.upper_quartile.reset();
+  key.count = 0;
+  key.mean = 0.0;
+  key.m2 = 0.0;
+  key.start_time = time;
+}
+
+double MeasurementAggregator::recent_variance(const KeyState& key) noexcept {
+  if (key.weight <= 0.0) {
+    return 0.0;
+  }
+  const double mean = key.sum_c / key.weight;
+  return std::max(key.sum_cc / key.weight - mean * mean, 0.0);
+}
+
+double MeasurementAggregator::recent_drift(const KeyState& key) noexcept {
+  const double denominator = key.weight * key.sum_tt - key.sum_t * key.sum_t;
+  if (denominator <= kEpsilon) {
+    return 0.0;
+  }
+  return (key.weight * key.sum_tc - key.sum_t * key.sum_c) / denominator;
+}
+
+void MeasurementAggregator::update_recent(KeyState& key, double cents,
+                                          double time) noexcept {
+  // Restart after a gap, otherwise decay by the elapsed time
+  if (key.weight <= 0.0 || time < key.last_time ||
+      time - key.last_time > kSegmentGap) {
+    key.origin = time;
+    key.weight = 0.0;
+    key.sum_t = 0.0;
+    key.sum_c = 0.0;
+    key.sum_tt = 0.0;
+    key.sum_tc = 0.0;
+    key.sum_cc = 0.0;
+    key.outliers = 0;
+    key.stable = false;
+    start_segment(key, time);
+  } else if (key.weight >= kMinStableWeight &&
+             std::abs(cents - key.sum_c / key.weight) > kOutlierCents &&
+             ++key.outliers < kMaxOutliers) {
+    key.last_time = time;
+    return;
+  } else {
+    const double decay = std::exp(-(time - key.window_time) / kRecentSeconds);
+    key.weight *= decay;
+    key.sum_t *= decay;
+    key.sum_c *= decay;
+    key.sum_tt *= decay;
+    key.sum_tc *= decay;
+    key.sum_cc *= decay;
+  }
+  key.outliers = 0;
+  const double t = time - key.origin;
+  key.weight += 1.0;
+  key.sum_t += t;
+  key.sum_c += cents;
+  key.sum_tt += t * t;
+  key.sum_tc += t * cents;
+  key.sum_cc += cents * cents;
+  key.window_time = time;
+  key.last_time = time;
+
+  // Settling after a move starts a segment holding only the steady pitch
+  const bool stable =
+      key.weight >= kMinStableWeight &&
+      recent_variance(key) <= kStableSpread * kStableSpread &&
+      std::abs(recent_drift(key)) <= kStableDrift;
+  if (stable && !key.stable) {
+    start_segment(key, time);
+  }
+  key.stable = stable;
+}
+
+void MeasurementAggregator::add(int midi_note, double cents,
+                                double time) noexcept {
+  if (!in_range(midi_note) || !(std::abs(cents) <= kMaxCents) ||
+      !std::isfinite(time)) {
+    return;
+  }
+  KeyState& key = keys_[static_cast<std::size_t>(midi_note -
+                                                 TuningTable::kFirstKey)];
+
+  update_recent(key, cents, time);
+  key.median.add(cents);
+  key.lower_quartile.add(cents);
+  key.upper_quartile.add(cents);
+  ++key.count;
+  const double delta = cents - key.mean;
+  key.mean += delta / static_cast<double>(key.count);
+  key.m2 += delta * (cents - key.mean);
+  if (key.count == 1) {
+    key.minimum = cents;
+    key.maximum = cents;
+  } else {
+    key.minimum = std::min(key.minimum, cents);
+    key.maximum = std::max(key.maximum, cents);
+  }
+  last_key_ = midi_note;
+}
+
+std::size_t MeasurementAggregator::add_detections(
+    const DetectionEvent* events, std::size_t count,
+    const FrequencyCalculator& calculator) noexcept {
+  if (events == nullptr) {
+    return 0;
+  }
+  std::size_t used = 0;
+  double frequencies[kBatchSize];
+  int notes[kBatchSize];
+  double cents[kBatchSize];
+  for (std::size_t first = 0; first < count; first += kBatchSize) {
+    const std::size_t n = std::min(kBatchSize, count - first);
+    for (std::size_t i = 0; i < n; ++i) {
+      frequencies[i] = events[first + i].frequency;
+    }
+    calculator.convert_batch(frequencies, n, NoteResults{notes, cents});
+    for (std::size_t i = 0; i < n; ++i) {
+      if (frequencies[i] > 0.0) {
+        add(notes[i], cents[i], events[first + i].time);
+        ++used;
+      }
+    }
+  }
+  return used;
+}
+
+bool MeasurementAggregator::get_summary(int midi_note,
+                                        KeySummary& summary) const noexcept {
+  if (!in_range(midi_note)) {
+    return false;
+  }
+  const KeyState& key =
+      keys_[static_cast<std::size_t>(midi_note - TuningTable::kFirstKey)];
+  if (key.count == 0) {
+    return false;
+  }
+  summary.midi_note = midi_note;
+  summary.segments = key.segments;
+  summary.count = key.count;
+  summary.median = key.median.value();
+  summary.lower_quartile = key.lower_quartile.value();
+  summary.upper_quartile = key.upper_quartile.value();
+  summary.mean = key.mean;
+  summary.stddev =
+      key.count > 1 ? std::sqrt(key.m2 / static_cast<double>(key.count - 1))
+                    : 0.0;
+  summary.minimum = key.minimum;
+  summary.maximum = key.maximum;
+  summary.recent = key.sum_c / key.weight;
+  summary.recent_stddev = std::sqrt(recent_variance(key));
+  summary.drift = recent_drift(key);
+  summary.start_time = key.start_time;
+  summary.last_time = key.last_time;
+  summary.is_stable = key.stable;
+  return true;
+}
+
+void MeasurementAggregator::reset_key(int midi_note) noexcept {
+  if (in_range(midi_note)) {
+    keys_[static_cast<std::size_t>(midi_note - TuningTable::kFirstKey)] =
+        KeyState();
+  }
+}
+
+void MeasurementAggregator::reset() noexcept {
+  keys_.fill(KeyState());
+  last_key_ = 0;
+}
+
+}  // namespace simple_tuner
@@ -0,0 +1,414 @@
+#include "simple_tuner/algorithms/MultiPitchEstimator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace simple_tuner {
+
+namespace {
+using Complex = std::complex<double>;
+
+constexpr double kPi = 3.14159265358979323846;
+constexpr int kMax = MultiPitchResult::kMaxComponents;
+// Low-pass transition: from kBandwidth to kBasebandRate - kBandwidth, the
+// first frequency that aliases into the band (Blackman: ~5.5 / taps wide)
+constexpr double kTransitionWidth =
+    MultiPitchEstimator::kBasebandRate - 2.0 * MultiPitchEstimator::kBandwidth;
+constexpr int kMaxSweeps = 30;
+// Growing poles are noise; capped so the amplitude fit stays bounded
+constexpr double kMaxPoleRadius = 1.01;
+constexpr int kRootIterations = 500;
+
+int decimation_for(double sample_rate) noexcept {
+  return std::max(1, static_cast<int>(std::lround(
+                         sample_rate / MultiPitchEstimator::kBasebandRate)));
+}
+
+std::vector<double> low_pass(double sample_rate, int decimation) {
+  const int half = static_cast<int>(
+      std::ceil(2.75 * sample_rate / kTransitionWidth));
+  const int count = 2 * half + 1;
+  const double cutoff = 0.5 / static_cast<double>(decimation);
+  std::vector<double> taps(static_cast<std::size_t>(count));
+  double sum = 0.0;
+  for (int i = 0; i < count; ++i) {
+    const double n = static_cast<double>(i - half);
+    const double sinc =
+        i == half ? 2.0 * cutoff : std::sin(2.0 * kPi * cutoff * n) / (kPi * n);
+    const double phase = 2.0 * kPi * i / (count - 1);
+    const double window =
+        0.42 - 0.5 * std::cos(phase) + 0.08 * std::cos(2.0 * phase);
+    taps[static_cast<std::size_t>(i)] = sinc * window;
+    sum += sinc * window;
+  }
+  for (double& tap : taps) {
+    tap /= sum;
+  }
+  return taps;
+}
+
+// Solves a x = b in place for n <= kMax (a: n x n, b: n x columns, both
+// row-major; x replaces b); false if a is singular
+bool solve(Complex* a, Complex* b, int n, int columns) noexcept {
+  for (int col = 0; col < n; ++col) {
+    int pivot = col;
+    for (int row = col + 1; row < n; ++row) {
+      if (std::abs(a[row * n + col]) > std::abs(a[pivot * n + col])) {
+        pivot = row;
+      }
+    }
+    if (std::abs(a[pivot * n + col]) < 1e-300) {
+      return false;
+    }
+    if (pivot != col) {
+      std::swap_ranges(a + pivot * n, a + pivot * n + n, a + col * n);
+      std::swap_ranges(b + pivot * columns, b + pivot * columns + columns,
+                       b + col * columns);
+    }
+    for (int row = col + 1; row < n; ++row) {
+      const Complex factor = a[row * n + col] / a[col * n + col];
+      for (int k = col; k < n; ++k) {
+        a[row * n + k] -= factor * a[col * n + k];
+      }
+      for (int k = 0; k < columns; ++k) {
+        b[row * columns + k] -= factor * b[col * columns + k];
+      }
+    }
+  }
+  for (int row = n - 1; row >= 0; --row) {
+    for (int k = 0; k < columns; ++k) {
+      Complex sum = b[row * columns + k];
+      for (int j = row + 1; j < n; ++j) {
+        sum -= a[row * n + j] * b[j * columns + k];
+      }
+      b[row * columns + k] = sum / a[row * n + row];
+    }
+  }
+  return true;
+}
+
+// Eigenvalues of the n x n (n <= kMax) matrix m: roots of its
+// characteristic polynomial, by Durand-Kerner iteration
+void eigenvalues(const Complex* m, int n, Complex* out) noexcept {
+  if (n == 1) {
+    out[0] = m[0];
+    return;
+  }
+  // Monic coefficients c[0] + c[1] z + ... + z^n
+  Complex c[kMax];
+  if (n == 2) {
+    c[1] = -(m[0] + m[3]);
+    c[0] = m[0] * m[3] - m[1] * m[2];
+  } else {
+    c[2] = -(m[0] + m[4] + m[8]);
+    c[1] = m[0] * m[4] - m[1] * m[3] + m[0] * m[8] - m[2] * m[6] +
+           m[4] * m[8] - m[5] * m[7];
+    c[0] = -(m[0] * (m[4] * m[8] - m[5] * m[7]) -
+             m[1] * (m[3] * m[8] - m[5] * m[6]) +
+             m[2] * (m[3] * m[7] - m[4] * m[6]));
+  }
+  const auto evaluate = [&](Complex z) {
+    Complex value(1.0, 0.0);
+    for (int k = n - 1; k >= 0; --k) {
+      value = value * z + c[k];
+    }
+    return value;
+  };
+  const Complex seed(0.4, 0.9);
+  Complex power(1.0, 0.0);
+  for (int i = 0; i < n; ++i) {
+    out[i] = power;
+    power *= seed;
+  }
+  for (int iteration = 0; iteration < kRootIterations; ++iteration) {
+    double change = 0.0;
+    for (int i = 0; i < n; ++i) {
+      Complex denominator(1.0, 0.0);
+      for (int j = 0; j < n; ++j) {
+        if (j != i) {
+          denominator *= out[i] - out[j];
+        }
+      }
+      if (std::abs(denominator) < 1e-300) {
+        denominator = Complex(1e-12, 0.0);
+      }
+      const Complex step = evaluate(out[i]) / denominator;
+      out[i] -= step;
+      change = std::max(change, std::abs(step));
+    }
+    if (change < 1e-15) {
+      break;
+    }
+  }
+}
+}  // namespace
+
+MultiPitchEstimator::MultiPitchEstimator(double sample_rate,
+                                         double window_seconds)
+    : sample_rate_(sample_rate > 0.0 ? sample_rate : 48000.0),
+      decimation_(decimation_for(sample_rate_)),
+      input_length_(0),
+      snapshot_(0),
+      threshold_db_(kDefaultThresholdDb),
+      taps_(low_pass(sample_rate_, decimation_)),
+      mixer_(taps_.size()) {
+  if (!(window_seconds > 0.0)) {
+    window_seconds = kDefaultWindowSeconds;
+  }
+  window_seconds =
+      std::clamp(window_seconds, kMinWindowSeconds, kMaxWindowSeconds);
+  const double rate = sample_rate_ / decimation_;
+  const auto length =
+      static_cast<std::size_t>(std::lround(window_seconds * rate));
+  baseband_.resize(length);
+  input_length_ =
+      (length - 1) * static_cast<std::size_t>(decimation_) + taps_.size();
+  snapshot_ = length / 3;
+  covariance_.resize(snapshot_ * snapshot_);
+  vectors_.resize(snapshot_ * snapshot_);
+  eigenvalues_.resize(snapshot_);
+  order_.resize(snapshot_);
+}
+
+void MultiPitchEstimator::set_threshold_db(double threshold_db) noexcept {
+  threshold_db_ = threshold_db;
+}
+
+MultiPitchResult MultiPitchEstimator::estimate(
+    const float* samples, std::size_t num_samples,
+    double center_frequency) noexcept {
+  MultiPitchResult result;
+  if (samples == nullptr || num_samples < input_length_ ||
+      !(center_frequency > 0.0) ||
+      center_frequency >= 0.5 * sample_rate_) {
+    return result;
+  }
+  mix_down(samples, num_samples, center_frequency);
+  build_covariance();
+  decompose();
+
+  // Model order: eigenvalues standing clear of the noise subspace's
+  const std::size_t l = snapshot_;
+  std::iota(order_.begin(), order_.end(), std::size_t{0});
+  std::sort(order_.begin(), order_.end(), [this](std::size_t a,
+                                                 std::size_t b) {
+    return eigenvalues_[a] > eigenvalues_[b];
+  });
+  double noise = 0.0;
+  for (std::size_t i = kMax + 1; i < l; ++i) {
+    noise += std::max(eigenvalues_[order_[i]], 0.0);
+  }
+  noise /= static_cast<double>(l - kMax - 1);
+  const double largest = eigenvalues_[order_[0]];
+  int order = 0;
+  while (order < kMax &&
+         eigenvalues_[order_[static_cast<std::size_t>(order)]] >
+             std::max(kOrderFactor * noise, kDynamicRange * largest) &&
+         largest > 0.0) {
+    ++order;
+  }
+  if (order == 0) {
+    return result;
+  }
+
+  // ESPRIT: U1 psi = U2 for the signal subspace's first and last L - 1
+  // rows; least squares via (U1^H U1) psi = U1^H U2
+  Complex gram[kMax * kMax] = {};
+  Complex cross[kMax * kMax] = {};
+  for (int i = 0; i < order; ++i) {
+    const std::size_t ci = order_[static_cast<std::size_t>(i)];
+    for (int j = 0; j < order; ++j) {
+      const std::size_t cj = order_[static_cast<std::size_t>(j)];
+      Complex g;
+      Complex x;
+      for (std::size_t r = 0; r + 1 < l; ++r) {
+        const Complex u = std::conj(vectors_[r * l + ci]);
+        g += u * vectors_[r * l + cj];
+        x += u * vectors_[(r + 1) * l + cj];
+      }
+      gram[i * order + j] = g;
+      cross[i * order + j] = x;
+    }
+  }
+  if (!solve(gram, cross, order, order)) {
+    return result;
+  }
+  Complex poles[kMax];
+  eigenvalues(cross, order, poles);
+
+  // Amplitudes: least squares fit of the (decaying) poles to the
+  // baseband, then each one's mean magnitude over the window
+  const double rate = sample_rate_ / decimation_;
+  Complex steps[kMax];
+  double mean_gain[kMax];
+  for (int k = 0; k < order; ++k) {
+    const double radius = std::min(std::abs(poles[k]), kMaxPoleRadius);
+    steps[k] = std::polar(radius, std::arg(poles[k]));
+    mean_gain[k] = 0.0;
+  }
+  Complex normal[kMax * kMax] = {};
+  Complex projection[kMax] = {};
+  Complex phase[kMax];
+  std::fill(phase, phase + order, Complex(1.0, 0.0));
+  for (const Complex& y : baseband_) {
+    for (int i = 0; i < order; ++i) {
+      const Complex conj_i = std::conj(phase[i]);
+      projection[i] += conj_i * y;
+      for (int j = 0; j < order; ++j) {
+        normal[i * order + j] += conj_i * phase[j];
+      }
+    }
+    for (int k = 0; k < order; ++k) {
+      mean_gain[k] += std::abs(phase[k]);
+      phase[k] *= steps[k];
+    }
+  }
+  if (!solve(normal, projection, order, 1)) {
+    return result;
+  }
+
+  const double threshold = std::pow(10.0, threshold_db_ / 20.0);
+  for (int k = 0; k < order; ++k) {
+    const double offset = std::arg(poles[k]) * rate / (2.0 * kPi);
+    // Mixing halved the real sinusoid; the low-pass has unit gain
+    const double amplitude = 2.0 * std::abs(projection[k]) * mean_gain[k] /
+                             static_cast<double>(baseband_.size());
+    if (std::abs(offset) <= kBandwidth && amplitude >= threshold) {
+      PitchComponent& component =
+          result.components[static_cast<std::size_t>(result.count++)];
+      component.frequency = center_frequency + offset;
+      component.amplitude = amplitude;
+    }
+  }
+  // Ascending frequency (insertion; at most kMax)
+  auto& components = result.components;
+  for (std::size_t i = 1; i < static_cast<std::size_t>(result.count); ++i) {
+    for (std::size_t j = i;
+         j > 0 && components[j].frequency < components[j - 1].frequency;
+         --j) {
+      std::swap(components[j], components[j - 1]);
+    }
+  }
+  result.is_valid = result.count > 0;
+  return result;
+}
+
+void MultiPitchEstimator::mix_down(const float* samples,
+                                   std::size_t num_samples,
+                                   double center_frequency) noexcept {
+  const float* frame = samples + (num_samples - input_length_);
+  const double omega = 2.0 * kPi * center_frequency / sample_rate_;
+  for (std::size_t t = 0; t < taps_.size(); ++t) {
+    mixer_[t] = std::polar(taps_[t], -omega * static_cast<double>(t));
+  }
+  const std::size_t step = static_cast<std::size_t>(decimation_);
+  for (std::size_t m = 0; m < baseband_.size(); ++m) {
+    const std::size_t first = m * step;
+    const float* x = frame + first;
+    Complex sum;
+    for (std::size_t t = 0; t < taps_.size(); ++t) {
+      sum += mixer_[t] * static_cast<double>(x[t]);
+    }
+    baseband_[m] =
+        sum * std::polar(1.0, -omega * static_cast<double>(first));
+  }
+}
+
+void MultiPitchEstimator::build_covariance() noexcept {
+  const std::size_t l = snapshot_;
+  const std::size_t snapshots = baseband_.size() - l + 1;
+  std::fill(covariance_.begin(), covariance_.end(), Complex());
+  for (std::size_t m = 0; m < snapshots; ++m) {
+    const Complex* x = baseband_.data() + m;
+    for (std::size_t i = 0; i < l; ++i) {
+      for (std::size_t j = i; j < l; ++j) {
+        covariance_[i * l + j] += x[i] * std::conj(x[j]);
+      }
+    }
+  }
+  // Forward only: averaging with the time-reversed snapshots would add a
+  // mirror pole 1 / conj(z) for every decaying string
+  const double scale = 1.0 / static_cast<double>(snapshots);
+  for (std::size_t i = 0; i < l; ++i) {
+    covariance_[i * l + i] *= scale;
+    for (std::size_t j = i + 1; j < l; ++j) {
+      covariance_[i * l + j] *= scale;
+      covariance_[j * l + i] = std::conj(covariance_[i * l + j]);
+    }
+  }
+}
+
+void MultiPitchEstimator::decompose() noexcept {
+  // Cyclic Jacobi for Hermitian matrices: each rotation first turns the
+  // (p, q) element real with a phase on column q, then zeroes it as the
+  // real algorithm does
+  const std::size_t l = snapshot_;
+  Complex* a = covariance_.data();
+  Complex* v = vectors_.data();
+  std::fill(vectors_.begin(), vectors_.end(), Complex());
+  double norm = 0.0;
+  for (std::size_t i = 0; i < l; ++i) {
+    v[i * l + i] = 1.0;
+    for (std::size_t j = 0; j < l; ++j) {
+      norm += std::norm(a[i * l + j]);
+    }
+  }
+  const double tolerance = 1e-26 * norm;
+  for (int sweep = 0; sweep < kMaxSweeps; ++sweep) {
+    double off = 0.0;
+    for (std::size_t p = 0; p < l; ++p) {
+      for (std::size_t q = p + 1; q < l; ++q) {
+        off += std::norm(a[p * l + q]);
+      }
+    }
+    if (off <= tolerance) {
+      break;
+    }
+    for (std::size_t p = 0; p + 1 < l; ++p) {
+      for (std::size_t q = p + 1; q < l; ++q) {
+        const double magnitude = std::abs(a[p * l + q]);
+        if (magnitude * magnitude <= tolerance / static_cast<double>(l * l)) {
+          continue;
+        }
+        const Complex phase = std::conj(a[p * l + q]) / magnitude;
+        const double theta =
+            (a[q * l + q].real() - a[p * l + p].real()) / (2.0 * magnitude);
+        const double t = (theta >= 0.0 ? 1.0 : -1.0) /
+                         (std::abs(theta) + std::sqrt(theta * theta + 1.0));
+        const double c = 1.0 / std::sqrt(t * t + 1.0);
+        const double s = t * c;
+        // U = diag(.., 1 at p, phase at q, ..) x real rotation (c, s)
+        const Complex upp(c, 0.0);
+        const Complex upq(s, 0.0);
+        const Complex uqp = -s * phase;
+        const Complex uqq = c * phase;
+        for (std::size_t k = 0; k < l; ++k) {  // A U, V U
+          const Complex akp = a[k * l + p];
+          const Complex akq = a[k * l + q];
+          a[k * l + p] = akp * upp + akq * uqp;
+          a[k * l + q] = akp * upq + akq * uqq;
+          const Complex vkp = v[k * l + p];
+          const Complex vkq = v[k * l + q];
+          v[k * l + p] = vkp * upp + vkq * uqp;
+          v[k * l + q] = vkp * upq + vkq * uqq;
+        }
+        for (std::size_t k = 0; k < l; ++k) {  // U^H (A U)
+          const Complex apk = a[p * l + k];
+          const Complex aqk = a[q * l + k];
+          a[p * l + k] = std::conj(upp) * apk + std::conj(uqp) * aqk;
+          a[q * l + k] = std::conj(upq) * apk + std::conj(uqq) * aqk;
+        }
+        a[p * l + q] = Complex();
+        a[q * l + p] = Complex();
+        a[p * l + p] = a[p * l + p].real();
+        a[q * l + q] = a[q * l + q].real();
+      }
+    }
+  }
+  for (std::size_t i = 0; i < l; ++i) {
+    eigenvalues_[i] = a[i * l + i].real();
+  }
+}
+
+}  // namespace simple_tuner
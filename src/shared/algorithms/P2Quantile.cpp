@@ -0,0 +1,99 @@
+#include "simple_tuner/algorithms/P2Quantile.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace simple_tuner {
+
+P2Quantile::P2Quantile(double probability) noexcept
+    : probability_(std::clamp(probability, 0.0, 1.0)),
+      count_(0),
+      heights_(),
+      positions_(),
+      desired_(),
+      increments_() {}
+
+void P2Quantile::reset() noexcept { count_ = 0; }
+
+void P2Quantile::add(double value) noexcept {
+  const double p = probability_;
+  if (count_ < kMarkers) {
+    heights_[count_++] = value;
+    if (count_ == kMarkers) {
+      std::sort(heights_, heights_ + kMarkers);
+      const double desired[kMarkers] = {0.0, 2.0 * p, 4.0 * p, 2.0 + 2.0 * p,
+                                        4.0};
+      const double increments[kMarkers] = {0.0, p / 2.0, p, (1.0 + p) / 2.0,
+                                           1.0};
+      for (int i = 0; i < kMarkers; ++i) {
+        positions_[i] = i;
+        desired_[i] = desired[i];
+        increments_[i] = increments[i];
+      }
+    }
+    return;
+  }
+
+  // Cell of the new sample; the extreme markers absorb new extremes
+  int cell = 0;
+  if (value < heights_[0]) {
+    heights_[0] = value;
+  } else if (value >= heights_[kMarkers - 1]) {
+    heights_[kMarkers - 1] = value;
+    cell = kMarkers - 2;
+  } else {
+    while (value >= heights_[cell + 1]) {
+      ++cell;
+    }
+  }
+  for (int i = cell + 1; i < kMarkers; ++i) {
+    positions_[i] += 1.0;
+  }
+  for (int i = 0; i < kMarkers; ++i) {
+    desired_[i] += increments_[i];
+  }
+
+  // Move the middle markers one rank toward their ideal ranks
+  for (int i = 1; i < kMarkers - 1; ++i) {
+    const double offset = desired_[i] - positions_[i];
+    if ((offset >= 1.0 && positions_[i + 1] - positions_[i] > 1.0) ||
+        (offset <= -1.0 && positions_[i - 1] - positions_[i] < -1.0)) {
+      const double d = offset > 0.0 ? 1.0 : -1.0;
+      const double below = positions_[i] - positions_[i - 1];
+      const double above = positions_[i + 1] - positions_[i];
+      const double parabolic =
+          heights_[i] +
+          d / (positions_[i + 1] - positions_[i - 1]) *
+              ((below + d) * (heights_[i + 1] - heights_[i]) / above +
+               (above - d) * (heights_[i] - heights_[i - 1]) / below);
+      if (heights_[i - 1] < parabolic && parabolic < heights_[i + 1]) {
+        heights_[i] = parabolic;
+      } else {
+        // Linear fallback keeps the markers ordered
+        const int j = i + static_cast<int>(d);
+        heights_[i] += d * (heights_[j] - heights_[i]) /
+                       (positions_[j] - positions_[i]);
+      }
+      positions_[i] += d;
+    }
+  }
+  ++count_;
+}
+
+double P2Quantile::value() const noexcept {
+  if (count_ == 0) {
+    return 0.0;
+  }
+  if (count_ < kMarkers) {
+    // Exact: nearest rank of the samples so far
+    double sorted[kMarkers];
+    std::copy(heights_, heights_ + count_, sorted);
+    std::sort(sorted, sorted + count_);
+    const auto rank = static_cast<std::size_t>(
+        std::lround(probability_ * static_cast<double>(count_ - 1)));
+    return sorted[rank];
+  }
+  return heights_[2];
+}
+
+}  // namespace simple_tuner
@@ -3,6 +3,9 @@
 #include <algorithm>
 #include <cmath>
 #include <limits>
+#include <thread>
+
+#include "simple_tuner/algorithms/MpmPeakPicking.h"
 
 namespace simple_tuner {
 
@@ -13,69 +16,142 @@ constexpr double kDefaultMinFrequency = 32.7;    // C1
 constexpr double kDefaultMaxFrequency = 4186.0;  // C8
 constexpr double kBaseClarity = 0.01;            // Base clarity threshold
 constexpr double kEpsilon = 1e-10;               // Numerical stability
+// Lags searched past the lowest period: with few cycles in the frame the
+// NSDF peak sits a little long, and must still test as a local maximum
+constexpr double kLagSlack = 1.03;  // ~Quarter tone
 constexpr double kPi = 3.14159265358979323846;
 }  // namespace
 
-PitchDetector::PitchDetector(double sample_rate, std::size_t buffer_size)
+template <typename Precision>
+BasicPitchDetector<Precision>::BasicPitchDetector(double sample_rate,
+                                                  std::size_t buffer_size)
+    : BasicPitchDetector(
+          sample_rate,
+          capacity_for(sample_rate, buffer_size, kDefaultMinFrequency),
+          nullptr) {}
+
+template <typename Precision>
+BasicPitchDetector<Precision>::BasicPitchDetector(double sample_rate,
+                                                  std::size_t buffer_size,
+                                                  BufferArena& arena)
+    : BasicPitchDetector(
+          sample_rate,
+          capacity_for(sample_rate, buffer_size, kDefaultMinFrequency),
+          &arena) {}
+
+template <typename Precision>
+BasicPitchDetector<Precision>::BasicPitchDetector(
+    double sample_rate, const DetectorCapacity& capacity)
+    : BasicPitchDetector(sample_rate, capacity, nullptr) {}
+
+template <typename Precision>
+BasicPitchDetector<Precision>::BasicPitchDetector(
+    double sample_rate, const DetectorCapacity& capacity, BufferArena& arena)
+    : BasicPitchDetector(sample_rate, capacity, &arena) {}
+
+template <typename Precision>
+BasicPitchDetector<Precision>::BasicPitchDetector(
+    double sample_rate, const DetectorCapacity& capacity, BufferArena* arena)
     : sample_rate_(sample_rate),
-      buffer_size_(buffer_size),
+      capacity_(capacity),
+      buffer_size_(capacity.max_buffer_size),
       threshold_db_(kDefaultThresholdDb),
       min_freq_(kDefaultMinFrequency),
       max_freq_(kDefaultMaxFrequency),
       window_type_(WindowType::kRectangular),
-      base_clarity_threshold_(kBaseClarity) {
-  // Calculate lag range from frequency limits
+      base_clarity_threshold_(kBaseClarity),
+      working_(ArenaAllocator<float>(arena)),
+      window_(ArenaAllocator<float>(arena)),
+      autocorr_(ArenaAllocator<Storage>(arena)),
+      square_sum_(ArenaAllocator<Storage>(arena)),
+      nsdf_(ArenaAllocator<Storage>(arena)) {
+  // Pre-allocate buffers in access order, sized for the full capacity so
+  // later reconfiguration never reallocates
+  working_.resize(capacity_.max_buffer_size, 0.0f);
+  window_.resize(capacity_.max_buffer_size, 1.0f);
+  autocorr_.resize(capacity_.max_lag + 1, Storage(0));
+  square_sum_.resize(capacity_.max_lag + 1, Storage(0));
+  nsdf_.resize(capacity_.max_lag + 1, Storage(0));
+
+  update_lag_range();
+
+  // Pre-compute window coefficients
+  compute_window();
+}
+
+template <typename Precision>
+DetectorCapacity BasicPitchDetector<Precision>::capacity_for(
+    double sample_rate, std::size_t buffer_size,
+    double min_frequency) noexcept {
+  const int max_lag = lag_limit(sample_rate, min_frequency, buffer_size);
+  return DetectorCapacity{buffer_size,
+                          static_cast<std::size_t>(std::max(max_lag, 0))};
+}
+
+template <typename Precision>
+std::size_t BasicPitchDetector<Precision>::arena_bytes(
+    double sample_rate, std::size_t buffer_size) noexcept {
+  return arena_bytes(
+      capacity_for(sample_rate, buffer_size, kDefaultMinFrequency));
+}
+
+template <typename Precision>
+std::size_t BasicPitchDetector<Precision>::arena_bytes(
+    const DetectorCapacity& capacity) noexcept {
+  return 2 * BufferArena::footprint<float>(capacity.max_buffer_size) +
+         3 * BufferArena::footprint<Storage>(capacity.max_lag + 1);
+}
+
+template <typename Precision>
+int BasicPitchDetector<Precision>::lag_limit(double sample_rate,
+                                             double frequency,
+                                             std::size_t buffer_size) noexcept {
+  const int lag = static_cast<int>(kLagSlack * sample_rate / frequency) + 1;
+  return std::min(lag, static_cast<int>(buffer_size) - 1);
+}
+
+template <typename Precision>
+void BasicPitchDetector<Precision>::update_lag_range() noexcept {
   // period = sample_rate / frequency
   // For max frequency (min period): min_lag = sample_rate / max_freq
-  // For min frequency (max period): max_lag = sample_rate / min_freq
-  max_lag_ = static_cast<int>(sample_rate_ / min_freq_);
+  // For min frequency (max period): max_lag = sample_rate / min_freq,
+  // clamped to the preallocated NSDF buffers
+  max_lag_ = lag_limit(sample_rate_, min_freq_, buffer_size_);
+  max_lag_ = std::min(max_lag_, static_cast<int>(capacity_.max_lag));
   min_lag_ = static_cast<int>(sample_rate_ / max_freq_);
-
-  // Clamp to buffer size
-  max_lag_ = std::min(max_lag_, static_cast<int>(buffer_size_) - 1);
   min_lag_ = std::max(min_lag_, 1);
-
-  // Pre-allocate buffers
-  nsdf_.resize(max_lag_ + 1, 0.0);
-  autocorr_.resize(max_lag_ + 1, 0.0);
-  square_sum_.resize(max_lag_ + 1, 0.0);
-  window_.resize(buffer_size_, 1.0);
-  working_.resize(buffer_size_, 0.0f);
-
-  // Pre-compute window coefficients
-  compute_window();
 }
 
-double PitchDetector::detect_pitch(const float* samples,
-                                   std::size_t num_samples) noexcept {
+template <typename Precision>
+double BasicPitchDetector<Precision>::detect_pitch(
+    const float* samples, std::size_t num_samples) noexcept {
   DetectionResult result = detect_pitch_detailed(samples, num_samples);
   return result.frequency;
 }
 
-DetectionResult PitchDetector::detect_pitch_detailed(
+template <typename Precision>
+DetectionResult BasicPitchDetector<Precision>::detect_pitch_detailed(
     const float* samples, std::size_t num_samples) noexcept {
   // Validate input
   if (samples == nullptr || num_samples == 0) {
     return DetectionResult(0.0, 0.0, false);
   }
 
+  // Level statistics, DC removal and windowing in one fused kernel
+  // (rectangular window = no multiply)
+  const std::size_t frame_size = std::min(num_samples, buffer_size_);
+  const float* window =
+      window_type_ == WindowType::kRectangular ? nullptr : window_.data();
+  const dsp::BlockStats stats =
+      dsp::preprocess_frame(samples, window, working_.data(), frame_size);
+
   // Validate signal strength
-  if (!validate_signal(samples, num_samples)) {
+  if (!validate_signal(stats, frame_size)) {
     return DetectionResult(0.0, 0.0, false);
   }
 
-  // Use pre-allocated working buffer for pre-processing
-  const std::size_t copy_size = std::min(num_samples, working_.size());
-  std::copy(samples, samples + copy_size, working_.begin());
-
-  // Apply DC offset removal
-  remove_dc_offset(working_.data(), copy_size);
-
-  // Apply windowing (rectangular window = no-op for default)
-  apply_window(working_.data(), copy_size);
-
   // Compute NSDF on processed signal
-  compute_nsdf(working_.data(), copy_size);
+  compute_nsdf(working_.data(), frame_size);
 
   // Find highest clarity peak
   int peak_index = find_highest_clarity_peak();
@@ -90,142 +166,203 @@ DetectionResult PitchDetector::detect_pitch_detailed(
   double frequency = sample_rate_ / refined_period;
 
   // Get confidence from NSDF peak value
-  double confidence = nsdf_[peak_index];
+  double confidence = static_cast<double>(nsdf_[peak_index]);
 
   return DetectionResult(frequency, confidence, true);
 }
 
-void PitchDetector::set_threshold_db(double threshold_db) noexcept {
+template <typename Precision>
+std::size_t BasicPitchDetector<Precision>::count_frames(
+    std::size_t num_samples, std::size_t hop_size) const noexcept {
+  if (hop_size == 0 || num_samples < buffer_size_) {
+    return 0;
+  }
+  return 1 + (num_samples - buffer_size_) / hop_size;
+}
+
+template <typename Precision>
+std::size_t BasicPitchDetector<Precision>::detect_frames(
+    const float* signal, std::size_t num_samples, std::size_t hop_size,
+    const FrameResults& results, unsigned int num_threads) noexcept {
+  if (signal == nullptr || results.frequency == nullptr ||
+      results.confidence == nullptr || results.valid == nullptr) {
+    return 0;
+  }
+
+  const std::size_t num_frames = count_frames(num_samples, hop_size);
+  if (num_frames == 0) {
+    return 0;
+  }
+
+  const std::size_t num_workers =
+      std::min(static_cast<std::size_t>(std::max(num_threads, 1U)), num_frames);
+  const std::size_t frames_per_worker =
+      (num_frames + num_workers - 1) / num_workers;
+
+  // The calling thread processes the first slice with this detector's
+  // buffers; each worker thread gets a private copy of the detector so no
+  // scratch state is shared
+  std::vector<BasicPitchDetector> workers;
+  std::vector<std::thread> threads;
+  const std::size_t local_frames = std::min(frames_per_worker, num_frames);
+  std::size_t next_frame = local_frames;
+  try {
+    workers.reserve(num_workers - 1);
+    threads.reserve(num_workers - 1);
+    while (next_frame < num_frames) {
+      const std::size_t first = next_frame;
+      const std::size_t last = std::min(first + frames_per_worker, num_frames);
+      workers.push_back(*this);
+      BasicPitchDetector* worker = &workers.back();
+      threads.emplace_back([worker, signal, hop_size, &results, first, last]() {
+        worker->detect_frame_range(signal, hop_size, results, first, last);
+      });
+      next_frame = last;
+    }
+  } catch (...) {
+    // Thread creation failed: remaining frames run on the calling thread
+  }
+
+  detect_frame_range(signal, hop_size, results, 0, local_frames);
+  detect_frame_range(signal, hop_size, results, next_frame, num_frames);
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  return num_frames;
+}
+
+template <typename Precision>
+void BasicPitchDetector<Precision>::detect_frame_range(
+    const float* signal, std::size_t hop_size, const FrameResults& results,
+    std::size_t first_frame, std::size_t last_frame) noexcept {
+  for (std::size_t frame = first_frame; frame < last_frame; ++frame) {
+    const DetectionResult result =
+        detect_pitch_detailed(signal + frame * hop_size, buffer_size_);
+    results.frequency[frame] = result.frequency;
+    results.confidence[frame] = result.confidence;
+    results.valid[frame] = result.is_valid;
+  }
+}
+
+template <typename Precision>
+void BasicPitchDetector<Precision>::set_threshold_db(
+    double threshold_db) noexcept {
   threshold_db_ = threshold_db;
 }
 
-void PitchDetector::set_min_frequency(double min_freq) noexcept {
+template <typename Precision>
+void BasicPitchDetector<Precision>::set_min_frequency(
+    double min_freq) noexcept {
+  if (min_freq <= 0.0) {
+    return;
+  }
   min_freq_ = min_freq;
-  max_lag_ = static_cast<int>(sample_rate_ / min_freq_);
-  max_lag_ = std::min(max_lag_, static_cast<int>(buffer_size_) - 1);
+  update_lag_range();
 }
 
-void PitchDetector::set_max_frequency(double max_freq) noexcept {
+template <typename Precision>
+void BasicPitchDetector<Precision>::set_max_frequency(
+    double max_freq) noexcept {
+  if (max_freq <= 0.0) {
+    return;
+  }
   max_freq_ = max_freq;
-  min_lag_ = static_cast<int>(sample_rate_ / max_freq_);
-  min_lag_ = std::max(min_lag_, 1);
+  update_lag_range();
+}
+
+template <typename Precision>
+void BasicPitchDetector<Precision>::set_sample_rate(
+    double sample_rate) noexcept {
+  if (sample_rate <= 0.0) {
+    return;
+  }
+  sample_rate_ = sample_rate;
+  update_lag_range();
 }
 
-void PitchDetector::set_window_type(WindowType type) noexcept {
+template <typename Precision>
+void BasicPitchDetector<Precision>::set_buffer_length(
+    std::size_t buffer_length) noexcept {
+  buffer_size_ = std::clamp<std::size_t>(buffer_length, 2,
+                                         capacity_.max_buffer_size);
+  update_lag_range();
+  compute_window();
+}
+
+template <typename Precision>
+void BasicPitchDetector<Precision>::set_window_type(WindowType type) noexcept {
   window_type_ = type;
   compute_window();
 }
 
-void PitchDetector::set_base_clarity_threshold(double threshold) noexcept {
+template <typename Precision>
+void BasicPitchDetector<Precision>::set_base_clarity_threshold(
+    double threshold) noexcept {
   base_clarity_threshold_ = threshold;
 }
 
-void PitchDetector::compute_nsdf(const float* samples,
-                                 std::size_t num_samples) noexcept {
+template <typename Precision>
+void BasicPitchDetector<Precision>::compute_nsdf(
+    const float* samples, std::size_t num_samples) noexcept {
   const int max_lag = std::min(max_lag_, static_cast<int>(num_samples) - 1);
+  const auto searched_lags = static_cast<std::ptrdiff_t>(max_lag_ + 1);
 
-  // Initialize accumulators
-  std::fill(autocorr_.begin(), autocorr_.end(), 0.0);
-  std::fill(square_sum_.begin(), square_sum_.end(), 0.0);
+  // Initialize accumulators (only the searched lags are ever read)
+  std::fill(autocorr_.begin(), autocorr_.begin() + searched_lags, Storage(0));
+  std::fill(square_sum_.begin(), square_sum_.begin() + searched_lags,
+            Storage(0));
 
   // Compute autocorrelation and square sums for each lag
   for (int lag = 0; lag <= max_lag; ++lag) {
-    double r = 0.0;  // Autocorrelation r(tau)
-    double m = 0.0;  // Square sum m(tau)
+    Accumulator r = 0;  // Autocorrelation r(tau)
+    Accumulator m = 0;  // Square sum m(tau)
 
     const std::size_t valid_samples = num_samples - lag;
     for (std::size_t i = 0; i < valid_samples; ++i) {
-      const double x_i = samples[i];
-      const double x_i_lag = samples[i + lag];
+      const Accumulator x_i = samples[i];
+      const Accumulator x_i_lag = samples[i + lag];
       r += x_i * x_i_lag;
       m += x_i * x_i + x_i_lag * x_i_lag;
     }
 
-    autocorr_[lag] = r;
-    square_sum_[lag] = m;
+    autocorr_[lag] = static_cast<Storage>(r);
+    square_sum_[lag] = static_cast<Storage>(m);
   }
 
   // Compute NSDF: NSDF(tau) = 2 * r(tau) / m(tau)
-  for (int lag = 0; lag <= max_lag; ++lag) {
+  // Lags past the input length have zero sums and come out as zero
+  for (int lag = 0; lag <= max_lag_; ++lag) {
     if (square_sum_[lag] > kEpsilon) {
-      nsdf_[lag] = 2.0 * autocorr_[lag] / square_sum_[lag];
+      nsdf_[lag] = Storage(2) * autocorr_[lag] / square_sum_[lag];
     } else {
-      nsdf_[lag] = 0.0;
+      nsdf_[lag] = Storage(0);
     }
   }
 }
 
-int PitchDetector::find_highest_clarity_peak() const noexcept {
-  // MPM algorithm: find the first peak that exceeds the adaptive clarity
-  // threshold Search from min_lag (skip DC component at lag=0) Ensure we have
-  // room for three-point test
+template <typename Precision>
+int BasicPitchDetector<Precision>::find_highest_clarity_peak() const noexcept {
   const int start_lag = std::max(min_lag_, 1);
-  const int end_lag = std::min(max_lag_, static_cast<int>(nsdf_.size()) - 1);
-
-  // First try to find a local maximum (peak)
-  for (int lag = start_lag; lag < end_lag; ++lag) {
-    // Three-point local maximum test
-    if (nsdf_[lag] > nsdf_[lag - 1] && nsdf_[lag] > nsdf_[lag + 1]) {
-      // Calculate adaptive threshold based on number of cycles in buffer
-      // For lower frequencies (fewer cycles), we relax the threshold
-      const double cycles = sample_rate_ / static_cast<double>(lag);
-      const double adaptive_threshold =
-          base_clarity_threshold_ / std::sqrt(std::max(cycles, 1.0));
-
-      // Return first peak that exceeds adaptive clarity threshold
-      if (nsdf_[lag] >= adaptive_threshold) {
-        return lag;
-      }
-    }
-  }
-
-  // If no peak found (e.g., very low frequencies near buffer limit),
-  // find the lag with highest NSDF value in the valid range
-  int best_lag = -1;
-  double best_nsdf = 0.0;
-  for (int lag = start_lag; lag <= end_lag; ++lag) {
-    const double cycles = sample_rate_ / static_cast<double>(lag);
-    const double adaptive_threshold =
-        base_clarity_threshold_ / std::sqrt(std::max(cycles, 1.0));
-
-    if (nsdf_[lag] > best_nsdf && nsdf_[lag] >= adaptive_threshold) {
-      best_nsdf = nsdf_[lag];
-      best_lag = lag;
-    }
-  }
-
-  return best_lag;
+  return mpm::find_highest_clarity_peak(nsdf_.data(), start_lag, max_lag_,
+                                        sample_rate_, base_clarity_threshold_);
 }
 
-double PitchDetector::parabolic_interpolation(int peak_index) const noexcept {
-  // Bounds check - need room for neighbors
-  if (peak_index <= 0 || peak_index >= static_cast<int>(nsdf_.size()) - 1) {
-    return static_cast<double>(peak_index);
-  }
-
-  // Three-point parabolic interpolation
-  const double alpha = nsdf_[peak_index - 1];
-  const double beta = nsdf_[peak_index];
-  const double gamma = nsdf_[peak_index + 1];
-
-  // Calculate parabola vertex offset: delta = (alpha - gamma) / (2 * (alpha -
-  // 2*beta + gamma))
-  const double denominator = 2.0 * (alpha - 2.0 * beta + gamma);
-
-  // Avoid division by zero or near-zero (flat peak)
-  if (std::abs(denominator) < kEpsilon) {
-    return static_cast<double>(peak_index);
-  }
-
-  const double delta = (alpha - gamma) / denominator;
-
-  // Refined peak position (sub-sample accuracy)
-  return static_cast<double>(peak_index) + delta;
+template <typename Precision>
+double BasicPitchDetector<Precision>::parabolic_interpolation(
+    int peak_index) const noexcept {
+  return mpm::parabolic_interpolation(nsdf_.data(), max_lag_ + 1, peak_index);
 }
 
-bool PitchDetector::validate_signal(const float* samples,
-                                    std::size_t num_samples) const noexcept {
-  const double rms = calculate_rms(samples, num_samples);
+template <typename Precision>
+bool BasicPitchDetector<Precision>::validate_signal(
+    const dsp::BlockStats& stats, std::size_t num_samples) const noexcept {
+  if (num_samples == 0) {
+    return false;
+  }
+  const double rms =
+      std::sqrt(stats.sum_squares / static_cast<double>(num_samples));
 
   // Convert threshold from dB to linear
   const double threshold_linear = std::pow(10.0, threshold_db_ / 20.0);
@@ -233,68 +370,33 @@ bool PitchDetector::validate_signal(const float* samples,
   return rms >= threshold_linear;
 }
 
-double PitchDetector::calculate_rms(const float* samples,
-                                    std::size_t num_samples) const noexcept {
-  if (num_samples == 0) {
-    return 0.0;
-  }
-
-  double sum_squares = 0.0;
-  for (std::size_t i = 0; i < num_samples; ++i) {
-    sum_squares += samples[i] * samples[i];
-  }
-
-  return std::sqrt(sum_squares / static_cast<double>(num_samples));
-}
-
-void PitchDetector::compute_window() noexcept {
+template <typename Precision>
+void BasicPitchDetector<Precision>::compute_window() noexcept {
   const std::size_t n = buffer_size_;
 
   switch (window_type_) {
     case WindowType::kRectangular:
-      std::fill(window_.begin(), window_.end(), 1.0);
+      std::fill(window_.data(), window_.data() + n, 1.0f);
       break;
 
     case WindowType::kHann:
       for (std::size_t i = 0; i < n; ++i) {
-        window_[i] = 0.5 * (1.0 - std::cos(2.0 * kPi * i / (n - 1)));
+        window_[i] =
+            static_cast<float>(0.5 * (1.0 - std::cos(2.0 * kPi * i / (n - 1))));
       }
       break;
 
     case WindowType::kHamming:
       for (std::size_t i = 0; i < n; ++i) {
-        window_[i] = 0.54 - 0.46 * std::cos(2.0 * kPi * i / (n - 1));
+        window_[i] =
+            static_cast<float>(0.54 - 0.46 * std::cos(2.0 * kPi * i / (n - 1)));
       }
       break;
   }
 }
 
-void PitchDetector::remove_dc_offset(float* samples,
-                                     std::size_t num_samples) const noexcept {
-  if (num_samples == 0) {
-    return;
-  }
-
-  // Calculate mean
-  double mean = 0.0;
-  for (std::size_t i = 0; i < num_samples; ++i) {
-    mean += samples[i];
-  }
-  mean /= static_cast<double>(num_samples);
-
-  // Subtract mean from all samples
-  for (std::size_t i = 0; i < num_samples; ++i) {
-    samples[i] -= static_cast<float>(mean);
-  }
-}
-
-void PitchDetector::apply_window(float* samples,
-                                 std::size_t num_samples) const noexcept {
-  const std::size_t samples_to_window = std::min(num_samples, window_.size());
-
-  for (std::size_t i = 0; i < samples_to_window; ++i) {
-    samples[i] *= static_cast<float>(window_[i]);
-  }
-}
+template class BasicPitchDetector<FloatPrecision>;
+template class BasicPitchDetector<DoublePrecision>;
+template class BasicPitchDetector<MixedPrecision>;
 
 }  // namespace simple_tuner
@@ -0,0 +1,78 @@
+#include "simple_tuner/algorithms/PitchDetectorFactory.h"
+
+#include <type_traits>
+
+#include "simple_tuner/algorithms/FixedPitchDetector.h"
+#include "simple_tuner/algorithms/PitchDetector.h"
+
+namespace simple_tuner {
+
+namespace {
+// Calls fn with a null pointer of the FixedPitchDetector type matching the
+// (supported) sample rate and buffer size
+template <typename Fn>
+auto with_fixed_type(double sample_rate, std::size_t buffer_size, Fn&& fn) {
+  const bool is_44k = sample_rate == 44100.0;
+  switch (buffer_size) {
+    case 512:
+      return is_44k ? fn(static_cast<FixedPitchDetector<512, 44100>*>(nullptr))
+                    : fn(static_cast<FixedPitchDetector<512, 48000>*>(nullptr));
+    case 1024:
+      return is_44k
+                 ? fn(static_cast<FixedPitchDetector<1024, 44100>*>(nullptr))
+                 : fn(static_cast<FixedPitchDetector<1024, 48000>*>(nullptr));
+    default:
+      return is_44k
+                 ? fn(static_cast<FixedPitchDetector<4096, 44100>*>(nullptr))
+                 : fn(static_cast<FixedPitchDetector<4096, 48000>*>(nullptr));
+  }
+}
+}  // namespace
+
+std::unique_ptr<IPitchDetector> PitchDetectorFactory::create(
+    double sample_rate, std::size_t buffer_size) {
+  if (has_fixed_detector(sample_rate, buffer_size)) {
+    return with_fixed_type(
+        sample_rate, buffer_size,
+        [](auto* tag) -> std::unique_ptr<IPitchDetector> {
+          using Fixed = std::remove_pointer_t<decltype(tag)>;
+          return std::make_unique<Fixed>();
+        });
+  }
+  return std::make_unique<PitchDetector>(sample_rate, buffer_size);
+}
+
+ArenaPtr<IPitchDetector> PitchDetectorFactory::create(double sample_rate,
+                                                      std::size_t buffer_size,
+                                                      BufferArena& arena) {
+  if (has_fixed_detector(sample_rate, buffer_size)) {
+    return with_fixed_type(sample_rate, buffer_size,
+                           [&arena](auto* tag) -> ArenaPtr<IPitchDetector> {
+                             using Fixed = std::remove_pointer_t<decltype(tag)>;
+                             return make_in_arena<Fixed>(arena);
+                           });
+  }
+  return make_in_arena<PitchDetector>(arena, sample_rate, buffer_size, arena);
+}
+
+std::size_t PitchDetectorFactory::arena_bytes(
+    double sample_rate, std::size_t buffer_size) noexcept {
+  if (has_fixed_detector(sample_rate, buffer_size)) {
+    return with_fixed_type(sample_rate, buffer_size, [](auto* tag) {
+      using Fixed = std::remove_pointer_t<decltype(tag)>;
+      return BufferArena::footprint<Fixed>(1);
+    });
+  }
+  return BufferArena::footprint<PitchDetector>(1) +
+         PitchDetector::arena_bytes(sample_rate, buffer_size);
+}
+
+bool PitchDetectorFactory::has_fixed_detector(
+    double sample_rate, std::size_t buffer_size) noexcept {
+  const bool rate_supported = sample_rate == 44100.0 || sample_rate == 48000.0;
+  const bool size_supported =
+      buffer_size == 512 || buffer_size == 1024 || buffer_size == 4096;
+  return rate_supported && size_supported;
+}
+
+}  // namespace simple_tuner
@@ -0,0 +1,487 @@
+#include "simple_tuner/algorithms/StretchSolver.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace simple_tuner {
+
+namespace {
+constexpr int kNumKeys = TuningTable::kNumKeys;
+constexpr int kFirstKey = TuningTable::kFirstKey;
+constexpr int kReferenceIndex = StretchSolver::kReferenceKey - kFirstKey;
+constexpr int kMaxPartials = StretchSolver::kMaxPartials;
+constexpr double kCentsPerOctave = 1200.0;
+
+// Intervals in the cost, in semitones: octave, twelfth, double octave
+constexpr int kNumIntervals = 3;
+constexpr int kIntervals[kNumIntervals] = {12, 19, 24};
+
+// Sethares' fit of the Plomp-Levelt roughness curve
+constexpr double kRoughnessScale = 0.24;
+constexpr double kRoughnessSlope = 0.0207;
+constexpr double kRoughnessOffset = 18.96;
+constexpr double kRoughnessDecay1 = 3.51;
+constexpr double kRoughnessDecay2 = 5.75;
+constexpr double kRoughnessCutoff = 4.0;  // Scaled distance treated as 0
+
+// Curvature penalty per squared cent of second difference
+constexpr double kCurvatureWeight = 1e-5;
+
+// Candidate octave types: 2:1 up to 6:3 (or as far as the partials go) in
+// half-type steps
+constexpr double kTypeStep = 0.5;
+constexpr int kMaxOctaveType = 3;
+
+// Refinement: offsets tried per key are +-kGridSteps steps of the current
+// step; a key moves kDamping of its best offset per sweep
+constexpr double kInitialStep = 1.0;  // Cents
+constexpr double kFinalStep = 0.01;
+constexpr int kGridSteps = 4;
+constexpr double kDamping = 0.5;
+constexpr int kMaxSweeps = 400;
+
+constexpr double kMinInharmonicity = 1e-7;  // Floor for log interpolation
+
+using Curve = std::array<double, kNumKeys>;
+using Partials = std::array<double, kMaxPartials>;
+
+// Runs fn(i) for i in [0, count) on up to num_threads threads, in
+// contiguous slices; the calling thread takes the first slice (and any
+// slice a thread could not be started for)
+template <typename Fn>
+void parallel_for(std::size_t count, unsigned int num_threads, const Fn& fn) {
+  if (count == 0) {
+    return;
+  }
+  const std::size_t num_workers =
+      std::min(static_cast<std::size_t>(std::max(num_threads, 1U)), count);
+  const std::size_t per_worker = (count + num_workers - 1) / num_workers;
+  const auto run_range = [&fn](std::size_t first, std::size_t last) {
+    for (std::size_t i = first; i < last; ++i) {
+      fn(i);
+    }
+  };
+
+  std::vector<std::thread> threads;
+  const std::size_t local = std::min(per_worker, count);
+  std::size_t next = local;
+  try {
+    threads.reserve(num_workers - 1);
+    while (next < count) {
+      const std::size_t first = next;
+      const std::size_t last = std::min(first + per_worker, count);
+      threads.emplace_back(run_range, first, last);
+      next = last;
+    }
+  } catch (...) {
+    // Thread creation failed: remaining indices run on the calling thread
+  }
+  run_range(0, local);
+  run_range(next, count);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+// Roughness of all partial pairs of two tones (frequencies in Hz)
+double pair_roughness(const double* a, const double* b, const double* amp,
+                      int num_partials) noexcept {
+  double sum = 0.0;
+  for (int m = 0; m < num_partials; ++m) {
+    for (int n = 0; n < num_partials; ++n) {
+      const double low = std::min(a[m], b[n]);
+      const double x = kRoughnessScale * std::abs(a[m] - b[n]) /
+                       (kRoughnessSlope * low + kRoughnessOffset);
+      if (x < kRoughnessCutoff) {
+        sum += amp[m] * amp[n] *
+               (std::exp(-kRoughnessDecay1 * x) -
+                std::exp(-kRoughnessDecay2 * x));
+      }
+    }
+  }
+  return sum;
+}
+
+// Keyboard model for one solve: partial ratios and amplitudes per key
+class Problem {
+ public:
+  Problem(double reference_a4, int num_partials,
+          const double (&weights)[kNumIntervals], unsigned int num_threads)
+      : num_partials_(num_partials),
+        num_threads_(num_threads),
+        weights_{weights[0], weights[1], weights[2]} {
+    for (int k = 0; k < kNumKeys; ++k) {
+      base_hz_[static_cast<std::size_t>(k)] =
+          reference_a4 * std::exp2((k - kReferenceIndex) / 12.0);
+    }
+    for (int n = 0; n < kMaxPartials; ++n) {
+      amplitude_[static_cast<std::size_t>(n)] = 1.0 / (n + 1);
+    }
+  }
+
+  // ratios[n]: partial n + 1 over partial 1
+  void set_key(int k, const Partials& ratios) noexcept {
+    ratio_[static_cast<std::size_t>(k)] = ratios;
+  }
+
+  // Stretch of partial n (1-based) beyond harmonic, in cents
+  double stretch_cents(int k, int n) const noexcept {
+    return kCentsPerOctave *
+           std::log2(ratio_[static_cast<std::size_t>(k)]
+                           [static_cast<std::size_t>(n - 1)] /
+                     n);
+  }
+
+  // Offset between key lo and lo + 12 that makes partial 2t of lo meet
+  // partial t of lo + 12; fractional types blend the neighbouring ones
+  double octave_step(int lo, double type) const noexcept {
+    const int whole = static_cast<int>(type);
+    const double fraction = type - whole;
+    const auto step = [this, lo](int t) {
+      return stretch_cents(lo, 2 * t) - stretch_cents(lo + 12, t);
+    };
+    const double low = step(whole);
+    return fraction > 0.0 ? low + fraction * (step(whole + 1) - low) : low;
+  }
+
+  // Octave-type curve: the type runs linearly from middle at A4 to bass at
+  // A0 and treble at C8; A3..A4 is interpolated, the rest chains octaves
+  void build_candidate(double bass, double middle, double treble,
+                       Curve& curve) const noexcept {
+    const auto type_at = [=](int k) {
+      if (k < kReferenceIndex) {
+        return middle + (bass - middle) * (kReferenceIndex - k) /
+                            static_cast<double>(kReferenceIndex);
+      }
+      return middle + (treble - middle) * (k - kReferenceIndex) /
+                          static_cast<double>(kNumKeys - 1 - kReferenceIndex);
+    };
+    curve[kReferenceIndex] = 0.0;
+    const int a3 = kReferenceIndex - 12;
+    curve[a3] = -octave_step(a3, type_at(a3));
+    for (int k = a3 + 1; k < kReferenceIndex; ++k) {
+      curve[static_cast<std::size_t>(k)] = curve[a3] * (kReferenceIndex - k) /
+                                           12.0;
+    }
+    for (int k = kReferenceIndex + 1; k < kNumKeys; ++k) {
+      curve[static_cast<std::size_t>(k)] =
+          curve[static_cast<std::size_t>(k - 12)] +
+          octave_step(k - 12, type_at(k));
+    }
+    for (int k = a3 - 1; k >= 0; --k) {
+      curve[static_cast<std::size_t>(k)] =
+          curve[static_cast<std::size_t>(k + 12)] -
+          octave_step(k, type_at(k));
+    }
+  }
+
+  // Partial frequencies of key k offset by cents
+  void partials(int k, double cents, double* out) const noexcept {
+    const double f1 =
+        base_hz_[static_cast<std::size_t>(k)] * std::exp2(cents / 1200.0);
+    for (int n = 0; n < num_partials_; ++n) {
+      out[n] = f1 * ratio_[static_cast<std::size_t>(k)]
+                          [static_cast<std::size_t>(n)];
+    }
+  }
+
+  // Partial frequencies of every key under curve
+  void all_partials(const Curve& curve,
+                    std::array<Partials, kNumKeys>& out) const noexcept {
+    for (int k = 0; k < kNumKeys; ++k) {
+      partials(k, curve[static_cast<std::size_t>(k)],
+               out[static_cast<std::size_t>(k)].data());
+    }
+  }
+
+  // Curvature penalty at key k, with key moved to cents
+  static double curvature(const Curve& curve, int k, int moved = -1,
+                          double cents = 0.0) noexcept {
+    const auto at = [&](int j) {
+      return j == moved ? cents : curve[static_cast<std::size_t>(j)];
+    };
+    const double d = at(k - 1) - 2.0 * at(k) + at(k + 1);
+    return kCurvatureWeight * d * d;
+  }
+
+  // Roughness of the intervals above key k plus the curvature at k
+  double upper_cost(const Curve& curve,
+                    const std::array<Partials, kNumKeys>& partials,
+                    int k) const noexcept {
+    double sum = 0.0;
+    for (int i = 0; i < kNumIntervals; ++i) {
+      const int upper = k + kIntervals[i];
+      if (upper < kNumKeys && weights_[i] > 0.0) {
+        sum += weights_[i] *
+               pair_roughness(partials[static_cast<std::size_t>(k)].data(),
+                              partials[static_cast<std::size_t>(upper)].data(),
+                              amplitude_.data(), num_partials_);
+      }
+    }
+    if (k > 0 && k < kNumKeys - 1) {
+      sum += curvature(curve, k);
+    }
+    return sum;
+  }
+
+  // Total cost; per-key terms run in parallel and are summed in key order
+  double cost(const Curve& curve, unsigned int num_threads) const {
+    std::array<Partials, kNumKeys> partials;
+    all_partials(curve, partials);
+    std::array<double, kNumKeys> terms;
+    parallel_for(kNumKeys, num_threads, [&](std::size_t k) {
+      terms[k] = upper_cost(curve, partials, static_cast<int>(k));
+    });
+    double sum = 0.0;
+    for (double term : terms) {
+      sum += term;
+    }
+    return sum;
+  }
+
+  // Every term of the cost that involves key k, with k at cents
+  double local_cost(const Curve& curve,
+                    const std::array<Partials, kNumKeys>& partials, int k,
+                    double cents) const noexcept {
+    double own[kMaxPartials];
+    this->partials(k, cents, own);
+    double sum = 0.0;
+    for (int i = 0; i < kNumIntervals; ++i) {
+      if (weights_[i] <= 0.0) {
+        continue;
+      }
+      for (int other : {k - kIntervals[i], k + kIntervals[i]}) {
+        if (other >= 0 && other < kNumKeys) {
+          sum += weights_[i] *
+                 pair_roughness(
+                     own, partials[static_cast<std::size_t>(other)].data(),
+                     amplitude_.data(), num_partials_);
+        }
+      }
+    }
+    for (int j = std::max(k - 1, 1); j <= std::min(k + 1, kNumKeys - 2);
+         ++j) {
+      sum += curvature(curve, j, k, cents);
+    }
+    return sum;
+  }
+
+  unsigned int num_threads() const noexcept { return num_threads_; }
+
+ private:
+  int num_partials_;
+  unsigned int num_threads_;
+  double weights_[kNumIntervals];
+  std::array<double, kNumKeys> base_hz_{};  // Equal-tempered partial 1
+  std::array<Partials, kNumKeys> ratio_{};
+  Partials amplitude_{};
+};
+
+// Stage 2: damped Jacobi sweeps from curve; returns the sweeps accepted
+int refine(const Problem& problem, Curve& curve, double& cost) {
+  std::array<Partials, kNumKeys> partials;
+  std::array<double, kNumKeys> best_offset;
+  int accepted = 0;
+  double step = kInitialStep;
+  for (int sweep = 0; sweep < kMaxSweeps && step >= kFinalStep; ++sweep) {
+    problem.all_partials(curve, partials);
+    parallel_for(kNumKeys, problem.num_threads(), [&](std::size_t k) {
+      best_offset[k] = 0.0;
+      if (static_cast<int>(k) == kReferenceIndex) {
+        return;
+      }
+      double best = problem.local_cost(curve, partials, static_cast<int>(k),
+                                       curve[k]);
+      for (int g = -kGridSteps; g <= kGridSteps; ++g) {
+        if (g == 0) {
+          continue;
+        }
+        const double offset = g * step;
+        const double value = problem.local_cost(
+            curve, partials, static_cast<int>(k), curve[k] + offset);
+        if (value < best) {
+          best = value;
+          best_offset[k] = offset;
+        }
+      }
+    });
+
+    Curve trial = curve;
+    for (std::size_t k = 0; k < trial.size(); ++k) {
+      trial[k] += kDamping * best_offset[k];
+    }
+    const double trial_cost = problem.cost(trial, problem.num_threads());
+    if (trial_cost < cost) {
+      curve = trial;
+      cost = trial_cost;
+      ++accepted;
+    } else {
+      step *= 0.5;
+    }
+  }
+  return accepted;
+}
+}  // namespace
+
+StretchSolver::StretchSolver(double reference_a4) noexcept
+    : reference_a4_(reference_a4 > 0.0 ? reference_a4 : 440.0),
+      num_partials_(kDefaultPartials),
+      octave_weight_(1.0),
+      twelfth_weight_(0.5),
+      double_octave_weight_(0.5),
+      num_threads_(0),
+      keys_() {}
+
+void StretchSolver::set_reference_a4(double frequency) noexcept {
+  if (frequency > 0.0) {
+    reference_a4_ = frequency;
+  }
+}
+
+void StretchSolver::set_measurement(
+    int midi_note, const InharmonicityResult& result) noexcept {
+  if (!in_range(midi_note) || !result.is_valid ||
+      result.inharmonicity < 0.0) {
+    return;
+  }
+  Key& key = keys_[static_cast<std::size_t>(midi_note - kFirstKey)];
+  key = Key();
+  key.inharmonicity = result.inharmonicity;
+  key.measured = true;
+  const double first = result.partials[0];
+  if (first > 0.0) {
+    for (std::size_t n = 0; n < key.ratios.size(); ++n) {
+      key.ratios[n] = result.partials[n] / first;
+    }
+  }
+}
+
+void StretchSolver::set_inharmonicity(int midi_note,
+                                      double inharmonicity) noexcept {
+  if (!in_range(midi_note) || !(inharmonicity >= 0.0)) {
+    return;
+  }
+  Key& key = keys_[static_cast<std::size_t>(midi_note - kFirstKey)];
+  key = Key();
+  key.inharmonicity = inharmonicity;
+  key.measured = true;
+}
+
+void StretchSolver::clear_key(int midi_note) noexcept {
+  if (in_range(midi_note)) {
+    keys_[static_cast<std::size_t>(midi_note - kFirstKey)] = Key();
+  }
+}
+
+void StretchSolver::clear() noexcept { keys_.fill(Key()); }
+
+int StretchSolver::measured_keys() const noexcept {
+  return static_cast<int>(
+      std::count_if(keys_.begin(), keys_.end(),
+                    [](const Key& key) { return key.measured; }));
+}
+
+void StretchSolver::set_num_partials(int num_partials) noexcept {
+  num_partials_ = std::clamp(num_partials, 2, kMaxPartials);
+}
+
+void StretchSolver::set_interval_weights(double octave, double twelfth,
+                                         double double_octave) noexcept {
+  octave_weight_ = std::max(octave, 0.0);
+  twelfth_weight_ = std::max(twelfth, 0.0);
+  double_octave_weight_ = std::max(double_octave, 0.0);
+}
+
+void StretchSolver::set_num_threads(unsigned int num_threads) noexcept {
+  num_threads_ = num_threads;
+}
+
+StretchCurve StretchSolver::solve() const {
+  StretchCurve result;
+  if (measured_keys() < kMinMeasuredKeys) {
+    return result;
+  }
+  unsigned int num_threads = num_threads_;
+  if (num_threads == 0) {
+    num_threads = std::max(std::thread::hardware_concurrency(), 1U);
+  }
+
+  // Key model: B log-interpolated between measured keys (held beyond the
+  // outermost), measured partial ratios where present
+  const double weights[kNumIntervals] = {octave_weight_, twelfth_weight_,
+                                         double_octave_weight_};
+  Problem problem(reference_a4_, num_partials_, weights, num_threads);
+  const auto log_b = [this](int index) {
+    return std::log(std::max(
+        keys_[static_cast<std::size_t>(index)].inharmonicity,
+        kMinInharmonicity));
+  };
+  int previous = -1;
+  for (int k = 0; k < kNumKeys; ++k) {
+    int next = k;
+    while (next < kNumKeys && !keys_[static_cast<std::size_t>(next)].measured) {
+      ++next;
+    }
+    double inharmonicity = 0.0;
+    if (next == k) {
+      previous = k;
+      inharmonicity = keys_[static_cast<std::size_t>(k)].inharmonicity;
+    } else if (previous < 0 || next == kNumKeys) {
+      inharmonicity =
+          keys_[static_cast<std::size_t>(previous < 0 ? next : previous)]
+              .inharmonicity;
+    } else {
+      const double t = static_cast<double>(k - previous) / (next - previous);
+      inharmonicity = std::exp(log_b(previous) +
+                               t * (log_b(next) - log_b(previous)));
+    }
+    Partials ratios{};
+    const Key& key = keys_[static_cast<std::size_t>(k)];
+    for (int n = 1; n <= kMaxPartials; ++n) {
+      const double measured = key.ratios[static_cast<std::size_t>(n - 1)];
+      ratios[static_cast<std::size_t>(n - 1)] =
+          measured > 0.0 ? measured
+                         : n * std::sqrt((1.0 + inharmonicity * n * n) /
+                                         (1.0 + inharmonicity));
+    }
+    problem.set_key(k, ratios);
+  }
+
+  // Stage 1: octave-type candidates, scored in parallel
+  const int max_type = std::min(num_partials_ / 2, kMaxOctaveType);
+  const int max_type_steps =
+      static_cast<int>(std::lround((max_type - 1) / kTypeStep));
+  const int types = max_type_steps + 1;
+  const auto num_candidates = static_cast<std::size_t>(types * types * types);
+  std::vector<double> candidate_cost(num_candidates);
+  parallel_for(num_candidates, num_threads, [&](std::size_t c) {
+    const auto index = static_cast<int>(c);
+    Curve curve;
+    problem.build_candidate(1.0 + kTypeStep * (index / (types * types)),
+                            1.0 + kTypeStep * (index / types % types),
+                            1.0 + kTypeStep * (index % types), curve);
+    candidate_cost[c] = problem.cost(curve, 1);
+  });
+  const auto best = static_cast<int>(
+      std::min_element(candidate_cost.begin(), candidate_cost.end()) -
+      candidate_cost.begin());
+  result.bass_octave = 1.0 + kTypeStep * (best / (types * types));
+  result.middle_octave = 1.0 + kTypeStep * (best / types % types);
+  result.treble_octave = 1.0 + kTypeStep * (best % types);
+
+  // Stage 2: per-key refinement
+  Curve curve;
+  problem.build_candidate(result.bass_octave, result.middle_octave,
+                          result.treble_octave, curve);
+  double cost = candidate_cost[static_cast<std::size_t>(best)];
+  result.sweeps = refine(problem, curve, cost);
+  result.cents = curve;
+  result.roughness = cost;
+  result.is_valid = true;
+  return result;
+}
+
+}  // namespace simple_tuner
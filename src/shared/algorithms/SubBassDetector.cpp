@@ -0,0 +1,279 @@
+#include "simple_tuner/algorithms/SubBassDetector.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "simple_tuner/algorithms/MpmPeakPicking.h"
+#include "simple_tuner/dsp/BlockOps.h"
+
+namespace simple_tuner {
+
+namespace {
+constexpr double kPi = 3.14159265358979323846;
+constexpr double kDefaultThresholdDb = -50.0;
+constexpr double kDefaultMinPeak = 0.3;
+constexpr double kCutoffRatio = 0.2;  // Low-pass cutoff / decimated rate
+// Q of the two sections of a 4th-order Butterworth low-pass
+constexpr double kSectionQ[] = {0.54119610014619698, 1.30656296487637653};
+// Score a longer candidate period must gain over a shorter one to replace
+// it (guards against reporting a sub-octave of a periodic signal)
+constexpr double kSubOctaveMargin = 0.1;
+constexpr int kSecondPeakRadius = 2;  // Search around 2T for its peak
+constexpr double kEpsilon = 1e-10;
+
+std::size_t next_power_of_two(std::size_t value) noexcept {
+  std::size_t result = 1;
+  while (result < value) {
+    result <<= 1;
+  }
+  return result;
+}
+}  // namespace
+
+SubBassDetector::SubBassDetector(double sample_rate)
+    : SubBassDetector(sample_rate, nullptr) {}
+
+SubBassDetector::SubBassDetector(double sample_rate, BufferArena& arena)
+    : SubBassDetector(sample_rate, &arena) {}
+
+SubBassDetector::SubBassDetector(double sample_rate, BufferArena* arena)
+    : sample_rate_(sample_rate > 0.0 ? sample_rate : 48000.0),
+      decimation_(decimation_for(sample_rate_)),
+      decimated_rate_(sample_rate_ / decimation_),
+      window_length_(window_length_for(sample_rate_)),
+      history_mask_(history_length_for(sample_rate_) - 1),
+      lag_capacity_(max_lag_for(sample_rate_)),
+      threshold_db_(kDefaultThresholdDb),
+      min_freq_(kDefaultMinFrequency),
+      max_freq_(kDefaultMaxFrequency),
+      min_peak_(kDefaultMinPeak),
+      sections_(),
+      phase_(0),
+      write_index_(0),
+      filled_(0),
+      history_(ArenaAllocator<float>(arena)),
+      working_(ArenaAllocator<float>(arena)),
+      energy_(ArenaAllocator<double>(arena)),
+      nsdf_(ArenaAllocator<double>(arena)) {
+  // Buffers in the order detect() touches them
+  history_.resize(history_mask_ + 1, 0.0f);
+  working_.resize(window_length_, 0.0f);
+  energy_.resize(window_length_ + 1, 0.0);
+  nsdf_.resize(static_cast<std::size_t>(2 * lag_capacity_ + 4), 0.0);
+
+  // RBJ low-pass sections at the input rate
+  const double omega =
+      2.0 * kPi * kCutoffRatio * decimated_rate_ / sample_rate_;
+  for (int s = 0; s < kNumSections; ++s) {
+    const double alpha = std::sin(omega) / (2.0 * kSectionQ[s]);
+    const double cos_omega = std::cos(omega);
+    const double a0 = 1.0 + alpha;
+    Biquad& section = sections_[s];
+    section.b0 = (1.0 - cos_omega) / (2.0 * a0);
+    section.b1 = (1.0 - cos_omega) / a0;
+    section.b2 = section.b0;
+    section.a1 = -2.0 * cos_omega / a0;
+    section.a2 = (1.0 - alpha) / a0;
+  }
+  reset();
+}
+
+int SubBassDetector::decimation_for(double sample_rate) noexcept {
+  return std::max(1, static_cast<int>(
+                         std::lround(sample_rate / kTargetDecimatedRate)));
+}
+
+std::size_t SubBassDetector::window_length_for(double sample_rate) noexcept {
+  const double decimated_rate = sample_rate / decimation_for(sample_rate);
+  // At least two of the longest periods plus the 2T search radius
+  const auto min_length =
+      static_cast<std::size_t>(2 * max_lag_for(sample_rate) + 8);
+  return std::max(
+      static_cast<std::size_t>(std::lround(kWindowSeconds * decimated_rate)),
+      min_length);
+}
+
+std::size_t SubBassDetector::history_length_for(double sample_rate) noexcept {
+  return next_power_of_two(window_length_for(sample_rate));
+}
+
+int SubBassDetector::max_lag_for(double sample_rate) noexcept {
+  const double decimated_rate = sample_rate / decimation_for(sample_rate);
+  return static_cast<int>(std::ceil(decimated_rate / kLowestFrequency));
+}
+
+std::size_t SubBassDetector::arena_bytes(double sample_rate) noexcept {
+  if (!(sample_rate > 0.0)) {
+    sample_rate = 48000.0;
+  }
+  return BufferArena::footprint<float>(history_length_for(sample_rate)) +
+         BufferArena::footprint<float>(window_length_for(sample_rate)) +
+         BufferArena::footprint<double>(window_length_for(sample_rate) + 1) +
+         BufferArena::footprint<double>(
+             static_cast<std::size_t>(2 * max_lag_for(sample_rate) + 4));
+}
+
+void SubBassDetector::reset() noexcept {
+  for (Biquad& section : sections_) {
+    section.z1 = 0.0;
+    section.z2 = 0.0;
+  }
+  phase_ = 0;
+  write_index_ = 0;
+  filled_ = 0;
+}
+
+void SubBassDetector::push_samples(const float* samples,
+                                   std::size_t num_samples) noexcept {
+  if (samples == nullptr) {
+    return;
+  }
+  for (std::size_t i = 0; i < num_samples; ++i) {
+    double y = samples[i];
+    for (Biquad& s : sections_) {
+      const double out = s.b0 * y + s.z1;
+      s.z1 = s.b1 * y - s.a1 * out + s.z2;
+      s.z2 = s.b2 * y - s.a2 * out;
+      y = out;
+    }
+    if (++phase_ == decimation_) {
+      phase_ = 0;
+      history_[write_index_] = static_cast<float>(y);
+      write_index_ = (write_index_ + 1) & history_mask_;
+      filled_ = std::min(filled_ + 1, window_length_);
+    }
+  }
+}
+
+DetectionResult SubBassDetector::detect() noexcept {
+  const std::size_t n = window_length_;
+  if (filled_ < n || min_freq_ >= max_freq_) {
+    return DetectionResult(0.0, 0.0, false);
+  }
+
+  // Linearize the newest window and remove its mean
+  const std::size_t start = (write_index_ - n) & history_mask_;
+  for (std::size_t i = 0; i < n; ++i) {
+    working_[i] = history_[(start + i) & history_mask_];
+  }
+  const dsp::BlockStats stats = dsp::block_stats(working_.data(), n);
+  const double mean = stats.sum / static_cast<double>(n);
+  dsp::subtract(working_.data(), n, static_cast<float>(mean));
+  const double energy = stats.sum_squares - stats.sum * mean;
+  if (std::sqrt(std::max(energy, 0.0) / static_cast<double>(n)) <
+      std::pow(10.0, threshold_db_ / 20.0)) {
+    return DetectionResult(0.0, 0.0, false);
+  }
+
+  // Prefix energies: the NSDF normalizer m(lag) is energy[n - lag] +
+  // (energy[n] - energy[lag])
+  energy_[0] = 0.0;
+  for (std::size_t i = 0; i < n; ++i) {
+    energy_[i + 1] =
+        energy_[i] + static_cast<double>(working_[i]) * working_[i];
+  }
+
+  // NSDF over the candidate periods and their second repetitions
+  const int max_lag = std::min(
+      lag_capacity_, static_cast<int>(std::ceil(decimated_rate_ / min_freq_)));
+  const int min_lag =
+      std::max(2, static_cast<int>(decimated_rate_ / max_freq_));
+  const int last_lag = 2 * max_lag + kSecondPeakRadius + 1;
+  const float* x = working_.data();
+  for (int lag = min_lag - 1; lag <= last_lag; ++lag) {
+    const auto offset = static_cast<std::size_t>(lag);
+    const double r = dsp::dot_product(x, x + offset, n - offset);
+    const double m = energy_[n - offset] + (energy_[n] - energy_[offset]);
+    nsdf_[offset] = m > kEpsilon ? 2.0 * r / m : 0.0;
+  }
+
+  // Score every candidate period on both repetitions; a longer period
+  // wins only with a clearly better score
+  double best_score = -1.0;
+  double best_period = 0.0;
+  const double* nsdf = nsdf_.data();
+  for (int lag = min_lag; lag <= max_lag; ++lag) {
+    if (!(nsdf[lag] > nsdf[lag - 1] && nsdf[lag] >= nsdf[lag + 1]) ||
+        nsdf[lag] < min_peak_) {
+      continue;
+    }
+    const double period =
+        mpm::parabolic_interpolation(nsdf, last_lag + 1, lag);
+    const int second =
+        peak_near(static_cast<int>(std::lround(2.0 * period)),
+                  kSecondPeakRadius, last_lag);
+    const double second_nsdf = second > 0 ? std::max(nsdf[second], 0.0) : 0.0;
+    const double score = 0.5 * (nsdf[lag] + second_nsdf);
+    if (best_score >= 0.0 && score <= best_score + kSubOctaveMargin) {
+      continue;
+    }
+    best_score = score;
+    // Least-squares fit of T to the peaks at T and 2T
+    const double second_period =
+        second > 0 ? mpm::parabolic_interpolation(nsdf, last_lag + 1, second)
+                   : 2.0 * period;
+    best_period = (period + 2.0 * second_period) / 5.0;
+  }
+
+  if (best_score < 0.0 || best_period <= 0.0) {
+    return DetectionResult(0.0, 0.0, false);
+  }
+  const double frequency = decimated_rate_ / best_period;
+  if (frequency < min_freq_ || frequency > max_freq_) {
+    return DetectionResult(0.0, 0.0, false);
+  }
+  return DetectionResult(frequency, std::clamp(best_score, 0.0, 1.0), true);
+}
+
+int SubBassDetector::peak_near(int lag, int radius,
+                               int last_lag) const noexcept {
+  int best = -1;
+  for (int candidate = std::max(lag - radius, 1);
+       candidate <= std::min(lag + radius, last_lag - 1); ++candidate) {
+    const double value = nsdf_[static_cast<std::size_t>(candidate)];
+    const bool is_peak =
+        value >= nsdf_[static_cast<std::size_t>(candidate - 1)] &&
+        value >= nsdf_[static_cast<std::size_t>(candidate + 1)];
+    if (is_peak && (best < 0 || std::abs(candidate - lag) <
+                                    std::abs(best - lag))) {
+      best = candidate;
+    }
+  }
+  return best;
+}
+
+DetectionResult SubBassDetector::detect_pitch_detailed(
+    const float* samples, std::size_t num_samples) noexcept {
+  if (samples == nullptr || num_samples == 0) {
+    return DetectionResult(0.0, 0.0, false);
+  }
+  reset();
+  push_samples(samples, num_samples);
+  return detect();
+}
+
+void SubBassDetector::set_threshold_db(double threshold_db) noexcept {
+  threshold_db_ = threshold_db;
+}
+
+void SubBassDetector::set_min_frequency(double min_freq) noexcept {
+  if (min_freq > 0.0) {
+    min_freq_ = std::max(min_freq, kLowestFrequency);
+  }
+}
+
+void SubBassDetector::set_max_frequency(double max_freq) noexcept {
+  if (max_freq > 0.0) {
+    max_freq_ = max_freq;
+  }
+}
+
+void SubBassDetector::set_window_type(WindowType type) noexcept {
+  (void)type;
+}
+
+void SubBassDetector::set_base_clarity_threshold(double threshold) noexcept {
+  min_peak_ = threshold;
+}
+
+}  // namespace simple_tuner
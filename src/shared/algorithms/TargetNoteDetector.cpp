@@ -0,0 +1,341 @@
+#include "simple_tuner/algorithms/TargetNoteDetector.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "simple_tuner/dsp/BlockOps.h"
+
+namespace simple_tuner {
+
+namespace {
+constexpr double kPi = 3.14159265358979323846;
+constexpr double kTwoPi = 2.0 * kPi;
+constexpr double kDefaultThresholdDb = -50.0;
+constexpr double kDefaultMinFrequency = 27.5;    // A0
+constexpr double kDefaultMaxFrequency = 4186.0;  // C8
+constexpr double kDefaultEnergyFraction = 0.2;
+constexpr double kMaxInharmonicity = 0.05;
+constexpr double kBandLimit = 0.45;  // Fraction of the sample rate
+// Partials weaker than this fraction of the strongest are not averaged in
+constexpr double kMinRelativePower = 0.01;
+constexpr int kDefaultPartials = 4;
+// Partial spacing, in full-frame bins, the half-frame refinement resolves
+constexpr double kResolvingBins = 8.0;
+
+std::size_t frame_length(std::size_t buffer_size) noexcept {
+  return std::max<std::size_t>(buffer_size & ~std::size_t{1}, 4);
+}
+
+void fill_hann(float* window, std::size_t length) noexcept {
+  for (std::size_t i = 0; i < length; ++i) {
+    window[i] = static_cast<float>(
+        0.5 * (1.0 - std::cos(kTwoPi * static_cast<double>(i) /
+                              static_cast<double>(length))));
+  }
+}
+
+// Hann magnitude response (peak-normalized) at an offset in bins. The
+// strongest point of a one-bin grid is within half a bin of a sinusoid, so
+// larger offsets (noise) are clamped and the correction stays below 1.5 dB.
+double hann_gain(double offset) noexcept {
+  const double d = std::min(std::abs(offset), 0.5);
+  if (d < 1e-9) {
+    return 1.0;
+  }
+  return std::sin(kPi * d) / (kPi * d * (1.0 - d * d));
+}
+
+// Wraps a phase to (-pi, pi]
+double wrap_phase(double phase) noexcept {
+  return phase - kTwoPi * std::floor((phase + kPi) / kTwoPi);
+}
+}  // namespace
+
+TargetNoteDetector::TargetNoteDetector(double sample_rate,
+                                       std::size_t buffer_size)
+    : TargetNoteDetector(sample_rate, buffer_size, nullptr) {}
+
+TargetNoteDetector::TargetNoteDetector(double sample_rate,
+                                       std::size_t buffer_size,
+                                       BufferArena& arena)
+    : TargetNoteDetector(sample_rate, buffer_size, &arena) {}
+
+TargetNoteDetector::TargetNoteDetector(double sample_rate,
+                                       std::size_t buffer_size,
+                                       BufferArena* arena)
+    : sample_rate_(sample_rate > 0.0 ? sample_rate : 48000.0),
+      buffer_size_(frame_length(buffer_size)),
+      threshold_db_(kDefaultThresholdDb),
+      min_freq_(kDefaultMinFrequency),
+      max_freq_(kDefaultMaxFrequency),
+      min_energy_fraction_(kDefaultEnergyFraction),
+      target_(0.0),
+      inharmonicity_(0.0),
+      num_partials_(kDefaultPartials),
+      window_(ArenaAllocator<float>(arena)),
+      half_window_(ArenaAllocator<float>(arena)),
+      frame_(ArenaAllocator<float>(arena)),
+      first_half_(ArenaAllocator<float>(arena)),
+      second_half_(ArenaAllocator<float>(arena)) {
+  const std::size_t half = buffer_size_ / 2;
+  window_.resize(buffer_size_);
+  half_window_.resize(half);
+  frame_.resize(buffer_size_);
+  first_half_.resize(half);
+  second_half_.resize(half);
+  // Periodic Hann: its DFT phase at any frequency refers to the frame
+  // center, which the refinement relies on
+  fill_hann(window_.data(), buffer_size_);
+  fill_hann(half_window_.data(), half);
+}
+
+std::size_t TargetNoteDetector::arena_bytes(std::size_t buffer_size) noexcept {
+  const std::size_t size = frame_length(buffer_size);
+  return 2 * BufferArena::footprint<float>(size) +
+         3 * BufferArena::footprint<float>(size / 2);
+}
+
+double TargetNoteDetector::min_target(double sample_rate,
+                                      std::size_t buffer_size) noexcept {
+  const double rate = sample_rate > 0.0 ? sample_rate : 48000.0;
+  return kResolvingBins * rate /
+         static_cast<double>(frame_length(buffer_size));
+}
+
+void TargetNoteDetector::set_target(double frequency) noexcept {
+  target_ = frequency > 0.0 ? frequency : 0.0;
+}
+
+void TargetNoteDetector::set_inharmonicity(double inharmonicity) noexcept {
+  inharmonicity_ = std::clamp(inharmonicity, 0.0, kMaxInharmonicity);
+}
+
+void TargetNoteDetector::set_num_partials(int num_partials) noexcept {
+  num_partials_ = std::clamp(num_partials, 1, kMaxPartials);
+}
+
+void TargetNoteDetector::run_bank(const float* frame, std::size_t length,
+                                  const double* coeff, int count,
+                                  State* states) noexcept {
+  // kLanes resonators per pass over the frame: independent chains hide the
+  // latency of each one's recurrence (a single Goertzel is latency-bound)
+  constexpr int kLanes = 24;
+  for (int first = 0; first < count; first += kLanes) {
+    double c[kLanes];
+    double s1[kLanes] = {};
+    double s2[kLanes] = {};
+    for (int k = 0; k < kLanes; ++k) {
+      c[k] = coeff[std::min(first + k, count - 1)];
+    }
+    // Two samples per step with s1 and s2 trading roles, so each update is
+    // in place (no register shuffling between lanes)
+    std::size_t i = 0;
+    for (; i + 1 < length; i += 2) {
+      const double x0 = frame[i];
+      const double x1 = frame[i + 1];
+      for (int k = 0; k < kLanes; ++k) {
+        s2[k] = x0 + c[k] * s1[k] - s2[k];
+      }
+      for (int k = 0; k < kLanes; ++k) {
+        s1[k] = x1 + c[k] * s2[k] - s1[k];
+      }
+    }
+    if (i < length) {
+      const double x = frame[i];
+      for (int k = 0; k < kLanes; ++k) {
+        const double s0 = x + c[k] * s1[k] - s2[k];
+        s2[k] = s1[k];
+        s1[k] = s0;
+      }
+    }
+    for (int k = 0; k < kLanes && first + k < count; ++k) {
+      states[first + k] = State{s1[k], s2[k]};
+    }
+  }
+}
+
+TargetNoteDetector::Bin TargetNoteDetector::to_bin(
+    State state, double omega, std::size_t length) noexcept {
+  // Closing rotation of the Goertzel state to sum x[i] e^{-j w i}
+  const double re = state.s1 - state.s2 * std::cos(omega);
+  const double im = state.s2 * std::sin(omega);
+  const double end_phase = -omega * static_cast<double>(length - 1);
+  const double c = std::cos(end_phase);
+  const double s = std::sin(end_phase);
+  return Bin{re * c - im * s, re * s + im * c};
+}
+
+DetectionResult TargetNoteDetector::detect_pitch_detailed(
+    const float* samples, std::size_t num_samples) noexcept {
+  if (samples == nullptr || num_samples < buffer_size_ || target_ <= 0.0 ||
+      target_ < min_target(sample_rate_, buffer_size_)) {
+    return DetectionResult(0.0, 0.0, false);
+  }
+
+  // Mean removal, level check and the three windowed copies
+  const std::size_t length = buffer_size_;
+  const std::size_t half = length / 2;
+  const dsp::BlockStats stats = dsp::preprocess_frame(
+      samples, window_.data(), frame_.data(), length);
+  const double mean = stats.sum / static_cast<double>(length);
+  const double mean_square =
+      std::max(stats.sum_squares / static_cast<double>(length) - mean * mean,
+               0.0);
+  if (std::sqrt(mean_square) < std::pow(10.0, threshold_db_ / 20.0)) {
+    return DetectionResult(0.0, 0.0, false);
+  }
+  const auto mean_f = static_cast<float>(mean);
+  for (std::size_t i = 0; i < half; ++i) {
+    first_half_[i] = (samples[i] - mean_f) * half_window_[i];
+    second_half_[i] = (samples[half + i] - mean_f) * half_window_[i];
+  }
+
+  // Coarse grid for every partial: one-bin spacing over +-kSearchCents (the
+  // refinement is unambiguous within a bin of the grid point)
+  const double bin = sample_rate_ / static_cast<double>(length);
+  const double ratio = std::exp2(kSearchCents / 1200.0);
+  double stretch[kMaxPartials];
+  double low[kMaxPartials];
+  double step[kMaxPartials];
+  int first_point[kMaxPartials + 1];
+  double coeff[kMaxPartials * kMaxGridPoints];
+  int count = 0;
+  for (int p = 0; p < num_partials_; ++p) {
+    const double n = p + 1.0;
+    stretch[p] = std::sqrt((1.0 + inharmonicity_ * n * n) /
+                           (1.0 + inharmonicity_));
+    const double expected = n * target_ * stretch[p];
+    low[p] = expected / ratio;
+    const double high =
+        std::min(expected * ratio, kBandLimit * sample_rate_);
+    first_point[p] = count;
+    if (expected < min_freq_ || expected > max_freq_ || high <= low[p]) {
+      continue;  // No grid points: partial skipped
+    }
+    const int points =
+        std::clamp(static_cast<int>(std::ceil((high - low[p]) / bin)) + 1, 2,
+                   kMaxGridPoints);
+    step[p] = (high - low[p]) / (points - 1);
+    for (int k = 0; k < points; ++k) {
+      coeff[count++] =
+          2.0 * std::cos(kTwoPi * (low[p] + k * step[p]) / sample_rate_);
+    }
+  }
+  first_point[num_partials_] = count;
+  if (count == 0) {
+    return DetectionResult(0.0, 0.0, false);
+  }
+
+  State states[kMaxPartials * kMaxGridPoints];
+  run_bank(frame_.data(), length, coeff, count, states);
+
+  // Per partial: strongest grid point and its power. Hann over N has gain
+  // N / 2: a sinusoid of amplitude A gives |X| = A N / 4 and a mean square
+  // of A^2 / 2 = 8 |X|^2 / N^2.
+  const double n_squared = static_cast<double>(length) * length;
+  double powers[kMaxPartials];
+  double omegas[kMaxPartials];
+  double half_coeff[kMaxPartials];
+  int measured[kMaxPartials];
+  int num_measured = 0;
+  double strongest = 0.0;
+  double total_power = 0.0;
+  for (int p = 0; p < num_partials_; ++p) {
+    int best = -1;
+    double best_magnitude = 0.0;
+    for (int k = first_point[p]; k < first_point[p + 1]; ++k) {
+      const State& st = states[k];
+      const double magnitude =
+          st.s1 * st.s1 + st.s2 * st.s2 - coeff[k] * st.s1 * st.s2;
+      if (best < 0 || magnitude > best_magnitude) {
+        best = k;
+        best_magnitude = magnitude;
+      }
+    }
+    if (best < 0) {
+      continue;
+    }
+    const double power = 8.0 * std::max(best_magnitude, 0.0) / n_squared;
+    const double coarse_hz =
+        low[p] + static_cast<double>(best - first_point[p]) * step[p];
+    powers[num_measured] = power;
+    omegas[num_measured] = kTwoPi * coarse_hz / sample_rate_;
+    half_coeff[num_measured] = coeff[best];
+    measured[num_measured++] = p;
+    strongest = std::max(strongest, power);
+    total_power += power;
+  }
+
+  // Refinement: the phase advance of each partial's coarse bin between the
+  // half-frames (hop = half the frame); its deviation from the expected
+  // advance is the frequency offset. Both halves run as one bank each.
+  State first_states[kMaxPartials];
+  State second_states[kMaxPartials];
+  run_bank(first_half_.data(), half, half_coeff, num_measured, first_states);
+  run_bank(second_half_.data(), half, half_coeff, num_measured,
+           second_states);
+  const double hop = static_cast<double>(half);
+  double implied[kMaxPartials];
+  for (int m = 0; m < num_measured; ++m) {
+    const double omega = omegas[m];
+    const Bin first = to_bin(first_states[m], omega, half);
+    const Bin second = to_bin(second_states[m], omega, half);
+    const double advance =
+        std::atan2(second.im * first.re - second.re * first.im,
+                   second.re * first.re + second.im * first.im);
+    const double deviation = wrap_phase(advance - omega * hop);
+    const double refined_hz = (omega + deviation / hop) * sample_rate_ / kTwoPi;
+    const int p = measured[m];
+    implied[m] = refined_hz / ((p + 1.0) * stretch[p]);
+    // Undo the Hann scalloping loss of the coarse bin at the refined offset
+    const double gain = hann_gain((deviation / hop) * length / kTwoPi);
+    const double corrected = powers[m] / (gain * gain);
+    total_power += corrected - powers[m];
+    strongest = std::max(strongest, corrected);
+    powers[m] = corrected;
+  }
+
+  double weighted = 0.0;
+  double weights = 0.0;
+  for (int m = 0; m < num_measured; ++m) {
+    if (powers[m] > 0.0 && powers[m] >= kMinRelativePower * strongest) {
+      weighted += powers[m] * implied[m];
+      weights += powers[m];
+    }
+  }
+  if (weights <= 0.0) {
+    return DetectionResult(0.0, 0.0, false);
+  }
+
+  const double confidence = std::min(total_power / mean_square, 1.0);
+  const double frequency = weighted / weights;
+  return DetectionResult(frequency, confidence,
+                         confidence >= min_energy_fraction_);
+}
+
+void TargetNoteDetector::set_threshold_db(double threshold_db) noexcept {
+  threshold_db_ = threshold_db;
+}
+
+void TargetNoteDetector::set_min_frequency(double min_freq) noexcept {
+  if (min_freq > 0.0) {
+    min_freq_ = min_freq;
+  }
+}
+
+void TargetNoteDetector::set_max_frequency(double max_freq) noexcept {
+  if (max_freq > 0.0) {
+    max_freq_ = max_freq;
+  }
+}
+
+void TargetNoteDetector::set_window_type(WindowType type) noexcept {
+  (void)type;
+}
+
+void TargetNoteDetector::set_base_clarity_threshold(
+    double threshold) noexcept {
+  min_energy_fraction_ = threshold;
+}
+
+}  // namespace simple_tuner
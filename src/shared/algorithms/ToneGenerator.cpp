@@ -1,17 +1,475 @@
 #include "simple_tuner/algorithms/ToneGenerator.h"
 
+#include <algorithm>
+#include <cmath>
+
+#include "simple_tuner/dsp/FastSine.h"
+
 namespace simple_tuner {
 
+namespace {
+constexpr double kDefaultFrequency = 440.0;  // A4
+constexpr float kDefaultAmplitude = 0.5f;
+constexpr double kDefaultSampleRate = 44100.0;
+constexpr double kDefaultGlideSeconds = 0.010;
+constexpr std::size_t kChunkSize = 256;  // Samples per vectorized inner loop
+constexpr int kLaneCapacity = ToneGenerator::kMaxVoices;
+
+// Segment parameters of the audible voices, one lane each; lanes past the
+// audible count are zero (silent)
+struct VoiceLanes {
+  alignas(64) double phase[kLaneCapacity];
+  alignas(64) double increment[kLaneCapacity];
+  alignas(64) double half_slope[kLaneCapacity];
+  alignas(64) float start_gain[kLaneCapacity];
+  alignas(64) float direction[kLaneCapacity];
+  alignas(64) float distance[kLaneCapacity];
+};
+
+// Writes the sum of the first Lanes voices to out. Each sample's phase
+// comes from its index (no serial dependency), reduced to [-0.5, 0.5]
+// cycles in double before the float polynomial. With a full set of lanes
+// the lane loop vectorizes across voices and the lanes are summed pairwise;
+// with one or two, the sample loop vectorizes instead. The inner index is
+// an int so its conversions vectorize.
+template <int Lanes>
+void render_lanes(const VoiceLanes& lanes, float slope, float* buffer,
+                  std::size_t num_samples) noexcept {
+  static_assert(Lanes >= 1 && Lanes <= kLaneCapacity &&
+                    (Lanes & (Lanes - 1)) == 0,
+                "Lane counts are powers of two");
+  for (std::size_t chunk = 0; chunk < num_samples; chunk += kChunkSize) {
+    const int count =
+        static_cast<int>(std::min(kChunkSize, num_samples - chunk));
+    const auto chunk_offset = static_cast<double>(chunk);
+    float* out = buffer + chunk;
+    for (int i = 0; i < count; ++i) {
+      const double j = chunk_offset + static_cast<double>(i);
+      const float travelled = static_cast<float>(j) * slope;
+      float lane[Lanes];
+      for (int v = 0; v < Lanes; ++v) {
+        const double phase =
+            lanes.phase[v] +
+            j * (lanes.increment[v] + lanes.half_slope[v] * (j - 1.0));
+        const auto x = static_cast<float>(phase - dsp::round_to_int(phase));
+        const float distance = lanes.distance[v];
+        const float gain =
+            lanes.start_gain[v] +
+            lanes.direction[v] * (travelled < distance ? travelled : distance);
+        lane[v] = gain * dsp::sin_2pi(x);
+      }
+      for (int width = Lanes / 2; width > 0; width /= 2) {
+        for (int v = 0; v < width; ++v) {
+          lane[v] += lane[v + width];
+        }
+      }
+      out[i] = lane[0];
+    }
+  }
+}
+}  // namespace
+
+ToneGenerator::ToneGenerator() noexcept
+    : resync_(false),
+      frequency_(kDefaultFrequency),
+      amplitude_(kDefaultAmplitude),
+      enabled_(false),
+      sample_rate_(kDefaultSampleRate),
+      glide_seconds_(kDefaultGlideSeconds),
+      waveform_(Waveform::kSine),
+      wavetable_bank_(nullptr),
+      sample_time_(0),
+      active_voices_(0),
+      next_voice_id_(1),
+      target_amplitude_(kDefaultAmplitude),
+      target_enabled_(false),
+      clock_(0),
+      table_bank_(nullptr) {
+  for (int v = 0; v < kMaxVoices; ++v) {
+    phase_[v] = 0.0;
+    current_frequency_[v] = kDefaultFrequency;
+    target_frequency_[v] = kDefaultFrequency;
+    table_phase_[v] = 0.0;
+    table_[v] = nullptr;
+    table_frequency_[v] = 0.0;
+    gain_[v] = 0.0f;
+    target_gain_[v] = 0.0f;
+    voice_id_[v] = 0;
+    start_time_[v] = 0;
+  }
+}
+
+bool ToneGenerator::post(const ParameterEvent& event) noexcept {
+  return events_.try_push(event);
+}
+
 void ToneGenerator::set_frequency(double frequency_hz) noexcept {
-  frequency_ = frequency_hz;
+  if (frequency_hz >= 0.0) {
+    frequency_.store(frequency_hz, std::memory_order_relaxed);
+    if (!schedule(Parameter::kFrequency, frequency_hz, 0)) {
+      resync_.store(true, std::memory_order_release);
+    }
+  }
+}
+
+double ToneGenerator::get_frequency() const noexcept {
+  return frequency_.load(std::memory_order_relaxed);
+}
+
+void ToneGenerator::set_amplitude(float amplitude) noexcept {
+  amplitude = std::clamp(amplitude, 0.0f, 1.0f);
+  amplitude_.store(amplitude, std::memory_order_relaxed);
+  if (!schedule(Parameter::kAmplitude, amplitude, 0)) {
+    resync_.store(true, std::memory_order_release);
+  }
+}
+
+float ToneGenerator::get_amplitude() const noexcept {
+  return amplitude_.load(std::memory_order_relaxed);
+}
+
+void ToneGenerator::set_enabled(bool enabled) noexcept {
+  enabled_.store(enabled, std::memory_order_relaxed);
+  if (!schedule(Parameter::kEnabled, enabled ? 1.0 : 0.0, 0)) {
+    resync_.store(true, std::memory_order_release);
+  }
+}
+
+bool ToneGenerator::is_enabled() const noexcept {
+  return enabled_.load(std::memory_order_relaxed);
+}
+
+bool ToneGenerator::schedule(Parameter parameter, double value,
+                             std::uint64_t sample_time) noexcept {
+  EventType type = EventType::kFrequency;
+  switch (parameter) {
+    case Parameter::kFrequency:
+      if (!(value >= 0.0)) {
+        return false;
+      }
+      type = EventType::kFrequency;
+      break;
+    case Parameter::kAmplitude:
+      type = EventType::kAmplitude;
+      break;
+    case Parameter::kEnabled:
+      type = EventType::kEnabled;
+      break;
+  }
+  return post(ParameterEvent{type, value, 0.0f, 0, sample_time});
+}
+
+ToneGenerator::VoiceId ToneGenerator::note_on(
+    double frequency_hz, float amplitude, std::uint64_t sample_time) noexcept {
+  if (!(frequency_hz >= 0.0)) {
+    return 0;
+  }
+  const VoiceId voice = next_voice_id_;
+  if (!post(ParameterEvent{EventType::kNoteOn, frequency_hz,
+                           std::clamp(amplitude, 0.0f, 1.0f), voice,
+                           sample_time})) {
+    return 0;
+  }
+  next_voice_id_ = voice + 1 != 0 ? voice + 1 : 1;
+  return voice;
+}
+
+bool ToneGenerator::note_off(VoiceId voice,
+                             std::uint64_t sample_time) noexcept {
+  return post(
+      ParameterEvent{EventType::kNoteOff, 0.0, 0.0f, voice, sample_time});
+}
+
+bool ToneGenerator::all_notes_off(std::uint64_t sample_time) noexcept {
+  return post(
+      ParameterEvent{EventType::kAllNotesOff, 0.0, 0.0f, 0, sample_time});
+}
+
+int ToneGenerator::active_voices() const noexcept {
+  return active_voices_.load(std::memory_order_relaxed);
+}
+
+std::uint64_t ToneGenerator::sample_time() const noexcept {
+  return sample_time_.load(std::memory_order_acquire);
+}
+
+void ToneGenerator::set_glide_time(double seconds) noexcept {
+  glide_seconds_.store(std::max(seconds, 0.0), std::memory_order_relaxed);
+}
+
+void ToneGenerator::set_waveform(Waveform waveform) noexcept {
+  waveform_.store(waveform, std::memory_order_relaxed);
+}
+
+ToneGenerator::Waveform ToneGenerator::get_waveform() const noexcept {
+  return waveform_.load(std::memory_order_relaxed);
+}
+
+void ToneGenerator::set_wavetable_bank(const WavetableBank* bank) noexcept {
+  wavetable_bank_.store(bank, std::memory_order_release);
+}
+
+void ToneGenerator::set_sample_rate(double sample_rate) noexcept {
+  if (sample_rate > 0.0) {
+    sample_rate_.store(sample_rate, std::memory_order_relaxed);
+  }
+}
+
+int ToneGenerator::allocate_voice() const noexcept {
+  // A silent voice if there is one, else the oldest released (fading)
+  // voice, else the oldest held one
+  int best = 1;
+  for (int v = 1; v < kMaxVoices; ++v) {
+    if (voice_id_[v] == 0 && gain_[v] == 0.0f && target_gain_[v] == 0.0f) {
+      return v;
+    }
+    const bool held = voice_id_[v] != 0;
+    const bool best_held = voice_id_[best] != 0;
+    if (held != best_held ? !held : start_time_[v] < start_time_[best]) {
+      best = v;
+    }
+  }
+  return best;
+}
+
+void ToneGenerator::apply_event(const ParameterEvent& event) noexcept {
+  switch (event.type) {
+    case EventType::kFrequency:
+      target_frequency_[0] = event.value;
+      break;
+    case EventType::kAmplitude:
+      target_amplitude_ =
+          std::clamp(static_cast<float>(event.value), 0.0f, 1.0f);
+      break;
+    case EventType::kEnabled:
+      target_enabled_ = event.value != 0.0;
+      break;
+    case EventType::kNoteOn: {
+      const int v = allocate_voice();
+      // A stolen voice jumps to the new pitch with its phase intact
+      current_frequency_[v] = event.value;
+      target_frequency_[v] = event.value;
+      target_gain_[v] = event.amplitude;
+      voice_id_[v] = event.voice;
+      start_time_[v] = clock_;
+      break;
+    }
+    case EventType::kNoteOff:
+      for (int v = 1; v < kMaxVoices; ++v) {
+        if (event.voice != 0 && voice_id_[v] == event.voice) {
+          target_gain_[v] = 0.0f;
+          voice_id_[v] = 0;
+        }
+      }
+      break;
+    case EventType::kAllNotesOff:
+      for (int v = 1; v < kMaxVoices; ++v) {
+        target_gain_[v] = 0.0f;
+        voice_id_[v] = 0;
+      }
+      break;
+  }
 }
 
 void ToneGenerator::generate_samples(float* buffer, std::size_t num_samples,
                                      double sample_rate) noexcept {
-  // Stub: Phase 4 implementation (sine wave generation)
-  (void)buffer;
-  (void)num_samples;
-  (void)sample_rate;
+  if (buffer == nullptr || num_samples == 0) {
+    return;
+  }
+
+  // Split the block at every event that falls inside it
+  std::size_t done = 0;
+  while (done < num_samples) {
+    std::size_t segment = num_samples - done;
+    while (const ParameterEvent* event = events_.front()) {
+      if (event->sample_time > clock_) {
+        segment = static_cast<std::size_t>(
+            std::min<std::uint64_t>(segment, event->sample_time - clock_));
+        break;
+      }
+      apply_event(*event);
+      events_.discard();
+    }
+
+    // After a dropped event the queue lags the latest settings; the
+    // snapshot goes last so stale queued values cannot override it
+    if (done == 0 && resync_.load(std::memory_order_relaxed) &&
+        resync_.exchange(false, std::memory_order_acquire)) {
+      target_frequency_[0] = frequency_.load(std::memory_order_relaxed);
+      target_amplitude_ = amplitude_.load(std::memory_order_relaxed);
+      target_enabled_ = enabled_.load(std::memory_order_relaxed);
+    }
+
+    if (sample_rate > 0.0) {
+      render_segment(buffer + done, segment, sample_rate);
+    } else {
+      std::fill(buffer + done, buffer + done + segment, 0.0f);
+    }
+    done += segment;
+    clock_ += segment;
+  }
+
+  int active = 0;
+  for (int v = 0; v < kMaxVoices; ++v) {
+    active += gain_[v] != 0.0f || target_gain_[v] != 0.0f ? 1 : 0;
+  }
+  active_voices_.store(active, std::memory_order_relaxed);
+  sample_time_.store(clock_, std::memory_order_release);
+}
+
+void ToneGenerator::render_segment(float* buffer, std::size_t num_samples,
+                                   double sample_rate) noexcept {
+  target_gain_[0] = target_enabled_ ? target_amplitude_ : 0.0f;
+
+  const auto n = static_cast<double>(num_samples);
+  const auto slope = static_cast<float>(1.0 / (kRampSeconds * sample_rate));
+  const auto ramp_length = static_cast<float>(num_samples) * slope;
+  const double glide = glide_seconds_.load(std::memory_order_relaxed);
+  const double glide_factor =
+      glide > 0.0 ? std::exp(-n / (glide * sample_rate)) : 0.0;
+
+  // Per-voice segment parameters, computed across all voices at once.
+  // Gain ramps linearly towards its target at a fixed slope, so amplitude,
+  // enable and note changes fade over kRampSeconds instead of clicking.
+  // Frequency glides exponentially, one step per segment, with the phase
+  // increment (cycles per sample, kept below Nyquist) ramping linearly, so
+  // sample j starts at phase phase_ + j * (increment + half_slope * (j - 1)).
+  // A silent voice starts its next note on pitch.
+  alignas(64) double increment[kMaxVoices];
+  alignas(64) double half_slope[kMaxVoices];
+  alignas(64) double end_frequency[kMaxVoices];
+  alignas(64) float start_gain[kMaxVoices];
+  alignas(64) float direction[kMaxVoices];
+  alignas(64) float distance[kMaxVoices];
+  alignas(64) float end_gain[kMaxVoices];
+  for (int v = 0; v < kMaxVoices; ++v) {
+    const double target = target_frequency_[v];
+    const double current =
+        gain_[v] == 0.0f || glide <= 0.0 ? target : current_frequency_[v];
+    end_frequency[v] = target + (current - target) * glide_factor;
+    increment[v] = std::min(current / sample_rate, 0.5);
+    const double end_increment = std::min(end_frequency[v] / sample_rate, 0.5);
+    half_slope[v] = 0.5 * (end_increment - increment[v]) / n;
+
+    start_gain[v] = gain_[v];
+    distance[v] = std::abs(target_gain_[v] - gain_[v]);
+    direction[v] = target_gain_[v] >= gain_[v] ? 1.0f : -1.0f;
+    end_gain[v] = start_gain[v] + direction[v] * (ramp_length < distance[v]
+                                                      ? ramp_length
+                                                      : distance[v]);
+  }
+
+  bool audible = false;
+  for (int v = 0; v < kMaxVoices; ++v) {
+    audible = audible || start_gain[v] != 0.0f || end_gain[v] != 0.0f;
+  }
+
+  const WavetableBank* bank =
+      waveform_.load(std::memory_order_relaxed) == Waveform::kPiano
+          ? wavetable_bank_.load(std::memory_order_acquire)
+          : nullptr;
+
+  if (!audible) {
+    std::fill(buffer, buffer + num_samples, 0.0f);
+  } else if (bank != nullptr) {
+    // Linearly interpolated table reads (gathers, so voice by voice); each
+    // table spans table.cycles fundamental cycles, and its guard sample
+    // covers index + 1. A voice keeps the table of its target frequency for
+    // the whole glide; the phase, in fundamental cycles, maps onto a new
+    // table without a jump in the fundamental.
+    std::fill(buffer, buffer + num_samples, 0.0f);
+    if (table_bank_ != bank) {
+      std::fill(table_, table_ + kMaxVoices, nullptr);
+      table_bank_ = bank;
+    }
+    for (int v = 0; v < kMaxVoices; ++v) {
+      if (start_gain[v] == 0.0f && end_gain[v] == 0.0f) {
+        continue;
+      }
+      if (table_[v] == nullptr || table_frequency_[v] != target_frequency_[v]) {
+        table_[v] = &bank->table_for_frequency(
+            std::min(target_frequency_[v], 0.5 * sample_rate));
+        table_frequency_[v] = target_frequency_[v];
+      }
+      const WavetableBank::Table& table = *table_[v];
+      const auto length = static_cast<double>(table.length);
+      const double scale = length / table.cycles;
+      double step = increment[v] * scale;
+      const double step_slope = 2.0 * half_slope[v] * scale;
+      double position = std::fmod(table_phase_[v], table.cycles) * scale;
+      if (position >= length) {  // Rounding
+        position -= length;
+      }
+      for (std::size_t i = 0; i < num_samples; ++i) {
+        const auto index = static_cast<std::size_t>(position);
+        const auto fraction = static_cast<float>(position - index);
+        const float a = table.samples[index];
+        const float b = table.samples[index + 1];
+        const float travelled = static_cast<float>(i) * slope;
+        const float gain =
+            start_gain[v] +
+            direction[v] * (travelled < distance[v] ? travelled : distance[v]);
+        buffer[i] += gain * (a + fraction * (b - a));
+        position += step;
+        step += step_slope;
+        if (position >= length) {
+          position -= length;
+        }
+      }
+      table_phase_[v] = position / scale;
+    }
+  } else {
+    // Audible voices packed into the low lanes (the rest stay silent), so
+    // the common single-voice case does not pay for the whole pool
+    VoiceLanes lanes = {};
+    int num_lanes = 0;
+    for (int v = 0; v < kMaxVoices; ++v) {
+      if (start_gain[v] == 0.0f && end_gain[v] == 0.0f) {
+        continue;
+      }
+      lanes.phase[num_lanes] = phase_[v];
+      lanes.increment[num_lanes] = increment[v];
+      lanes.half_slope[num_lanes] = half_slope[v];
+      lanes.start_gain[num_lanes] = start_gain[v];
+      lanes.direction[num_lanes] = direction[v];
+      lanes.distance[num_lanes] = distance[v];
+      ++num_lanes;
+    }
+    // (GCC vectorizes a four-lane loop poorly; three and four voices run
+    // faster in the full-width loop)
+    if (num_lanes == 1) {
+      render_lanes<1>(lanes, slope, buffer, num_samples);
+    } else if (num_lanes == 2) {
+      render_lanes<2>(lanes, slope, buffer, num_samples);
+    } else {
+      render_lanes<kMaxVoices>(lanes, slope, buffer, num_samples);
+    }
+  }
+
+  // Advance and wrap the accumulators once per segment
+  for (int v = 0; v < kMaxVoices; ++v) {
+    phase_[v] += n * (increment[v] + half_slope[v] * (n - 1.0));
+    phase_[v] -= std::floor(phase_[v]);
+    current_frequency_[v] = end_frequency[v];
+    gain_[v] = end_gain[v];
+  }
+}
+
+void ToneGenerator::process(float* buffer, int num_samples) noexcept {
+  if (num_samples <= 0) {
+    return;
+  }
+  generate_samples(buffer, static_cast<std::size_t>(num_samples),
+                   sample_rate_.load(std::memory_order_relaxed));
+}
+
+void ToneGenerator::reset() noexcept {
+  for (int v = 0; v < kMaxVoices; ++v) {
+    phase_[v] = 0.0;
+    table_phase_[v] = 0.0;
+    gain_[v] = 0.0f;
+    current_frequency_[v] = target_frequency_[v];
+  }
 }
 
 }  // namespace simple_tuner
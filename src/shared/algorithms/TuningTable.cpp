@@ -0,0 +1,216 @@
+#include "simple_tuner/algorithms/TuningTable.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "simple_tuner/dsp/FastLog2.h"
+
+namespace simple_tuner {
+
+namespace {
+constexpr int kMidiNoteA4 = 69;
+constexpr int kNotesPerOctave = 12;
+constexpr int kPitchClassA = 9;
+constexpr double kCentsPerOctave = 1200.0;
+
+// Quarter-comma meantone fifth (a quarter of four fifths = 5:1) and its
+// deviation from the equal-tempered fifth
+constexpr double kMeantoneFifthCents = 696.578;
+constexpr double kMeantoneStep = kMeantoneFifthCents - 700.0;
+
+// Deviations from equal temperament in cents, C through B, with C at 0
+constexpr double kTemperamentCents[][kNotesPerOctave] = {
+    // Equal
+    {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+    // Pythagorean (Eb..G# chain of pure fifths)
+    {0.0, 13.69, 3.91, -5.87, 7.82, -1.96, 11.73, 1.96, 15.64, 5.87, -3.91,
+     9.78},
+    // Quarter-comma meantone (Eb..G#): k fifths from C deviate by k steps
+    {0.0, 7 * kMeantoneStep, 2 * kMeantoneStep, -3 * kMeantoneStep,
+     4 * kMeantoneStep, -1 * kMeantoneStep, 6 * kMeantoneStep, kMeantoneStep,
+     8 * kMeantoneStep, 3 * kMeantoneStep, -2 * kMeantoneStep,
+     5 * kMeantoneStep},
+    // Werckmeister III
+    {0.0, -9.78, -7.82, -5.87, -9.78, -1.96, -11.73, -3.91, -7.82, -11.73,
+     -3.91, -7.82},
+    // Kirnberger III
+    {0.0, -9.78, -6.84, -5.87, -13.69, -1.96, -9.78, -3.42, -7.82, -10.26,
+     -3.91, -11.73},
+    // Vallotti
+    {0.0, -5.87, -3.91, -1.96, -7.82, 1.96, -7.82, -1.96, -3.91, -5.87, 0.0,
+     -9.78},
+};
+
+int pitch_class(int midi_note) noexcept {
+  return ((midi_note % kNotesPerOctave) + kNotesPerOctave) % kNotesPerOctave;
+}
+}  // namespace
+
+TuningTable::TuningTable(double reference_a4) noexcept
+    : reference_a4_(reference_a4 > 0.0 ? reference_a4 : 440.0),
+      temperament_(Temperament::kEqual) {
+  key_offset_cents_.fill(0.0);
+  rebuild();
+}
+
+void TuningTable::set_reference_a4(double frequency) noexcept {
+  if (frequency > 0.0) {
+    reference_a4_ = frequency;
+    rebuild();
+  }
+}
+
+void TuningTable::set_temperament(Temperament temperament) noexcept {
+  temperament_ = temperament;
+  rebuild();
+}
+
+void TuningTable::set_key_offset(int midi_note, double cents) noexcept {
+  if (in_range(midi_note)) {
+    key_offset_cents_[static_cast<std::size_t>(midi_note - kFirstKey)] =
+        cents;
+    rebuild();
+  }
+}
+
+double TuningTable::get_key_offset(int midi_note) const noexcept {
+  if (!in_range(midi_note)) {
+    return 0.0;
+  }
+  return key_offset_cents_[static_cast<std::size_t>(midi_note - kFirstKey)];
+}
+
+void TuningTable::set_stretch_curve(
+    const std::array<double, kNumKeys>& cents) noexcept {
+  key_offset_cents_ = cents;
+  rebuild();
+}
+
+void TuningTable::clear_stretch_curve() noexcept {
+  key_offset_cents_.fill(0.0);
+  rebuild();
+}
+
+double TuningTable::temperament_offset(Temperament temperament,
+                                       int pitch_class_index) noexcept {
+  const double* cents = kTemperamentCents[static_cast<int>(temperament)];
+  return cents[pitch_class(pitch_class_index)] - cents[kPitchClassA];
+}
+
+void TuningTable::rebuild() noexcept {
+  // One pass: log2 of every target, then its frequency and the boundary to
+  // the key below
+  const double log2_reference = std::log2(reference_a4_);
+  for (int i = 0; i < kNumKeys; ++i) {
+    const int midi_note = kFirstKey + i;
+    const double semitones =
+        static_cast<double>(midi_note - kMidiNoteA4) / kNotesPerOctave;
+    const double cents = temperament_offset(temperament_, midi_note) +
+                         key_offset_cents_[static_cast<std::size_t>(i)];
+    const auto key = static_cast<std::size_t>(i);
+    log2_[key] = log2_reference + semitones + cents / kCentsPerOctave;
+    frequency_[key] = std::exp2(log2_[key]);
+    if (i > 0) {
+      upper_boundary_[key - 1] = 0.5 * (log2_[key - 1] + log2_[key]);
+    }
+  }
+  upper_boundary_[kNumKeys - 1] = log2_[kNumKeys - 1] + 1.0;
+}
+
+double TuningTable::target_log2(int midi_note) const noexcept {
+  if (in_range(midi_note)) {
+    return log2_[static_cast<std::size_t>(midi_note - kFirstKey)];
+  }
+  return std::log2(reference_a4_) +
+         static_cast<double>(midi_note - kMidiNoteA4) / kNotesPerOctave +
+         temperament_offset(temperament_, midi_note) / kCentsPerOctave;
+}
+
+double TuningTable::target_frequency(int midi_note) const noexcept {
+  if (in_range(midi_note)) {
+    return frequency_[static_cast<std::size_t>(midi_note - kFirstKey)];
+  }
+  return std::exp2(target_log2(midi_note));
+}
+
+int TuningTable::nearest_key(double frequency) const noexcept {
+  const double log2_frequency = dsp::fast_log2(frequency);
+  return key_for_log2(log2_frequency,
+                      std::lround(equal_tempered_key(log2_frequency)));
+}
+
+void TuningTable::nearest_keys(const double* frequencies, std::size_t count,
+                               int* keys, double* cents) const noexcept {
+  if (frequencies == nullptr || keys == nullptr || cents == nullptr) {
+    return;
+  }
+
+  // Chunks keep the scratch on the stack. The first two loops are
+  // branch-free and vectorize; the clamp gets its own loop because GCC will
+  // not if-convert it into the bit manipulation of fast_log2. The last loop
+  // (boundary stepping, usually zero or one step) stays scalar.
+  constexpr std::size_t kChunk = 256;
+  double log2_frequency[kChunk];
+  double guess[kChunk];
+  for (std::size_t start = 0; start < count; start += kChunk) {
+    const int n = static_cast<int>(std::min(kChunk, count - start));
+    const double* in = frequencies + start;
+    for (int i = 0; i < n; ++i) {
+      // Invalid inputs (NaN included) are evaluated at the smallest normal
+      // and overwritten below
+      log2_frequency[i] = std::max(std::numeric_limits<double>::min(), in[i]);
+    }
+    for (int i = 0; i < n; ++i) {
+      log2_frequency[i] = dsp::fast_log2(log2_frequency[i]);
+      guess[i] = equal_tempered_key(log2_frequency[i]);
+    }
+    for (int i = 0; i < n; ++i) {
+      const std::size_t out = start + static_cast<std::size_t>(i);
+      if (!(in[i] > 0.0)) {
+        keys[out] = kFirstKey;
+        cents[out] = 0.0;
+        continue;
+      }
+      const int key = key_for_log2(log2_frequency[i], std::lround(guess[i]));
+      const double target = log2_[static_cast<std::size_t>(key - kFirstKey)];
+      keys[out] = key;
+      cents[out] = kCentsPerOctave * (log2_frequency[i] - target);
+    }
+  }
+}
+
+double TuningTable::equal_tempered_key(double log2_frequency) const noexcept {
+  const double guess =
+      kMidiNoteA4 +
+      kNotesPerOctave * (log2_frequency - log2_[kMidiNoteA4 - kFirstKey]);
+  // min/max rather than std::clamp, so the batch loop stays branch-free
+  return std::min(std::max(guess, static_cast<double>(kFirstKey)),
+                  static_cast<double>(kLastKey));
+}
+
+int TuningTable::key_for_log2(double log2_frequency,
+                              long guess) const noexcept {
+  // Step from the guess to the key whose boundaries enclose the frequency
+  // (one step at most unless offsets exceed 50 cents)
+  int key = static_cast<int>(guess);
+  while (key > kFirstKey &&
+         log2_frequency <
+             upper_boundary_[static_cast<std::size_t>(key - 1 - kFirstKey)]) {
+    --key;
+  }
+  while (key < kLastKey &&
+         log2_frequency >=
+             upper_boundary_[static_cast<std::size_t>(key - kFirstKey)]) {
+    ++key;
+  }
+  return key;
+}
+
+double TuningTable::cents_from_target(double frequency,
+                                      int midi_note) const noexcept {
+  return kCentsPerOctave *
+         (dsp::fast_log2(frequency) - target_log2(midi_note));
+}
+
+}  // namespace simple_tuner
@@ -0,0 +1,138 @@
+#include "simple_tuner/algorithms/WavetableBank.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace simple_tuner {
+
+namespace {
+constexpr double kPi = 3.14159265358979323846;
+constexpr double kReferenceA4 = 440.0;
+constexpr double kBandLimit = 0.45;        // Fraction of the sample rate
+constexpr double kMinSamplesPerCycle = 4;  // For the highest partial
+constexpr double kHammerPosition = 1.0 / 8.0;
+
+double note_frequency(int midi_note) {
+  return kReferenceA4 * std::pow(2.0, (midi_note - 69) / 12.0);
+}
+
+// Partial frequency over the fundamental's; the fundamental itself is
+// stretched by sqrt(1 + B), which is folded into the played pitch
+double partial_ratio(int partial, double inharmonicity) {
+  const double n = partial;
+  return n * std::sqrt((1.0 + inharmonicity * n * n) / (1.0 + inharmonicity));
+}
+}  // namespace
+
+WavetableBank::WavetableBank(double sample_rate,
+                             std::size_t memory_budget_bytes)
+    : sample_rate_(sample_rate), table_length_(kMinTableLength) {
+  // Longest power-of-two table that fits the budget (with guard samples)
+  while (table_length_ < kMaxTableLength &&
+         kNumRanges * (2 * table_length_ + 1) * sizeof(float) <=
+             memory_budget_bytes) {
+    table_length_ *= 2;
+  }
+
+  samples_.assign(kNumRanges * (table_length_ + 1), 0.0f);
+  tables_.resize(kNumRanges);
+
+  // One cycle of sine at table resolution: partial c of a table is
+  // sine[(c * j) mod length], exact for an integer cycle count
+  std::vector<double> sine(table_length_);
+  for (std::size_t j = 0; j < table_length_; ++j) {
+    sine[j] = std::sin(2.0 * kPi * static_cast<double>(j) /
+                       static_cast<double>(table_length_));
+  }
+
+  for (int range = 0; range < kNumRanges; ++range) {
+    build_table(range, sine);
+  }
+}
+
+void WavetableBank::build_table(int range, const std::vector<double>& sine) {
+  const int first_note = kFirstMidiNote + range * kKeysPerRange;
+  const int top_note = first_note + kKeysPerRange - 1;
+  const double inharmonicity_b =
+      inharmonicity(first_note + kKeysPerRange / 2);
+
+  // Band limit: every partial of the range's highest key below kBandLimit
+  const double top_frequency = note_frequency(top_note);
+  int num_partials = 1;
+  while (num_partials < kMaxPartials &&
+         top_frequency * partial_ratio(num_partials + 1, inharmonicity_b) <
+             kBandLimit * sample_rate_) {
+    ++num_partials;
+  }
+
+  // As many fundamental cycles as keep the highest partial at
+  // kMinSamplesPerCycle table samples or more
+  const double highest_ratio = partial_ratio(num_partials, inharmonicity_b);
+  const double cycles = std::max(
+      1.0, std::floor(static_cast<double>(table_length_) /
+                      (kMinSamplesPerCycle * highest_ratio)));
+
+  const std::size_t mask = table_length_ - 1;
+  std::vector<double> sum(table_length_, 0.0);
+  for (int n = 1; n <= num_partials; ++n) {
+    const auto partial_cycles = static_cast<std::size_t>(
+        std::lround(cycles * partial_ratio(n, inharmonicity_b)));
+    const double amplitude = partial_amplitude(n);
+    std::size_t index = 0;
+    for (std::size_t j = 0; j < table_length_; ++j) {
+      sum[j] += amplitude * sine[index];
+      index = (index + partial_cycles) & mask;
+    }
+  }
+
+  // Normalize to unit peak
+  double peak = 0.0;
+  for (double value : sum) {
+    peak = std::max(peak, std::abs(value));
+  }
+  const double scale = peak > 0.0 ? 1.0 / peak : 0.0;
+
+  float* table =
+      samples_.data() + static_cast<std::size_t>(range) * (table_length_ + 1);
+  for (std::size_t j = 0; j < table_length_; ++j) {
+    table[j] = static_cast<float>(sum[j] * scale);
+  }
+  table[table_length_] = table[0];
+
+  tables_[static_cast<std::size_t>(range)] =
+      Table{table, table_length_, cycles};
+}
+
+const WavetableBank::Table& WavetableBank::table_for_frequency(
+    double frequency_hz) const noexcept {
+  if (frequency_hz <= 0.0) {
+    return table_for_note(kFirstMidiNote);
+  }
+  const double midi = 69.0 + 12.0 * std::log2(frequency_hz / kReferenceA4);
+  return table_for_note(static_cast<int>(std::lround(
+      std::clamp(midi, 0.0, static_cast<double>(kFirstMidiNote + kNumKeys)))));
+}
+
+const WavetableBank::Table& WavetableBank::table_for_note(
+    int midi_note) const noexcept {
+  const int key = std::clamp(midi_note - kFirstMidiNote, 0, kNumKeys - 1);
+  return tables_[static_cast<std::size_t>(key / kKeysPerRange)];
+}
+
+double WavetableBank::inharmonicity(int midi_note) noexcept {
+  // Wound bass strings: B falls from ~4e-4 at A0 to its minimum at C2 (36);
+  // plain treble strings: B grows ~7.5% per semitone from there
+  constexpr int kMinimumNote = 36;
+  constexpr double kMinimumB = 1.1e-4;
+  if (midi_note < kMinimumNote) {
+    return kMinimumB * std::exp(0.085 * (kMinimumNote - midi_note));
+  }
+  return kMinimumB * std::exp(0.075 * (midi_note - kMinimumNote));
+}
+
+double WavetableBank::partial_amplitude(int partial) noexcept {
+  return std::abs(std::sin(partial * kPi * kHammerPosition)) /
+         std::pow(partial, 1.5);
+}
+
+}  // namespace simple_tuner
@@ -27,4 +27,20 @@ bool ConfigManager::reset_reference_pitch() noexcept {
   return storage_->set_double(kReferencePitchKey, kDefaultReferencePitch);
 }
 
+std::size_t ConfigManager::get_wavetable_memory_budget() const noexcept {
+  auto stored_value = storage_->get_double(kWavetableBudgetKey);
+  double budget = kDefaultWavetableBudget;
+  if (stored_value.has_value()) {
+    budget =
+        std::clamp(*stored_value, kMinWavetableBudget, kMaxWavetableBudget);
+  }
+  return static_cast<std::size_t>(budget);
+}
+
+bool ConfigManager::set_wavetable_memory_budget(std::size_t bytes) noexcept {
+  double clamped = std::clamp(static_cast<double>(bytes), kMinWavetableBudget,
+                              kMaxWavetableBudget);
+  return storage_->set_double(kWavetableBudgetKey, clamped);
+}
+
 }  // namespace simple_tuner
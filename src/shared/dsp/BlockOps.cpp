@@ -0,0 +1,637 @@
+#include "simple_tuner/dsp/BlockOps.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <initializer_list>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SIMPLE_TUNER_DSP_SSE2 1
+#if defined(__GNUC__)
+#include <immintrin.h>
+#define SIMPLE_TUNER_DSP_AVX2 1
+#define SIMPLE_TUNER_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define SIMPLE_TUNER_DSP_NEON 1
+#endif
+
+namespace simple_tuner {
+namespace dsp {
+
+namespace {
+
+constexpr float kInt16ToFloat = 1.0f / 32768.0f;
+constexpr float kFloatToInt16 = 32767.0f;
+
+// One entry per primitive; sum() and sum_of_squares() share block_stats,
+// whose second accumulator is free in a loop bound by memory reads
+struct Kernels {
+  SimdLevel level;
+  BlockStats (*block_stats)(const float*, std::size_t);
+  void (*subtract)(float*, std::size_t, float);
+  void (*multiply)(float*, const float*, std::size_t);
+  float (*dot_product)(const float*, const float*, std::size_t);
+  void (*int16_to_float)(const std::int16_t*, float*, std::size_t);
+  void (*float_to_int16)(const float*, std::int16_t*, std::size_t);
+  // dst = (src - mean) * window (window may be null); returns sum of dst^2
+  double (*dc_window)(const float*, const float*, float, float*, std::size_t);
+};
+
+// Scalar reference kernels (also used for the tails of the SIMD kernels)
+
+BlockStats block_stats_scalar(const float* x, std::size_t n) noexcept {
+  BlockStats stats;
+  for (std::size_t i = 0; i < n; ++i) {
+    const double value = x[i];
+    stats.sum += value;
+    stats.sum_squares += value * value;
+  }
+  return stats;
+}
+
+void subtract_scalar(float* x, std::size_t n, float value) noexcept {
+  for (std::size_t i = 0; i < n; ++i) {
+    x[i] -= value;
+  }
+}
+
+void multiply_scalar(float* x, const float* window, std::size_t n) noexcept {
+  for (std::size_t i = 0; i < n; ++i) {
+    x[i] *= window[i];
+  }
+}
+
+// Independent partial sums so the compiler can keep them in one SIMD
+// register instead of serializing on a single accumulator
+float dot_product_scalar(const float* a, const float* b,
+                         std::size_t n) noexcept {
+  constexpr std::size_t kLanes = 8;
+  std::array<float, kLanes> partial{};
+  const std::size_t blocked = n - (n % kLanes);
+  for (std::size_t i = 0; i < blocked; i += kLanes) {
+    for (std::size_t j = 0; j < kLanes; ++j) {
+      partial[j] += a[i + j] * b[i + j];
+    }
+  }
+
+  float sum = ((partial[0] + partial[1]) + (partial[2] + partial[3])) +
+              ((partial[4] + partial[5]) + (partial[6] + partial[7]));
+  for (std::size_t i = blocked; i < n; ++i) {
+    sum += a[i] * b[i];
+  }
+  return sum;
+}
+
+void int16_to_float_scalar(const std::int16_t* src, float* dst,
+                           std::size_t n) noexcept {
+  for (std::size_t i = 0; i < n; ++i) {
+    dst[i] = static_cast<float>(src[i]) * kInt16ToFloat;
+  }
+}
+
+void float_to_int16_scalar(const float* src, std::int16_t* dst,
+                           std::size_t n) noexcept {
+  for (std::size_t i = 0; i < n; ++i) {
+    const float clamped = std::clamp(src[i], -1.0f, 1.0f);
+    dst[i] = static_cast<std::int16_t>(std::lrint(clamped * kFloatToInt16));
+  }
+}
+
+double dc_window_scalar(const float* src, const float* window, float mean,
+                        float* dst, std::size_t n) noexcept {
+  double energy = 0.0;
+  for (std::size_t i = 0; i < n; ++i) {
+    float value = src[i] - mean;
+    if (window != nullptr) {
+      value *= window[i];
+    }
+    dst[i] = value;
+    energy += static_cast<double>(value) * value;
+  }
+  return energy;
+}
+
+constexpr Kernels kScalarKernels = {
+    SimdLevel::kScalar,    block_stats_scalar,    subtract_scalar,
+    multiply_scalar,       dot_product_scalar,    int16_to_float_scalar,
+    float_to_int16_scalar, dc_window_scalar,
+};
+
+#if defined(SIMPLE_TUNER_DSP_SSE2)
+
+double horizontal_sum(__m128d v) noexcept {
+  return _mm_cvtsd_f64(_mm_add_sd(v, _mm_unpackhi_pd(v, v)));
+}
+
+float horizontal_sum(__m128 v) noexcept {
+  const __m128 pairs = _mm_add_ps(v, _mm_movehl_ps(v, v));
+  return _mm_cvtss_f32(
+      _mm_add_ss(pairs, _mm_shuffle_ps(pairs, pairs, _MM_SHUFFLE(1, 1, 1, 1))));
+}
+
+BlockStats block_stats_sse2(const float* x, std::size_t n) noexcept {
+  __m128d sum_lo = _mm_setzero_pd();
+  __m128d sum_hi = _mm_setzero_pd();
+  __m128d squares_lo = _mm_setzero_pd();
+  __m128d squares_hi = _mm_setzero_pd();
+  const std::size_t blocked = n - (n % 4);
+  for (std::size_t i = 0; i < blocked; i += 4) {
+    const __m128 v = _mm_loadu_ps(x + i);
+    const __m128d lo = _mm_cvtps_pd(v);
+    const __m128d hi = _mm_cvtps_pd(_mm_movehl_ps(v, v));
+    sum_lo = _mm_add_pd(sum_lo, lo);
+    sum_hi = _mm_add_pd(sum_hi, hi);
+    squares_lo = _mm_add_pd(squares_lo, _mm_mul_pd(lo, lo));
+    squares_hi = _mm_add_pd(squares_hi, _mm_mul_pd(hi, hi));
+  }
+
+  BlockStats tail = block_stats_scalar(x + blocked, n - blocked);
+  tail.sum += horizontal_sum(_mm_add_pd(sum_lo, sum_hi));
+  tail.sum_squares += horizontal_sum(_mm_add_pd(squares_lo, squares_hi));
+  return tail;
+}
+
+void subtract_sse2(float* x, std::size_t n, float value) noexcept {
+  const __m128 offset = _mm_set1_ps(value);
+  const std::size_t blocked = n - (n % 4);
+  for (std::size_t i = 0; i < blocked; i += 4) {
+    _mm_storeu_ps(x + i, _mm_sub_ps(_mm_loadu_ps(x + i), offset));
+  }
+  subtract_scalar(x + blocked, n - blocked, value);
+}
+
+void multiply_sse2(float* x, const float* window, std::size_t n) noexcept {
+  const std::size_t blocked = n - (n % 4);
+  for (std::size_t i = 0; i < blocked; i += 4) {
+    _mm_storeu_ps(x + i,
+                  _mm_mul_ps(_mm_loadu_ps(x + i), _mm_loadu_ps(window + i)));
+  }
+  multiply_scalar(x + blocked, window + blocked, n - blocked);
+}
+
+float dot_product_sse2(const float* a, const float* b,
+                       std::size_t n) noexcept {
+  __m128 acc0 = _mm_setzero_ps();
+  __m128 acc1 = _mm_setzero_ps();
+  const std::size_t blocked = n - (n % 8);
+  for (std::size_t i = 0; i < blocked; i += 8) {
+    acc0 = _mm_add_ps(acc0,
+                      _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    acc1 = _mm_add_ps(
+        acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+  }
+
+  float sum = horizontal_sum(_mm_add_ps(acc0, acc1));
+  for (std::size_t i = blocked; i < n; ++i) {
+    sum += a[i] * b[i];
+  }
+  return sum;
+}
+
+void int16_to_float_sse2(const std::int16_t* src, float* dst,
+                         std::size_t n) noexcept {
+  const __m128 scale = _mm_set1_ps(kInt16ToFloat);
+  const std::size_t blocked = n - (n % 8);
+  for (std::size_t i = 0; i < blocked; i += 8) {
+    const __m128i v =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    // Sign-extend by placing each sample in the high half, then shifting
+    const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+    const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+    _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+    _mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+  }
+  int16_to_float_scalar(src + blocked, dst + blocked, n - blocked);
+}
+
+void float_to_int16_sse2(const float* src, std::int16_t* dst,
+                         std::size_t n) noexcept {
+  const __m128 lower = _mm_set1_ps(-1.0f);
+  const __m128 upper = _mm_set1_ps(1.0f);
+  const __m128 scale = _mm_set1_ps(kFloatToInt16);
+  const std::size_t blocked = n - (n % 8);
+  for (std::size_t i = 0; i < blocked; i += 8) {
+    const __m128 lo = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i), lower),
+                                 upper);
+    const __m128 hi = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i + 4), lower),
+                                 upper);
+    const __m128i packed =
+        _mm_packs_epi32(_mm_cvtps_epi32(_mm_mul_ps(lo, scale)),
+                        _mm_cvtps_epi32(_mm_mul_ps(hi, scale)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), packed);
+  }
+  float_to_int16_scalar(src + blocked, dst + blocked, n - blocked);
+}
+
+double dc_window_sse2(const float* src, const float* window, float mean,
+                      float* dst, std::size_t n) noexcept {
+  const __m128 offset = _mm_set1_ps(mean);
+  __m128d energy_lo = _mm_setzero_pd();
+  __m128d energy_hi = _mm_setzero_pd();
+  const std::size_t blocked = n - (n % 4);
+  for (std::size_t i = 0; i < blocked; i += 4) {
+    __m128 value = _mm_sub_ps(_mm_loadu_ps(src + i), offset);
+    if (window != nullptr) {
+      value = _mm_mul_ps(value, _mm_loadu_ps(window + i));
+    }
+    _mm_storeu_ps(dst + i, value);
+    const __m128d lo = _mm_cvtps_pd(value);
+    const __m128d hi = _mm_cvtps_pd(_mm_movehl_ps(value, value));
+    energy_lo = _mm_add_pd(energy_lo, _mm_mul_pd(lo, lo));
+    energy_hi = _mm_add_pd(energy_hi, _mm_mul_pd(hi, hi));
+  }
+
+  const float* tail_window = window != nullptr ? window + blocked : nullptr;
+  return horizontal_sum(_mm_add_pd(energy_lo, energy_hi)) +
+         dc_window_scalar(src + blocked, tail_window, mean, dst + blocked,
+                          n - blocked);
+}
+
+constexpr Kernels kSse2Kernels = {
+    SimdLevel::kSse2,    block_stats_sse2,    subtract_sse2,
+    multiply_sse2,       dot_product_sse2,    int16_to_float_sse2,
+    float_to_int16_sse2, dc_window_sse2,
+};
+
+#endif  // SIMPLE_TUNER_DSP_SSE2
+
+#if defined(SIMPLE_TUNER_DSP_AVX2)
+
+SIMPLE_TUNER_TARGET_AVX2 double horizontal_sum_avx2(__m256d v) noexcept {
+  const __m128d halves =
+      _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+  return _mm_cvtsd_f64(_mm_add_sd(halves, _mm_unpackhi_pd(halves, halves)));
+}
+
+SIMPLE_TUNER_TARGET_AVX2 BlockStats block_stats_avx2(const float* x,
+                                                     std::size_t n) noexcept {
+  __m256d sum_lo = _mm256_setzero_pd();
+  __m256d sum_hi = _mm256_setzero_pd();
+  __m256d squares_lo = _mm256_setzero_pd();
+  __m256d squares_hi = _mm256_setzero_pd();
+  const std::size_t blocked = n - (n % 8);
+  for (std::size_t i = 0; i < blocked; i += 8) {
+    const __m256 v = _mm256_loadu_ps(x + i);
+    const __m256d lo = _mm256_cvtps_pd(_mm256_castps256_ps128(v));
+    const __m256d hi = _mm256_cvtps_pd(_mm256_extractf128_ps(v, 1));
+    sum_lo = _mm256_add_pd(sum_lo, lo);
+    sum_hi = _mm256_add_pd(sum_hi, hi);
+    squares_lo = _mm256_add_pd(squares_lo, _mm256_mul_pd(lo, lo));
+    squares_hi = _mm256_add_pd(squares_hi, _mm256_mul_pd(hi, hi));
+  }
+
+  BlockStats tail = block_stats_scalar(x + blocked, n - blocked);
+  tail.sum += horizontal_sum_avx2(_mm256_add_pd(sum_lo, sum_hi));
+  tail.sum_squares +=
+      horizontal_sum_avx2(_mm256_add_pd(squares_lo, squares_hi));
+  return tail;
+}
+
+SIMPLE_TUNER_TARGET_AVX2 void subtract_avx2(float* x, std::size_t n,
+                                            float value) noexcept {
+  const __m256 offset = _mm256_set1_ps(value);
+  const std::size_t blocked = n - (n % 8);
+  for (std::size_t i = 0; i < blocked; i += 8) {
+    _mm256_storeu_ps(x + i, _mm256_sub_ps(_mm256_loadu_ps(x + i), offset));
+  }
+  subtract_scalar(x + blocked, n - blocked, value);
+}
+
+SIMPLE_TUNER_TARGET_AVX2 void multiply_avx2(float* x, const float* window,
+                                            std::size_t n) noexcept {
+  const std::size_t blocked = n - (n % 8);
+  for (std::size_t i = 0; i < blocked; i += 8) {
+    _mm256_storeu_ps(x + i, _mm256_mul_ps(_mm256_loadu_ps(x + i),
+                                          _mm256_loadu_ps(window + i)));
+  }
+  multiply_scalar(x + blocked, window + blocked, n - blocked);
+}
+
+SIMPLE_TUNER_TARGET_AVX2 float dot_product_avx2(const float* a, const float* b,
+                                                std::size_t n) noexcept {
+  __m256 acc0 = _mm256_setzero_ps();
+  __m256 acc1 = _mm256_setzero_ps();
+  const std::size_t blocked = n - (n % 16);
+  for (std::size_t i = 0; i < blocked; i += 16) {
+    acc0 = _mm256_add_ps(
+        acc0, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+    acc1 = _mm256_add_ps(acc1, _mm256_mul_ps(_mm256_loadu_ps(a + i + 8),
+                                             _mm256_loadu_ps(b + i + 8)));
+  }
+
+  const __m256 acc = _mm256_add_ps(acc0, acc1);
+  const __m128 halves =
+      _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+  float sum = horizontal_sum(halves);
+  for (std::size_t i = blocked; i < n; ++i) {
+    sum += a[i] * b[i];
+  }
+  return sum;
+}
+
+SIMPLE_TUNER_TARGET_AVX2 void int16_to_float_avx2(const std::int16_t* src,
+                                                  float* dst,
+                                                  std::size_t n) noexcept {
+  const __m256 scale = _mm256_set1_ps(kInt16ToFloat);
+  const std::size_t blocked = n - (n % 8);
+  for (std::size_t i = 0; i < blocked; i += 8) {
+    const __m256i widened = _mm256_cvtepi16_epi32(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+    _mm256_storeu_ps(dst + i,
+                     _mm256_mul_ps(_mm256_cvtepi32_ps(widened), scale));
+  }
+  int16_to_float_scalar(src + blocked, dst + blocked, n - blocked);
+}
+
+SIMPLE_TUNER_TARGET_AVX2 void float_to_int16_avx2(const float* src,
+                                                  std::int16_t* dst,
+                                                  std::size_t n) noexcept {
+  const __m256 lower = _mm256_set1_ps(-1.0f);
+  const __m256 upper = _mm256_set1_ps(1.0f);
+  const __m256 scale = _mm256_set1_ps(kFloatToInt16);
+  const std::size_t blocked = n - (n % 8);
+  for (std::size_t i = 0; i < blocked; i += 8) {
+    const __m256 clamped =
+        _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(src + i), lower), upper);
+    const __m256i rounded = _mm256_cvtps_epi32(_mm256_mul_ps(clamped, scale));
+    const __m128i packed =
+        _mm_packs_epi32(_mm256_castsi256_si128(rounded),
+                        _mm256_extracti128_si256(rounded, 1));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), packed);
+  }
+  float_to_int16_scalar(src + blocked, dst + blocked, n - blocked);
+}
+
+SIMPLE_TUNER_TARGET_AVX2 double dc_window_avx2(const float* src,
+                                               const float* window, float mean,
+                                               float* dst,
+                                               std::size_t n) noexcept {
+  const __m256 offset = _mm256_set1_ps(mean);
+  __m256d energy_lo = _mm256_setzero_pd();
+  __m256d energy_hi = _mm256_setzero_pd();
+  const std::size_t blocked = n - (n % 8);
+  for (std::size_t i = 0; i < blocked; i += 8) {
+    __m256 value = _mm256_sub_ps(_mm256_loadu_ps(src + i), offset);
+    if (window != nullptr) {
+      value = _mm256_mul_ps(value, _mm256_loadu_ps(window + i));
+    }
+    _mm256_storeu_ps(dst + i, value);
+    const __m256d lo = _mm256_cvtps_pd(_mm256_castps256_ps128(value));
+    const __m256d hi = _mm256_cvtps_pd(_mm256_extractf128_ps(value, 1));
+    energy_lo = _mm256_add_pd(energy_lo, _mm256_mul_pd(lo, lo));
+    energy_hi = _mm256_add_pd(energy_hi, _mm256_mul_pd(hi, hi));
+  }
+
+  const float* tail_window = window != nullptr ? window + blocked : nullptr;
+  return horizontal_sum_avx2(_mm256_add_pd(energy_lo, energy_hi)) +
+         dc_window_scalar(src + blocked, tail_window, mean, dst + blocked,
+                          n - blocked);
+}
+
+constexpr Kernels kAvx2Kernels = {
+    SimdLevel::kAvx2,    block_stats_avx2,    subtract_avx2,
+    multiply_avx2,       dot_product_avx2,    int16_to_float_avx2,
+    float_to_int16_avx2, dc_window_avx2,
+};
+
+#endif  // SIMPLE_TUNER_DSP_AVX2
+
+#if defined(SIMPLE_TUNER_DSP_NEON)
+
+BlockStats block_stats_neon(const float* x, std::size_t n) noexcept {
+  float64x2_t sum_lo = vdupq_n_f64(0.0);
+  float64x2_t sum_hi = vdupq_n_f64(0.0);
+  float64x2_t squares_lo = vdupq_n_f64(0.0);
+  float64x2_t squares_hi = vdupq_n_f64(0.0);
+  const std::size_t blocked = n - (n % 4);
+  for (std::size_t i = 0; i < blocked; i += 4) {
+    const float32x4_t v = vld1q_f32(x + i);
+    const float64x2_t lo = vcvt_f64_f32(vget_low_f32(v));
+    const float64x2_t hi = vcvt_high_f64_f32(v);
+    sum_lo = vaddq_f64(sum_lo, lo);
+    sum_hi = vaddq_f64(sum_hi, hi);
+    squares_lo = vaddq_f64(squares_lo, vmulq_f64(lo, lo));
+    squares_hi = vaddq_f64(squares_hi, vmulq_f64(hi, hi));
+  }
+
+  BlockStats tail = block_stats_scalar(x + blocked, n - blocked);
+  tail.sum += vaddvq_f64(vaddq_f64(sum_lo, sum_hi));
+  tail.sum_squares += vaddvq_f64(vaddq_f64(squares_lo, squares_hi));
+  return tail;
+}
+
+void subtract_neon(float* x, std::size_t n, float value) noexcept {
+  const float32x4_t offset = vdupq_n_f32(value);
+  const std::size_t blocked = n - (n % 4);
+  for (std::size_t i = 0; i < blocked; i += 4) {
+    vst1q_f32(x + i, vsubq_f32(vld1q_f32(x + i), offset));
+  }
+  subtract_scalar(x + blocked, n - blocked, value);
+}
+
+void multiply_neon(float* x, const float* window, std::size_t n) noexcept {
+  const std::size_t blocked = n - (n % 4);
+  for (std::size_t i = 0; i < blocked; i += 4) {
+    vst1q_f32(x + i, vmulq_f32(vld1q_f32(x + i), vld1q_f32(window + i)));
+  }
+  multiply_scalar(x + blocked, window + blocked, n - blocked);
+}
+
+float dot_product_neon(const float* a, const float* b,
+                       std::size_t n) noexcept {
+  float32x4_t acc0 = vdupq_n_f32(0.0f);
+  float32x4_t acc1 = vdupq_n_f32(0.0f);
+  const std::size_t blocked = n - (n % 8);
+  for (std::size_t i = 0; i < blocked; i += 8) {
+    acc0 = vaddq_f32(acc0, vmulq_f32(vld1q_f32(a + i), vld1q_f32(b + i)));
+    acc1 =
+        vaddq_f32(acc1, vmulq_f32(vld1q_f32(a + i + 4), vld1q_f32(b + i + 4)));
+  }
+
+  float sum = vaddvq_f32(vaddq_f32(acc0, acc1));
+  for (std::size_t i = blocked; i < n; ++i) {
+    sum += a[i] * b[i];
+  }
+  return sum;
+}
+
+void int16_to_float_neon(const std::int16_t* src, float* dst,
+                         std::size_t n) noexcept {
+  const std::size_t blocked = n - (n % 8);
+  for (std::size_t i = 0; i < blocked; i += 8) {
+    const int16x8_t v = vld1q_s16(src + i);
+    const float32x4_t lo = vcvtq_f32_s32(vmovl_s16(vget_low_s16(v)));
+    const float32x4_t hi = vcvtq_f32_s32(vmovl_high_s16(v));
+    vst1q_f32(dst + i, vmulq_n_f32(lo, kInt16ToFloat));
+    vst1q_f32(dst + i + 4, vmulq_n_f32(hi, kInt16ToFloat));
+  }
+  int16_to_float_scalar(src + blocked, dst + blocked, n - blocked);
+}
+
+void float_to_int16_neon(const float* src, std::int16_t* dst,
+                         std::size_t n) noexcept {
+  const float32x4_t lower = vdupq_n_f32(-1.0f);
+  const float32x4_t upper = vdupq_n_f32(1.0f);
+  const std::size_t blocked = n - (n % 8);
+  for (std::size_t i = 0; i < blocked; i += 8) {
+    const float32x4_t lo = vminq_f32(vmaxq_f32(vld1q_f32(src + i), lower),
+                                     upper);
+    const float32x4_t hi = vminq_f32(vmaxq_f32(vld1q_f32(src + i + 4), lower),
+                                     upper);
+    const int32x4_t lo_rounded = vcvtnq_s32_f32(vmulq_n_f32(lo, kFloatToInt16));
+    const int32x4_t hi_rounded = vcvtnq_s32_f32(vmulq_n_f32(hi, kFloatToInt16));
+    vst1q_s16(dst + i,
+              vcombine_s16(vqmovn_s32(lo_rounded), vqmovn_s32(hi_rounded)));
+  }
+  float_to_int16_scalar(src + blocked, dst + blocked, n - blocked);
+}
+
+double dc_window_neon(const float* src, const float* window, float mean,
+                      float* dst, std::size_t n) noexcept {
+  const float32x4_t offset = vdupq_n_f32(mean);
+  float64x2_t energy_lo = vdupq_n_f64(0.0);
+  float64x2_t energy_hi = vdupq_n_f64(0.0);
+  const std::size_t blocked = n - (n % 4);
+  for (std::size_t i = 0; i < blocked; i += 4) {
+    float32x4_t value = vsubq_f32(vld1q_f32(src + i), offset);
+    if (window != nullptr) {
+      value = vmulq_f32(value, vld1q_f32(window + i));
+    }
+    vst1q_f32(dst + i, value);
+    const float64x2_t lo = vcvt_f64_f32(vget_low_f32(value));
+    const float64x2_t hi = vcvt_high_f64_f32(value);
+    energy_lo = vaddq_f64(energy_lo, vmulq_f64(lo, lo));
+    energy_hi = vaddq_f64(energy_hi, vmulq_f64(hi, hi));
+  }
+
+  const float* tail_window = window != nullptr ? window + blocked : nullptr;
+  return vaddvq_f64(vaddq_f64(energy_lo, energy_hi)) +
+         dc_window_scalar(src + blocked, tail_window, mean, dst + blocked,
+                          n - blocked);
+}
+
+constexpr Kernels kNeonKernels = {
+    SimdLevel::kNeon,    block_stats_neon,    subtract_neon,
+    multiply_neon,       dot_product_neon,    int16_to_float_neon,
+    float_to_int16_neon, dc_window_neon,
+};
+
+#endif  // SIMPLE_TUNER_DSP_NEON
+
+const Kernels* kernels_for(SimdLevel level) noexcept {
+  switch (level) {
+    case SimdLevel::kScalar:
+      return &kScalarKernels;
+    case SimdLevel::kSse2:
+#if defined(SIMPLE_TUNER_DSP_SSE2)
+      return &kSse2Kernels;
+#else
+      return nullptr;
+#endif
+    case SimdLevel::kAvx2:
+#if defined(SIMPLE_TUNER_DSP_AVX2)
+      return __builtin_cpu_supports("avx2") ? &kAvx2Kernels : nullptr;
+#else
+      return nullptr;
+#endif
+    case SimdLevel::kNeon:
+#if defined(SIMPLE_TUNER_DSP_NEON)
+      return &kNeonKernels;
+#else
+      return nullptr;
+#endif
+  }
+  return nullptr;
+}
+
+// Selected on first use; every table is constant data, so a racing first
+// call from two threads stores the same pointer
+std::atomic<const Kernels*> g_active_kernels{nullptr};
+
+const Kernels& active_kernels() noexcept {
+  const Kernels* kernels = g_active_kernels.load(std::memory_order_relaxed);
+  if (kernels == nullptr) {
+    kernels = kernels_for(detect_simd_level());
+    g_active_kernels.store(kernels, std::memory_order_relaxed);
+  }
+  return *kernels;
+}
+
+}  // namespace
+
+double sum(const float* x, std::size_t n) noexcept {
+  return active_kernels().block_stats(x, n).sum;
+}
+
+double sum_of_squares(const float* x, std::size_t n) noexcept {
+  return active_kernels().block_stats(x, n).sum_squares;
+}
+
+BlockStats block_stats(const float* x, std::size_t n) noexcept {
+  return active_kernels().block_stats(x, n);
+}
+
+void subtract(float* x, std::size_t n, float value) noexcept {
+  active_kernels().subtract(x, n, value);
+}
+
+void multiply(float* x, const float* window, std::size_t n) noexcept {
+  active_kernels().multiply(x, window, n);
+}
+
+float dot_product(const float* a, const float* b, std::size_t n) noexcept {
+  return active_kernels().dot_product(a, b, n);
+}
+
+void int16_to_float(const std::int16_t* src, float* dst,
+                    std::size_t n) noexcept {
+  active_kernels().int16_to_float(src, dst, n);
+}
+
+void float_to_int16(const float* src, std::int16_t* dst,
+                    std::size_t n) noexcept {
+  active_kernels().float_to_int16(src, dst, n);
+}
+
+BlockStats preprocess_frame(const float* src, const float* window, float* dst,
+                            std::size_t n, double* processed_energy) noexcept {
+  const Kernels& kernels = active_kernels();
+  const BlockStats stats = kernels.block_stats(src, n);
+  const float mean =
+      n > 0 ? static_cast<float>(stats.sum / static_cast<double>(n)) : 0.0f;
+  const double energy = kernels.dc_window(src, window, mean, dst, n);
+  if (processed_energy != nullptr) {
+    *processed_energy = energy;
+  }
+  return stats;
+}
+
+SimdLevel simd_level() noexcept { return active_kernels().level; }
+
+SimdLevel detect_simd_level() noexcept {
+  for (SimdLevel level :
+       {SimdLevel::kAvx2, SimdLevel::kNeon, SimdLevel::kSse2}) {
+    if (kernels_for(level) != nullptr) {
+      return level;
+    }
+  }
+  return SimdLevel::kScalar;
+}
+
+bool force_simd_level(SimdLevel level) noexcept {
+  const Kernels* kernels = kernels_for(level);
+  if (kernels == nullptr) {
+    return false;
+  }
+  g_active_kernels.store(kernels, std::memory_order_relaxed);
+  return true;
+}
+
+}  // namespace dsp
+}  // namespace simple_tuner
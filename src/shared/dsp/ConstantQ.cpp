@@ -0,0 +1,125 @@
+#include "simple_tuner/dsp/ConstantQ.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace simple_tuner {
+namespace dsp {
+
+namespace {
+constexpr double kPi = 3.14159265358979323846;
+constexpr double kTwoPi = 2.0 * kPi;
+constexpr double kMaxBinFraction = 0.45;  // Of the sample rate
+
+double q_for(int bins_per_octave, double window_scale) noexcept {
+  return window_scale /
+         (std::pow(2.0, 1.0 / static_cast<double>(bins_per_octave)) - 1.0);
+}
+
+// Bins below kMaxBinFraction of the sample rate
+int usable_bins(double sample_rate, double min_frequency, int num_bins,
+                int bins_per_octave) noexcept {
+  const double limit = kMaxBinFraction * sample_rate / min_frequency;
+  const int max_bins = static_cast<int>(
+      std::ceil(static_cast<double>(bins_per_octave) * std::log2(limit)));
+  return std::max(0, std::min(num_bins, max_bins));
+}
+
+std::size_t longest_window(double sample_rate, double min_frequency,
+                           double q) noexcept {
+  return static_cast<std::size_t>(std::ceil(q * sample_rate / min_frequency));
+}
+}  // namespace
+
+ConstantQTransform::ConstantQTransform(double sample_rate,
+                                       double min_frequency, int num_bins,
+                                       int bins_per_octave,
+                                       double window_scale, double sparsity)
+    : sample_rate_(sample_rate > 0.0 ? sample_rate : 48000.0),
+      min_frequency_(min_frequency > 0.0 ? min_frequency : 27.5),
+      num_bins_(0),
+      bins_per_octave_(std::max(bins_per_octave, 1)),
+      q_(q_for(bins_per_octave_, window_scale > 0.0 ? window_scale : 1.0)),
+      fft_(longest_window(sample_rate_, min_frequency_, q_)),
+      spectrum_(fft_.size()) {
+  num_bins_ = usable_bins(sample_rate_, min_frequency_, num_bins,
+                          bins_per_octave_);
+  bins_.resize(static_cast<std::size_t>(num_bins_));
+  row_start_.reserve(static_cast<std::size_t>(num_bins_) + 1);
+  row_start_.push_back(0);
+
+  const std::size_t size = fft_.size();
+  const double scale = 1.0 / static_cast<double>(size);
+  std::vector<std::complex<double>> kernel(size);
+  for (int bin = 0; bin < num_bins_; ++bin) {
+    const double frequency = bin_frequency(bin);
+    const std::size_t length = std::min(window_length(bin), size);
+    const std::size_t offset = (size - length) / 2;
+    std::fill(kernel.begin(), kernel.end(), std::complex<double>());
+    double window_sum = 0.0;
+    for (std::size_t n = 0; n < length; ++n) {
+      const double w = 0.5 - 0.5 * std::cos(kTwoPi * (n + 0.5) /
+                                            static_cast<double>(length));
+      window_sum += w;
+      kernel[offset + n] = std::polar(
+          w, kTwoPi * frequency * static_cast<double>(n) / sample_rate_);
+    }
+    // Twice the window's mean: a real sinusoid's positive half reads A
+    const double gain = 2.0 / window_sum;
+    fft_.forward(kernel.data());
+    double peak = 0.0;
+    for (const auto& value : kernel) {
+      peak = std::max(peak, std::abs(value));
+    }
+    const double threshold = sparsity * peak;
+    for (std::size_t i = 0; i < size; ++i) {
+      if (std::abs(kernel[i]) >= threshold) {
+        columns_.push_back(static_cast<std::uint32_t>(i));
+        values_.push_back(std::conj(kernel[i]) * (gain * scale));
+      }
+    }
+    row_start_.push_back(values_.size());
+  }
+}
+
+double ConstantQTransform::bin_frequency(int bin) const noexcept {
+  return min_frequency_ * std::exp2(static_cast<double>(bin) /
+                                    static_cast<double>(bins_per_octave_));
+}
+
+std::size_t ConstantQTransform::window_length(int bin) const noexcept {
+  return std::max<std::size_t>(
+      static_cast<std::size_t>(
+          std::lround(q_ * sample_rate_ / bin_frequency(bin))),
+      1);
+}
+
+void ConstantQTransform::transform(const float* frame,
+                                   std::complex<double>* out) noexcept {
+  const std::size_t size = fft_.size();
+  for (std::size_t i = 0; i < size; ++i) {
+    spectrum_[i] = std::complex<double>(frame[i], 0.0);
+  }
+  fft_.forward(spectrum_.data());
+  // Parseval: sum x conj(k) = (1 / N) sum X conj(K)
+  for (int bin = 0; bin < num_bins_; ++bin) {
+    std::complex<double> sum;
+    const std::size_t end = row_start_[static_cast<std::size_t>(bin) + 1];
+    for (std::size_t i = row_start_[static_cast<std::size_t>(bin)]; i < end;
+         ++i) {
+      sum += spectrum_[columns_[i]] * values_[i];
+    }
+    out[bin] = sum;
+  }
+}
+
+void ConstantQTransform::magnitudes(const float* frame, float* out) noexcept {
+  transform(frame, bins_.data());
+  for (int bin = 0; bin < num_bins_; ++bin) {
+    out[bin] =
+        static_cast<float>(std::abs(bins_[static_cast<std::size_t>(bin)]));
+  }
+}
+
+}  // namespace dsp
+}  // namespace simple_tuner
@@ -0,0 +1,145 @@
+#include "simple_tuner/dsp/Fft.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace simple_tuner {
+namespace dsp {
+
+namespace {
+constexpr double kPi = 3.14159265358979323846;
+constexpr double kTwoPi = 2.0 * kPi;
+}  // namespace
+
+std::size_t Fft::next_power_of_two(std::size_t value) noexcept {
+  std::size_t result = 2;
+  while (result < value) {
+    result <<= 1;
+  }
+  return result;
+}
+
+Fft::Fft(std::size_t size) : Fft(size, nullptr) {}
+
+Fft::Fft(std::size_t size, BufferArena& arena) : Fft(size, &arena) {}
+
+Fft::Fft(std::size_t size, BufferArena* arena)
+    : size_(next_power_of_two(size)),
+      twiddles_(size_ / 2, std::complex<double>(),
+                ArenaAllocator<std::complex<double>>(arena)),
+      bit_reversed_(size_, 0, ArenaAllocator<std::size_t>(arena)) {
+  for (std::size_t k = 0; k < size_ / 2; ++k) {
+    twiddles_[k] = std::polar(1.0, -kTwoPi * static_cast<double>(k) /
+                                       static_cast<double>(size_));
+  }
+  std::size_t bits = 0;
+  while ((std::size_t{1} << bits) < size_) {
+    ++bits;
+  }
+  for (std::size_t i = 0; i < size_; ++i) {
+    std::size_t reversed = 0;
+    for (std::size_t b = 0; b < bits; ++b) {
+      reversed |= ((i >> b) & 1) << (bits - 1 - b);
+    }
+    bit_reversed_[i] = reversed;
+  }
+}
+
+std::size_t Fft::arena_bytes(std::size_t size) noexcept {
+  const std::size_t rounded = next_power_of_two(size);
+  return BufferArena::footprint<std::complex<double>>(rounded / 2) +
+         BufferArena::footprint<std::size_t>(rounded);
+}
+
+void Fft::forward(std::complex<double>* data) const noexcept {
+  transform(data, false);
+}
+
+void Fft::inverse(std::complex<double>* data) const noexcept {
+  transform(data, true);
+  const double scale = 1.0 / static_cast<double>(size_);
+  for (std::size_t i = 0; i < size_; ++i) {
+    data[i] *= scale;
+  }
+}
+
+void Fft::transform(std::complex<double>* data, bool inverse) const noexcept {
+  for (std::size_t i = 0; i < size_; ++i) {
+    if (i < bit_reversed_[i]) {
+      std::swap(data[i], data[bit_reversed_[i]]);
+    }
+  }
+  // Iterative decimation in time; the inverse uses conjugate twiddles.
+  // The twiddle product is written out: std::complex's operator* checks
+  // every result for NaN (C99 Annex G), which made it most of the cost.
+  const double sign = inverse ? -1.0 : 1.0;
+  for (std::size_t span = 1; span < size_; span <<= 1) {
+    const std::size_t stride = size_ / (2 * span);
+    for (std::size_t start = 0; start < size_; start += 2 * span) {
+      for (std::size_t k = 0; k < span; ++k) {
+        const double w_re = twiddles_[k * stride].real();
+        const double w_im = sign * twiddles_[k * stride].imag();
+        const std::complex<double> x = data[start + k + span];
+        const std::complex<double> odd(w_re * x.real() - w_im * x.imag(),
+                                       w_re * x.imag() + w_im * x.real());
+        data[start + k + span] = data[start + k] - odd;
+        data[start + k] += odd;
+      }
+    }
+  }
+}
+
+ChirpZTransform::ChirpZTransform(std::size_t input_length,
+                                 std::size_t max_points, double spacing)
+    : input_length_(std::max<std::size_t>(input_length, 1)),
+      max_points_(std::max<std::size_t>(max_points, 1)),
+      spacing_(spacing),
+      fft_(input_length_ + max_points_ - 1),
+      filter_(fft_.size()),
+      work_(fft_.size()) {
+  // Inverse chirp at lags -(input_length - 1) .. max_points - 1, stored
+  // circularly so the FFT product is their linear convolution
+  const std::size_t size = fft_.size();
+  std::fill(filter_.begin(), filter_.end(), std::complex<double>());
+  for (std::size_t m = 0; m < max_points_; ++m) {
+    filter_[m] = std::conj(chirp(m));
+  }
+  for (std::size_t m = 1; m < input_length_; ++m) {
+    filter_[size - m] = std::conj(chirp(m));
+  }
+  fft_.forward(filter_.data());
+}
+
+std::complex<double> ChirpZTransform::chirp(std::size_t n) const noexcept {
+  const double n_double = static_cast<double>(n);
+  const double phase =
+      std::remainder(0.5 * spacing_ * n_double * n_double, kTwoPi);
+  return std::polar(1.0, -phase);
+}
+
+void ChirpZTransform::transform(const float* x, double start,
+                                std::size_t num_points,
+                                std::complex<double>* out) noexcept {
+  // kn = (k^2 + n^2 - (k - n)^2) / 2 turns the zoomed DTFT into a
+  // convolution with the inverse chirp
+  num_points = std::min(num_points, max_points_);
+  for (std::size_t n = 0; n < input_length_; ++n) {
+    const double phase =
+        std::remainder(start * static_cast<double>(n), kTwoPi);
+    work_[n] = static_cast<double>(x[n]) * std::polar(1.0, -phase) * chirp(n);
+  }
+  std::fill(work_.begin() + static_cast<std::ptrdiff_t>(input_length_),
+            work_.end(), std::complex<double>());
+  fft_.forward(work_.data());
+  for (std::size_t i = 0; i < work_.size(); ++i) {
+    work_[i] *= filter_[i];
+  }
+  fft_.inverse(work_.data());
+  for (std::size_t k = 0; k < num_points; ++k) {
+    out[k] = work_[k] * chirp(k);
+  }
+}
+
+}  // namespace dsp
+}  // namespace simple_tuner
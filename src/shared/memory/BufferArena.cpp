@@ -0,0 +1,30 @@
+#include "simple_tuner/memory/BufferArena.h"
+
+namespace simple_tuner {
+
+BufferArena::BufferArena(std::size_t capacity_bytes)
+    : block_(nullptr),
+      capacity_(round_up(capacity_bytes, kPageSize)),
+      offset_(0) {
+  if (capacity_ > 0) {
+    block_ = static_cast<unsigned char*>(
+        ::operator new(capacity_, std::align_val_t(kPageSize)));
+  }
+}
+
+BufferArena::~BufferArena() {
+  if (block_ != nullptr) {
+    ::operator delete(block_, capacity_, std::align_val_t(kPageSize));
+  }
+}
+
+void* BufferArena::allocate_bytes(std::size_t bytes) noexcept {
+  if (bytes > capacity_ - offset_) {
+    return nullptr;
+  }
+  void* storage = block_ + offset_;
+  offset_ += bytes;
+  return storage;
+}
+
+}  // namespace simple_tuner
@@ -0,0 +1,99 @@
+#include "simple_tuner/session/ChunkFileWriter.h"
+
+namespace simple_tuner {
+namespace session_log {
+
+ChunkFileWriter::ChunkFileWriter() noexcept
+    : file_(nullptr), offset_(0), failed_(false) {}
+
+ChunkFileWriter::~ChunkFileWriter() { close(); }
+
+bool ChunkFileWriter::open(const std::string& path) {
+  if (file_ != nullptr) {
+    return false;
+  }
+  file_ = std::fopen(path.c_str(), "wb");
+  if (file_ == nullptr) {
+    return false;
+  }
+  offset_ = 0;
+  index_.clear();
+  failed_ = false;
+  unsigned char header[kFileHeaderBytes];
+  encode_file_header(0, header);
+  if (!write_bytes(header, sizeof(header))) {
+    std::fclose(file_);
+    file_ = nullptr;
+    return false;
+  }
+  return true;
+}
+
+bool ChunkFileWriter::write_chunk(const ChunkHeader& header,
+                                  const unsigned char* payload) {
+  if (file_ == nullptr || failed_) {
+    return false;
+  }
+  const std::uint64_t offset = offset_;
+  unsigned char bytes[kChunkHeaderBytes];
+  encode_chunk_header(header, bytes);
+  if (!write_bytes(bytes, sizeof(bytes)) ||
+      !write_bytes(payload, header.payload_bytes)) {
+    return false;
+  }
+  if (header.type != ChunkType::kIndex) {
+    IndexEntry entry;
+    entry.offset = offset;
+    entry.header = header;
+    index_.push_back(entry);
+  }
+  return true;
+}
+
+bool ChunkFileWriter::flush() {
+  if (file_ == nullptr || failed_) {
+    return false;
+  }
+  if (std::fflush(file_) != 0) {
+    failed_ = true;
+  }
+  return !failed_;
+}
+
+bool ChunkFileWriter::close() {
+  if (file_ == nullptr) {
+    return false;
+  }
+  if (!failed_) {
+    const std::uint64_t index_offset = offset_;
+    ChunkHeader header;
+    payload_.clear();
+    encode_index(index_.data(), index_.size(), header, payload_);
+    unsigned char file_header[kFileHeaderBytes];
+    encode_file_header(index_offset, file_header);
+    if (write_chunk(header, payload_.data()) &&
+        std::fseek(file_, 0, SEEK_SET) == 0) {
+      write_bytes(file_header, sizeof(file_header));
+    } else {
+      failed_ = true;
+    }
+  }
+  if (std::fclose(file_) != 0) {
+    failed_ = true;
+  }
+  file_ = nullptr;
+  return !failed_;
+}
+
+bool ChunkFileWriter::write_bytes(const unsigned char* data,
+                                  std::size_t bytes) noexcept {
+  if (bytes > 0 && std::fwrite(data, 1, bytes, file_) != bytes) {
+    failed_ = true;
+    return false;
+  }
+  offset_ += bytes;
+  return true;
+}
+
+}  // namespace session_log
+}  // namespace simple_tuner
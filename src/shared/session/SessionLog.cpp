@@ -0,0 +1,411 @@
+#include "simple_tuner/session/SessionLog.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace simple_tuner {
+namespace session_log {
+
+namespace {
+constexpr double kTicksPerSecond = 1e6;  // Delta-encoded time resolution
+constexpr int kNumKeys = TuningTable::kNumKeys;
+constexpr std::size_t kDetectionFixedBytes = 3 * 4 + 1;  // Per record
+constexpr int kSummaryFloats = 12;
+constexpr std::size_t kSummaryBytes = 8 + 1 + 4 + 8 + 1 + kSummaryFloats * 8;
+
+std::int64_t to_ticks(double time) noexcept {
+  return static_cast<std::int64_t>(std::llround(time * kTicksPerSecond));
+}
+
+void put_varint(std::vector<unsigned char>& out, std::int64_t value) {
+  // Zigzag: small magnitudes of either sign take few bytes
+  auto bits = (static_cast<std::uint64_t>(value) << 1) ^
+              static_cast<std::uint64_t>(value >> 63);
+  while (bits >= 0x80) {
+    out.push_back(static_cast<unsigned char>(bits | 0x80));
+    bits >>= 7;
+  }
+  out.push_back(static_cast<unsigned char>(bits));
+}
+
+// Reads a varint from [*in, end); false if truncated
+bool get_varint(const unsigned char*& in, const unsigned char* end,
+                std::int64_t& value) noexcept {
+  std::uint64_t bits = 0;
+  for (int shift = 0; shift < 64 && in < end; shift += 7) {
+    const unsigned char byte = *in++;
+    bits |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+    if ((byte & 0x80) == 0) {
+      value = static_cast<std::int64_t>(bits >> 1) ^
+              -static_cast<std::int64_t>(bits & 1);
+      return true;
+    }
+  }
+  return false;
+}
+
+int key_index(int midi_note) noexcept {
+  return midi_note - TuningTable::kFirstKey;
+}
+}  // namespace
+
+void put_u16(unsigned char* out, std::uint16_t value) noexcept {
+  out[0] = static_cast<unsigned char>(value);
+  out[1] = static_cast<unsigned char>(value >> 8);
+}
+
+void put_u32(unsigned char* out, std::uint32_t value) noexcept {
+  for (int i = 0; i < 4; ++i) {
+    out[i] = static_cast<unsigned char>(value >> (8 * i));
+  }
+}
+
+void put_u64(unsigned char* out, std::uint64_t value) noexcept {
+  for (int i = 0; i < 8; ++i) {
+    out[i] = static_cast<unsigned char>(value >> (8 * i));
+  }
+}
+
+void put_f32(unsigned char* out, float value) noexcept {
+  std::uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  put_u32(out, bits);
+}
+
+void put_f64(unsigned char* out, double value) noexcept {
+  std::uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  put_u64(out, bits);
+}
+
+std::uint16_t get_u16(const unsigned char* in) noexcept {
+  return static_cast<std::uint16_t>(in[0] | (in[1] << 8));
+}
+
+std::uint32_t get_u32(const unsigned char* in) noexcept {
+  std::uint32_t value = 0;
+  for (int i = 3; i >= 0; --i) {
+    value = (value << 8) | in[i];
+  }
+  return value;
+}
+
+std::uint64_t get_u64(const unsigned char* in) noexcept {
+  std::uint64_t value = 0;
+  for (int i = 7; i >= 0; --i) {
+    value = (value << 8) | in[i];
+  }
+  return value;
+}
+
+float get_f32(const unsigned char* in) noexcept {
+  const std::uint32_t bits = get_u32(in);
+  float value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+double get_f64(const unsigned char* in) noexcept {
+  const std::uint64_t bits = get_u64(in);
+  double value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+void ChunkHeader::add_key(int midi_note) noexcept {
+  const int index = key_index(midi_note);
+  if (index < 0 || index >= kNumKeys) {
+    return;
+  }
+  if (index < 64) {
+    key_mask_low |= std::uint64_t{1} << index;
+  } else {
+    key_mask_high |= std::uint32_t{1} << (index - 64);
+  }
+}
+
+bool ChunkHeader::has_key(int midi_note) const noexcept {
+  if (midi_note == 0) {
+    return true;
+  }
+  const int index = key_index(midi_note);
+  if (index < 0 || index >= kNumKeys) {
+    return false;
+  }
+  return index < 64 ? ((key_mask_low >> index) & 1) != 0
+                    : ((key_mask_high >> (index - 64)) & 1) != 0;
+}
+
+void encode_file_header(std::uint64_t index_offset,
+                        unsigned char* out) noexcept {
+  std::memset(out, 0, kFileHeaderBytes);
+  std::memcpy(out, kMagic, sizeof(kMagic));
+  put_u32(out + 8, kVersion);
+  put_u32(out + 12, static_cast<std::uint32_t>(kFileHeaderBytes));
+  put_u64(out + 16, index_offset);
+}
+
+bool decode_file_header(const unsigned char* in, std::size_t bytes,
+                        std::uint64_t& index_offset) noexcept {
+  if (bytes < kFileHeaderBytes ||
+      std::memcmp(in, kMagic, sizeof(kMagic)) != 0 ||
+      get_u32(in + 8) != kVersion ||
+      get_u32(in + 12) != kFileHeaderBytes) {
+    return false;
+  }
+  index_offset = get_u64(in + 16);
+  return true;
+}
+
+void encode_chunk_header(const ChunkHeader& header,
+                         unsigned char* out) noexcept {
+  put_u32(out, kChunkMagic);
+  put_u16(out + 4, static_cast<std::uint16_t>(header.type));
+  put_u16(out + 6, header.flags);
+  put_u32(out + 8, header.count);
+  put_u32(out + 12, header.payload_bytes);
+  put_f64(out + 16, header.first_time);
+  put_f64(out + 24, header.last_time);
+  put_u64(out + 32, header.key_mask_low);
+  put_u32(out + 40, header.key_mask_high);
+  put_u32(out + 44, 0);
+}
+
+bool decode_chunk_header(const unsigned char* in,
+                         ChunkHeader& header) noexcept {
+  if (get_u32(in) != kChunkMagic) {
+    return false;
+  }
+  const std::uint16_t type = get_u16(in + 4);
+  if (type < static_cast<std::uint16_t>(ChunkType::kDetections) ||
+      type > static_cast<std::uint16_t>(ChunkType::kControls)) {
+    return false;
+  }
+  header.type = static_cast<ChunkType>(type);
+  header.flags = get_u16(in + 6);
+  header.count = get_u32(in + 8);
+  header.payload_bytes = get_u32(in + 12);
+  header.first_time = get_f64(in + 16);
+  header.last_time = get_f64(in + 24);
+  header.key_mask_low = get_u64(in + 32);
+  header.key_mask_high = get_u32(in + 40);
+  return true;
+}
+
+void encode_detections(const LoggedDetection* detections, std::size_t count,
+                       ChunkHeader& header, std::vector<unsigned char>& out) {
+  header.type = ChunkType::kDetections;
+  header.count = static_cast<std::uint32_t>(count);
+  header.key_mask_low = 0;
+  header.key_mask_high = 0;
+  header.first_time = count > 0 ? detections[0].time : 0.0;
+  header.last_time = header.first_time;
+
+  const std::size_t start = out.size();
+  out.resize(start + count * kDetectionFixedBytes);
+  unsigned char* frequency = out.data() + start;
+  unsigned char* confidence = frequency + 4 * count;
+  unsigned char* cents = confidence + 4 * count;
+  unsigned char* key = cents + 4 * count;
+  for (std::size_t i = 0; i < count; ++i) {
+    const LoggedDetection& d = detections[i];
+    put_f32(frequency + 4 * i, static_cast<float>(d.frequency));
+    put_f32(confidence + 4 * i, static_cast<float>(d.confidence));
+    put_f32(cents + 4 * i, static_cast<float>(d.cents));
+    key[i] = static_cast<unsigned char>(std::clamp(d.midi_note, 0, 255));
+    header.add_key(d.midi_note);
+    header.first_time = std::min(header.first_time, d.time);
+    header.last_time = std::max(header.last_time, d.time);
+  }
+  if ((header.flags & kDeltaTimes) != 0) {
+    std::int64_t previous = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+      const std::int64_t ticks = to_ticks(detections[i].time);
+      put_varint(out, ticks - previous);
+      previous = ticks;
+    }
+  } else {
+    const std::size_t times = out.size();
+    out.resize(times + 8 * count);
+    for (std::size_t i = 0; i < count; ++i) {
+      put_f64(out.data() + times + 8 * i, detections[i].time);
+    }
+  }
+  header.payload_bytes = static_cast<std::uint32_t>(out.size() - start);
+}
+
+bool decode_detections(const unsigned char* payload,
+                       const ChunkHeader& header, double start_time,
+                       double end_time, int midi_note,
+                       std::vector<LoggedDetection>& out) {
+  const std::size_t count = header.count;
+  const std::size_t fixed = count * kDetectionFixedBytes;
+  if (header.type != ChunkType::kDetections ||
+      header.payload_bytes < fixed) {
+    return false;
+  }
+  const unsigned char* frequency = payload;
+  const unsigned char* confidence = frequency + 4 * count;
+  const unsigned char* cents = confidence + 4 * count;
+  const unsigned char* key = cents + 4 * count;
+  const unsigned char* times = key + count;
+  const unsigned char* end = payload + header.payload_bytes;
+  const bool delta = (header.flags & kDeltaTimes) != 0;
+  if (!delta && static_cast<std::size_t>(end - times) < 8 * count) {
+    return false;
+  }
+
+  std::int64_t ticks = 0;
+  for (std::size_t i = 0; i < count; ++i) {
+    double time = 0.0;
+    if (delta) {
+      std::int64_t step = 0;
+      if (!get_varint(times, end, step)) {
+        return false;
+      }
+      ticks += step;
+      time = static_cast<double>(ticks) / kTicksPerSecond;
+    } else {
+      time = get_f64(times + 8 * i);
+    }
+    if (time < start_time || time >= end_time ||
+        (midi_note != 0 && key[i] != midi_note)) {
+      continue;
+    }
+    LoggedDetection d;
+    d.time = time;
+    d.frequency = get_f32(frequency + 4 * i);
+    d.confidence = get_f32(confidence + 4 * i);
+    d.cents = get_f32(cents + 4 * i);
+    d.midi_note = key[i];
+    out.push_back(d);
+  }
+  return true;
+}
+
+void encode_summaries(const LoggedSummary* summaries, std::size_t count,
+                      ChunkHeader& header, std::vector<unsigned char>& out) {
+  header.type = ChunkType::kSummaries;
+  header.flags = 0;
+  header.count = static_cast<std::uint32_t>(count);
+  header.key_mask_low = 0;
+  header.key_mask_high = 0;
+  header.first_time = count > 0 ? summaries[0].time : 0.0;
+  header.last_time = header.first_time;
+
+  const std::size_t start = out.size();
+  out.resize(start + count * kSummaryBytes);
+  unsigned char* time = out.data() + start;
+  unsigned char* key = time + 8 * count;
+  unsigned char* segments = key + count;
+  unsigned char* samples = segments + 4 * count;
+  unsigned char* stable = samples + 8 * count;
+  unsigned char* floats = stable + count;
+  for (std::size_t i = 0; i < count; ++i) {
+    const LoggedSummary& s = summaries[i];
+    const KeySummary& k = s.summary;
+    put_f64(time + 8 * i, s.time);
+    key[i] = static_cast<unsigned char>(std::clamp(k.midi_note, 0, 255));
+    put_u32(segments + 4 * i, static_cast<std::uint32_t>(k.segments));
+    put_u64(samples + 8 * i, k.count);
+    stable[i] = k.is_stable ? 1 : 0;
+    const double values[kSummaryFloats] = {
+        k.median, k.lower_quartile, k.upper_quartile, k.mean,
+        k.stddev, k.minimum,        k.maximum,        k.recent,
+        k.recent_stddev, k.drift,   k.start_time,     k.last_time};
+    for (int f = 0; f < kSummaryFloats; ++f) {
+      put_f64(floats + 8 * (f * count + i), values[f]);
+    }
+    header.add_key(k.midi_note);
+    header.first_time = std::min(header.first_time, s.time);
+    header.last_time = std::max(header.last_time, s.time);
+  }
+  header.payload_bytes = static_cast<std::uint32_t>(out.size() - start);
+}
+
+bool decode_summaries(const unsigned char* payload,
+                      const ChunkHeader& header, int midi_note,
+                      std::vector<LoggedSummary>& out) {
+  const std::size_t count = header.count;
+  if (header.type != ChunkType::kSummaries ||
+      header.payload_bytes < count * kSummaryBytes) {
+    return false;
+  }
+  const unsigned char* time = payload;
+  const unsigned char* key = time + 8 * count;
+  const unsigned char* segments = key + count;
+  const unsigned char* samples = segments + 4 * count;
+  const unsigned char* stable = samples + 8 * count;
+  const unsigned char* floats = stable + count;
+  for (std::size_t i = 0; i < count; ++i) {
+    if (midi_note != 0 && key[i] != midi_note) {
+      continue;
+    }
+    double values[kSummaryFloats];
+    for (int f = 0; f < kSummaryFloats; ++f) {
+      values[f] = get_f64(floats + 8 * (f * count + i));
+    }
+    LoggedSummary s;
+    s.time = get_f64(time + 8 * i);
+    KeySummary& k = s.summary;
+    k.midi_note = key[i];
+    k.segments = static_cast<int>(get_u32(segments + 4 * i));
+    k.count = static_cast<std::size_t>(get_u64(samples + 8 * i));
+    k.is_stable = stable[i] != 0;
+    k.median = values[0];
+    k.lower_quartile = values[1];
+    k.upper_quartile = values[2];
+    k.mean = values[3];
+    k.stddev = values[4];
+    k.minimum = values[5];
+    k.maximum = values[6];
+    k.recent = values[7];
+    k.recent_stddev = values[8];
+    k.drift = values[9];
+    k.start_time = values[10];
+    k.last_time = values[11];
+    out.push_back(s);
+  }
+  return true;
+}
+
+void encode_index(const IndexEntry* entries, std::size_t count,
+                  ChunkHeader& header, std::vector<unsigned char>& out) {
+  header = ChunkHeader();
+  header.type = ChunkType::kIndex;
+  header.count = static_cast<std::uint32_t>(count);
+  const std::size_t entry_bytes = 8 + kChunkHeaderBytes;
+  const std::size_t start = out.size();
+  out.resize(start + count * entry_bytes);
+  for (std::size_t i = 0; i < count; ++i) {
+    unsigned char* entry = out.data() + start + i * entry_bytes;
+    put_u64(entry, entries[i].offset);
+    encode_chunk_header(entries[i].header, entry + 8);
+  }
+  header.payload_bytes = static_cast<std::uint32_t>(out.size() - start);
+}
+
+bool decode_index(const unsigned char* payload, const ChunkHeader& header,
+                  std::vector<IndexEntry>& out) {
+  const std::size_t entry_bytes = 8 + kChunkHeaderBytes;
+  if (header.type != ChunkType::kIndex ||
+      header.payload_bytes < header.count * entry_bytes) {
+    return false;
+  }
+  const std::size_t start = out.size();
+  for (std::size_t i = 0; i < header.count; ++i) {
+    const unsigned char* entry = payload + i * entry_bytes;
+    IndexEntry e;
+    e.offset = get_u64(entry);
+    if (!decode_chunk_header(entry + 8, e.header)) {
+      out.resize(start);
+      return false;
+    }
+    out.push_back(e);
+  }
+  return true;
+}
+
+}  // namespace session_log
+}  // namespace simple_tuner
@@ -0,0 +1,184 @@
+#include "simple_tuner/session/SessionLogReader.h"
+
+#include <cstdio>
+#include <utility>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace simple_tuner {
+
+namespace sl = session_log;
+
+SessionLogReader::SessionLogReader() noexcept
+    : data_(nullptr),
+      size_(0),
+      detection_count_(0),
+      summary_count_(0),
+      recovered_(false) {}
+
+SessionLogReader::~SessionLogReader() { close(); }
+
+bool SessionLogReader::open(const std::string& path) {
+  close();
+#if defined(_WIN32)
+  std::FILE* file = std::fopen(path.c_str(), "rb");
+  if (file == nullptr) {
+    return false;
+  }
+  unsigned char buffer[65536];
+  std::size_t read = 0;
+  while ((read = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+    contents_.insert(contents_.end(), buffer, buffer + read);
+  }
+  std::fclose(file);
+  if (contents_.empty()) {
+    return false;
+  }
+  data_ = contents_.data();
+  size_ = contents_.size();
+#else
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat info;
+  if (::fstat(fd, &info) != 0 || info.st_size <= 0) {
+    ::close(fd);
+    return false;
+  }
+  const auto size = static_cast<std::size_t>(info.st_size);
+  void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);  // The mapping keeps the file alive
+  if (mapping == MAP_FAILED) {
+    return false;
+  }
+  data_ = static_cast<const unsigned char*>(mapping);
+  size_ = size;
+#endif
+
+  std::uint64_t index_offset = 0;
+  if (!sl::decode_file_header(data_, size_, index_offset)) {
+    close();
+    return false;
+  }
+  recovered_ = index_offset == 0 || index_offset > size_ ||
+               !load_index(static_cast<std::size_t>(index_offset));
+  if (recovered_) {
+    scan_chunks();
+  }
+  for (const sl::IndexEntry& chunk : chunks_) {
+    if (chunk.header.type == sl::ChunkType::kDetections) {
+      detection_count_ += chunk.header.count;
+    } else if (chunk.header.type == sl::ChunkType::kSummaries) {
+      summary_count_ += chunk.header.count;
+    }
+  }
+  return true;
+}
+
+void SessionLogReader::close() noexcept {
+#if defined(_WIN32)
+  contents_.clear();
+  contents_.shrink_to_fit();
+#else
+  if (data_ != nullptr) {
+    ::munmap(const_cast<unsigned char*>(data_), size_);
+  }
+#endif
+  data_ = nullptr;
+  size_ = 0;
+  chunks_.clear();
+  detection_count_ = 0;
+  summary_count_ = 0;
+  recovered_ = false;
+}
+
+bool SessionLogReader::load_index(std::size_t index_offset) {
+  sl::ChunkHeader header;
+  if (size_ - index_offset < sl::kChunkHeaderBytes ||
+      !sl::decode_chunk_header(data_ + index_offset, header) ||
+      header.type != sl::ChunkType::kIndex ||
+      size_ - index_offset - sl::kChunkHeaderBytes < header.payload_bytes) {
+    return false;
+  }
+  std::vector<sl::IndexEntry> entries;
+  if (!sl::decode_index(data_ + index_offset + sl::kChunkHeaderBytes, header,
+                        entries)) {
+    return false;
+  }
+  for (const sl::IndexEntry& entry : entries) {
+    // Every listed chunk must lie before the index
+    if (entry.offset < sl::kFileHeaderBytes || entry.offset > index_offset ||
+        index_offset - entry.offset <
+            sl::kChunkHeaderBytes + entry.header.payload_bytes ||
+        entry.header.type == sl::ChunkType::kIndex) {
+      return false;
+    }
+  }
+  chunks_ = std::move(entries);
+  return true;
+}
+
+void SessionLogReader::scan_chunks() {
+  chunks_.clear();
+  std::size_t offset = sl::kFileHeaderBytes;
+  while (size_ - offset >= sl::kChunkHeaderBytes) {
+    sl::IndexEntry entry;
+    if (!sl::decode_chunk_header(data_ + offset, entry.header) ||
+        size_ - offset - sl::kChunkHeaderBytes < entry.header.payload_bytes) {
+      break;  // Torn write at the end of the log
+    }
+    entry.offset = offset;
+    if (entry.header.type != sl::ChunkType::kIndex) {
+      chunks_.push_back(entry);
+    }
+    offset += sl::kChunkHeaderBytes + entry.header.payload_bytes;
+  }
+}
+
+bool SessionLogReader::read_detections(
+    double start_time, double end_time, int midi_note,
+    std::vector<LoggedDetection>& out) const {
+  bool intact = true;
+  for (const sl::IndexEntry& chunk : chunks_) {
+    const sl::ChunkHeader& header = chunk.header;
+    if (header.type != sl::ChunkType::kDetections ||
+        header.last_time < start_time || header.first_time >= end_time ||
+        !header.has_key(midi_note)) {
+      continue;
+    }
+    const std::size_t before = out.size();
+    if (!sl::decode_detections(data_ + chunk.offset + sl::kChunkHeaderBytes,
+                               header, start_time, end_time, midi_note,
+                               out)) {
+      out.resize(before);
+      intact = false;
+    }
+  }
+  return intact;
+}
+
+bool SessionLogReader::read_summaries(
+    int midi_note, std::vector<LoggedSummary>& out) const {
+  bool intact = true;
+  for (const sl::IndexEntry& chunk : chunks_) {
+    if (chunk.header.type != sl::ChunkType::kSummaries ||
+        !chunk.header.has_key(midi_note)) {
+      continue;
+    }
+    const std::size_t before = out.size();
+    if (!sl::decode_summaries(data_ + chunk.offset + sl::kChunkHeaderBytes,
+                              chunk.header, midi_note, out)) {
+      out.resize(before);
+      intact = false;
+    }
+  }
+  return intact;
+}
+
+}  // namespace simple_tuner
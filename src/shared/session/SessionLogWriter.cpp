@@ -0,0 +1,182 @@
+#include "simple_tuner/session/SessionLogWriter.h"
+
+#include <chrono>
+#include <system_error>
+
+namespace simple_tuner {
+
+namespace sl = session_log;
+
+SessionLogWriter::SessionLogWriter(bool delta_encode_times)
+    : delta_encode_times_(delta_encode_times),
+      open_(false),
+      dropped_(0),
+      failed_(false),
+      flush_requested_(0),
+      flush_done_(0),
+      stop_(false) {}
+
+SessionLogWriter::~SessionLogWriter() { close(); }
+
+bool SessionLogWriter::open(const std::string& path) {
+  if (open_) {
+    return false;
+  }
+  if (!file_.open(path)) {
+    return false;
+  }
+  failed_.store(false, std::memory_order_relaxed);
+
+  // Leftovers of an earlier session
+  LoggedDetection detection;
+  while (detections_.try_pop(detection)) {
+  }
+  LoggedSummary summary;
+  while (summaries_.try_pop(summary)) {
+  }
+  pending_detections_.clear();
+  pending_detections_.reserve(kChunkRecords);
+  pending_summaries_.clear();
+  pending_summaries_.reserve(kSummaryChunkRecords);
+  dropped_.store(0, std::memory_order_relaxed);
+  flush_requested_ = 0;
+  flush_done_ = 0;
+  stop_ = false;
+
+  try {
+    worker_ = std::thread(&SessionLogWriter::run, this);
+  } catch (const std::system_error&) {
+    file_.close();
+    return false;
+  }
+  open_ = true;
+  return true;
+}
+
+bool SessionLogWriter::close() {
+  if (!open_) {
+    return false;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  wake_.notify_all();
+  worker_.join();
+  open_ = false;
+
+  // The worker drained everything before exiting
+  const bool written = file_.close();
+  failed_.store(!written, std::memory_order_relaxed);
+  return written;
+}
+
+bool SessionLogWriter::append(const LoggedDetection& detection) noexcept {
+  if (!open_) {
+    return false;
+  }
+  if (!detections_.try_push(detection)) {
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  return true;
+}
+
+bool SessionLogWriter::append(const LoggedSummary& summary) noexcept {
+  if (!open_) {
+    return false;
+  }
+  if (!summaries_.try_push(summary)) {
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  return true;
+}
+
+bool SessionLogWriter::flush() {
+  if (!open_) {
+    return false;
+  }
+  std::unique_lock<std::mutex> lock(mutex_);
+  const std::uint64_t request = ++flush_requested_;
+  wake_.notify_one();
+  flushed_.wait(lock, [this, request]() { return flush_done_ >= request; });
+  return !failed_.load(std::memory_order_relaxed);
+}
+
+void SessionLogWriter::run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    wake_.wait_for(lock, std::chrono::milliseconds(kPollIntervalMs),
+                   [this]() {
+                     return stop_ || flush_requested_ != flush_done_;
+                   });
+    const bool stopping = stop_;
+    const std::uint64_t request = flush_requested_;
+    const bool forced = stopping || request != flush_done_;
+    lock.unlock();
+
+    drain(forced);
+    if (forced) {
+      file_.flush();
+    }
+    failed_.store(file_.failed(), std::memory_order_relaxed);
+
+    lock.lock();
+    if (request != flush_done_) {
+      flush_done_ = request;
+      flushed_.notify_all();
+    }
+    if (stopping) {
+      return;
+    }
+  }
+}
+
+void SessionLogWriter::drain(bool force) {
+  LoggedDetection detection;
+  while (detections_.try_pop(detection)) {
+    pending_detections_.push_back(detection);
+    if (pending_detections_.size() >= kChunkRecords) {
+      write_detections();
+    }
+  }
+  LoggedSummary summary;
+  while (summaries_.try_pop(summary)) {
+    pending_summaries_.push_back(summary);
+    if (pending_summaries_.size() >= kSummaryChunkRecords) {
+      write_summaries();
+    }
+  }
+  if (force) {
+    write_detections();
+    write_summaries();
+  }
+}
+
+void SessionLogWriter::write_detections() {
+  if (pending_detections_.empty()) {
+    return;
+  }
+  sl::ChunkHeader header;
+  header.flags = delta_encode_times_ ? sl::kDeltaTimes : 0;
+  payload_.clear();
+  sl::encode_detections(pending_detections_.data(),
+                        pending_detections_.size(), header, payload_);
+  pending_detections_.clear();
+  file_.write_chunk(header, payload_.data());
+}
+
+void SessionLogWriter::write_summaries() {
+  if (pending_summaries_.empty()) {
+    return;
+  }
+  sl::ChunkHeader header;
+  payload_.clear();
+  sl::encode_summaries(pending_summaries_.data(), pending_summaries_.size(),
+                       header, payload_);
+  pending_summaries_.clear();
+  file_.write_chunk(header, payload_.data());
+}
+
+}  // namespace simple_tuner
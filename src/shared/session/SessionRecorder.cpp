@@ -0,0 +1,243 @@
+#include "simple_tuner/session/SessionRecorder.h"
+
+#include <system_error>
+
+namespace simple_tuner {
+
+namespace sl = session_log;
+
+namespace {
+constexpr std::size_t kChunkResults = 1024;
+
+std::int64_t now_ticks() noexcept {
+  return std::chrono::steady_clock::now().time_since_epoch().count();
+}
+}  // namespace
+
+SessionRecorder::SessionRecorder()
+    : sample_rate_(0.0),
+      recording_(false),
+      generation_(0),
+      start_ticks_(0),
+      audio_generation_(0),
+      blocks_(0),
+      gap_(false),
+      dropped_blocks_(0),
+      dropped_events_(0),
+      stop_(false) {}
+
+SessionRecorder::~SessionRecorder() { stop(); }
+
+bool SessionRecorder::start(const std::string& path, double sample_rate,
+                            std::size_t buffer_size) {
+  if (worker_.joinable() || !(sample_rate > 0.0) || buffer_size == 0 ||
+      !file_.open(path)) {
+    return false;
+  }
+  RecordingInfo info;
+  info.sample_rate = sample_rate;
+  info.buffer_size = buffer_size;
+  sl::ChunkHeader header;
+  payload_.clear();
+  sl::encode_recording_info(info, header, payload_);
+  if (!file_.write_chunk(header, payload_.data())) {
+    file_.close();
+    return false;
+  }
+
+  // Leftovers of a block that straddled the last stop()
+  float stale[256];
+  while (samples_.pop(stale, 256) > 0) {
+  }
+  RecordedBlock block;
+  while (blocks_queue_.try_pop(block)) {
+  }
+  RecordedResult result;
+  while (results_.try_pop(result)) {
+  }
+  RecordedControl control;
+  while (controls_.try_pop(control)) {
+  }
+  pending_blocks_.clear();
+  pending_samples_.clear();
+  pending_samples_.reserve(2 * kChunkSamples);
+  pending_results_.clear();
+  pending_controls_.clear();
+  dropped_blocks_.store(0, std::memory_order_relaxed);
+  dropped_events_.store(0, std::memory_order_relaxed);
+  sample_rate_ = sample_rate;
+  stop_ = false;
+
+  try {
+    worker_ = std::thread(&SessionRecorder::run, this);
+  } catch (const std::system_error&) {
+    file_.close();
+    return false;
+  }
+  start_ticks_.store(now_ticks(), std::memory_order_relaxed);
+  generation_.fetch_add(1, std::memory_order_relaxed);
+  recording_.store(true, std::memory_order_release);
+  return true;
+}
+
+bool SessionRecorder::stop() {
+  if (!worker_.joinable()) {
+    return false;
+  }
+  recording_.store(false, std::memory_order_release);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  wake_.notify_all();
+  worker_.join();
+  return file_.close();
+}
+
+bool SessionRecorder::begin_block() noexcept {
+  const std::uint32_t generation =
+      generation_.load(std::memory_order_relaxed);
+  if (generation == audio_generation_) {
+    return false;
+  }
+  audio_generation_ = generation;
+  blocks_ = 0;
+  gap_ = false;
+  return true;
+}
+
+void SessionRecorder::record_control(RecordedControl::Kind kind, double a,
+                                     double b) noexcept {
+  RecordedControl control;
+  control.block = blocks_;
+  control.kind = kind;
+  control.a = a;
+  control.b = b;
+  if (!controls_.try_push(control)) {
+    dropped_events_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void SessionRecorder::record_block(const float* samples,
+                                   std::size_t num_samples,
+                                   std::uint64_t first_sample) noexcept {
+  // The consumer only ever frees space, so these checks are conservative
+  if (num_samples > kSampleQueueSize - samples_.size() ||
+      blocks_queue_.size() == kBlockQueueSize) {
+    dropped_blocks_.fetch_add(1, std::memory_order_relaxed);
+    gap_ = true;
+    return;
+  }
+  RecordedBlock block;
+  const std::chrono::steady_clock::duration elapsed(
+      now_ticks() - start_ticks_.load(std::memory_order_relaxed));
+  block.callback_time = std::chrono::duration<double>(elapsed).count();
+  block.first_sample = first_sample;
+  block.size = static_cast<std::uint32_t>(num_samples);
+  block.flags = gap_ ? RecordedBlock::kGapBefore : 0;
+  // Samples first: the worker takes a block's samples once it sees it
+  samples_.push(samples, num_samples);
+  blocks_queue_.try_push(block);
+  gap_ = false;
+  ++blocks_;
+}
+
+void SessionRecorder::record_result(RecordedResult::Kind kind, double time,
+                                    double value, double confidence,
+                                    bool valid) noexcept {
+  RecordedResult result;
+  result.block = blocks_ > 0 ? blocks_ - 1 : 0;
+  result.time = time;
+  result.value = value;
+  result.confidence = confidence;
+  result.kind = kind;
+  result.valid = valid ? 1 : 0;
+  if (!results_.try_push(result)) {
+    dropped_events_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void SessionRecorder::run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    const bool stopping =
+        wake_.wait_for(lock, std::chrono::milliseconds(kPollIntervalMs),
+                       [this]() { return stop_; });
+    lock.unlock();
+    drain(stopping);
+    lock.lock();
+    if (stopping) {
+      return;
+    }
+  }
+}
+
+void SessionRecorder::drain(bool force) {
+  RecordedControl control;
+  while (controls_.try_pop(control)) {
+    pending_controls_.push_back(control);
+  }
+  RecordedBlock block;
+  while (blocks_queue_.try_pop(block)) {
+    const std::size_t offset = pending_samples_.size();
+    pending_samples_.resize(offset + block.size);
+    samples_.pop(pending_samples_.data() + offset, block.size);
+    pending_blocks_.push_back(block);
+    if (pending_samples_.size() >= kChunkSamples) {
+      write_blocks();
+    }
+  }
+  RecordedResult result;
+  while (results_.try_pop(result)) {
+    pending_results_.push_back(result);
+    if (pending_results_.size() >= kChunkResults) {
+      write_results();
+    }
+  }
+  if (force) {
+    write_controls();
+    write_blocks();
+    write_results();
+  }
+}
+
+void SessionRecorder::write_blocks() {
+  if (pending_blocks_.empty()) {
+    return;
+  }
+  write_controls();
+  sl::ChunkHeader header;
+  payload_.clear();
+  sl::encode_audio_blocks(pending_blocks_.data(), pending_blocks_.size(),
+                          pending_samples_.data(), sample_rate_, header,
+                          payload_);
+  pending_blocks_.clear();
+  pending_samples_.clear();
+  file_.write_chunk(header, payload_.data());
+}
+
+void SessionRecorder::write_results() {
+  if (pending_results_.empty()) {
+    return;
+  }
+  sl::ChunkHeader header;
+  payload_.clear();
+  sl::encode_results(pending_results_.data(), pending_results_.size(),
+                     header, payload_);
+  pending_results_.clear();
+  file_.write_chunk(header, payload_.data());
+}
+
+void SessionRecorder::write_controls() {
+  if (pending_controls_.empty()) {
+    return;
+  }
+  sl::ChunkHeader header;
+  payload_.clear();
+  sl::encode_controls(pending_controls_.data(), pending_controls_.size(),
+                      header, payload_);
+  pending_controls_.clear();
+  file_.write_chunk(header, payload_.data());
+}
+
+}  // namespace simple_tuner
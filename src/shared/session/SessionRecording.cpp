@@ -0,0 +1,207 @@
+#include "simple_tuner/session/SessionRecording.h"
+
+namespace simple_tuner {
+namespace session_log {
+
+namespace {
+constexpr std::size_t kInfoBytes = 8 + 8;
+constexpr std::size_t kBlockBytes = 8 + 8 + 4 + 4;  // Without samples
+constexpr std::size_t kResultBytes = 8 + 8 + 8 + 8 + 1 + 1;
+constexpr std::size_t kControlBytes = 8 + 1 + 8 + 8;
+
+void begin_chunk(ChunkType type, std::size_t count,
+                 ChunkHeader& header) noexcept {
+  header = ChunkHeader();
+  header.type = type;
+  header.count = static_cast<std::uint32_t>(count);
+}
+}  // namespace
+
+void encode_recording_info(const RecordingInfo& info, ChunkHeader& header,
+                           std::vector<unsigned char>& out) {
+  begin_chunk(ChunkType::kRecordingInfo, 1, header);
+  const std::size_t start = out.size();
+  out.resize(start + kInfoBytes);
+  put_f64(out.data() + start, info.sample_rate);
+  put_u64(out.data() + start + 8, info.buffer_size);
+  header.payload_bytes = static_cast<std::uint32_t>(kInfoBytes);
+}
+
+bool decode_recording_info(const unsigned char* payload,
+                           const ChunkHeader& header, RecordingInfo& info) {
+  if (header.type != ChunkType::kRecordingInfo || header.count != 1 ||
+      header.payload_bytes < kInfoBytes) {
+    return false;
+  }
+  info.sample_rate = get_f64(payload);
+  info.buffer_size = get_u64(payload + 8);
+  return true;
+}
+
+void encode_audio_blocks(const RecordedBlock* blocks, std::size_t count,
+                         const float* samples, double sample_rate,
+                         ChunkHeader& header,
+                         std::vector<unsigned char>& out) {
+  begin_chunk(ChunkType::kAudioBlocks, count, header);
+  std::size_t total = 0;
+  for (std::size_t i = 0; i < count; ++i) {
+    total += blocks[i].size;
+  }
+  const std::size_t start = out.size();
+  out.resize(start + count * kBlockBytes + total * 4);
+  unsigned char* callback_time = out.data() + start;
+  unsigned char* first_sample = callback_time + 8 * count;
+  unsigned char* size = first_sample + 8 * count;
+  unsigned char* flags = size + 4 * count;
+  unsigned char* audio = flags + 4 * count;
+  for (std::size_t i = 0; i < count; ++i) {
+    put_f64(callback_time + 8 * i, blocks[i].callback_time);
+    put_u64(first_sample + 8 * i, blocks[i].first_sample);
+    put_u32(size + 4 * i, blocks[i].size);
+    put_u32(flags + 4 * i, blocks[i].flags);
+  }
+  for (std::size_t i = 0; i < total; ++i) {
+    put_f32(audio + 4 * i, samples[i]);
+  }
+  if (count > 0 && sample_rate > 0.0) {
+    header.first_time =
+        static_cast<double>(blocks[0].first_sample) / sample_rate;
+    header.last_time = static_cast<double>(blocks[count - 1].first_sample +
+                                           blocks[count - 1].size) /
+                       sample_rate;
+  }
+  header.payload_bytes = static_cast<std::uint32_t>(out.size() - start);
+}
+
+bool decode_audio_blocks(const unsigned char* payload,
+                         const ChunkHeader& header,
+                         std::vector<RecordedBlock>& blocks,
+                         std::vector<float>& samples) {
+  const std::size_t count = header.count;
+  if (header.type != ChunkType::kAudioBlocks ||
+      header.payload_bytes < count * kBlockBytes) {
+    return false;
+  }
+  const unsigned char* callback_time = payload;
+  const unsigned char* first_sample = callback_time + 8 * count;
+  const unsigned char* size = first_sample + 8 * count;
+  const unsigned char* flags = size + 4 * count;
+  const unsigned char* audio = flags + 4 * count;
+  std::size_t total = 0;
+  for (std::size_t i = 0; i < count; ++i) {
+    total += get_u32(size + 4 * i);
+  }
+  if ((header.payload_bytes - count * kBlockBytes) / 4 < total) {
+    return false;
+  }
+  for (std::size_t i = 0; i < count; ++i) {
+    RecordedBlock block;
+    block.callback_time = get_f64(callback_time + 8 * i);
+    block.first_sample = get_u64(first_sample + 8 * i);
+    block.size = get_u32(size + 4 * i);
+    block.flags = get_u32(flags + 4 * i);
+    blocks.push_back(block);
+  }
+  const std::size_t offset = samples.size();
+  samples.resize(offset + total);
+  for (std::size_t i = 0; i < total; ++i) {
+    samples[offset + i] = get_f32(audio + 4 * i);
+  }
+  return true;
+}
+
+void encode_results(const RecordedResult* results, std::size_t count,
+                    ChunkHeader& header, std::vector<unsigned char>& out) {
+  begin_chunk(ChunkType::kResults, count, header);
+  const std::size_t start = out.size();
+  out.resize(start + count * kResultBytes);
+  unsigned char* block = out.data() + start;
+  unsigned char* time = block + 8 * count;
+  unsigned char* value = time + 8 * count;
+  unsigned char* confidence = value + 8 * count;
+  unsigned char* kind = confidence + 8 * count;
+  unsigned char* valid = kind + count;
+  for (std::size_t i = 0; i < count; ++i) {
+    const RecordedResult& r = results[i];
+    put_u64(block + 8 * i, r.block);
+    put_f64(time + 8 * i, r.time);
+    put_f64(value + 8 * i, r.value);
+    put_f64(confidence + 8 * i, r.confidence);
+    kind[i] = static_cast<unsigned char>(r.kind);
+    valid[i] = r.valid != 0 ? 1 : 0;
+  }
+  if (count > 0) {
+    header.first_time = results[0].time;
+    header.last_time = results[count - 1].time;
+  }
+  header.payload_bytes = static_cast<std::uint32_t>(out.size() - start);
+}
+
+bool decode_results(const unsigned char* payload, const ChunkHeader& header,
+                    std::vector<RecordedResult>& out) {
+  const std::size_t count = header.count;
+  if (header.type != ChunkType::kResults ||
+      header.payload_bytes < count * kResultBytes) {
+    return false;
+  }
+  const unsigned char* block = payload;
+  const unsigned char* time = block + 8 * count;
+  const unsigned char* value = time + 8 * count;
+  const unsigned char* confidence = value + 8 * count;
+  const unsigned char* kind = confidence + 8 * count;
+  const unsigned char* valid = kind + count;
+  for (std::size_t i = 0; i < count; ++i) {
+    RecordedResult r;
+    r.block = get_u64(block + 8 * i);
+    r.time = get_f64(time + 8 * i);
+    r.value = get_f64(value + 8 * i);
+    r.confidence = get_f64(confidence + 8 * i);
+    r.kind = static_cast<RecordedResult::Kind>(kind[i]);
+    r.valid = valid[i];
+    out.push_back(r);
+  }
+  return true;
+}
+
+void encode_controls(const RecordedControl* controls, std::size_t count,
+                     ChunkHeader& header, std::vector<unsigned char>& out) {
+  begin_chunk(ChunkType::kControls, count, header);
+  const std::size_t start = out.size();
+  out.resize(start + count * kControlBytes);
+  unsigned char* block = out.data() + start;
+  unsigned char* kind = block + 8 * count;
+  unsigned char* a = kind + count;
+  unsigned char* b = a + 8 * count;
+  for (std::size_t i = 0; i < count; ++i) {
+    put_u64(block + 8 * i, controls[i].block);
+    kind[i] = static_cast<unsigned char>(controls[i].kind);
+    put_f64(a + 8 * i, controls[i].a);
+    put_f64(b + 8 * i, controls[i].b);
+  }
+  header.payload_bytes = static_cast<std::uint32_t>(out.size() - start);
+}
+
+bool decode_controls(const unsigned char* payload, const ChunkHeader& header,
+                     std::vector<RecordedControl>& out) {
+  const std::size_t count = header.count;
+  if (header.type != ChunkType::kControls ||
+      header.payload_bytes < count * kControlBytes) {
+    return false;
+  }
+  const unsigned char* block = payload;
+  const unsigned char* kind = block + 8 * count;
+  const unsigned char* a = kind + count;
+  const unsigned char* b = a + 8 * count;
+  for (std::size_t i = 0; i < count; ++i) {
+    RecordedControl c;
+    c.block = get_u64(block + 8 * i);
+    c.kind = static_cast<RecordedControl::Kind>(kind[i]);
+    c.a = get_f64(a + 8 * i);
+    c.b = get_f64(b + 8 * i);
+    out.push_back(c);
+  }
+  return true;
+}
+
+}  // namespace session_log
+}  // namespace simple_tuner
@@ -0,0 +1,244 @@
+#include "simple_tuner/session/SessionReplay.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <memory>
+
+#include "simple_tuner/controllers/PitchDetectionController.h"
+
+namespace simple_tuner {
+
+namespace sl = session_log;
+
+namespace {
+constexpr std::size_t kDrainSize = 64;
+
+template <typename T>
+void sort_by_block(std::vector<T>& records) {
+  std::stable_sort(records.begin(), records.end(),
+                   [](const T& a, const T& b) { return a.block < b.block; });
+}
+}  // namespace
+
+SessionReplay::SessionReplay() noexcept
+    : num_blocks_(0),
+      intact_(false),
+      frequency_tolerance_(0.0),
+      confidence_tolerance_(0.0) {}
+
+bool SessionReplay::open(const std::string& path) {
+  close();
+  if (!reader_.open(path)) {
+    return false;
+  }
+  bool has_info = false;
+  intact_ = true;
+  for (const sl::IndexEntry& chunk : reader_.chunks()) {
+    const unsigned char* payload = reader_.payload(chunk);
+    switch (chunk.header.type) {
+      case sl::ChunkType::kRecordingInfo:
+        has_info = sl::decode_recording_info(payload, chunk.header, info_);
+        break;
+      case sl::ChunkType::kAudioBlocks:
+        num_blocks_ += chunk.header.count;
+        break;
+      case sl::ChunkType::kResults:
+        intact_ = sl::decode_results(payload, chunk.header, results_) &&
+                  intact_;
+        break;
+      case sl::ChunkType::kControls:
+        intact_ = sl::decode_controls(payload, chunk.header, controls_) &&
+                  intact_;
+        break;
+      default:
+        break;
+    }
+  }
+  if (!has_info || !(info_.sample_rate > 0.0) || info_.buffer_size == 0) {
+    close();
+    return false;
+  }
+  // Chunks of different types are spilled independently
+  sort_by_block(controls_);
+  sort_by_block(results_);
+  return true;
+}
+
+void SessionReplay::close() noexcept {
+  reader_.close();
+  info_ = RecordingInfo();
+  num_blocks_ = 0;
+  controls_.clear();
+  results_.clear();
+  intact_ = false;
+}
+
+void SessionReplay::set_tolerance(double frequency,
+                                  double confidence) noexcept {
+  frequency_tolerance_ = std::max(frequency, 0.0);
+  confidence_tolerance_ = std::max(confidence, 0.0);
+}
+
+ReplayReport SessionReplay::run() const {
+  if (!is_open()) {
+    return ReplayReport();
+  }
+  auto controller = std::make_unique<PitchDetectionController>(
+      static_cast<std::size_t>(info_.buffer_size), info_.sample_rate);
+  return run(*controller);
+}
+
+ReplayReport SessionReplay::run(PitchDetectionController& controller) const {
+  ReplayReport report;
+  if (!is_open()) {
+    return report;
+  }
+  report.is_valid = intact_;
+
+  std::vector<RecordedBlock> blocks;
+  std::vector<float> samples;
+  DetectionEvent events[kDrainSize];
+  std::size_t next_control = 0;
+  std::size_t next_result = 0;
+  std::uint64_t index = 0;
+  const auto mismatch = [&report](std::uint64_t block) {
+    if (report.mismatches++ == 0) {
+      report.first_mismatch_block = static_cast<std::int64_t>(block);
+    }
+  };
+  const auto compare = [&](double value, double confidence,
+                           const RecordedResult& expected,
+                           std::uint64_t block) {
+    const double value_error = std::abs(value - expected.value);
+    const double confidence_error =
+        std::abs(confidence - expected.confidence);
+    report.max_frequency_error =
+        std::max(report.max_frequency_error, value_error);
+    report.max_confidence_error =
+        std::max(report.max_confidence_error, confidence_error);
+    if (value_error > frequency_tolerance_ ||
+        confidence_error > confidence_tolerance_) {
+      mismatch(block);
+    }
+  };
+
+  for (const sl::IndexEntry& chunk : reader_.chunks()) {
+    if (chunk.header.type != sl::ChunkType::kAudioBlocks) {
+      continue;
+    }
+    blocks.clear();
+    samples.clear();
+    if (!sl::decode_audio_blocks(reader_.payload(chunk), chunk.header, blocks,
+                                 samples)) {
+      report.is_valid = false;
+      break;
+    }
+    const float* block_samples = samples.data();
+    for (const RecordedBlock& block : blocks) {
+      if (index == 0) {
+        report.cold_start = block.first_sample == 0;
+      }
+      if ((block.flags & RecordedBlock::kGapBefore) != 0) {
+        ++report.gaps;
+      }
+      while (next_control < controls_.size() &&
+             controls_[next_control].block <= index) {
+        apply_control(controls_[next_control++], controller);
+      }
+
+      const auto start = std::chrono::steady_clock::now();
+      controller.process_audio(block_samples, block.size);
+      const double seconds = std::chrono::duration<double>(
+                                 std::chrono::steady_clock::now() - start)
+                                 .count();
+      report.process_seconds += seconds;
+      report.worst_block_seconds =
+          std::max(report.worst_block_seconds, seconds);
+      block_samples += block.size;
+      report.samples += block.size;
+      ++report.blocks;
+
+      // This block's recorded results (sorted by block)
+      while (next_result < results_.size() &&
+             results_[next_result].block < index) {
+        ++next_result;
+      }
+      std::size_t end_result = next_result;
+      while (end_result < results_.size() &&
+             results_[end_result].block == index) {
+        ++end_result;
+      }
+      report.recorded_results += end_result - next_result;
+
+      // Pitch detections, pairwise in publication order
+      std::size_t expected = next_result;
+      std::size_t drained = 0;
+      while ((drained = controller.drain_detections(events, kDrainSize)) > 0) {
+        report.replayed_results += drained;
+        for (std::size_t i = 0; i < drained; ++i) {
+          while (expected < end_result &&
+                 results_[expected].kind != RecordedResult::Kind::kPitch) {
+            ++expected;
+          }
+          if (expected == end_result) {
+            mismatch(index);  // Not published when recording
+            continue;
+          }
+          compare(events[i].frequency, events[i].confidence,
+                  results_[expected++], index);
+        }
+      }
+      for (; expected < end_result; ++expected) {
+        if (results_[expected].kind == RecordedResult::Kind::kPitch) {
+          mismatch(index);  // Published when recording, not now
+        }
+      }
+
+      // Beat analyses: the latest one is what the controller shows
+      for (std::size_t r = next_result; r < end_result; ++r) {
+        if (results_[r].kind != RecordedResult::Kind::kBeats) {
+          continue;
+        }
+        double rate = 0.0;
+        double clarity = 0.0;
+        const bool valid = controller.get_latest_beats(rate, clarity);
+        if (valid != (results_[r].valid != 0)) {
+          mismatch(index);
+        } else if (valid) {
+          compare(rate, clarity, results_[r], index);
+        }
+      }
+      next_result = end_result;
+      ++index;
+    }
+  }
+  return report;
+}
+
+void SessionReplay::apply_control(
+    const RecordedControl& control,
+    PitchDetectionController& controller) const noexcept {
+  switch (control.kind) {
+    case RecordedControl::Kind::kRange:
+      controller.set_frequency_range(control.a, control.b);
+      break;
+    case RecordedControl::Kind::kTarget:
+      controller.set_target_frequency(control.a);
+      break;
+    case RecordedControl::Kind::kBeatFrequency:
+      controller.set_beat_frequency(control.a);
+      break;
+    case RecordedControl::Kind::kConfidenceThreshold:
+      controller.set_confidence_threshold(control.a);
+      break;
+    case RecordedControl::Kind::kFullTierMethod:
+      controller.set_full_tier_method(
+          control.a == static_cast<double>(FullTierMethod::kHarmonicSum)
+              ? FullTierMethod::kHarmonicSum
+              : FullTierMethod::kNsdf);
+      break;
+  }
+}
+
+}  // namespace simple_tuner
@@ -1,9 +1,7 @@
 #include "simple_tuner/ui/MainComponent.h"
 
-#include <iomanip>
-#include <sstream>
-
 #include "simple_tuner/algorithms/FrequencyCalculator.h"
+#include "simple_tuner/algorithms/ToneGenerator.h"
 #include "simple_tuner/controllers/PitchDetectionController.h"
 #include "simple_tuner/ui/AlertHelpers.h"
 #include "simple_tuner/ui/ModeSelector.h"
@@ -16,8 +14,10 @@ namespace simple_tuner {
 
 MainComponent::MainComponent(std::shared_ptr<FrequencyCalculator> freq_calc)
     : pitch_controller_(nullptr),
+      tone_generator_(nullptr),
       frequency_calculator_(std::move(freq_calc)),
-      current_mode_(AppMode::kMeter) {
+      current_mode_(AppMode::kMeter),
+      last_midi_note_(69) {  // A4 until a note is detected
   initialize_ui();
   setSize(400, 600);
   startTimerHz(60);  // 60 FPS update rate for lower latency
@@ -147,10 +147,23 @@ void MainComponent::set_pitch_controller(
   pitch_controller_ = controller;
 }
 
+void MainComponent::set_tone_generator(ToneGenerator* generator) noexcept {
+  tone_generator_ = generator;
+}
+
+void MainComponent::drain_measurements() noexcept {
+  DetectionEvent events[64];
+  std::size_t count = 0;
+  while ((count = pitch_controller_->drain_detections(events, 64)) > 0) {
+    measurements_.add_detections(events, count, *frequency_calculator_);
+  }
+}
+
 void MainComponent::timerCallback() {
   if (pitch_controller_ == nullptr) {
     return;
   }
+  drain_measurements();
 
   double frequency = 0.0;
   double confidence = 0.0;
@@ -159,6 +172,13 @@ void MainComponent::timerCallback() {
     // Valid pitch detected
     int midi_note = frequency_calculator_->frequency_to_midi(frequency);
     double cents = frequency_calculator_->calculate_cents(frequency, midi_note);
+    last_midi_note_ = midi_note;
+
+    // A held, settled note reads its median rather than the latest frame
+    KeySummary summary;
+    if (measurements_.get_summary(midi_note, summary) && summary.is_stable) {
+      cents = summary.median;
+    }
 
     // Update all components
     note_display_->update_note_with_cents(midi_note, confidence,
@@ -182,20 +202,15 @@ void MainComponent::handle_mode_change(ModeSelector::Mode mode) noexcept {
     current_mode_ = AppMode::kSound;
   }
 
-  // Phase 3: Visual-only change (Sound mode not implemented yet)
+  // Sound mode plays the equal-tempered pitch of the last detected note
+  if (tone_generator_ != nullptr) {
+    tone_generator_->set_frequency(
+        frequency_calculator_->midi_to_frequency(last_midi_note_));
+    tone_generator_->set_enabled(current_mode_ == AppMode::kSound);
+  }
+
   DBG("Mode changed to: " +
       juce::String(current_mode_ == AppMode::kMeter ? "Meter" : "Sound"));
 }
 
-juce::String MainComponent::format_cents(double cents) const noexcept {
-  try {
-    std::ostringstream stream;
-    stream << std::showpos << std::fixed << std::setprecision(1) << cents
-           << " cents";
-    return stream.str();
-  } catch (...) {
-    return "--";
-  }
-}
-
 }  // namespace simple_tuner
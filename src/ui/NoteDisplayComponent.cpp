@@ -1,8 +1,7 @@
 #include "simple_tuner/ui/NoteDisplayComponent.h"
 
 #include <cmath>
-#include <iomanip>
-#include <sstream>
+#include <string_view>
 
 #include "simple_tuner/algorithms/FrequencyCalculator.h"
 #include "simple_tuner/ui/UIConstants.h"
@@ -16,6 +15,7 @@ NoteDisplayComponent::NoteDisplayComponent(
       accidental_(""),
       reference_freq_(""),
       current_midi_note_(0),
+      current_reference_hz_(0.0),
       current_cents_(0.0f),
       has_signal_(false) {}
 
@@ -42,39 +42,36 @@ void NoteDisplayComponent::set_no_signal() noexcept {
   note_letter_ = "--";
   accidental_ = "";
   reference_freq_ = "";
+  current_midi_note_ = 0;  // Rebuild the texts when a signal returns
   has_signal_ = false;
   current_cents_ = 0.0f;
   repaint();
 }
 
 void NoteDisplayComponent::update_display_from_midi(int midi_note) noexcept {
+  // Called every valid frame; the texts (juce::String allocates) are only
+  // rebuilt when the note or its target frequency changes
+  const double reference_hz =
+      frequency_calculator_->midi_to_frequency(midi_note);
+  if (midi_note == current_midi_note_ &&
+      reference_hz == current_reference_hz_) {
+    return;
+  }
+
   try {
     current_midi_note_ = midi_note;
-
-    // Get note name with accidental
-    std::string note_name = frequency_calculator_->midi_to_note_name(midi_note);
-
-    // Parse note letter and accidental
-    if (note_name.length() >= 1) {
-      note_letter_ = juce::String::charToString(note_name[0]);
-
-      if (note_name.length() == 2) {
-        // Has accidental (# or b)
-        accidental_ = juce::String::charToString(note_name[1]);
-      } else {
-        accidental_ = "";
-      }
-    } else {
-      note_letter_ = "--";
-      accidental_ = "";
-    }
-
-    // Calculate reference frequency for this MIDI note
-    double ref_freq = frequency_calculator_->midi_to_frequency(midi_note);
-    std::ostringstream freq_stream;
-    freq_stream << std::fixed << std::setprecision(2) << ref_freq << " Hz";
-    reference_freq_ = freq_stream.str();
-
+    current_reference_hz_ = reference_hz;
+
+    // Note letter and optional accidental ('#')
+    const std::string_view note_name =
+        FrequencyCalculator::note_name(midi_note);
+    note_letter_ = juce::String(note_name.data(), 1);
+    accidental_ = note_name.size() == 2 ? juce::String(note_name.data() + 1, 1)
+                                        : juce::String();
+
+    const std::string_view reference =
+        text_cache_.reference_text(midi_note, reference_hz);
+    reference_freq_ = juce::String(reference.data(), reference.size());
   } catch (...) {
     note_letter_ = "--";
     accidental_ = "";
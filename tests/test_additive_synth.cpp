@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "simple_tuner/algorithms/AdditiveSynth.h"
+
+namespace simple_tuner {
+namespace {
+
+constexpr double kSampleRate = 48000.0;
+constexpr double kPi = 3.14159265358979323846;
+
+// Renders num_samples in blocks of block_size (last block may be short)
+std::vector<float> render(AdditiveSynth& synth, std::size_t num_samples,
+                          std::size_t block_size) {
+  std::vector<float> out(num_samples);
+  for (std::size_t i = 0; i < num_samples; i += block_size) {
+    synth.render(out.data() + i, std::min(block_size, num_samples - i));
+  }
+  return out;
+}
+
+// Hann-windowed single-bin DFT magnitude, scaled to the amplitude of a
+// matching sinusoid
+double magnitude_at(const std::vector<float>& x, double frequency) {
+  const auto n = static_cast<double>(x.size());
+  double re = 0.0;
+  double im = 0.0;
+  for (std::size_t i = 0; i < x.size(); ++i) {
+    const auto t = static_cast<double>(i);
+    const double window = 0.5 - 0.5 * std::cos(2.0 * kPi * t / n);
+    const double angle = 2.0 * kPi * frequency * t / kSampleRate;
+    re += window * x[i] * std::cos(angle);
+    im += window * x[i] * std::sin(angle);
+  }
+  return 4.0 * std::hypot(re, im) / n;
+}
+
+TEST(AdditiveSynthTest, PartialFrequencyFollowsStiffStringSeries) {
+  EXPECT_DOUBLE_EQ(AdditiveSynth::partial_frequency(100.0, 1, 0.0), 100.0);
+  EXPECT_DOUBLE_EQ(AdditiveSynth::partial_frequency(100.0, 3, 0.0), 300.0);
+  EXPECT_DOUBLE_EQ(AdditiveSynth::partial_frequency(100.0, 10, 0.01),
+                   1000.0 * std::sqrt(2.0));
+}
+
+TEST(AdditiveSynthTest, SustainedPartialMatchesReferenceSine) {
+  // Odd block size exercises the lane tail; many blocks check drift
+  AdditiveSynth synth(kSampleRate);
+  synth.set_num_partials(1);
+  synth.set_partial(1, 0.5f, 0.0);
+  synth.note_on(441.0);
+
+  const auto out = render(synth, 96000, 101);
+  double max_error = 0.0;
+  for (std::size_t i = 0; i < out.size(); ++i) {
+    const double expected =
+        0.5 * std::sin(2.0 * kPi * 441.0 * static_cast<double>(i) /
+                       kSampleRate);
+    max_error = std::max(max_error, std::abs(out[i] - expected));
+  }
+  EXPECT_LT(max_error, 1e-5);
+}
+
+TEST(AdditiveSynthTest, PartialsAreStretchedByInharmonicity) {
+  AdditiveSynth synth(kSampleRate);
+  synth.set_inharmonicity(0.005);
+  synth.set_num_partials(4);
+  for (int n = 1; n <= 4; ++n) {
+    synth.set_partial(n, 0.2f, 0.0);
+  }
+  synth.note_on(110.0);
+  const auto out = render(synth, 48000, 128);
+
+  for (int n = 2; n <= 4; ++n) {
+    const double stretched = AdditiveSynth::partial_frequency(110.0, n, 0.005);
+    EXPECT_NEAR(magnitude_at(out, stretched), 0.2, 0.01) << "partial " << n;
+    // The harmonic position is two or more Hz away: nothing there
+    EXPECT_LT(magnitude_at(out, 110.0 * n), 0.02) << "partial " << n;
+  }
+}
+
+TEST(AdditiveSynthTest, PartialDecaysSixtyDecibelsInDecayTime) {
+  AdditiveSynth synth(kSampleRate);
+  synth.set_num_partials(1);
+  synth.set_partial(1, 1.0f, 0.5);
+  synth.note_on(1000.0);
+  const auto out = render(synth, 24000 + 480, 64);
+
+  const auto peak = [&](std::size_t start) {
+    float value = 0.0f;
+    for (std::size_t i = start; i < start + 48; ++i) {  // One cycle
+      value = std::max(value, std::abs(out[i]));
+    }
+    return value;
+  };
+  EXPECT_NEAR(peak(0), 1.0f, 0.01f);
+  EXPECT_NEAR(20.0 * std::log10(peak(24000)), -60.0, 0.5);
+}
+
+TEST(AdditiveSynthTest, PartialsAboveBandLimitAreDropped) {
+  AdditiveSynth synth(kSampleRate);
+  synth.set_default_spectrum(32, 2.0);
+  synth.note_on(100.0);
+  EXPECT_EQ(synth.active_partials(), 32);
+
+  // 0.45 * 48 kHz = 21.6 kHz: partials 1..5 of 4 kHz fit
+  synth.note_on(4000.0);
+  EXPECT_EQ(synth.active_partials(), 5);
+}
+
+TEST(AdditiveSynthTest, DefaultSpectrumNeverClips) {
+  AdditiveSynth synth(kSampleRate);
+  synth.set_default_spectrum(32, 4.0);
+  synth.note_on(55.0);
+  const auto out = render(synth, 48000, 256);
+  for (float sample : out) {
+    ASSERT_LE(std::abs(sample), 1.0f);
+  }
+}
+
+TEST(AdditiveSynthTest, DecayedPartialsStopRendering) {
+  AdditiveSynth synth(kSampleRate);
+  synth.set_default_spectrum(16, 0.05);
+  synth.note_on(220.0);
+  EXPECT_EQ(synth.active_partials(), 16);
+  render(synth, 24000, 128);
+  EXPECT_EQ(synth.active_partials(), 0);
+
+  std::vector<float> out(128, 1.0f);
+  synth.render(out.data(), out.size());
+  for (float sample : out) {
+    EXPECT_EQ(sample, 0.0f);
+  }
+}
+
+}  // namespace
+}  // namespace simple_tuner
@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include "simple_tuner/algorithms/BeatDetector.h"
+#include "simple_tuner/controllers/PitchDetectionController.h"
+
+namespace simple_tuner {
+namespace {
+
+constexpr double kSampleRate = 48000.0;
+constexpr double kPi = 3.14159265358979323846;
+
+// Sum of sines (frequency, amplitude), seconds long
+std::vector<float> generate_partials(
+    const std::vector<std::pair<double, double>>& partials, double seconds) {
+  const auto num_samples =
+      static_cast<std::size_t>(std::lround(seconds * kSampleRate));
+  std::vector<float> samples(num_samples);
+  for (std::size_t i = 0; i < num_samples; ++i) {
+    const double t = static_cast<double>(i) / kSampleRate;
+    double value = 0.0;
+    int index = 0;
+    for (const auto& partial : partials) {
+      value += partial.second *
+               std::sin(2.0 * kPi * partial.first * t + 0.9 * ++index);
+    }
+    samples[i] = static_cast<float>(value);
+  }
+  return samples;
+}
+
+BeatResult measure(double center,
+                   const std::vector<std::pair<double, double>>& partials) {
+  BeatDetector detector(kSampleRate);
+  detector.set_frequency(center);
+  const auto samples =
+      generate_partials(partials, BeatDetector::kHistorySeconds);
+  for (std::size_t i = 0; i < samples.size(); i += 512) {
+    detector.push_samples(samples.data() + i,
+                          std::min<std::size_t>(512, samples.size() - i));
+  }
+  return detector.detect();
+}
+
+TEST(BeatDetectorTest, DisabledWithoutFrequency) {
+  BeatDetector detector(kSampleRate);
+  const auto samples = generate_partials({{440.0, 0.3}}, 2.0);
+  detector.push_samples(samples.data(), samples.size());
+  EXPECT_FALSE(detector.detect().is_valid);
+
+  detector.set_frequency(kSampleRate);
+  EXPECT_EQ(detector.get_frequency(), 0.0);
+}
+
+TEST(BeatDetectorTest, NeedsMinimumHistory) {
+  BeatDetector detector(kSampleRate);
+  detector.set_frequency(440.0);
+  const auto samples = generate_partials({{440.0, 0.3}, {441.5, 0.3}}, 0.5);
+  detector.push_samples(samples.data(), samples.size());
+  EXPECT_FALSE(detector.detect().is_valid);
+}
+
+TEST(BeatDetectorTest, MeasuresUnisonBeats) {
+  for (double beat : {0.6, 1.5, 4.0, 12.0}) {
+    const BeatResult result = measure(440.0 + beat / 2.0,
+                                      {{440.0, 0.3}, {440.0 + beat, 0.3}});
+    ASSERT_TRUE(result.is_valid) << beat;
+    EXPECT_NEAR(result.rate, beat, 0.02 * beat) << beat;
+    EXPECT_GT(result.clarity, 0.8) << beat;
+  }
+}
+
+TEST(BeatDetectorTest, MeasuresFastBeats) {
+  // Periods of 10..12.5 envelope samples, near the shortest searched: the
+  // negative lobe lies below the shortest lag and the first peak above it
+  for (double beat : {15.5, 16.0, 18.0, 19.5}) {
+    const BeatResult result = measure(440.0 + beat / 2.0,
+                                      {{440.0, 0.3}, {440.0 + beat, 0.3}});
+    ASSERT_TRUE(result.is_valid) << beat;
+    EXPECT_NEAR(result.rate, beat, 0.02 * beat) << beat;
+  }
+}
+
+TEST(BeatDetectorTest, SteadyPartialHasNoBeats) {
+  const BeatResult result = measure(440.0, {{440.0, 0.3}});
+  ASSERT_TRUE(result.is_valid);
+  EXPECT_EQ(result.rate, 0.0);
+  EXPECT_LT(result.depth, BeatDetector::kMinDepth);
+}
+
+TEST(BeatDetectorTest, IsolatesCoincidentPartialOfFifth) {
+  // A3 and a slightly narrow E4: 3rd partial of A3 (660) against the 2nd
+  // of E4 (659.255), with the other partials outside the band
+  const double a3 = 220.0;
+  const double e4 = 329.6275;
+  const BeatResult result =
+      measure(660.0, {{a3, 0.3}, {2 * a3, 0.2}, {3 * a3, 0.1},
+                      {e4, 0.3}, {2 * e4, 0.15}, {3 * e4, 0.1}});
+  ASSERT_TRUE(result.is_valid);
+  EXPECT_NEAR(result.rate, 3 * a3 - 2 * e4, 0.02);
+}
+
+TEST(BeatDetectorTest, RejectsSilence) {
+  const BeatResult result = measure(440.0, {{440.0, 1e-5}, {441.5, 1e-5}});
+  EXPECT_FALSE(result.is_valid);
+}
+
+TEST(BeatDetectorTest, ArenaBytesCoverConstruction) {
+  const std::size_t bytes = BeatDetector::arena_bytes(kSampleRate);
+  BufferArena arena(bytes);
+  BeatDetector detector(kSampleRate, arena);
+  EXPECT_EQ(arena.used(), bytes);
+}
+
+TEST(BeatDetectorTest, ControllerReportsBeats) {
+  PitchDetectionController controller(4096, kSampleRate);
+  double rate = 0.0;
+  double clarity = 0.0;
+  EXPECT_FALSE(controller.get_latest_beats(rate, clarity));
+
+  controller.set_beat_frequency(440.0);
+  const auto samples = generate_partials({{439.0, 0.3}, {441.0, 0.3}}, 3.0);
+  for (std::size_t i = 0; i < samples.size(); i += 256) {
+    controller.process_audio(samples.data() + i,
+                             std::min<std::size_t>(256, samples.size() - i));
+  }
+  ASSERT_TRUE(controller.get_latest_beats(rate, clarity));
+  EXPECT_NEAR(rate, 2.0, 0.05);
+
+  controller.set_beat_frequency(0.0);
+  controller.process_audio(samples.data(), 256);
+  EXPECT_FALSE(controller.get_latest_beats(rate, clarity));
+}
+
+}  // namespace
+}  // namespace simple_tuner
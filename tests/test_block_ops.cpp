@@ -0,0 +1,168 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "simple_tuner/dsp/BlockOps.h"
+
+namespace simple_tuner {
+namespace dsp {
+namespace {
+
+// Odd length so every SIMD kernel also runs its scalar tail
+constexpr std::size_t kLength = 1027;
+
+std::vector<float> make_signal(std::size_t n) {
+  std::vector<float> signal(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    const double t = static_cast<double>(i);
+    signal[i] = static_cast<float>(0.7 * std::sin(0.031 * t) + 0.2 +
+                                   0.05 * std::cos(0.7 * t));
+  }
+  return signal;
+}
+
+// Runs every test once per kernel set the CPU supports, comparing against
+// the scalar reference
+class BlockOpsTest : public ::testing::TestWithParam<SimdLevel> {
+ protected:
+  void SetUp() override {
+    if (!force_simd_level(GetParam())) {
+      GTEST_SKIP() << "Kernel set not supported on this CPU";
+    }
+  }
+
+  void TearDown() override { force_simd_level(detect_simd_level()); }
+};
+
+TEST_P(BlockOpsTest, StatsMatchScalarReference) {
+  const auto signal = make_signal(kLength);
+  double expected_sum = 0.0;
+  double expected_squares = 0.0;
+  for (float value : signal) {
+    expected_sum += value;
+    expected_squares += static_cast<double>(value) * value;
+  }
+
+  const BlockStats stats = block_stats(signal.data(), signal.size());
+  EXPECT_NEAR(stats.sum, expected_sum, 1e-9);
+  EXPECT_NEAR(stats.sum_squares, expected_squares, 1e-9);
+  EXPECT_NEAR(sum(signal.data(), signal.size()), expected_sum, 1e-9);
+  EXPECT_NEAR(sum_of_squares(signal.data(), signal.size()), expected_squares,
+              1e-9);
+  EXPECT_EQ(sum(signal.data(), 0), 0.0);
+}
+
+TEST_P(BlockOpsTest, ElementwiseOpsAreExact) {
+  const auto signal = make_signal(kLength);
+  const auto window = make_signal(kLength);
+
+  auto shifted = signal;
+  subtract(shifted.data(), shifted.size(), 0.25f);
+  auto scaled = signal;
+  multiply(scaled.data(), window.data(), scaled.size());
+
+  for (std::size_t i = 0; i < kLength; ++i) {
+    EXPECT_EQ(shifted[i], signal[i] - 0.25f);
+    EXPECT_EQ(scaled[i], signal[i] * window[i]);
+  }
+}
+
+TEST_P(BlockOpsTest, DotProductMatchesDoubleReference) {
+  const auto a = make_signal(kLength);
+  const auto b = make_signal(kLength + 5);
+  double expected = 0.0;
+  for (std::size_t i = 0; i < kLength; ++i) {
+    expected += static_cast<double>(a[i]) * b[i + 5];
+  }
+
+  EXPECT_NEAR(dot_product(a.data(), b.data() + 5, kLength), expected,
+              std::abs(expected) * 1e-5);
+}
+
+TEST_P(BlockOpsTest, Int16ConversionRoundTrips) {
+  std::vector<std::int16_t> pcm(kLength);
+  for (std::size_t i = 0; i < kLength; ++i) {
+    pcm[i] = static_cast<std::int16_t>(static_cast<int>(i * 67) - 32768);
+  }
+
+  std::vector<float> samples(kLength);
+  int16_to_float(pcm.data(), samples.data(), kLength);
+  EXPECT_EQ(samples[0], -1.0f);
+
+  std::vector<std::int16_t> round_trip(kLength);
+  float_to_int16(samples.data(), round_trip.data(), kLength);
+  for (std::size_t i = 0; i < kLength; ++i) {
+    EXPECT_NEAR(round_trip[i], pcm[i], 1) << i;
+  }
+}
+
+TEST_P(BlockOpsTest, FloatToInt16Saturates) {
+  std::vector<float> samples(kLength, 2.0f);
+  samples[1] = -3.0f;
+  samples[kLength - 1] = -3.0f;
+  std::vector<std::int16_t> pcm(kLength);
+
+  float_to_int16(samples.data(), pcm.data(), kLength);
+  EXPECT_EQ(pcm[0], 32767);
+  EXPECT_EQ(pcm[1], -32767);
+  EXPECT_EQ(pcm[kLength - 1], -32767);
+}
+
+TEST_P(BlockOpsTest, PreprocessFrameRemovesDcAndWindows) {
+  const auto signal = make_signal(kLength);
+  const auto window = make_signal(kLength);
+  const BlockStats reference = block_stats(signal.data(), kLength);
+  const float mean =
+      static_cast<float>(reference.sum / static_cast<double>(kLength));
+
+  std::vector<float> processed(kLength);
+  double energy = 0.0;
+  const BlockStats stats = preprocess_frame(signal.data(), window.data(),
+                                            processed.data(), kLength, &energy);
+
+  double expected_energy = 0.0;
+  for (std::size_t i = 0; i < kLength; ++i) {
+    const float expected = (signal[i] - mean) * window[i];
+    EXPECT_EQ(processed[i], expected);
+    expected_energy += static_cast<double>(expected) * expected;
+  }
+  EXPECT_EQ(stats.sum, reference.sum);
+  EXPECT_NEAR(energy, expected_energy, 1e-9);
+
+  // Null window is rectangular
+  preprocess_frame(signal.data(), nullptr, processed.data(), kLength);
+  EXPECT_EQ(processed[3], signal[3] - mean);
+}
+
+std::string level_name(const ::testing::TestParamInfo<SimdLevel>& info) {
+  switch (info.param) {
+    case SimdLevel::kScalar:
+      return "Scalar";
+    case SimdLevel::kSse2:
+      return "Sse2";
+    case SimdLevel::kAvx2:
+      return "Avx2";
+    case SimdLevel::kNeon:
+      return "Neon";
+  }
+  return "Unknown";
+}
+
+INSTANTIATE_TEST_SUITE_P(AllKernels, BlockOpsTest,
+                         ::testing::Values(SimdLevel::kScalar, SimdLevel::kSse2,
+                                           SimdLevel::kAvx2, SimdLevel::kNeon),
+                         level_name);
+
+TEST(BlockOpsDispatchTest, DetectedLevelIsActiveByDefault) {
+  EXPECT_EQ(simd_level(), detect_simd_level());
+  EXPECT_TRUE(force_simd_level(SimdLevel::kScalar));
+  EXPECT_EQ(simd_level(), SimdLevel::kScalar);
+  EXPECT_TRUE(force_simd_level(detect_simd_level()));
+}
+
+}  // namespace
+}  // namespace dsp
+}  // namespace simple_tuner
@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+#include "simple_tuner/algorithms/PitchDetector.h"
+#include "simple_tuner/algorithms/PitchDetectorFactory.h"
+#include "simple_tuner/controllers/PitchDetectionController.h"
+#include "simple_tuner/memory/BufferArena.h"
+
+namespace simple_tuner {
+namespace {
+
+std::vector<float> generate_sine(double frequency, std::size_t num_samples,
+                                 double sample_rate) {
+  std::vector<float> samples(num_samples);
+  constexpr double pi = 3.14159265358979323846;
+  const double angular_freq = 2.0 * pi * frequency / sample_rate;
+  for (std::size_t i = 0; i < num_samples; ++i) {
+    samples[i] =
+        static_cast<float>(std::sin(angular_freq * static_cast<double>(i)));
+  }
+  return samples;
+}
+
+std::uintptr_t address_of(const void* pointer) {
+  return reinterpret_cast<std::uintptr_t>(pointer);
+}
+
+TEST(BufferArenaTest, CapacityRoundsUpToPage) {
+  BufferArena arena(100);
+  EXPECT_EQ(arena.capacity(), BufferArena::kPageSize);
+  EXPECT_EQ(address_of(arena.data()) % BufferArena::kPageSize, 0u);
+  EXPECT_EQ(arena.used(), 0u);
+}
+
+TEST(BufferArenaTest, AllocationsAreContiguousAndCacheLineAligned) {
+  BufferArena arena(8192);
+  float* first = arena.allocate<float>(10);
+  double* second = arena.allocate<double>(3);
+
+  ASSERT_NE(first, nullptr);
+  ASSERT_NE(second, nullptr);
+  EXPECT_EQ(address_of(first), address_of(arena.data()));
+  EXPECT_EQ(address_of(second) - address_of(first),
+            BufferArena::kCacheLineSize);
+  EXPECT_EQ(address_of(second) % BufferArena::kCacheLineSize, 0u);
+  EXPECT_EQ(arena.used(), 2 * BufferArena::kCacheLineSize);
+}
+
+TEST(BufferArenaTest, ExhaustionReturnsNull) {
+  BufferArena arena(BufferArena::kPageSize);
+  EXPECT_NE(arena.allocate<char>(BufferArena::kPageSize), nullptr);
+  EXPECT_EQ(arena.allocate<char>(1), nullptr);
+  EXPECT_THROW(make_in_arena<int>(arena, 1), std::bad_alloc);
+}
+
+TEST(BufferArenaTest, ArenaVectorCopyUsesHeap) {
+  BufferArena arena(BufferArena::kPageSize);
+  ArenaVector<float> original(16, 1.0f, ArenaAllocator<float>(&arena));
+  const std::size_t used = arena.used();
+
+  ArenaVector<float> copy(original);
+  EXPECT_EQ(arena.used(), used);
+  EXPECT_EQ(copy.get_allocator().arena(), nullptr);
+  EXPECT_EQ(copy, original);
+}
+
+// Arena-backed detectors must consume exactly what arena_bytes() reports
+// and give the same results as heap-backed ones
+TEST(BufferArenaTest, ArenaDetectorMatchesHeapDetector) {
+  constexpr double kSampleRate = 44100.0;
+  constexpr std::size_t kSize = 2048;
+  BufferArena arena(PitchDetector::arena_bytes(kSampleRate, kSize));
+  PitchDetector arena_detector(kSampleRate, kSize, arena);
+  PitchDetector heap_detector(kSampleRate, kSize);
+
+  EXPECT_EQ(arena.used(), PitchDetector::arena_bytes(kSampleRate, kSize));
+
+  auto samples = generate_sine(110.0, kSize, kSampleRate);
+  auto arena_result =
+      arena_detector.detect_pitch_detailed(samples.data(), samples.size());
+  auto heap_result =
+      heap_detector.detect_pitch_detailed(samples.data(), samples.size());
+  ASSERT_TRUE(arena_result.is_valid);
+  EXPECT_DOUBLE_EQ(arena_result.frequency, heap_result.frequency);
+  EXPECT_DOUBLE_EQ(arena_result.confidence, heap_result.confidence);
+}
+
+TEST(BufferArenaTest, FactoryArenaBytesCoverCreatedDetector) {
+  for (std::size_t size : {512u, 2048u, 4096u}) {
+    const std::size_t bytes = PitchDetectorFactory::arena_bytes(48000.0, size);
+    BufferArena arena(bytes);
+    auto detector = PitchDetectorFactory::create(48000.0, size, arena);
+    ASSERT_NE(detector, nullptr);
+    EXPECT_EQ(arena.used(), bytes) << "buffer size " << size;
+  }
+}
+
+TEST(BufferArenaTest, ControllerUsesSingleArena) {
+  PitchDetectionController controller(4096, 48000.0);
+  EXPECT_GE(controller.memory_footprint(),
+            PitchDetectionController::required_memory(4096, 48000.0));
+  EXPECT_EQ(controller.memory_footprint() % BufferArena::kPageSize, 0u);
+
+  auto samples = generate_sine(220.0, 4096, 48000.0);
+  controller.process_audio(samples.data(), samples.size());
+
+  double frequency = 0.0;
+  double confidence = 0.0;
+  ASSERT_TRUE(controller.get_latest_result(frequency, confidence));
+  EXPECT_NEAR(frequency, 220.0, 1.0);
+}
+
+}  // namespace
+}  // namespace simple_tuner
@@ -85,5 +85,24 @@ TEST(ConfigManagerTest, CorruptedDataFallsBackToDefault) {
   EXPECT_DOUBLE_EQ(480.0, manager.get_reference_pitch());
 }
 
+TEST(ConfigManagerTest, DefaultWavetableBudgetOneMebibyte) {
+  auto storage = std::make_unique<MockConfigStorage>();
+  ConfigManager manager(std::move(storage));
+  EXPECT_EQ(1024u * 1024u, manager.get_wavetable_memory_budget());
+}
+
+TEST(ConfigManagerTest, WavetableBudgetStoredAndClamped) {
+  auto storage = std::make_unique<MockConfigStorage>();
+  ConfigManager manager(std::move(storage));
+  EXPECT_TRUE(manager.set_wavetable_memory_budget(4u * 1024u * 1024u));
+  EXPECT_EQ(4u * 1024u * 1024u, manager.get_wavetable_memory_budget());
+
+  EXPECT_TRUE(manager.set_wavetable_memory_budget(1));
+  EXPECT_EQ(128u * 1024u, manager.get_wavetable_memory_budget());
+
+  EXPECT_TRUE(manager.set_wavetable_memory_budget(1u << 30));
+  EXPECT_EQ(8u * 1024u * 1024u, manager.get_wavetable_memory_budget());
+}
+
 }  // namespace
 }  // namespace simple_tuner
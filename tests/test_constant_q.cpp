@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <vector>
+
+#include "simple_tuner/dsp/ConstantQ.h"
+
+namespace simple_tuner {
+namespace dsp {
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+constexpr double kSampleRate = 16000.0;
+
+std::vector<float> sine(double frequency, double amplitude,
+                        std::size_t length) {
+  std::vector<float> x(length);
+  for (std::size_t n = 0; n < length; ++n) {
+    x[n] = static_cast<float>(
+        amplitude * std::sin(2.0 * kPi * frequency * n / kSampleRate + 0.3));
+  }
+  return x;
+}
+
+TEST(ConstantQTest, GeometryFollowsParameters) {
+  ConstantQTransform cqt(kSampleRate, 55.0, 72, 12);
+  EXPECT_EQ(cqt.num_bins(), 72);
+  EXPECT_NEAR(cqt.q(), 1.0 / (std::exp2(1.0 / 12.0) - 1.0), 1e-12);
+  EXPECT_NEAR(cqt.bin_frequency(12), 110.0, 1e-9);
+  EXPECT_NEAR(cqt.bin_frequency(71), 55.0 * std::exp2(71.0 / 12.0), 1e-6);
+  const std::size_t frame = cqt.frame_length();
+  EXPECT_EQ(frame & (frame - 1), 0u);
+  EXPECT_GE(frame, cqt.window_length(0));
+  EXPECT_LT(frame, 2 * cqt.window_length(0));
+  EXPECT_NEAR(static_cast<double>(cqt.window_length(12)),
+              0.5 * static_cast<double>(cqt.window_length(0)), 1.0);
+  // Sparse: a small fraction of a dense bins x frame kernel
+  EXPECT_LT(cqt.kernel_size(), 72 * frame / 20);
+
+  // A shorter window scale shortens the frame
+  ConstantQTransform coarse(kSampleRate, 55.0, 72, 12, 0.5);
+  EXPECT_EQ(coarse.frame_length(), frame / 2);
+
+  // Bins reaching 0.45 of the sample rate are dropped
+  ConstantQTransform high(kSampleRate, 1000.0, 100, 12);
+  EXPECT_EQ(high.num_bins(), 35);
+  EXPECT_LT(high.bin_frequency(high.num_bins() - 1), 0.45 * kSampleRate);
+}
+
+TEST(ConstantQTest, SinusoidReadsItsAmplitudeInItsBin) {
+  ConstantQTransform cqt(kSampleRate, 55.0, 60, 12);
+  std::vector<float> magnitudes(60);
+  for (int bin : {0, 17, 30, 59}) {
+    const auto x = sine(cqt.bin_frequency(bin), 0.5, cqt.frame_length());
+    cqt.magnitudes(x.data(), magnitudes.data());
+    const auto peak = std::max_element(magnitudes.begin(), magnitudes.end());
+    EXPECT_EQ(peak - magnitudes.begin(), bin);
+    EXPECT_NEAR(*peak, 0.5, 0.01) << bin;
+    // An octave away there is next to nothing
+    if (bin + 12 < 60) {
+      EXPECT_LT(magnitudes[static_cast<std::size_t>(bin + 12)], 0.005);
+    }
+  }
+}
+
+TEST(ConstantQTest, MatchesDirectEvaluation) {
+  ConstantQTransform cqt(kSampleRate, 110.0, 36, 12, 1.0, 1e-6);
+  const std::size_t frame = cqt.frame_length();
+  std::vector<float> x(frame);
+  for (std::size_t n = 0; n < frame; ++n) {
+    x[n] = static_cast<float>(std::sin(0.013 * n) * std::cos(0.0007 * n) +
+                              0.25 * std::sin(0.31 * n));
+  }
+  std::vector<std::complex<double>> out(36);
+  cqt.transform(x.data(), out.data());
+  for (int bin : {0, 11, 35}) {
+    const std::size_t length = cqt.window_length(bin);
+    const std::size_t offset = (frame - length) / 2;
+    std::complex<double> sum;
+    double window_sum = 0.0;
+    for (std::size_t n = 0; n < length; ++n) {
+      const double w =
+          0.5 - 0.5 * std::cos(2.0 * kPi * (n + 0.5) / length);
+      window_sum += w;
+      sum += static_cast<double>(x[offset + n]) * w *
+             std::polar(1.0, -2.0 * kPi * cqt.bin_frequency(bin) * n /
+                                 kSampleRate);
+    }
+    sum *= 2.0 / window_sum;
+    EXPECT_NEAR(std::abs(out[static_cast<std::size_t>(bin)] - sum), 0.0,
+                1e-4 * std::max(std::abs(sum), 1.0))
+        << bin;
+  }
+}
+
+}  // namespace
+}  // namespace dsp
+}  // namespace simple_tuner
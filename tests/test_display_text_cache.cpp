@@ -0,0 +1,37 @@
+#include <gtest/gtest.h>
+
+#include <string_view>
+
+#include "simple_tuner/algorithms/DisplayTextCache.h"
+#include "simple_tuner/algorithms/FrequencyCalculator.h"
+
+namespace simple_tuner {
+namespace {
+
+static_assert(FrequencyCalculator::note_name(69) == "A");
+static_assert(FrequencyCalculator::note_name(61) == "C#");
+static_assert(FrequencyCalculator::note_name(-1) == "B");
+
+TEST(DisplayTextCacheTest, ReferenceTextRebuildsOnlyOnChange) {
+  DisplayTextCache cache;
+  FrequencyCalculator calc;
+  EXPECT_EQ(cache.reference_text(69, calc.midi_to_frequency(69)),
+            "440.00 Hz");
+  EXPECT_EQ(cache.reference_text(60, calc.midi_to_frequency(60)),
+            "261.63 Hz");
+  EXPECT_EQ(cache.reference_text(21, calc.midi_to_frequency(21)), "27.50 Hz");
+
+  // Same key and rounded value: the cached characters are returned
+  const std::string_view first = cache.reference_text(69, 440.001);
+  EXPECT_EQ(cache.reference_text(69, 439.999).data(), first.data());
+
+  calc.set_reference_a4(442.0);
+  EXPECT_EQ(cache.reference_text(69, calc.midi_to_frequency(69)),
+            "442.00 Hz");
+  EXPECT_EQ(cache.reference_text(108, 4186.009), "4186.01 Hz");
+  EXPECT_EQ(cache.reference_text(12, 16.35), "16.35 Hz");
+  EXPECT_EQ(cache.reference_text(69, -1.0), "--");
+}
+
+}  // namespace
+}  // namespace simple_tuner
@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <complex>
+#include <random>
+#include <vector>
+
+#include "simple_tuner/dsp/Fft.h"
+
+namespace simple_tuner {
+namespace dsp {
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+// Direct DTFT of x at omega (radians per sample)
+std::complex<double> dtft(const std::vector<float>& x, double omega) {
+  std::complex<double> sum;
+  for (std::size_t n = 0; n < x.size(); ++n) {
+    sum += static_cast<double>(x[n]) *
+           std::polar(1.0, -omega * static_cast<double>(n));
+  }
+  return sum;
+}
+
+std::vector<float> random_block(std::size_t size) {
+  std::mt19937 rng(3);
+  std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+  std::vector<float> x(size);
+  for (float& value : x) {
+    value = dist(rng);
+  }
+  return x;
+}
+
+TEST(FftTest, RoundsSizeUpToPowerOfTwo) {
+  EXPECT_EQ(Fft(1).size(), 2u);
+  EXPECT_EQ(Fft(64).size(), 64u);
+  EXPECT_EQ(Fft(65).size(), 128u);
+}
+
+TEST(FftTest, ForwardMatchesDirectDftAndInverseRestores) {
+  const std::size_t size = 256;
+  const auto x = random_block(size);
+  std::vector<std::complex<double>> data(x.begin(), x.end());
+  Fft fft(size);
+  fft.forward(data.data());
+  for (std::size_t k = 0; k < size; k += 17) {
+    const auto expected = dtft(x, 2.0 * kPi * k / size);
+    EXPECT_NEAR(data[k].real(), expected.real(), 1e-9);
+    EXPECT_NEAR(data[k].imag(), expected.imag(), 1e-9);
+  }
+  fft.inverse(data.data());
+  for (std::size_t n = 0; n < size; ++n) {
+    EXPECT_NEAR(data[n].real(), x[n], 1e-12);
+    EXPECT_NEAR(data[n].imag(), 0.0, 1e-12);
+  }
+}
+
+TEST(ChirpZTransformTest, MatchesDirectDtftOnAZoomedBand) {
+  const std::size_t length = 1000;
+  const std::size_t points = 300;
+  const double spacing = 2.0 * kPi / (8.0 * length);
+  const double start = 0.3;
+  const auto x = random_block(length);
+  ChirpZTransform zoom(length, points, spacing);
+  std::vector<std::complex<double>> out(points);
+  zoom.transform(x.data(), start, points, out.data());
+  for (std::size_t k = 0; k < points; k += 23) {
+    const auto expected = dtft(x, start + spacing * k);
+    EXPECT_NEAR(out[k].real(), expected.real(), 1e-8);
+    EXPECT_NEAR(out[k].imag(), expected.imag(), 1e-8);
+  }
+}
+
+}  // namespace
+}  // namespace dsp
+}  // namespace simple_tuner
@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <initializer_list>
+#include <memory>
+#include <vector>
+
+#include "simple_tuner/algorithms/FixedPitchDetector.h"
+#include "simple_tuner/algorithms/PitchDetector.h"
+#include "simple_tuner/algorithms/PitchDetectorFactory.h"
+
+namespace simple_tuner {
+namespace {
+
+constexpr double kCentTolerance = 1.0;  // ±1 cent accuracy
+
+std::vector<float> generate_sine(double frequency, std::size_t num_samples,
+                                 double sample_rate, double amplitude = 1.0) {
+  std::vector<float> samples(num_samples);
+  constexpr double pi = 3.14159265358979323846;
+  const double angular_freq = 2.0 * pi * frequency / sample_rate;
+  for (std::size_t i = 0; i < num_samples; ++i) {
+    samples[i] = static_cast<float>(
+        amplitude * std::sin(angular_freq * static_cast<double>(i)));
+  }
+  return samples;
+}
+
+double cents_between(double freq1, double freq2) {
+  return 1200.0 * std::log2(freq1 / freq2);
+}
+
+// Fixed detector should track the runtime detector on every tier
+template <typename Fixed>
+void expect_matches_runtime(std::initializer_list<double> frequencies) {
+  auto fixed = std::make_unique<Fixed>();
+  PitchDetector runtime(Fixed::kSampleRate, Fixed::kBufferSize);
+
+  for (double frequency : frequencies) {
+    auto samples =
+        generate_sine(frequency, Fixed::kBufferSize, Fixed::kSampleRate);
+    auto fixed_result =
+        fixed->detect_pitch_detailed(samples.data(), samples.size());
+    auto runtime_result =
+        runtime.detect_pitch_detailed(samples.data(), samples.size());
+
+    ASSERT_TRUE(fixed_result.is_valid) << frequency;
+    ASSERT_TRUE(runtime_result.is_valid) << frequency;
+    EXPECT_LE(std::abs(cents_between(fixed_result.frequency, frequency)),
+              kCentTolerance)
+        << frequency;
+    EXPECT_NEAR(fixed_result.frequency, runtime_result.frequency,
+                runtime_result.frequency * 1e-4)
+        << frequency;
+    EXPECT_NEAR(fixed_result.confidence, runtime_result.confidence, 1e-3)
+        << frequency;
+  }
+}
+
+TEST(FixedPitchDetectorTest, FastTierMatchesRuntime) {
+  expect_matches_runtime<FixedPitchDetector<512, 44100>>(
+      {261.63, 440.0, 987.77, 4186.01});
+}
+
+TEST(FixedPitchDetectorTest, MediumTierMatchesRuntime) {
+  expect_matches_runtime<FixedPitchDetector<1024, 48000>>(
+      {65.41, 110.0, 196.0, 440.0});
+}
+
+TEST(FixedPitchDetectorTest, FullTierMatchesRuntime) {
+  expect_matches_runtime<FixedPitchDetector<4096, 44100>>(
+      {32.70, 65.41, 220.0, 1479.98});
+}
+
+TEST(FixedPitchDetectorTest, ConstexprWindowMatchesRuntimeWindow) {
+  // Compile-time Hann table should give the same result as the runtime one
+  auto fixed = std::make_unique<FixedPitchDetector<4096, 48000>>();
+  PitchDetector runtime(48000.0, 4096);
+  fixed->set_window_type(WindowType::kHann);
+  runtime.set_window_type(WindowType::kHann);
+  auto samples = generate_sine(220.0, 4096, 48000.0);
+
+  auto fixed_result =
+      fixed->detect_pitch_detailed(samples.data(), samples.size());
+  auto runtime_result =
+      runtime.detect_pitch_detailed(samples.data(), samples.size());
+
+  ASSERT_TRUE(fixed_result.is_valid);
+  ASSERT_TRUE(runtime_result.is_valid);
+  EXPECT_NEAR(fixed_result.frequency, runtime_result.frequency,
+              runtime_result.frequency * 1e-4);
+}
+
+TEST(FixedPitchDetectorTest, ShortInputRejected) {
+  auto detector = std::make_unique<FixedPitchDetector<1024, 44100>>();
+  auto samples = generate_sine(440.0, 512, 44100.0);
+
+  EXPECT_FALSE(
+      detector->detect_pitch_detailed(samples.data(), samples.size()).is_valid);
+  EXPECT_FALSE(detector->detect_pitch_detailed(nullptr, 1024).is_valid);
+}
+
+TEST(FixedPitchDetectorTest, LowSignalRejection) {
+  auto detector = std::make_unique<FixedPitchDetector<512, 44100>>();
+  auto samples = generate_sine(440.0, 512, 44100.0, 0.0003);
+
+  auto result = detector->detect_pitch_detailed(samples.data(), samples.size());
+
+  EXPECT_FALSE(result.is_valid);
+  EXPECT_EQ(result.frequency, 0.0);
+}
+
+TEST(PitchDetectorFactoryTest, UsesFixedDetectorForTierSizes) {
+  EXPECT_TRUE(PitchDetectorFactory::has_fixed_detector(44100.0, 512));
+  EXPECT_TRUE(PitchDetectorFactory::has_fixed_detector(48000.0, 4096));
+
+  using MediumTier = FixedPitchDetector<1024, 44100>;
+  auto detector = PitchDetectorFactory::create(44100.0, 1024);
+  EXPECT_NE(dynamic_cast<MediumTier*>(detector.get()), nullptr);
+}
+
+TEST(PitchDetectorFactoryTest, FallsBackToRuntimeDetector) {
+  EXPECT_FALSE(PitchDetectorFactory::has_fixed_detector(22050.0, 512));
+  EXPECT_FALSE(PitchDetectorFactory::has_fixed_detector(44100.0, 2048));
+
+  auto detector = PitchDetectorFactory::create(22050.0, 2048);
+  ASSERT_NE(dynamic_cast<PitchDetector*>(detector.get()), nullptr);
+
+  auto samples = generate_sine(440.0, 2048, 22050.0);
+  auto result = detector->detect_pitch_detailed(samples.data(), samples.size());
+  EXPECT_TRUE(result.is_valid);
+  EXPECT_LE(std::abs(cents_between(result.frequency, 440.0)), kCentTolerance);
+}
+
+}  // namespace
+}  // namespace simple_tuner
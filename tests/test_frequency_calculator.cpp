@@ -101,5 +101,24 @@ TEST(FrequencyCalculatorTest, BoundaryC8HighFrequency) {
   EXPECT_NEAR(4186.01, calc.midi_to_frequency(108), 1.0);
 }
 
+TEST(FrequencyCalculatorTest, BatchConversionMatchesScalarApi) {
+  FrequencyCalculator calc(415.0);
+  const double frequencies[] = {27.0, 110.0, 261.0, 415.0, 430.0, 0.0, 4000.0};
+  constexpr std::size_t kCount = sizeof(frequencies) / sizeof(frequencies[0]);
+  int midi_notes[kCount];
+  double cents[kCount];
+  calc.convert_batch(frequencies, kCount, NoteResults{midi_notes, cents});
+
+  for (std::size_t i = 0; i < kCount; ++i) {
+    const int midi = calc.frequency_to_midi(frequencies[i]);
+    EXPECT_EQ(midi_notes[i], midi);
+    if (frequencies[i] > 0.0) {
+      EXPECT_NEAR(cents[i], calc.calculate_cents(frequencies[i], midi),
+                  kEpsilon);
+    }
+  }
+  EXPECT_EQ(midi_notes[3], 69);  // A4 at the 415 Hz reference
+}
+
 }  // namespace
 }  // namespace simple_tuner
@@ -0,0 +1,177 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "simple_tuner/algorithms/HarmonicSumDetector.h"
+#include "simple_tuner/controllers/PitchDetectionController.h"
+
+namespace simple_tuner {
+namespace {
+
+constexpr double kSampleRate = 48000.0;
+constexpr std::size_t kBufferSize = 4096;
+constexpr double kPi = 3.14159265358979323846;
+
+double key_frequency(int midi_note) {
+  return 440.0 * std::exp2((midi_note - 69) / 12.0);
+}
+
+double cents_between(double frequency, double reference) {
+  return 1200.0 * std::log2(frequency / reference);
+}
+
+// Stiff string: partial n at n f0 sqrt((1 + B n^2) / (1 + B)) with
+// amplitude 1 / n, the fundamental scaled by fundamental, plus a little
+// noise
+std::vector<float> generate_string(double f0, double inharmonicity,
+                                   double fundamental,
+                                   std::size_t num_samples) {
+  std::mt19937 rng(3);
+  std::normal_distribution<double> noise(0.0, 1e-4);
+  std::vector<float> samples(num_samples);
+  for (std::size_t i = 0; i < num_samples; ++i) {
+    const double t = static_cast<double>(i) / kSampleRate;
+    double value = 0.0;
+    for (int n = 1; n <= 10; ++n) {
+      const double frequency =
+          n * f0 * std::sqrt((1.0 + inharmonicity * n * n) /
+                             (1.0 + inharmonicity));
+      if (frequency < 0.45 * kSampleRate) {
+        value += (n == 1 ? fundamental : 1.0) *
+                 std::sin(2.0 * kPi * frequency * t + 0.7 * n) / n;
+      }
+    }
+    samples[i] = static_cast<float>(0.2 * value + noise(rng));
+  }
+  return samples;
+}
+
+TEST(HarmonicSumDetectorTest, ArenaHoldsTablesAndScratch) {
+  const std::size_t bytes = HarmonicSumDetector::arena_bytes(kBufferSize);
+  BufferArena arena(bytes);
+  HarmonicSumDetector detector(kSampleRate, kBufferSize, arena);
+  EXPECT_EQ(arena.used(), bytes);
+  EXPECT_EQ(detector.spectrum_length(), 2 * kBufferSize);
+
+  const auto samples =
+      generate_string(key_frequency(45), 0.0, 1.0, kBufferSize);
+  const DetectionResult result =
+      detector.detect_pitch_detailed(samples.data(), samples.size());
+  ASSERT_TRUE(result.is_valid);
+  EXPECT_NEAR(cents_between(result.frequency, key_frequency(45)), 0.0, 2.0);
+}
+
+TEST(HarmonicSumDetectorTest, WeakFundamentalIsNotReadAnOctaveUp) {
+  HarmonicSumDetector detector(kSampleRate, kBufferSize);
+  detector.set_inharmonicity(3e-4);
+  for (int key : {28, 31, 33, 36, 38, 40, 43}) {
+    // Fundamental 30 dB below the second partial
+    const double f0 = key_frequency(key);
+    const auto samples = generate_string(f0, 3e-4, 0.06, kBufferSize);
+    const DetectionResult result =
+        detector.detect_pitch_detailed(samples.data(), samples.size());
+    ASSERT_TRUE(result.is_valid) << key;
+    EXPECT_NEAR(cents_between(result.frequency, f0), 0.0, 3.0) << key;
+    EXPECT_GT(result.confidence, 0.8) << key;
+  }
+}
+
+TEST(HarmonicSumDetectorTest, PlacesPartialsOnTheStretchedSeries) {
+  // A treble-like B with a weak fundamental: the frequency rests on the
+  // upper partials, partial 8 sitting 47 cents sharp of 8 f0
+  const double f0 = key_frequency(81);
+  const auto samples = generate_string(f0, 2e-3, 0.03, kBufferSize);
+  HarmonicSumDetector detector(kSampleRate, kBufferSize);
+  detector.set_inharmonicity(2e-3);
+  const DetectionResult stretched =
+      detector.detect_pitch_detailed(samples.data(), samples.size());
+  ASSERT_TRUE(stretched.is_valid);
+  EXPECT_NEAR(cents_between(stretched.frequency, f0), 0.0, 1.0);
+  EXPECT_GT(stretched.confidence, 0.95);
+
+  // Looking for harmonic partials misses the upper ones, which leaves too
+  // few to fit the stretch
+  detector.set_inharmonicity(0.0);
+  const DetectionResult harmonic =
+      detector.detect_pitch_detailed(samples.data(), samples.size());
+  EXPECT_LT(harmonic.confidence, stretched.confidence - 0.1);
+  EXPECT_GT(std::abs(cents_between(harmonic.frequency, f0)), 5.0);
+}
+
+TEST(HarmonicSumDetectorTest, StretchedSeriesIsNotTakenForALowerNote) {
+  // Under a large assumed B, partials of the double octave below land on
+  // the winner's own partials; they must not count as evidence for it
+  HarmonicSumDetector detector(kSampleRate, kBufferSize);
+  detector.set_inharmonicity(5e-3);
+  for (int key : {45, 57, 69, 81}) {
+    const double f0 = key_frequency(key);
+    const auto samples = generate_string(f0, 5e-3, 0.03, kBufferSize);
+    const DetectionResult result =
+        detector.detect_pitch_detailed(samples.data(), samples.size());
+    ASSERT_TRUE(result.is_valid) << key;
+    EXPECT_NEAR(cents_between(result.frequency, f0), 0.0, 1.0) << key;
+  }
+}
+
+TEST(HarmonicSumDetectorTest, ReadsPureTonesAcrossTheRange) {
+  HarmonicSumDetector detector(kSampleRate, kBufferSize);
+  std::vector<float> samples(kBufferSize);
+  for (double frequency : {35.0, 100.0, 440.0, 1000.0, 3000.0}) {
+    for (std::size_t i = 0; i < samples.size(); ++i) {
+      samples[i] = static_cast<float>(
+          0.3 * std::sin(2.0 * kPi * frequency * static_cast<double>(i) /
+                         kSampleRate));
+    }
+    const DetectionResult result =
+        detector.detect_pitch_detailed(samples.data(), samples.size());
+    ASSERT_TRUE(result.is_valid) << frequency;
+    EXPECT_NEAR(cents_between(result.frequency, frequency), 0.0, 2.0)
+        << frequency;
+  }
+}
+
+TEST(HarmonicSumDetectorTest, RejectsSilenceNoiseAndShortFrames) {
+  HarmonicSumDetector detector(kSampleRate, kBufferSize);
+  const std::vector<float> silence(kBufferSize, 0.0f);
+  EXPECT_FALSE(
+      detector.detect_pitch_detailed(silence.data(), silence.size()).is_valid);
+  EXPECT_FALSE(detector.detect_pitch_detailed(nullptr, kBufferSize).is_valid);
+
+  std::mt19937 rng(9);
+  std::normal_distribution<float> noise(0.0f, 0.1f);
+  std::vector<float> white(kBufferSize);
+  for (float& sample : white) {
+    sample = noise(rng);
+  }
+  EXPECT_FALSE(
+      detector.detect_pitch_detailed(white.data(), white.size()).is_valid);
+
+  const auto tone = generate_string(key_frequency(45), 0.0, 1.0, kBufferSize);
+  EXPECT_FALSE(
+      detector.detect_pitch_detailed(tone.data(), tone.size() - 1).is_valid);
+  detector.set_threshold_db(0.0);
+  EXPECT_FALSE(
+      detector.detect_pitch_detailed(tone.data(), tone.size()).is_valid);
+}
+
+TEST(HarmonicSumDetectorTest, ControllerRunsItAsTheFullTier) {
+  // Low E of a guitar with its fundamental 30 dB down: the NSDF tiers only
+  // find the octave above, with too little clarity to be accepted
+  const double f0 = key_frequency(40);
+  const auto samples = generate_string(f0, 3e-4, 0.03, 4 * kBufferSize);
+  PitchDetectionController controller(kBufferSize, kSampleRate);
+  controller.set_full_tier_method(FullTierMethod::kHarmonicSum);
+  for (std::size_t i = 0; i < samples.size(); i += 256) {
+    controller.process_audio(samples.data() + i, 256);
+  }
+  double detected = 0.0;
+  double confidence = 0.0;
+  ASSERT_TRUE(controller.get_latest_result(detected, confidence));
+  EXPECT_NEAR(cents_between(detected, f0), 0.0, 1.0);
+  EXPECT_GT(confidence, 0.9);
+}
+
+}  // namespace
+}  // namespace simple_tuner
@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "simple_tuner/algorithms/InharmonicityAnalyzer.h"
+#include "simple_tuner/algorithms/InharmonicityEstimator.h"
+
+namespace simple_tuner {
+namespace {
+
+constexpr double kSampleRate = 48000.0;
+constexpr std::size_t kBlockSize = 24000;  // 0.5 s
+constexpr double kPi = 3.14159265358979323846;
+
+// Decaying stiff string: partial n at n f0 sqrt(1 + B n^2), amplitude 1 / n,
+// plus a little noise
+std::vector<float> generate_string(double f0, double inharmonicity,
+                                   std::size_t num_samples) {
+  std::mt19937 rng(11);
+  std::normal_distribution<double> noise(0.0, 1e-3);
+  std::vector<float> samples(num_samples);
+  for (std::size_t i = 0; i < num_samples; ++i) {
+    const double t = static_cast<double>(i) / kSampleRate;
+    double value = 0.0;
+    for (int n = 1; n <= 12; ++n) {
+      const double frequency =
+          n * f0 * std::sqrt(1.0 + inharmonicity * n * n);
+      if (frequency < 0.45 * kSampleRate) {
+        value += std::sin(2.0 * kPi * frequency * t + n) / n;
+      }
+    }
+    samples[i] = static_cast<float>(0.3 * value * std::exp(-2.0 * t) +
+                                    noise(rng));
+  }
+  return samples;
+}
+
+TEST(InharmonicityEstimatorTest, FitsBassAndTrebleStrings) {
+  InharmonicityEstimator estimator(kSampleRate, kBlockSize);
+  struct Case {
+    double f0;
+    double inharmonicity;
+  };
+  for (const Case& c : {Case{27.5, 2e-4}, Case{110.0, 4e-4},
+                        Case{1046.5, 1e-2}}) {
+    const auto samples = generate_string(c.f0, c.inharmonicity, kBlockSize);
+    // Nominal frequency 10 cents off the measured fundamental
+    const double nominal = c.f0 * std::sqrt(1.0 + c.inharmonicity) *
+                           std::exp2(10.0 / 1200.0);
+    const InharmonicityResult result =
+        estimator.estimate(samples.data(), samples.size(), nominal);
+    ASSERT_TRUE(result.is_valid) << c.f0;
+    EXPECT_EQ(result.num_partials, estimator.get_num_partials()) << c.f0;
+    EXPECT_NEAR(result.inharmonicity, c.inharmonicity,
+                0.01 * c.inharmonicity)
+        << c.f0;
+    EXPECT_NEAR(result.fundamental, c.f0, 1e-3 * c.f0) << c.f0;
+  }
+}
+
+TEST(InharmonicityEstimatorTest, HarmonicToneHasNoInharmonicity) {
+  InharmonicityEstimator estimator(kSampleRate, kBlockSize);
+  const auto samples = generate_string(440.0, 0.0, kBlockSize);
+  const InharmonicityResult result =
+      estimator.estimate(samples.data(), samples.size(), 440.0);
+  ASSERT_TRUE(result.is_valid);
+  EXPECT_LT(result.inharmonicity, 1e-6);
+  EXPECT_NEAR(result.partials[2], 1320.0, 0.01);
+}
+
+TEST(InharmonicityEstimatorTest, RejectsNoise) {
+  std::mt19937 rng(5);
+  std::normal_distribution<float> noise(0.0f, 0.1f);
+  std::vector<float> samples(kBlockSize);
+  for (float& sample : samples) {
+    sample = noise(rng);
+  }
+  InharmonicityEstimator estimator(kSampleRate, kBlockSize);
+  const InharmonicityResult result =
+      estimator.estimate(samples.data(), samples.size(), 440.0);
+  EXPECT_FALSE(result.is_valid);
+  EXPECT_LT(result.num_partials, InharmonicityEstimator::kMinPartials);
+}
+
+TEST(InharmonicityAnalyzerTest, AnalyzesBufferedAudioInTheBackground) {
+  InharmonicityAnalyzer analyzer(kSampleRate);
+  const auto samples = generate_string(220.0, 6e-4, kBlockSize);
+  InharmonicityResult result;
+  EXPECT_FALSE(analyzer.get_result(57, result));
+  EXPECT_FALSE(analyzer.request_analysis(10, 220.0, samples.data(),
+                                         samples.size()));
+
+  ASSERT_TRUE(analyzer.request_analysis(57, 220.0, samples.data(),
+                                        samples.size()));
+  ASSERT_TRUE(analyzer.wait_until_idle(std::chrono::seconds(5)));
+  ASSERT_TRUE(analyzer.get_result(57, result));
+  EXPECT_TRUE(result.is_valid);
+  EXPECT_NEAR(result.inharmonicity, 6e-4, 6e-6);
+}
+
+TEST(InharmonicityAnalyzerTest, CapturesFromTheAudioThread) {
+  InharmonicityAnalyzer analyzer(kSampleRate);
+  const auto samples =
+      generate_string(110.0, 3e-4, 4 * analyzer.capture_length());
+  ASSERT_TRUE(analyzer.request_capture(45, 110.0));
+  EXPECT_FALSE(analyzer.request_capture(46, 116.5));  // Busy
+
+  // Stand-in audio thread: 256-sample callbacks at roughly real time
+  std::size_t position = 0;
+  while (analyzer.is_busy() && position + 256 <= samples.size()) {
+    analyzer.push_audio(samples.data() + position, 256);
+    position += 256;
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  ASSERT_TRUE(analyzer.wait_until_idle(std::chrono::seconds(5)));
+  InharmonicityResult result;
+  ASSERT_TRUE(analyzer.get_result(45, result));
+  EXPECT_TRUE(result.is_valid);
+  EXPECT_NEAR(result.inharmonicity, 3e-4, 3e-5);
+}
+
+}  // namespace
+}  // namespace simple_tuner
@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "simple_tuner/algorithms/KeyIdentifier.h"
+#include "simple_tuner/algorithms/KeyTracker.h"
+
+namespace simple_tuner {
+namespace {
+
+constexpr double kSampleRate = 48000.0;
+constexpr double kPi = 3.14159265358979323846;
+
+double key_frequency(int midi_note) {
+  return 440.0 * std::exp2((midi_note - 69) / 12.0);
+}
+
+// Stiff string: partial n at n f0 sqrt(1 + B n^2) with amplitude
+// amplitude / n, the fundamental scaled by fundamental, plus a little noise
+std::vector<float> generate_string(double f0, double seconds,
+                                   double fundamental = 1.0,
+                                   double amplitude = 0.2) {
+  const double inharmonicity = f0 < 200.0 ? 3e-4 : 2e-3;
+  std::mt19937 rng(7);
+  std::normal_distribution<double> noise(0.0, 1e-4);
+  const auto length = static_cast<std::size_t>(seconds * kSampleRate);
+  std::vector<float> samples(length);
+  for (std::size_t i = 0; i < length; ++i) {
+    const double t = static_cast<double>(i) / kSampleRate;
+    double value = 0.0;
+    for (int n = 1; n <= 10; ++n) {
+      const double frequency =
+          n * f0 * std::sqrt(1.0 + inharmonicity * n * n);
+      if (frequency < 0.45 * kSampleRate) {
+        value += (n == 1 ? fundamental : 1.0) *
+                 std::sin(2.0 * kPi * frequency * t + n) / n;
+      }
+    }
+    samples[i] = static_cast<float>(amplitude * value + noise(rng));
+  }
+  return samples;
+}
+
+TEST(KeyIdentifierTest, FrameFitsAboutOneSecond) {
+  KeyIdentifier identifier(kSampleRate);
+  EXPECT_EQ(identifier.decimation(), 3);
+  EXPECT_EQ(identifier.transform().frame_length(), 16384u);
+  EXPECT_GT(identifier.frame_length(), 3u * 16384u);
+  EXPECT_EQ(identifier.transform().num_bins(), 264);
+  EXPECT_NEAR(identifier.transform().bin_frequency(
+                  KeyIdentifier::bin_of_key(69)),
+              440.0, 1e-6);
+  EXPECT_NEAR(identifier.transform().bin_frequency(
+                  KeyIdentifier::bin_of_key(21)),
+              27.5, 1e-9);
+
+  KeyIdentifier cd_rate(44100.0);
+  EXPECT_EQ(cd_rate.decimation(), 2);
+  EXPECT_EQ(cd_rate.transform().frame_length(), 32768u);
+}
+
+TEST(KeyIdentifierTest, IdentifiesKeysAcrossTheKeyboard) {
+  KeyIdentifier identifier(kSampleRate);
+  for (int key : {21, 33, 40, 52, 60, 69, 76, 88, 96, 105, 108}) {
+    const auto samples = generate_string(key_frequency(key), 1.2);
+    const KeyEstimate estimate =
+        identifier.identify(samples.data(), samples.size());
+    ASSERT_TRUE(estimate.is_valid) << key;
+    EXPECT_EQ(estimate.midi_note, key);
+    EXPECT_GT(estimate.confidence, 0.6) << key;
+    // Within a quarter semitone of the stretched fundamental
+    EXPECT_NEAR(1200.0 * std::log2(estimate.frequency / key_frequency(key)),
+                0.0, 25.0)
+        << key;
+  }
+}
+
+TEST(KeyIdentifierTest, RecoversMissingFundamental) {
+  KeyIdentifier identifier(kSampleRate);
+  for (int key : {24, 28, 33, 40}) {
+    // Fundamental 30 dB down, as on small pianos and phone microphones
+    const auto samples = generate_string(key_frequency(key), 1.2, 0.03);
+    const KeyEstimate estimate =
+        identifier.identify(samples.data(), samples.size());
+    ASSERT_TRUE(estimate.is_valid) << key;
+    EXPECT_EQ(estimate.midi_note, key);
+    EXPECT_LT(estimate.partial_db[0], -20.0) << key;
+  }
+}
+
+TEST(KeyIdentifierTest, ReportsPartialLevels) {
+  KeyIdentifier identifier(kSampleRate);
+  const auto samples = generate_string(key_frequency(45), 1.2);
+  const KeyEstimate estimate =
+      identifier.identify(samples.data(), samples.size());
+  ASSERT_TRUE(estimate.is_valid);
+  EXPECT_EQ(estimate.num_partials, KeyEstimate::kMaxPartials);
+  EXPECT_NEAR(estimate.level_db, 20.0 * std::log10(0.2), 1.0);
+  for (int h = 1; h <= KeyEstimate::kMaxPartials; ++h) {
+    EXPECT_NEAR(estimate.partial_db[static_cast<std::size_t>(h - 1)],
+                -20.0 * std::log10(h), 1.5)
+        << h;
+  }
+
+  // Near the top only the partials below C8 are analysed
+  const auto treble = generate_string(key_frequency(100), 1.2);
+  const KeyEstimate high = identifier.identify(treble.data(), treble.size());
+  ASSERT_TRUE(high.is_valid);
+  EXPECT_EQ(high.num_partials, 1);
+  EXPECT_EQ(high.partial_db[1], KeyEstimate::kFloorDb);
+}
+
+TEST(KeyIdentifierTest, QuietInputIsNotIdentified) {
+  KeyIdentifier identifier(kSampleRate);
+  const std::vector<float> silence(identifier.frame_length(), 0.0f);
+  EXPECT_FALSE(identifier.identify(silence.data(), silence.size()).is_valid);
+  EXPECT_FALSE(identifier.identify(nullptr, 0).is_valid);
+
+  const auto quiet = generate_string(key_frequency(60), 1.2, 1.0, 2e-4);
+  EXPECT_FALSE(identifier.identify(quiet.data(), quiet.size()).is_valid);
+  identifier.set_threshold_db(-90.0);
+  const KeyEstimate estimate = identifier.identify(quiet.data(), quiet.size());
+  EXPECT_TRUE(estimate.is_valid);
+  EXPECT_EQ(estimate.midi_note, 60);
+}
+
+TEST(KeyTrackerTest, SettlesOnTheKeyPlayed) {
+  auto tracker = std::make_unique<KeyTracker>(kSampleRate);
+  KeyEstimate estimate;
+  EXPECT_FALSE(tracker->get_estimate(estimate));
+
+  const auto samples = generate_string(key_frequency(57), 2.0);
+  std::size_t updates = 0;
+  for (std::size_t i = 0; i + 512 <= samples.size(); i += 512) {
+    tracker->push_audio(samples.data() + i, 512);
+    // Pace the audio so the ring never overruns
+    if ((i / 512) % 32 == 31) {
+      ASSERT_TRUE(
+          tracker->wait_for_updates(updates, std::chrono::seconds(5)));
+      updates = tracker->num_updates();
+    }
+  }
+  ASSERT_TRUE(tracker->wait_for_updates(updates, std::chrono::seconds(5)));
+  ASSERT_TRUE(tracker->get_estimate(estimate));
+  EXPECT_TRUE(estimate.is_valid);
+  EXPECT_EQ(estimate.midi_note, 57);
+  EXPECT_TRUE(estimate.is_stable);
+  EXPECT_GE(tracker->num_updates(), KeyTracker::kStableUpdates);
+}
+
+}  // namespace
+}  // namespace simple_tuner
@@ -0,0 +1,183 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "simple_tuner/algorithms/FrequencyCalculator.h"
+#include "simple_tuner/algorithms/MeasurementAggregator.h"
+#include "simple_tuner/algorithms/P2Quantile.h"
+#include "simple_tuner/controllers/PitchDetectionController.h"
+
+namespace simple_tuner {
+namespace {
+
+constexpr double kSampleRate = 48000.0;
+constexpr double kPi = 3.14159265358979323846;
+constexpr double kRate = 100.0;  // Detections per second in the streams
+
+TEST(P2QuantileTest, ExactForFewSamples) {
+  P2Quantile median;
+  EXPECT_EQ(median.value(), 0.0);
+  for (double value : {3.0, 1.0, 2.0}) {
+    median.add(value);
+  }
+  EXPECT_EQ(median.value(), 2.0);
+  EXPECT_EQ(median.count(), 3u);
+  median.reset();
+  EXPECT_EQ(median.count(), 0u);
+}
+
+TEST(P2QuantileTest, TracksQuantilesOfStream) {
+  std::mt19937 rng(7);
+  std::normal_distribution<double> noise(2.0, 1.5);
+  for (double probability : {0.1, 0.25, 0.5, 0.75, 0.9}) {
+    P2Quantile quantile(probability);
+    std::vector<double> values;
+    for (int i = 0; i < 5000; ++i) {
+      values.push_back(noise(rng));
+      quantile.add(values.back());
+    }
+    std::sort(values.begin(), values.end());
+    const double exact = values[static_cast<std::size_t>(
+        probability * static_cast<double>(values.size() - 1))];
+    EXPECT_NEAR(quantile.value(), exact, 0.1) << probability;
+  }
+}
+
+TEST(MeasurementAggregatorTest, IgnoresInvalidInput) {
+  MeasurementAggregator aggregator;
+  aggregator.add(20, 0.0, 0.0);
+  aggregator.add(60, 51.0, 0.0);
+  aggregator.add(60, std::nan(""), 0.0);
+  KeySummary summary;
+  EXPECT_FALSE(aggregator.get_summary(60, summary));
+  EXPECT_FALSE(aggregator.get_summary(20, summary));
+  EXPECT_EQ(aggregator.last_key(), 0);
+}
+
+TEST(MeasurementAggregatorTest, SummarizesHeldNote) {
+  MeasurementAggregator aggregator;
+  std::mt19937 rng(1);
+  std::normal_distribution<double> noise(0.0, 0.3);
+  for (int i = 0; i < 300; ++i) {
+    // Occasional wild readings do not move the median
+    const double cents = i % 25 == 12 ? -40.0 : 4.0 + noise(rng);
+    aggregator.add(60, cents, i / kRate);
+  }
+  KeySummary summary;
+  ASSERT_TRUE(aggregator.get_summary(60, summary));
+  EXPECT_EQ(aggregator.last_key(), 60);
+  EXPECT_TRUE(summary.is_stable);
+  EXPECT_NEAR(summary.median, 4.0, 0.15);
+  EXPECT_NEAR(summary.lower_quartile, 4.0 - 0.2, 0.15);
+  EXPECT_NEAR(summary.upper_quartile, 4.0 + 0.2, 0.15);
+  EXPECT_LT(summary.mean, summary.median);
+  EXPECT_EQ(summary.minimum, -40.0);
+  EXPECT_NEAR(summary.drift, 0.0, 1.0);
+  EXPECT_NEAR(summary.last_time, 2.99, 1e-9);
+}
+
+TEST(MeasurementAggregatorTest, SettlingAfterRetuningStartsSegment) {
+  // 2 s at +10 cents, the pin turned down to 0 over 1 s, then held
+  MeasurementAggregator aggregator;
+  std::mt19937 rng(2);
+  std::normal_distribution<double> noise(0.0, 0.2);
+  double time = 0.0;
+  const auto hold = [&](double cents, double seconds) {
+    for (int i = 0; i < seconds * kRate; ++i, time += 1.0 / kRate) {
+      aggregator.add(69, cents + noise(rng), time);
+    }
+  };
+  hold(10.0, 2.0);
+  KeySummary summary;
+  ASSERT_TRUE(aggregator.get_summary(69, summary));
+  const int segments = summary.segments;
+
+  for (int i = 0; i < kRate; ++i, time += 1.0 / kRate) {
+    aggregator.add(69, 10.0 - 10.0 * i / kRate, time);
+  }
+  ASSERT_TRUE(aggregator.get_summary(69, summary));
+  EXPECT_FALSE(summary.is_stable);
+  EXPECT_LT(summary.drift, -5.0);
+
+  hold(0.0, 2.0);
+  ASSERT_TRUE(aggregator.get_summary(69, summary));
+  EXPECT_TRUE(summary.is_stable);
+  EXPECT_GT(summary.segments, segments);
+  EXPECT_NEAR(summary.median, 0.0, 0.2);
+  EXPECT_LT(summary.maximum, 2.0);
+}
+
+TEST(MeasurementAggregatorTest, GapStartsSegment) {
+  MeasurementAggregator aggregator;
+  for (int i = 0; i < 100; ++i) {
+    aggregator.add(48, 3.0, i / kRate);
+  }
+  KeySummary before;
+  ASSERT_TRUE(aggregator.get_summary(48, before));
+  aggregator.add(48, -3.0, 1.0 + MeasurementAggregator::kSegmentGap + 0.5);
+  KeySummary after;
+  ASSERT_TRUE(aggregator.get_summary(48, after));
+  EXPECT_EQ(after.segments, before.segments + 1);
+  EXPECT_EQ(after.count, 1u);
+  EXPECT_EQ(after.median, -3.0);
+  EXPECT_FALSE(after.is_stable);
+
+  aggregator.reset_key(48);
+  EXPECT_FALSE(aggregator.get_summary(48, after));
+}
+
+TEST(MeasurementAggregatorTest, ConvertsDetections) {
+  FrequencyCalculator calc;
+  MeasurementAggregator aggregator;
+  std::vector<DetectionEvent> events(150);
+  for (std::size_t i = 0; i < events.size(); ++i) {
+    events[i].frequency = 440.0 * std::exp2(5.0 / 1200.0);
+    events[i].confidence = 0.9;
+    events[i].time = static_cast<double>(i) / kRate;
+  }
+  events[10].frequency = 0.0;
+  EXPECT_EQ(aggregator.add_detections(events.data(), events.size(), calc),
+            events.size() - 1);
+  KeySummary summary;
+  ASSERT_TRUE(aggregator.get_summary(69, summary));
+  EXPECT_NEAR(summary.median, 5.0, 1e-3);
+}
+
+TEST(MeasurementAggregatorTest, DrainsControllerDetections) {
+  PitchDetectionController controller(4096, kSampleRate);
+  std::vector<float> samples(static_cast<std::size_t>(kSampleRate));
+  for (std::size_t i = 0; i < samples.size(); ++i) {
+    samples[i] = static_cast<float>(
+        0.5 * std::sin(2.0 * kPi * 220.0 * static_cast<double>(i) /
+                       kSampleRate));
+  }
+  for (std::size_t i = 0; i + 256 <= samples.size(); i += 256) {
+    controller.process_audio(samples.data() + i, 256);
+  }
+
+  DetectionEvent events[64];
+  std::vector<DetectionEvent> drained;
+  std::size_t n = 0;
+  while ((n = controller.drain_detections(events, 64)) > 0) {
+    drained.insert(drained.end(), events, events + n);
+  }
+  ASSERT_GT(drained.size(), 100u);
+  for (std::size_t i = 1; i < drained.size(); ++i) {
+    EXPECT_GE(drained[i].time, drained[i - 1].time);
+  }
+  EXPECT_LE(drained.back().time, 1.0);
+
+  FrequencyCalculator calc;
+  MeasurementAggregator aggregator;
+  aggregator.add_detections(drained.data(), drained.size(), calc);
+  KeySummary summary;
+  ASSERT_TRUE(aggregator.get_summary(57, summary));
+  EXPECT_TRUE(summary.is_stable);
+  EXPECT_NEAR(summary.median, 0.0, 0.5);
+}
+
+}  // namespace
+}  // namespace simple_tuner
@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "simple_tuner/algorithms/MultiPitchEstimator.h"
+
+namespace simple_tuner {
+namespace {
+
+constexpr double kSampleRate = 48000.0;
+constexpr double kPi = 3.14159265358979323846;
+
+struct Partial {
+  double frequency;
+  double amplitude;
+};
+
+// Sum of sinusoids with a common decay and a little noise
+std::vector<float> generate(const std::vector<Partial>& partials,
+                            std::size_t length, double decay = 0.0,
+                            double noise_level = 1e-4) {
+  std::mt19937 rng(21);
+  std::normal_distribution<double> noise(0.0, noise_level);
+  std::vector<float> samples(length);
+  for (std::size_t i = 0; i < length; ++i) {
+    const double t = static_cast<double>(i) / kSampleRate;
+    double value = 0.0;
+    int k = 0;
+    for (const Partial& p : partials) {
+      value += p.amplitude * std::sin(2.0 * kPi * p.frequency * t + ++k);
+    }
+    samples[i] = static_cast<float>(value * std::exp(-decay * t) + noise(rng));
+  }
+  return samples;
+}
+
+TEST(MultiPitchEstimatorTest, ResolvesThreeStringUnison) {
+  MultiPitchEstimator estimator(kSampleRate);
+  EXPECT_EQ(estimator.window_length(), 100u);
+  // Strings 0.6 and 1.4 Hz apart: inside one Rayleigh bin of the window
+  const std::vector<Partial> strings = {
+      {219.6, 0.1}, {220.2, 0.08}, {221.6, 0.05}};
+  const auto samples = generate(strings, estimator.input_length());
+  const MultiPitchResult result =
+      estimator.estimate(samples.data(), samples.size(), 220.0);
+  ASSERT_TRUE(result.is_valid);
+  ASSERT_EQ(result.count, 3);
+  for (int k = 0; k < 3; ++k) {
+    const auto& component = result.components[static_cast<std::size_t>(k)];
+    EXPECT_NEAR(component.frequency, strings[k].frequency, 0.02) << k;
+    EXPECT_NEAR(component.amplitude, strings[k].amplitude,
+                0.1 * strings[k].amplitude)
+        << k;
+  }
+}
+
+TEST(MultiPitchEstimatorTest, ResolvesDecayingPairAtOtherRates) {
+  for (double sample_rate : {44100.0, 48000.0, 96000.0}) {
+    MultiPitchEstimator estimator(sample_rate, 1.5);
+    std::vector<float> samples(estimator.input_length());
+    for (std::size_t i = 0; i < samples.size(); ++i) {
+      const double t = static_cast<double>(i) / sample_rate;
+      samples[i] = static_cast<float>(
+          std::exp(-1.5 * t) * (0.2 * std::sin(2.0 * kPi * 110.0 * t) +
+                                0.15 * std::sin(2.0 * kPi * 110.5 * t + 1)));
+    }
+    const MultiPitchResult result =
+        estimator.estimate(samples.data(), samples.size(), 110.2);
+    ASSERT_EQ(result.count, 2) << sample_rate;
+    EXPECT_NEAR(result.components[0].frequency, 110.0, 0.03) << sample_rate;
+    EXPECT_NEAR(result.components[1].frequency, 110.5, 0.03) << sample_rate;
+  }
+}
+
+TEST(MultiPitchEstimatorTest, SingleStringGivesOneComponent) {
+  MultiPitchEstimator estimator(kSampleRate);
+  const auto samples =
+      generate({{440.3, 0.2}}, estimator.input_length(), 0.5, 1e-3);
+  const MultiPitchResult result =
+      estimator.estimate(samples.data(), samples.size(), 440.0);
+  ASSERT_TRUE(result.is_valid);
+  ASSERT_EQ(result.count, 1);
+  EXPECT_NEAR(result.components[0].frequency, 440.3, 0.01);
+}
+
+TEST(MultiPitchEstimatorTest, IgnoresPartialsOutsideTheBand) {
+  MultiPitchEstimator estimator(kSampleRate);
+  // A louder partial a semitone away (26 Hz) is filtered out
+  const auto samples = generate({{440.0, 0.05}, {466.16, 0.3}},
+                                estimator.input_length());
+  const MultiPitchResult result =
+      estimator.estimate(samples.data(), samples.size(), 441.0);
+  ASSERT_TRUE(result.is_valid);
+  ASSERT_EQ(result.count, 1);
+  EXPECT_NEAR(result.components[0].frequency, 440.0, 0.02);
+}
+
+TEST(MultiPitchEstimatorTest, RejectsQuietOrMissingInput) {
+  MultiPitchEstimator estimator(kSampleRate);
+  const std::vector<float> silence(estimator.input_length(), 0.0f);
+  EXPECT_FALSE(
+      estimator.estimate(silence.data(), silence.size(), 220.0).is_valid);
+  EXPECT_FALSE(estimator.estimate(nullptr, 0, 220.0).is_valid);
+
+  const auto quiet = generate({{220.0, 2e-4}}, estimator.input_length(), 0.0,
+                              1e-7);
+  EXPECT_FALSE(
+      estimator.estimate(quiet.data(), quiet.size(), 220.0).is_valid);
+  estimator.set_threshold_db(-90.0);
+  EXPECT_TRUE(estimator.estimate(quiet.data(), quiet.size(), 220.0).is_valid);
+  EXPECT_FALSE(
+      estimator.estimate(quiet.data(), quiet.size(), 30000.0).is_valid);
+
+  // Short of a window
+  const auto tone = generate({{220.0, 0.2}}, estimator.input_length());
+  EXPECT_FALSE(
+      estimator.estimate(tone.data(), tone.size() - 1, 220.0).is_valid);
+  EXPECT_TRUE(estimator.estimate(tone.data(), tone.size(), 220.0).is_valid);
+}
+
+}  // namespace
+}  // namespace simple_tuner
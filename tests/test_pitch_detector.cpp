@@ -1,6 +1,10 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <cmath>
+#include <initializer_list>
+#include <limits>
+#include <memory>
 #include <vector>
 
 #include "simple_tuner/algorithms/PitchDetector.h"
@@ -368,5 +372,173 @@ TEST_F(PitchDetectorTest, SimpleAPIEquivalence) {
   EXPECT_EQ(simple_result, detailed_result.frequency);
 }
 
+// Capacity Tests
+
+TEST_F(PitchDetectorTest, MinFrequencyBelowCapacityIsClamped) {
+  // Lags past the preallocated NSDF capacity must never be searched
+  detector_->set_min_frequency(5.0);
+  EXPECT_DOUBLE_EQ(detector_->get_min_frequency(), 5.0);
+
+  auto samples = generate_sine(55.0, kBufferSize);
+  auto result =
+      detector_->detect_pitch_detailed(samples.data(), samples.size());
+  ASSERT_TRUE(result.is_valid);
+  EXPECT_TRUE(is_frequency_accurate(result.frequency, 55.0, kCentTolerance));
+}
+
+TEST_F(PitchDetectorTest, ReconfiguredDetectorMatchesFreshDetector) {
+  // Sized for the worst case, then shrunk at runtime without reallocating
+  PitchDetector reconfigurable(
+      48000.0, PitchDetector::capacity_for(48000.0, kBufferSize, 20.0));
+  reconfigurable.set_sample_rate(kSampleRate);
+  reconfigurable.set_buffer_length(2048);
+  reconfigurable.set_window_type(WindowType::kHann);
+  EXPECT_EQ(reconfigurable.get_buffer_length(), 2048U);
+  EXPECT_EQ(reconfigurable.capacity().max_buffer_size, kBufferSize);
+
+  PitchDetector fresh(kSampleRate, 2048);
+  fresh.set_window_type(WindowType::kHann);
+
+  auto samples = generate_sine_with_harmonics(110.0, 2048);
+  auto expected = fresh.detect_pitch_detailed(samples.data(), samples.size());
+  auto actual =
+      reconfigurable.detect_pitch_detailed(samples.data(), samples.size());
+  ASSERT_TRUE(actual.is_valid);
+  EXPECT_EQ(actual.frequency, expected.frequency);
+  EXPECT_EQ(actual.confidence, expected.confidence);
+}
+
+TEST_F(PitchDetectorTest, BufferLengthClampedToCapacity) {
+  detector_->set_buffer_length(kBufferSize * 2);
+  EXPECT_EQ(detector_->get_buffer_length(), kBufferSize);
+  detector_->set_buffer_length(0);
+  EXPECT_EQ(detector_->get_buffer_length(), 2U);
+}
+
+// Batch API Tests
+
+TEST_F(PitchDetectorTest, BatchFrameCount) {
+  EXPECT_EQ(detector_->count_frames(kBufferSize - 1, 1024), 0U);
+  EXPECT_EQ(detector_->count_frames(kBufferSize, 1024), 1U);
+  EXPECT_EQ(detector_->count_frames(kBufferSize + 2048, 1024), 3U);
+  EXPECT_EQ(detector_->count_frames(kBufferSize + 2048, 0), 0U);
+}
+
+TEST_F(PitchDetectorTest, BatchMatchesPerFrameDetection) {
+  // Each batch frame should match a standalone detailed detection
+  constexpr std::size_t kHop = 1024;
+  auto signal = generate_sine(220.0, kBufferSize + 8 * kHop);
+  const std::size_t num_frames = detector_->count_frames(signal.size(), kHop);
+
+  std::vector<double> frequency(num_frames);
+  std::vector<double> confidence(num_frames);
+  std::unique_ptr<bool[]> valid(new bool[num_frames]);
+  FrameResults results{frequency.data(), confidence.data(), valid.get()};
+
+  ASSERT_EQ(detector_->detect_frames(signal.data(), signal.size(), kHop,
+                                     results),
+            num_frames);
+
+  PitchDetector reference(kSampleRate, kBufferSize);
+  for (std::size_t i = 0; i < num_frames; ++i) {
+    auto expected = reference.detect_pitch_detailed(
+        signal.data() + i * kHop, kBufferSize);
+    EXPECT_EQ(valid[i], expected.is_valid);
+    EXPECT_EQ(frequency[i], expected.frequency);
+    EXPECT_EQ(confidence[i], expected.confidence);
+  }
+}
+
+TEST_F(PitchDetectorTest, BatchMultiThreadedMatchesSingleThreaded) {
+  constexpr std::size_t kHop = 512;
+  auto signal = generate_sine_with_harmonics(110.0, kBufferSize + 20 * kHop);
+  const std::size_t num_frames = detector_->count_frames(signal.size(), kHop);
+
+  std::vector<double> freq_single(num_frames);
+  std::vector<double> conf_single(num_frames);
+  std::unique_ptr<bool[]> valid_single(new bool[num_frames]);
+  std::vector<double> freq_multi(num_frames);
+  std::vector<double> conf_multi(num_frames);
+  std::unique_ptr<bool[]> valid_multi(new bool[num_frames]);
+
+  detector_->detect_frames(
+      signal.data(), signal.size(), kHop,
+      FrameResults{freq_single.data(), conf_single.data(), valid_single.get()});
+  detector_->detect_frames(
+      signal.data(), signal.size(), kHop,
+      FrameResults{freq_multi.data(), conf_multi.data(), valid_multi.get()}, 4);
+
+  for (std::size_t i = 0; i < num_frames; ++i) {
+    EXPECT_TRUE(valid_multi[i]);
+    EXPECT_EQ(valid_single[i], valid_multi[i]);
+    EXPECT_EQ(freq_single[i], freq_multi[i]);
+    EXPECT_EQ(conf_single[i], conf_multi[i]);
+  }
+}
+
+TEST_F(PitchDetectorTest, BatchNullOutputHandling) {
+  auto signal = generate_sine(440.0, kBufferSize);
+  std::vector<double> frequency(1);
+  FrameResults results{frequency.data(), nullptr, nullptr};
+
+  EXPECT_EQ(detector_->detect_frames(signal.data(), signal.size(), 1024,
+                                     results),
+            0U);
+}
+
+// Precision Policy Tests
+
+// Accuracy of each precision tier on the controller's three tier sizes
+template <typename Detector>
+class PitchDetectorPrecisionTest : public ::testing::Test {
+ protected:
+  static constexpr double kSampleRate = 44100.0;
+
+  // Worst-case cents error over a set of test frequencies
+  static double max_cents_error(std::size_t buffer_size,
+                                std::initializer_list<double> frequencies) {
+    Detector detector(kSampleRate, buffer_size);
+    double worst = 0.0;
+    for (double frequency : frequencies) {
+      std::vector<float> samples(buffer_size);
+      constexpr double pi = 3.14159265358979323846;
+      for (std::size_t i = 0; i < buffer_size; ++i) {
+        samples[i] = static_cast<float>(
+            std::sin(2.0 * pi * frequency * static_cast<double>(i) /
+                     kSampleRate));
+      }
+      auto result = detector.detect_pitch_detailed(samples.data(), buffer_size);
+      if (!result.is_valid) {
+        return std::numeric_limits<double>::infinity();
+      }
+      worst = std::max(
+          worst, std::abs(1200.0 * std::log2(result.frequency / frequency)));
+    }
+    return worst;
+  }
+};
+
+using PrecisionDetectors =
+    ::testing::Types<FloatPitchDetector, MixedPitchDetector, PitchDetector>;
+TYPED_TEST_SUITE(PitchDetectorPrecisionTest, PrecisionDetectors);
+
+TYPED_TEST(PitchDetectorPrecisionTest, FastTierAccuracy) {
+  // 512 samples, C4 and above
+  EXPECT_LE(TestFixture::max_cents_error(512, {261.63, 440.0, 987.77, 4186.01}),
+            1.0);
+}
+
+TYPED_TEST(PitchDetectorPrecisionTest, MediumTierAccuracy) {
+  // 1024 samples, C2 and above
+  EXPECT_LE(TestFixture::max_cents_error(1024, {65.41, 110.0, 196.0, 440.0}),
+            1.0);
+}
+
+TYPED_TEST(PitchDetectorPrecisionTest, FullTierAccuracy) {
+  // 4096 samples, C1 and above
+  EXPECT_LE(TestFixture::max_cents_error(4096, {32.70, 65.41, 220.0, 1479.98}),
+            1.0);
+}
+
 }  // namespace
 }  // namespace simple_tuner
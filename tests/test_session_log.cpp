@@ -0,0 +1,319 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "simple_tuner/session/SessionLog.h"
+#include "simple_tuner/session/SessionLogReader.h"
+#include "simple_tuner/session/SessionLogWriter.h"
+
+namespace simple_tuner {
+namespace {
+
+std::string temp_path(const char* name) {
+  return testing::TempDir() + name;
+}
+
+long file_size(const std::string& path) {
+  std::FILE* file = std::fopen(path.c_str(), "rb");
+  if (file == nullptr) {
+    return -1;
+  }
+  std::fseek(file, 0, SEEK_END);
+  const long size = std::ftell(file);
+  std::fclose(file);
+  return size;
+}
+
+// A session walking up the keyboard: 100 detections per second, one key
+// per second, with a little wobble in the cents
+std::vector<LoggedDetection> make_session(std::size_t count) {
+  std::vector<LoggedDetection> session(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    LoggedDetection& d = session[i];
+    d.time = 0.01 * static_cast<double>(i) + 1e-4 * static_cast<double>(i % 3);
+    d.midi_note = 21 + static_cast<int>((i / 100) % 88);
+    d.cents = 3.0 * std::sin(0.1 * static_cast<double>(i));
+    d.frequency =
+        440.0 * std::pow(2.0, (d.midi_note - 69 + d.cents / 100.0) / 12.0);
+    d.confidence = 0.5 + 0.5 * std::cos(0.01 * static_cast<double>(i));
+  }
+  return session;
+}
+
+bool write_session(const std::string& path,
+                   const std::vector<LoggedDetection>& session,
+                   bool delta_encode_times) {
+  auto writer = std::make_unique<SessionLogWriter>(delta_encode_times);
+  if (!writer->open(path)) {
+    return false;
+  }
+  for (const LoggedDetection& d : session) {
+    while (!writer->append(d)) {
+      writer->flush();  // Ring full: let the worker catch up
+    }
+  }
+  return writer->close();
+}
+
+void expect_same(const LoggedDetection& actual,
+                 const LoggedDetection& expected, double time_tolerance) {
+  EXPECT_NEAR(actual.time, expected.time, time_tolerance);
+  EXPECT_FLOAT_EQ(static_cast<float>(actual.frequency),
+                  static_cast<float>(expected.frequency));
+  EXPECT_FLOAT_EQ(static_cast<float>(actual.confidence),
+                  static_cast<float>(expected.confidence));
+  EXPECT_FLOAT_EQ(static_cast<float>(actual.cents),
+                  static_cast<float>(expected.cents));
+  EXPECT_EQ(actual.midi_note, expected.midi_note);
+}
+
+TEST(SessionLogTest, ChunkHeaderRoundTrips) {
+  session_log::ChunkHeader header;
+  header.type = session_log::ChunkType::kSummaries;
+  header.flags = session_log::kDeltaTimes;
+  header.count = 17;
+  header.payload_bytes = 1234;
+  header.first_time = 1.25;
+  header.last_time = 9.5;
+  header.add_key(21);
+  header.add_key(108);
+  header.add_key(200);  // Ignored
+  unsigned char bytes[session_log::kChunkHeaderBytes];
+  session_log::encode_chunk_header(header, bytes);
+
+  session_log::ChunkHeader decoded;
+  ASSERT_TRUE(session_log::decode_chunk_header(bytes, decoded));
+  EXPECT_EQ(decoded.type, header.type);
+  EXPECT_EQ(decoded.flags, header.flags);
+  EXPECT_EQ(decoded.count, header.count);
+  EXPECT_EQ(decoded.payload_bytes, header.payload_bytes);
+  EXPECT_EQ(decoded.first_time, header.first_time);
+  EXPECT_EQ(decoded.last_time, header.last_time);
+  EXPECT_TRUE(decoded.has_key(21));
+  EXPECT_TRUE(decoded.has_key(108));
+  EXPECT_TRUE(decoded.has_key(0));
+  EXPECT_FALSE(decoded.has_key(60));
+
+  bytes[0] ^= 0xFF;
+  EXPECT_FALSE(session_log::decode_chunk_header(bytes, decoded));
+}
+
+TEST(SessionLogTest, RoundTripsDetections) {
+  const std::string path = temp_path("session_delta.stlog");
+  const auto session = make_session(10000);
+  ASSERT_TRUE(write_session(path, session, true));
+
+  SessionLogReader reader;
+  ASSERT_TRUE(reader.open(path));
+  EXPECT_FALSE(reader.recovered());
+  EXPECT_EQ(reader.detection_count(), session.size());
+  EXPECT_GE(reader.num_chunks(), 3u);
+
+  std::vector<LoggedDetection> all;
+  ASSERT_TRUE(reader.read_detections(-1.0, 1e9, 0, all));
+  ASSERT_EQ(all.size(), session.size());
+  for (std::size_t i = 0; i < session.size(); ++i) {
+    expect_same(all[i], session[i], 1e-6);
+  }
+  std::remove(path.c_str());
+}
+
+TEST(SessionLogTest, DeltaTimesShrinkTheLog) {
+  const std::string delta_path = temp_path("session_small.stlog");
+  const std::string raw_path = temp_path("session_raw.stlog");
+  const auto session = make_session(8192);
+  ASSERT_TRUE(write_session(delta_path, session, true));
+  ASSERT_TRUE(write_session(raw_path, session, false));
+
+  // 13 bytes of columns per detection plus 3 (delta) or 8 (raw) of time
+  const long delta_size = file_size(delta_path);
+  const long raw_size = file_size(raw_path);
+  EXPECT_LT(delta_size, 17 * 8192);
+  EXPECT_GT(raw_size, delta_size + 4 * 8192);
+
+  // Raw times come back bit for bit
+  SessionLogReader reader;
+  ASSERT_TRUE(reader.open(raw_path));
+  std::vector<LoggedDetection> all;
+  ASSERT_TRUE(reader.read_detections(-1.0, 1e9, 0, all));
+  ASSERT_EQ(all.size(), session.size());
+  for (std::size_t i = 0; i < session.size(); ++i) {
+    EXPECT_EQ(all[i].time, session[i].time);
+  }
+  std::remove(delta_path.c_str());
+  std::remove(raw_path.c_str());
+}
+
+TEST(SessionLogTest, FiltersByKeyAndTime) {
+  const std::string path = temp_path("session_filter.stlog");
+  const auto session = make_session(20000);
+  ASSERT_TRUE(write_session(path, session, true));
+
+  SessionLogReader reader;
+  ASSERT_TRUE(reader.open(path));
+  for (int midi_note : {0, 21, 60, 108}) {
+    std::vector<LoggedDetection> expected;
+    for (const LoggedDetection& d : session) {
+      if (d.time >= 50.0 && d.time < 150.0 &&
+          (midi_note == 0 || d.midi_note == midi_note)) {
+        expected.push_back(d);
+      }
+    }
+    std::vector<LoggedDetection> found;
+    ASSERT_TRUE(reader.read_detections(50.0, 150.0, midi_note, found));
+    ASSERT_EQ(found.size(), expected.size()) << midi_note;
+    for (std::size_t i = 0; i < found.size(); ++i) {
+      expect_same(found[i], expected[i], 1e-6);
+    }
+  }
+
+  // A key that was never played
+  std::vector<LoggedDetection> none;
+  ASSERT_TRUE(reader.read_detections(0.0, 1e9, 20, none));
+  EXPECT_TRUE(none.empty());
+  std::remove(path.c_str());
+}
+
+TEST(SessionLogTest, RoundTripsSummaries) {
+  const std::string path = temp_path("session_summaries.stlog");
+  auto writer = std::make_unique<SessionLogWriter>();
+  ASSERT_TRUE(writer->open(path));
+  std::vector<LoggedSummary> summaries;
+  for (int i = 0; i < 300; ++i) {
+    LoggedSummary s;
+    s.time = 0.5 * i;
+    s.summary.midi_note = 40 + i % 3;
+    s.summary.segments = i / 3;
+    s.summary.count = static_cast<std::size_t>(10 * i);
+    s.summary.median = 0.1 * i;
+    s.summary.lower_quartile = s.summary.median - 1.0;
+    s.summary.upper_quartile = s.summary.median + 1.0;
+    s.summary.drift = -0.25;
+    s.summary.last_time = s.time;
+    s.summary.is_stable = i % 2 == 0;
+    summaries.push_back(s);
+    ASSERT_TRUE(writer->append(s));
+    if (i == 200) {
+      ASSERT_TRUE(writer->flush());
+    }
+  }
+  ASSERT_TRUE(writer->close());
+
+  SessionLogReader reader;
+  ASSERT_TRUE(reader.open(path));
+  EXPECT_EQ(reader.summary_count(), summaries.size());
+  EXPECT_EQ(reader.detection_count(), 0u);
+  std::vector<LoggedSummary> found;
+  ASSERT_TRUE(reader.read_summaries(41, found));
+  ASSERT_EQ(found.size(), 100u);
+  for (std::size_t i = 0; i < found.size(); ++i) {
+    const LoggedSummary& expected = summaries[3 * i + 1];
+    EXPECT_EQ(found[i].time, expected.time);
+    EXPECT_EQ(found[i].summary.midi_note, 41);
+    EXPECT_EQ(found[i].summary.segments, expected.summary.segments);
+    EXPECT_EQ(found[i].summary.count, expected.summary.count);
+    EXPECT_EQ(found[i].summary.median, expected.summary.median);
+    EXPECT_EQ(found[i].summary.upper_quartile,
+              expected.summary.upper_quartile);
+    EXPECT_EQ(found[i].summary.drift, expected.summary.drift);
+    EXPECT_EQ(found[i].summary.last_time, expected.summary.last_time);
+    EXPECT_EQ(found[i].summary.is_stable, expected.summary.is_stable);
+  }
+  std::remove(path.c_str());
+}
+
+TEST(SessionLogTest, RecoversLogWithoutIndex) {
+  const std::string path = temp_path("session_open.stlog");
+  const auto session = make_session(5000);
+  auto writer = std::make_unique<SessionLogWriter>();
+  ASSERT_TRUE(writer->open(path));
+  for (const LoggedDetection& d : session) {
+    ASSERT_TRUE(writer->append(d) || writer->flush());
+  }
+  ASSERT_TRUE(writer->flush());
+
+  // The writer is still open: no index yet
+  {
+    SessionLogReader reader;
+    ASSERT_TRUE(reader.open(path));
+    EXPECT_TRUE(reader.recovered());
+    EXPECT_EQ(reader.detection_count() + writer->dropped(), session.size());
+  }
+
+  // A torn final chunk is left out, the ones before it survive
+  const long size = file_size(path);
+  std::vector<unsigned char> bytes(static_cast<std::size_t>(size));
+  std::FILE* file = std::fopen(path.c_str(), "rb");
+  ASSERT_NE(file, nullptr);
+  ASSERT_EQ(std::fread(bytes.data(), 1, bytes.size(), file), bytes.size());
+  std::fclose(file);
+  ASSERT_TRUE(writer->close());
+
+  const std::string torn_path = temp_path("session_torn.stlog");
+  file = std::fopen(torn_path.c_str(), "wb");
+  ASSERT_NE(file, nullptr);
+  std::fwrite(bytes.data(), 1, bytes.size() - 10, file);
+  std::fclose(file);
+
+  SessionLogReader reader;
+  ASSERT_TRUE(reader.open(torn_path));
+  EXPECT_TRUE(reader.recovered());
+  EXPECT_LT(reader.detection_count(), session.size());
+  std::vector<LoggedDetection> found;
+  ASSERT_TRUE(reader.read_detections(-1.0, 1e9, 0, found));
+  EXPECT_EQ(found.size(), reader.detection_count());
+  for (std::size_t i = 0; i < found.size(); ++i) {
+    EXPECT_EQ(found[i].midi_note, session[i].midi_note);
+  }
+  std::remove(path.c_str());
+  std::remove(torn_path.c_str());
+}
+
+TEST(SessionLogTest, RejectsOtherFiles) {
+  SessionLogReader reader;
+  EXPECT_FALSE(reader.open(temp_path("no_such_session.stlog")));
+
+  const std::string path = temp_path("not_a_session.stlog");
+  std::FILE* file = std::fopen(path.c_str(), "wb");
+  ASSERT_NE(file, nullptr);
+  const char text[] = "definitely not a session log, just some text";
+  std::fwrite(text, 1, sizeof(text), file);
+  std::fclose(file);
+  EXPECT_FALSE(reader.open(path));
+  EXPECT_FALSE(reader.is_open());
+  std::remove(path.c_str());
+}
+
+TEST(SessionLogTest, WriterCountsDroppedRecords) {
+  auto writer = std::make_unique<SessionLogWriter>();
+  EXPECT_FALSE(writer->append(LoggedDetection()));  // Not open
+  EXPECT_FALSE(writer->flush());
+
+  const std::string path = temp_path("session_burst.stlog");
+  ASSERT_TRUE(writer->open(path));
+  EXPECT_TRUE(writer->is_open());
+  EXPECT_FALSE(writer->open(path));
+
+  // A burst far beyond the ring: whatever the worker does not drain in
+  // time is dropped, never blocked on
+  const auto session = make_session(50000);
+  std::size_t accepted = 0;
+  for (const LoggedDetection& d : session) {
+    accepted += writer->append(d) ? 1 : 0;
+  }
+  ASSERT_TRUE(writer->close());
+  EXPECT_FALSE(writer->is_open());
+  EXPECT_EQ(accepted + writer->dropped(), session.size());
+
+  SessionLogReader reader;
+  ASSERT_TRUE(reader.open(path));
+  EXPECT_EQ(reader.detection_count(), accepted);
+  std::remove(path.c_str());
+}
+
+}  // namespace
+}  // namespace simple_tuner
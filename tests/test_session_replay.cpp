@@ -0,0 +1,197 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "simple_tuner/controllers/PitchDetectionController.h"
+#include "simple_tuner/session/SessionRecorder.h"
+#include "simple_tuner/session/SessionReplay.h"
+
+namespace simple_tuner {
+namespace {
+
+constexpr double kSampleRate = 48000.0;
+constexpr std::size_t kBufferSize = 4096;
+constexpr double kPi = 3.14159265358979323846;
+
+std::string temp_path(const char* name) {
+  return testing::TempDir() + name;
+}
+
+// Three notes of a few harmonics each, a little noise, and silence
+// between them
+std::vector<float> make_performance() {
+  const double notes[] = {220.0, 329.63, 110.0};
+  const std::size_t note_length = static_cast<std::size_t>(kSampleRate);
+  const std::size_t pause = static_cast<std::size_t>(0.2 * kSampleRate);
+  std::vector<float> audio;
+  std::mt19937 rng(5);
+  std::normal_distribution<float> noise(0.0f, 0.002f);
+  for (double frequency : notes) {
+    for (std::size_t i = 0; i < note_length; ++i) {
+      const double t = static_cast<double>(i) / kSampleRate;
+      double sample = 0.0;
+      for (int h = 1; h <= 4; ++h) {
+        sample += std::sin(2.0 * kPi * frequency * h * t) / h;
+      }
+      audio.push_back(static_cast<float>(0.3 * sample * std::exp(-t)) +
+                      noise(rng));
+    }
+    for (std::size_t i = 0; i < pause; ++i) {
+      audio.push_back(noise(rng));
+    }
+  }
+  return audio;
+}
+
+// Feeds audio in callback-sized blocks of varying length, changing
+// settings along the way; returns the number of blocks
+std::size_t perform(PitchDetectionController& controller,
+                    const std::vector<float>& audio) {
+  std::mt19937 rng(11);
+  std::uniform_int_distribution<std::size_t> block_size(64, 700);
+  std::size_t position = 0;
+  std::size_t blocks = 0;
+  while (position < audio.size()) {
+    const std::size_t n = std::min(block_size(rng), audio.size() - position);
+    if (blocks == 100) {
+      controller.set_beat_frequency(660.0);
+    } else if (blocks == 150) {
+      controller.set_confidence_threshold(0.6);
+    } else if (blocks == 200) {
+      controller.set_frequency_range(60.0, 2000.0);
+    } else if (blocks == 250) {
+      controller.set_full_tier_method(FullTierMethod::kHarmonicSum);
+    } else if (blocks == 300) {
+      controller.set_target_frequency(110.0);
+    }
+    controller.process_audio(audio.data() + position, n);
+    position += n;
+    ++blocks;
+  }
+  return blocks;
+}
+
+TEST(SessionReplayTest, ReplaysRecordingExactly) {
+  const std::string path = temp_path("replay_exact.strec");
+  const auto audio = make_performance();
+  std::size_t blocks = 0;
+  {
+    auto controller =
+        std::make_unique<PitchDetectionController>(kBufferSize, kSampleRate);
+    auto recorder = std::make_unique<SessionRecorder>();
+    ASSERT_TRUE(recorder->start(path, kSampleRate, kBufferSize));
+    controller->set_recorder(recorder.get());
+    blocks = perform(*controller, audio);
+    controller->set_recorder(nullptr);
+    ASSERT_TRUE(recorder->stop());
+    EXPECT_EQ(recorder->dropped_blocks(), 0u);
+    EXPECT_EQ(recorder->dropped_events(), 0u);
+  }
+
+  SessionReplay replay;
+  ASSERT_TRUE(replay.open(path));
+  EXPECT_EQ(replay.info().sample_rate, kSampleRate);
+  EXPECT_EQ(replay.info().buffer_size, kBufferSize);
+  EXPECT_EQ(replay.num_blocks(), blocks);
+
+  const ReplayReport report = replay.run();
+  EXPECT_TRUE(report.is_valid);
+  EXPECT_TRUE(report.cold_start);
+  EXPECT_EQ(report.blocks, blocks);
+  EXPECT_EQ(report.samples, audio.size());
+  EXPECT_EQ(report.gaps, 0u);
+  EXPECT_GT(report.recorded_results, 100u);
+  EXPECT_GT(report.replayed_results, 100u);
+  EXPECT_EQ(report.mismatches, 0u) << report.first_mismatch_block;
+  EXPECT_EQ(report.max_frequency_error, 0.0);
+  EXPECT_TRUE(report.matches());
+  EXPECT_GT(report.process_seconds, 0.0);
+  EXPECT_GE(report.process_seconds, report.worst_block_seconds);
+  std::remove(path.c_str());
+}
+
+TEST(SessionReplayTest, ReportsChangedBehaviour) {
+  const std::string path = temp_path("replay_changed.strec");
+  const auto audio = make_performance();
+  {
+    auto controller =
+        std::make_unique<PitchDetectionController>(kBufferSize, kSampleRate);
+    auto recorder = std::make_unique<SessionRecorder>();
+    ASSERT_TRUE(recorder->start(path, kSampleRate, kBufferSize));
+    controller->set_recorder(recorder.get());
+    perform(*controller, audio);
+    controller->set_recorder(nullptr);
+    ASSERT_TRUE(recorder->stop());
+  }
+
+  SessionReplay replay;
+  ASSERT_TRUE(replay.open(path));
+  // A controller with a smaller full tier detects differently
+  auto different =
+      std::make_unique<PitchDetectionController>(2048, kSampleRate);
+  const ReplayReport report = replay.run(*different);
+  EXPECT_TRUE(report.is_valid);
+  EXPECT_GT(report.mismatches, 0u);
+  EXPECT_GE(report.first_mismatch_block, 0);
+  EXPECT_FALSE(report.matches());
+
+  // Within a loose enough tolerance the pairs that line up agree
+  replay.set_tolerance(1e9, 1.0);
+  auto another =
+      std::make_unique<PitchDetectionController>(2048, kSampleRate);
+  const ReplayReport loose = replay.run(*another);
+  EXPECT_LE(loose.mismatches, report.mismatches);
+  std::remove(path.c_str());
+}
+
+TEST(SessionReplayTest, IdleRecorderRecordsNothing) {
+  auto controller =
+      std::make_unique<PitchDetectionController>(kBufferSize, kSampleRate);
+  auto recorder = std::make_unique<SessionRecorder>();
+  controller->set_recorder(recorder.get());
+  std::vector<float> silence(256, 0.0f);
+  controller->process_audio(silence.data(), silence.size());
+  EXPECT_FALSE(recorder->is_recording());
+  EXPECT_FALSE(recorder->stop());
+  EXPECT_FALSE(recorder->start(temp_path("replay_bad.strec"), 0.0, 4096));
+  EXPECT_FALSE(recorder->is_recording());
+
+  SessionReplay replay;
+  EXPECT_FALSE(replay.open(temp_path("no_such_recording.strec")));
+  EXPECT_FALSE(replay.run().is_valid);
+}
+
+TEST(SessionReplayTest, RecordingStartedMidStreamIsNotCold) {
+  const std::string path = temp_path("replay_warm.strec");
+  const auto audio = make_performance();
+  auto controller =
+      std::make_unique<PitchDetectionController>(kBufferSize, kSampleRate);
+  const std::size_t lead_in = 48000;
+  controller->process_audio(audio.data(), lead_in);
+
+  auto recorder = std::make_unique<SessionRecorder>();
+  ASSERT_TRUE(recorder->start(path, kSampleRate, kBufferSize));
+  controller->set_recorder(recorder.get());
+  for (std::size_t i = lead_in; i + 256 <= audio.size(); i += 256) {
+    controller->process_audio(audio.data() + i, 256);
+  }
+  controller->set_recorder(nullptr);
+  ASSERT_TRUE(recorder->stop());
+
+  SessionReplay replay;
+  ASSERT_TRUE(replay.open(path));
+  const ReplayReport report = replay.run();
+  EXPECT_TRUE(report.is_valid);
+  EXPECT_FALSE(report.cold_start);
+  EXPECT_EQ(report.blocks, (audio.size() - lead_in) / 256);
+  std::remove(path.c_str());
+}
+
+}  // namespace
+}  // namespace simple_tuner
@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <thread>
+
+#include "simple_tuner/memory/SpscQueue.h"
+
+namespace simple_tuner {
+namespace {
+
+TEST(SpscQueueTest, PopsInPushOrder) {
+  SpscQueue<int, 8> queue;
+  EXPECT_TRUE(queue.empty());
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_TRUE(queue.try_push(i));
+  }
+  EXPECT_EQ(queue.size(), 5u);
+  for (int i = 0; i < 5; ++i) {
+    int value = -1;
+    ASSERT_TRUE(queue.try_pop(value));
+    EXPECT_EQ(value, i);
+  }
+  int value = -1;
+  EXPECT_FALSE(queue.try_pop(value));
+}
+
+TEST(SpscQueueTest, RejectsPushWhenFull) {
+  SpscQueue<int, 4> queue;
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_TRUE(queue.try_push(i));
+  }
+  EXPECT_FALSE(queue.try_push(99));
+  EXPECT_EQ(queue.size(), 4u);
+}
+
+TEST(SpscQueueTest, BulkOperationsWrapAround) {
+  SpscQueue<int, 8> queue;
+  const int first[] = {1, 2, 3, 4, 5, 6};
+  EXPECT_EQ(queue.push(first, 6), 6u);
+  int out[8] = {};
+  EXPECT_EQ(queue.pop(out, 4), 4u);
+
+  // Six more only partly fit: 2 left + 6 = 8
+  const int second[] = {7, 8, 9, 10, 11, 12, 13};
+  EXPECT_EQ(queue.push(second, 7), 6u);
+  EXPECT_EQ(queue.pop(out, 8), 8u);
+  const int expected[] = {5, 6, 7, 8, 9, 10, 11, 12};
+  for (int i = 0; i < 8; ++i) {
+    EXPECT_EQ(out[i], expected[i]);
+  }
+}
+
+TEST(SpscQueueTest, FrontPeeksAndDiscardRemoves) {
+  SpscQueue<int, 4> queue;
+  EXPECT_EQ(queue.front(), nullptr);
+  queue.try_push(7);
+  queue.try_push(8);
+  ASSERT_NE(queue.front(), nullptr);
+  EXPECT_EQ(*queue.front(), 7);
+  queue.discard();
+  EXPECT_EQ(*queue.front(), 8);
+  queue.discard();
+  queue.discard();  // No-op when empty
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(SpscQueueTest, TransfersInOrderAcrossThreads) {
+  constexpr std::uint32_t kCount = 20000;
+  SpscQueue<std::uint32_t, 64> queue;
+
+  std::thread producer([&queue]() {
+    for (std::uint32_t i = 0; i < kCount;) {
+      if (queue.try_push(i)) {
+        ++i;
+      } else {
+        std::this_thread::yield();  // Full: let the consumer run
+      }
+    }
+  });
+
+  std::uint32_t expected = 0;
+  bool in_order = true;
+  while (expected < kCount) {
+    std::uint32_t batch[16];
+    const std::size_t n = queue.pop(batch, 16);
+    if (n == 0) {
+      std::this_thread::yield();  // Empty: let the producer run
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+      in_order = in_order && batch[i] == expected;
+      ++expected;
+    }
+  }
+  producer.join();
+  EXPECT_TRUE(in_order);
+  EXPECT_TRUE(queue.empty());
+}
+
+}  // namespace
+}  // namespace simple_tuner
@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include "simple_tuner/algorithms/FrequencyCalculator.h"
+#include "simple_tuner/algorithms/StretchSolver.h"
+
+namespace simple_tuner {
+namespace {
+
+constexpr std::size_t kA4 =
+    StretchSolver::kReferenceKey - TuningTable::kFirstKey;
+
+// Piano-like B: lowest around F2, rising toward both ends
+double typical_inharmonicity(int midi_note) {
+  return 1.5e-4 * std::exp(0.045 * std::max(45 - midi_note, 0) +
+                           0.075 * std::max(midi_note - 45, 0));
+}
+
+void measure_every_fourth_key(StretchSolver& solver) {
+  for (int key = TuningTable::kFirstKey; key <= TuningTable::kLastKey;
+       key += 4) {
+    solver.set_inharmonicity(key, typical_inharmonicity(key));
+  }
+}
+
+// Cents from partial 1 of one key to partial n
+double partial_cents(int n, double inharmonicity) {
+  return 1200.0 * std::log2(n * std::sqrt((1.0 + inharmonicity * n * n) /
+                                          (1.0 + inharmonicity)));
+}
+
+TEST(StretchSolverTest, RequiresMeasuredKeys) {
+  StretchSolver solver;
+  EXPECT_FALSE(solver.solve().is_valid);
+  solver.set_inharmonicity(60, 3e-4);
+  solver.set_inharmonicity(200, 3e-4);
+  solver.set_inharmonicity(62, -1.0);
+  EXPECT_EQ(solver.measured_keys(), 1);
+  EXPECT_FALSE(solver.solve().is_valid);
+  solver.set_inharmonicity(72, 4e-4);
+  EXPECT_TRUE(solver.solve().is_valid);
+  solver.clear();
+  EXPECT_EQ(solver.measured_keys(), 0);
+}
+
+TEST(StretchSolverTest, HarmonicStringsNeedNoStretch) {
+  // Without inharmonicity, pure octaves and double octaves are beatless
+  StretchSolver solver;
+  solver.set_interval_weights(1.0, 0.0, 0.5);
+  solver.set_inharmonicity(30, 0.0);
+  solver.set_inharmonicity(90, 0.0);
+  const StretchCurve curve = solver.solve();
+  ASSERT_TRUE(curve.is_valid);
+  for (double cents : curve.cents) {
+    EXPECT_NEAR(cents, 0.0, 0.05);
+  }
+}
+
+TEST(StretchSolverTest, StretchesInharmonicPiano) {
+  StretchSolver solver;
+  measure_every_fourth_key(solver);
+  const StretchCurve curve = solver.solve();
+  ASSERT_TRUE(curve.is_valid);
+  EXPECT_EQ(curve.cents[kA4], 0.0);
+  EXPECT_LT(curve.cents.front(), -3.0);
+  EXPECT_GT(curve.cents.back(), 15.0);
+  // Octaves are never narrower than the equal-tempered octave
+  for (std::size_t k = 0; k + 12 < curve.cents.size(); ++k) {
+    EXPECT_GT(curve.cents[k + 12], curve.cents[k] - 0.1) << k;
+  }
+
+  // A4-A5 lies between the 2:1 and 8:4 octaves of these strings
+  const double b4 = typical_inharmonicity(69);
+  const double b5 = typical_inharmonicity(81);
+  const double octave = 1200.0 + curve.cents[kA4 + 12] - curve.cents[kA4];
+  EXPECT_GT(octave, partial_cents(2, b4) - 0.1);
+  EXPECT_LT(octave,
+            partial_cents(8, b4) - partial_cents(4, b5) + 0.1);
+}
+
+TEST(StretchSolverTest, ThreadCountDoesNotChangeCurve) {
+  StretchSolver solver;
+  measure_every_fourth_key(solver);
+  solver.set_num_threads(1);
+  const StretchCurve single = solver.solve();
+  solver.set_num_threads(4);
+  const StretchCurve parallel = solver.solve();
+  ASSERT_TRUE(single.is_valid);
+  EXPECT_EQ(single.cents, parallel.cents);
+  EXPECT_EQ(single.roughness, parallel.roughness);
+}
+
+TEST(StretchSolverTest, UsesMeasuredPartials) {
+  // Partials located by the estimator stand in for the B model: a key
+  // whose measured partials match B gives the same curve as B alone
+  StretchSolver from_b;
+  StretchSolver from_partials;
+  measure_every_fourth_key(from_b);
+  measure_every_fourth_key(from_partials);
+  InharmonicityResult result;
+  result.inharmonicity = typical_inharmonicity(57);
+  result.fundamental = 220.0;
+  result.num_partials = 8;
+  for (int n = 1; n <= 8; ++n) {
+    result.partials[static_cast<std::size_t>(n - 1)] =
+        220.0 * std::exp2(partial_cents(n, result.inharmonicity) / 1200.0);
+  }
+  result.is_valid = true;
+  from_partials.set_measurement(57, result);
+  const StretchCurve expected = from_b.solve();
+  const StretchCurve actual = from_partials.solve();
+  for (std::size_t k = 0; k < expected.cents.size(); ++k) {
+    EXPECT_NEAR(actual.cents[k], expected.cents[k], 1e-6) << k;
+  }
+}
+
+TEST(StretchSolverTest, FeedsTuningTable) {
+  StretchSolver solver;
+  measure_every_fourth_key(solver);
+  const StretchCurve curve = solver.solve();
+  ASSERT_TRUE(curve.is_valid);
+  FrequencyCalculator calc;
+  calc.tuning_table().set_stretch_curve(curve.cents);
+  EXPECT_DOUBLE_EQ(calc.midi_to_frequency(69), 440.0);
+  EXPECT_GT(calc.midi_to_frequency(108), 4186.01);
+  EXPECT_NEAR(calc.calculate_cents(calc.midi_to_frequency(21), 21), 0.0,
+              1e-3);
+}
+
+}  // namespace
+}  // namespace simple_tuner
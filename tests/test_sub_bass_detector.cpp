@@ -0,0 +1,181 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include "simple_tuner/algorithms/SubBassDetector.h"
+#include "simple_tuner/controllers/PitchDetectionController.h"
+
+namespace simple_tuner {
+namespace {
+
+constexpr double kSampleRate = 48000.0;
+constexpr double kPi = 3.14159265358979323846;
+
+double cents_between(double frequency, double reference) {
+  return 1200.0 * std::log2(frequency / reference);
+}
+
+// Harmonic tone; amplitudes[0] is the fundamental
+std::vector<float> generate_tone(double frequency,
+                                 const std::vector<double>& amplitudes,
+                                 std::size_t num_samples) {
+  std::vector<float> samples(num_samples);
+  for (std::size_t i = 0; i < num_samples; ++i) {
+    double value = 0.0;
+    for (std::size_t n = 0; n < amplitudes.size(); ++n) {
+      value += amplitudes[n] * std::sin(2.0 * kPi * frequency * (n + 1.0) *
+                                        static_cast<double>(i) / kSampleRate);
+    }
+    samples[i] = static_cast<float>(0.3 * value);
+  }
+  return samples;
+}
+
+// Piano-bass-like spectrum: fundamental 26 dB below the second partial
+std::vector<double> weak_fundamental_spectrum() {
+  std::vector<double> amplitudes = {0.05};
+  for (int n = 2; n <= 12; ++n) {
+    amplitudes.push_back(1.0 / std::sqrt(static_cast<double>(n)));
+  }
+  return amplitudes;
+}
+
+TEST(SubBassDetectorTest, DecimatesToAboutFourKilohertz) {
+  SubBassDetector detector(kSampleRate);
+  EXPECT_EQ(detector.decimation_factor(), 12);
+  EXPECT_DOUBLE_EQ(detector.decimated_rate(), 4000.0);
+  EXPECT_GT(detector.window_span(), 4096u);  // Longer than the full tier
+  EXPECT_EQ(SubBassDetector(44100.0).decimation_factor(), 11);
+}
+
+TEST(SubBassDetectorTest, DetectsA0Sine) {
+  SubBassDetector detector(kSampleRate);
+  const auto samples =
+      generate_tone(27.5, {1.0}, detector.window_span() + 1024);
+  const DetectionResult result =
+      detector.detect_pitch_detailed(samples.data(), samples.size());
+  ASSERT_TRUE(result.is_valid);
+  EXPECT_NEAR(cents_between(result.frequency, 27.5), 0.0, 1.0);
+  EXPECT_GT(result.confidence, 0.9);
+}
+
+TEST(SubBassDetectorTest, WeakFundamentalIsNotReadAnOctaveUp) {
+  for (double frequency : {27.5, 29.135, 30.868}) {
+    SubBassDetector detector(kSampleRate);
+    const auto samples = generate_tone(frequency, weak_fundamental_spectrum(),
+                                       detector.window_span() + 1024);
+    const DetectionResult result =
+        detector.detect_pitch_detailed(samples.data(), samples.size());
+    ASSERT_TRUE(result.is_valid) << frequency;
+    EXPECT_NEAR(cents_between(result.frequency, frequency), 0.0, 2.0)
+        << frequency;
+  }
+}
+
+TEST(SubBassDetectorTest, HigherNoteIsNotReadAnOctaveDown) {
+  SubBassDetector detector(kSampleRate);
+  const auto samples = generate_tone(
+      58.27, {1.0, 0.5, 0.3, 0.2}, detector.window_span() + 1024);
+  const DetectionResult result =
+      detector.detect_pitch_detailed(samples.data(), samples.size());
+  ASSERT_TRUE(result.is_valid);
+  EXPECT_NEAR(cents_between(result.frequency, 58.27), 0.0, 2.0);
+}
+
+TEST(SubBassDetectorTest, StreamingMatchesStandaloneFrame) {
+  SubBassDetector streaming(kSampleRate);
+  SubBassDetector standalone(kSampleRate);
+  const auto samples = generate_tone(28.0, weak_fundamental_spectrum(),
+                                     streaming.window_span() + 2048);
+
+  EXPECT_FALSE(streaming.detect().is_valid);  // History not yet filled
+  for (std::size_t i = 0; i < samples.size(); i += 256) {
+    streaming.push_samples(samples.data() + i,
+                           std::min<std::size_t>(256, samples.size() - i));
+  }
+  const DetectionResult streamed = streaming.detect();
+  const DetectionResult framed =
+      standalone.detect_pitch_detailed(samples.data(), samples.size());
+  ASSERT_TRUE(streamed.is_valid);
+  EXPECT_DOUBLE_EQ(streamed.frequency, framed.frequency);
+}
+
+TEST(SubBassDetectorTest, RejectsSilenceAndOutOfRangeInput) {
+  SubBassDetector detector(kSampleRate);
+  std::vector<float> silence(detector.window_span() + 1024, 0.0f);
+  EXPECT_FALSE(
+      detector.detect_pitch_detailed(silence.data(), silence.size()).is_valid);
+
+  // A frame too short for the window
+  const auto short_frame = generate_tone(27.5, {1.0}, 2048);
+  EXPECT_FALSE(detector.detect_pitch_detailed(short_frame.data(),
+                                              short_frame.size())
+                   .is_valid);
+
+  // Minimum frequency above the tone
+  detector.set_min_frequency(40.0);
+  const auto samples =
+      generate_tone(27.5, {1.0}, detector.window_span() + 1024);
+  EXPECT_FALSE(
+      detector.detect_pitch_detailed(samples.data(), samples.size()).is_valid);
+}
+
+TEST(SubBassDetectorTest, ArenaBackedDetectorUsesReportedBytes) {
+  const std::size_t bytes = SubBassDetector::arena_bytes(kSampleRate);
+  BufferArena arena(bytes);
+  SubBassDetector detector(kSampleRate, arena);
+  EXPECT_EQ(arena.used(), bytes);
+}
+
+TEST(SubBassDetectorTest, ControllerReportsA0WithWeakFundamental) {
+  PitchDetectionController controller(4096, kSampleRate);
+  const auto samples =
+      generate_tone(27.5, weak_fundamental_spectrum(), 16384);
+  for (std::size_t i = 0; i < samples.size(); i += 256) {
+    controller.process_audio(samples.data() + i, 256);
+  }
+
+  double frequency = 0.0;
+  double confidence = 0.0;
+  ASSERT_TRUE(controller.get_latest_result(frequency, confidence));
+  EXPECT_NEAR(cents_between(frequency, 27.5), 0.0, 2.0);
+}
+
+TEST(SubBassDetectorTest, ControllerKeepsHigherBassNotes) {
+  PitchDetectionController controller(4096, kSampleRate);
+  const auto samples = generate_tone(55.0, {1.0, 0.5, 0.3}, 16384);
+  for (std::size_t i = 0; i < samples.size(); i += 256) {
+    controller.process_audio(samples.data() + i, 256);
+  }
+
+  double frequency = 0.0;
+  double confidence = 0.0;
+  ASSERT_TRUE(controller.get_latest_result(frequency, confidence));
+  EXPECT_NEAR(cents_between(frequency, 55.0), 0.0, 0.5);
+}
+
+TEST(SubBassDetectorTest, ControllerReadsLowestKeysPureAndHarmonic) {
+  // The short tiers hold less than a period of these; they must not
+  // report a confident reading of their own
+  const std::vector<std::vector<double>> spectra = {{1.0}, {1.0, 0.5, 0.3}};
+  for (double f0 : {27.5, 30.87, 36.71}) {  // A0, B0, D1
+    for (const auto& spectrum : spectra) {
+      PitchDetectionController controller(4096, kSampleRate);
+      const auto samples = generate_tone(f0, spectrum, 24064);
+      for (std::size_t i = 0; i < samples.size(); i += 256) {
+        controller.process_audio(samples.data() + i, 256);
+      }
+
+      double frequency = 0.0;
+      double confidence = 0.0;
+      ASSERT_TRUE(controller.get_latest_result(frequency, confidence))
+          << f0 << " Hz, " << spectrum.size() << " partials";
+      EXPECT_NEAR(cents_between(frequency, f0), 0.0, 0.5)
+          << f0 << " Hz, " << spectrum.size() << " partials";
+    }
+  }
+}
+
+}  // namespace
+}  // namespace simple_tuner
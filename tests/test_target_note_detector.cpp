@@ -0,0 +1,167 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "simple_tuner/algorithms/FrequencyCalculator.h"
+#include "simple_tuner/algorithms/TargetNoteDetector.h"
+#include "simple_tuner/controllers/PitchDetectionController.h"
+
+namespace simple_tuner {
+namespace {
+
+constexpr double kSampleRate = 48000.0;
+constexpr std::size_t kBufferSize = 4096;
+constexpr double kPi = 3.14159265358979323846;
+
+double cents_between(double frequency, double reference) {
+  return 1200.0 * std::log2(frequency / reference);
+}
+
+// Stiff-string tone: partial n at n * f0 * sqrt((1 + B n^2) / (1 + B)),
+// amplitude 1 / n
+std::vector<float> generate_string(double f0, double inharmonicity,
+                                   int partials, std::size_t num_samples) {
+  std::vector<float> samples(num_samples);
+  for (std::size_t i = 0; i < num_samples; ++i) {
+    double value = 0.0;
+    for (int n = 1; n <= partials; ++n) {
+      const double stretch = std::sqrt((1.0 + inharmonicity * n * n) /
+                                       (1.0 + inharmonicity));
+      value += std::sin(2.0 * kPi * n * f0 * stretch *
+                            static_cast<double>(i) / kSampleRate +
+                        0.7 * n) /
+               n;
+    }
+    samples[i] = static_cast<float>(0.3 * value);
+  }
+  return samples;
+}
+
+TEST(TargetNoteDetectorTest, RequiresATarget) {
+  TargetNoteDetector detector(kSampleRate, kBufferSize);
+  const auto samples = generate_string(440.0, 0.0, 1, kBufferSize);
+  EXPECT_FALSE(
+      detector.detect_pitch_detailed(samples.data(), samples.size()).is_valid);
+
+  detector.set_target(440.0);
+  EXPECT_TRUE(
+      detector.detect_pitch_detailed(samples.data(), samples.size()).is_valid);
+  EXPECT_FALSE(
+      detector.detect_pitch_detailed(samples.data(), kBufferSize / 2).is_valid);
+}
+
+TEST(TargetNoteDetectorTest, MeasuresDetunedSineToSubCent) {
+  FrequencyCalculator calc;
+  TargetNoteDetector detector(kSampleRate, kBufferSize);
+  detector.set_target(calc.midi_to_frequency(69));
+  for (double cents : {-45.0, -7.3, 0.0, 0.4, 12.0, 38.0}) {
+    const double frequency = 440.0 * std::exp2(cents / 1200.0);
+    const auto samples = generate_string(frequency, 0.0, 1, kBufferSize);
+    const DetectionResult result =
+        detector.detect_pitch_detailed(samples.data(), samples.size());
+    ASSERT_TRUE(result.is_valid) << cents;
+    EXPECT_NEAR(cents_between(result.frequency, 440.0), cents, 0.1);
+    EXPECT_GT(result.confidence, 0.9);
+  }
+}
+
+TEST(TargetNoteDetectorTest, CombinesStretchedPartials) {
+  // C4 three cents sharp with piano-like inharmonicity
+  const double target = 261.6256;
+  const double f0 = target * std::exp2(3.0 / 1200.0);
+  const double inharmonicity = 4e-4;
+  const auto samples = generate_string(f0, inharmonicity, 6, kBufferSize);
+
+  TargetNoteDetector detector(kSampleRate, kBufferSize);
+  detector.set_target(target);
+  detector.set_inharmonicity(inharmonicity);
+  detector.set_num_partials(6);
+  const DetectionResult result =
+      detector.detect_pitch_detailed(samples.data(), samples.size());
+  ASSERT_TRUE(result.is_valid);
+  EXPECT_NEAR(cents_between(result.frequency, target), 3.0, 0.2);
+  EXPECT_GT(result.confidence, 0.9);
+}
+
+TEST(TargetNoteDetectorTest, RejectsNoise) {
+  std::mt19937 rng(7);
+  std::normal_distribution<float> noise(0.0f, 0.1f);
+  std::vector<float> samples(kBufferSize);
+  for (float& sample : samples) {
+    sample = noise(rng);
+  }
+  TargetNoteDetector detector(kSampleRate, kBufferSize);
+  detector.set_target(440.0);
+  const DetectionResult result =
+      detector.detect_pitch_detailed(samples.data(), samples.size());
+  EXPECT_FALSE(result.is_valid);
+  EXPECT_LT(result.confidence, 0.2);
+}
+
+TEST(TargetNoteDetectorTest, RejectsTargetsItCannotResolve) {
+  // A1's partials are 55 Hz apart, under 4 half-frame bins of a 4096-sample
+  // frame: the reading would be biased, so it is invalid
+  const auto samples = generate_string(55.0, 0.0, 4, kBufferSize);
+  TargetNoteDetector detector(kSampleRate, kBufferSize);
+  detector.set_target(55.0);
+  EXPECT_GT(TargetNoteDetector::min_target(kSampleRate, kBufferSize), 55.0);
+  EXPECT_FALSE(
+      detector.detect_pitch_detailed(samples.data(), samples.size()).is_valid);
+}
+
+TEST(TargetNoteDetectorTest, ArenaBackedDetectorUsesReportedBytes) {
+  const std::size_t bytes = TargetNoteDetector::arena_bytes(kBufferSize);
+  BufferArena arena(bytes);
+  TargetNoteDetector detector(kSampleRate, kBufferSize, arena);
+  EXPECT_EQ(arena.used(), bytes);
+}
+
+TEST(TargetNoteDetectorTest, ControllerUsesTargetUntilCleared) {
+  // A4 8 cents sharp: the target reading is sub-cent; clearing the target
+  // returns to the tiers
+  PitchDetectionController controller(kBufferSize, kSampleRate);
+  const double frequency = 440.0 * std::exp2(8.0 / 1200.0);
+  const auto samples = generate_string(frequency, 0.0, 3, 4 * kBufferSize);
+  const auto feed = [&]() {
+    for (std::size_t i = 0; i < samples.size(); i += 256) {
+      controller.process_audio(samples.data() + i, 256);
+    }
+  };
+
+  controller.set_target_frequency(440.0);
+  feed();
+  double detected = 0.0;
+  double confidence = 0.0;
+  ASSERT_TRUE(controller.get_latest_result(detected, confidence));
+  EXPECT_NEAR(cents_between(detected, 440.0), 8.0, 0.1);
+
+  controller.set_target_frequency(0.0);
+  feed();
+  ASSERT_TRUE(controller.get_latest_result(detected, confidence));
+  EXPECT_NEAR(cents_between(detected, 440.0), 8.0, 5.0);
+}
+
+TEST(TargetNoteDetectorTest, ControllerMeasuresBassKeysOnLongerFrame) {
+  // Bass keys three cents sharp: partials closer than the full buffer
+  // resolves are measured on the longer bass frame
+  const FrequencyCalculator calc;
+  for (int midi : {21, 28, 33, 36}) {  // A0, E1, A1, C2
+    const double target = calc.midi_to_frequency(midi);
+    const double frequency = target * std::exp2(3.0 / 1200.0);
+    const auto samples = generate_string(frequency, 0.0, 4, 6 * kBufferSize);
+    PitchDetectionController controller(kBufferSize, kSampleRate);
+    controller.set_target_frequency(target);
+    for (std::size_t i = 0; i < samples.size(); i += 256) {
+      controller.process_audio(samples.data() + i, 256);
+    }
+    double detected = 0.0;
+    double confidence = 0.0;
+    ASSERT_TRUE(controller.get_latest_result(detected, confidence)) << midi;
+    EXPECT_NEAR(cents_between(detected, target), 3.0, 0.2) << midi;
+  }
+}
+
+}  // namespace
+}  // namespace simple_tuner
@@ -0,0 +1,306 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include "simple_tuner/algorithms/ToneGenerator.h"
+#include "simple_tuner/dsp/FastSine.h"
+
+namespace simple_tuner {
+namespace {
+
+constexpr double kSampleRate = 48000.0;
+constexpr double kPi = 3.14159265358979323846;
+
+// Enough samples for the gain ramp to settle
+constexpr std::size_t kSettleSamples = 1024;
+
+TEST(FastSineTest, MatchesStdSinOverOneCycle) {
+  double max_error = 0.0;
+  for (int i = -5000; i <= 5000; ++i) {
+    const double x = static_cast<double>(i) / 10000.0;
+    const double error = std::abs(
+        static_cast<double>(dsp::sin_2pi(static_cast<float>(x))) -
+        std::sin(2.0 * kPi * x));
+    max_error = std::max(max_error, error);
+  }
+  EXPECT_LT(max_error, 5e-7);
+}
+
+TEST(ToneGeneratorTest, DisabledByDefaultOutputsSilence) {
+  ToneGenerator generator;
+  std::vector<float> buffer(256, 1.0f);
+  generator.generate_samples(buffer.data(), buffer.size(), kSampleRate);
+  for (float sample : buffer) {
+    EXPECT_EQ(sample, 0.0f);
+  }
+}
+
+TEST(ToneGeneratorTest, SteadyStateMatchesReferenceSine) {
+  // Spectral purity: sample error below 1e-6 bounds every spur at -120 dBc
+  constexpr double kFrequency = 261.63;
+  ToneGenerator generator;
+  generator.set_frequency(kFrequency);
+  generator.set_amplitude(1.0f);
+  generator.set_enabled(true);
+
+  std::vector<float> buffer(kSettleSamples);
+  generator.generate_samples(buffer.data(), buffer.size(), kSampleRate);
+
+  double max_error = 0.0;
+  std::size_t position = kSettleSamples;
+  for (int block = 0; block < 400; ++block) {
+    std::vector<float> output(128);
+    generator.generate_samples(output.data(), output.size(), kSampleRate);
+    for (float sample : output) {
+      const double cycles =
+          kFrequency * static_cast<double>(position) / kSampleRate;
+      const double expected =
+          std::sin(2.0 * kPi * (cycles - std::floor(cycles)));
+      max_error = std::max(max_error, std::abs(sample - expected));
+      ++position;
+    }
+  }
+  EXPECT_LT(max_error, 1e-6);
+}
+
+TEST(ToneGeneratorTest, BlockSizeDoesNotChangeWaveform) {
+  ToneGenerator one_shot;
+  ToneGenerator blocked;
+  for (ToneGenerator* generator : {&one_shot, &blocked}) {
+    generator->set_frequency(1000.0);
+    generator->set_enabled(true);
+  }
+
+  std::vector<float> expected(4096);
+  one_shot.generate_samples(expected.data(), expected.size(), kSampleRate);
+
+  std::vector<float> actual(4096);
+  // Ramp finishes well inside the first block, so only the phase matters
+  blocked.generate_samples(actual.data(), 2048, kSampleRate);
+  for (std::size_t offset = 2048; offset < actual.size(); offset += 128) {
+    blocked.generate_samples(actual.data() + offset, 128, kSampleRate);
+  }
+
+  for (std::size_t i = 2048; i < actual.size(); ++i) {
+    EXPECT_NEAR(actual[i], expected[i], 1e-5) << i;
+  }
+}
+
+TEST(ToneGeneratorTest, GainChangesAreRamped) {
+  ToneGenerator generator;
+  generator.set_sample_rate(kSampleRate);
+  generator.set_amplitude(1.0f);
+  generator.set_enabled(true);
+
+  std::vector<float> buffer(32);
+  generator.process(buffer.data(), static_cast<int>(buffer.size()));
+
+  // 32 samples is a fraction of the 5 ms ramp, so the tone is still quiet
+  for (float sample : buffer) {
+    EXPECT_LT(std::abs(sample), 0.2f);
+  }
+
+  std::vector<float> settle(kSettleSamples);
+  generator.process(settle.data(), static_cast<int>(settle.size()));
+  generator.set_enabled(false);
+  generator.process(settle.data(), static_cast<int>(settle.size()));
+  std::vector<float> silent(128, 1.0f);
+  generator.process(silent.data(), static_cast<int>(silent.size()));
+  for (float sample : silent) {
+    EXPECT_EQ(sample, 0.0f);
+  }
+}
+
+TEST(ToneGeneratorTest, FrequencyClampedBelowNyquist) {
+  ToneGenerator generator;
+  generator.set_frequency(1e9);
+  generator.set_enabled(true);
+  generator.set_frequency(-5.0);  // Ignored
+  EXPECT_EQ(generator.get_frequency(), 1e9);
+
+  std::vector<float> buffer(512);
+  generator.generate_samples(buffer.data(), buffer.size(), kSampleRate);
+  for (float sample : buffer) {
+    EXPECT_TRUE(std::isfinite(sample));
+    EXPECT_LE(std::abs(sample), 1.0f);
+  }
+}
+
+// Rising zero crossings per second over x (frequency estimate)
+double crossing_rate(const float* x, std::size_t n) {
+  int crossings = 0;
+  std::size_t first = 0;
+  std::size_t last = 0;
+  for (std::size_t i = 1; i < n; ++i) {
+    if (x[i - 1] < 0.0f && x[i] >= 0.0f) {
+      if (crossings == 0) {
+        first = i;
+      }
+      last = i;
+      ++crossings;
+    }
+  }
+  return (crossings - 1) * kSampleRate / static_cast<double>(last - first);
+}
+
+TEST(ToneGeneratorTest, ScheduledEventAppliesAtExactSample) {
+  ToneGenerator generator;
+  generator.set_amplitude(1.0f);
+  ASSERT_TRUE(generator.schedule(ToneGenerator::Parameter::kEnabled, 1.0,
+                                 1000));
+
+  std::vector<float> buffer(2048);
+  for (std::size_t offset = 0; offset < buffer.size(); offset += 512) {
+    generator.generate_samples(buffer.data() + offset, 512, kSampleRate);
+  }
+  EXPECT_EQ(generator.sample_time(), 2048u);
+
+  for (std::size_t i = 0; i <= 1000; ++i) {
+    ASSERT_EQ(buffer[i], 0.0f) << i;
+  }
+  EXPECT_NE(buffer[1001], 0.0f);
+}
+
+TEST(ToneGeneratorTest, FrequencyChangeGlidesWithoutDiscontinuity) {
+  ToneGenerator generator;
+  generator.set_amplitude(1.0f);
+  generator.set_enabled(true);
+
+  std::vector<float> buffer(kSettleSamples + 9600);
+  generator.generate_samples(buffer.data(), kSettleSamples, kSampleRate);
+  generator.set_frequency(880.0);
+  for (std::size_t offset = kSettleSamples; offset < buffer.size();
+       offset += 128) {
+    generator.generate_samples(buffer.data() + offset, 128, kSampleRate);
+  }
+
+  // A unit sine at 880 Hz moves at most 2 pi 880 / fs per sample
+  const double max_step = 2.0 * kPi * 880.0 / kSampleRate;
+  for (std::size_t i = 1; i < buffer.size(); ++i) {
+    ASSERT_LE(std::abs(buffer[i] - buffer[i - 1]), max_step + 1e-4) << i;
+  }
+
+  // Settled on the new pitch after the 10 ms glide
+  const std::size_t tail = buffer.size() - 4800;
+  EXPECT_NEAR(crossing_rate(buffer.data() + tail, 4800), 880.0, 1.0);
+}
+
+TEST(ToneGeneratorTest, QueueOverflowResyncsToLatestSettings) {
+  ToneGenerator generator;
+  generator.set_glide_time(0.0);
+  generator.set_enabled(true);
+  for (int i = 0; i < 3 * static_cast<int>(ToneGenerator::kEventCapacity);
+       ++i) {
+    generator.set_frequency(200.0 + i);
+  }
+  generator.set_frequency(1000.0);
+
+  std::vector<float> buffer(9600);
+  generator.generate_samples(buffer.data(), buffer.size(), kSampleRate);
+  EXPECT_NEAR(crossing_rate(buffer.data() + 4800, 4800), 1000.0, 1.0);
+}
+
+TEST(ToneGeneratorTest, PoolVoicesSumLikeSeparateGenerators) {
+  // Five voices exercise the eight-lane path; each voice must sound exactly
+  // as it would alone
+  const double frequencies[] = {220.0, 261.63, 329.63, 392.0, 440.0};
+  ToneGenerator pool;
+  pool.set_amplitude(0.2f);
+  pool.set_frequency(frequencies[0]);
+  pool.set_enabled(true);
+  for (int v = 1; v < 5; ++v) {
+    EXPECT_NE(pool.note_on(frequencies[v], 0.2f), 0u);
+  }
+
+  std::vector<float> expected(2048, 0.0f);
+  for (double frequency : frequencies) {
+    ToneGenerator single;
+    single.set_amplitude(0.2f);
+    single.set_frequency(frequency);
+    single.set_enabled(true);
+    std::vector<float> voice(expected.size());
+    single.generate_samples(voice.data(), voice.size(), kSampleRate);
+    for (std::size_t i = 0; i < voice.size(); ++i) {
+      expected[i] += voice[i];
+    }
+  }
+
+  std::vector<float> actual(expected.size());
+  pool.generate_samples(actual.data(), actual.size(), kSampleRate);
+  EXPECT_EQ(pool.active_voices(), 5);
+  for (std::size_t i = 0; i < actual.size(); ++i) {
+    ASSERT_NEAR(actual[i], expected[i], 1e-5) << i;
+  }
+}
+
+TEST(ToneGeneratorTest, UnisonVoicesBeatAtFrequencyDifference) {
+  // 440 Hz against 442 Hz: two beats per second, cancelling at the troughs
+  ToneGenerator generator;
+  generator.set_frequency(440.0);
+  generator.set_enabled(true);
+  generator.note_on(442.0, 0.5f);
+
+  std::vector<float> buffer(static_cast<std::size_t>(kSampleRate));
+  generator.generate_samples(buffer.data(), buffer.size(), kSampleRate);
+
+  // Peak level per 10 ms window: loud at the crests, near silent between
+  float loudest = 0.0f;
+  float quietest = 1.0f;
+  for (std::size_t start = 960; start + 480 <= buffer.size(); start += 480) {
+    float peak = 0.0f;
+    for (std::size_t i = start; i < start + 480; ++i) {
+      peak = std::max(peak, std::abs(buffer[i]));
+    }
+    loudest = std::max(loudest, peak);
+    quietest = std::min(quietest, peak);
+  }
+  EXPECT_GT(loudest, 0.95f);
+  EXPECT_LT(quietest, 0.1f);
+}
+
+TEST(ToneGeneratorTest, OldestVoiceIsStolenWhenPoolIsFull) {
+  ToneGenerator generator;
+  std::vector<float> buffer(kSettleSamples);
+  std::vector<ToneGenerator::VoiceId> voices;
+  for (int v = 0; v < ToneGenerator::kMaxVoices; ++v) {
+    voices.push_back(generator.note_on(200.0 + 100.0 * v, 0.1f));
+    generator.generate_samples(buffer.data(), buffer.size(), kSampleRate);
+  }
+  // Seven pool voices; the eighth note took over the first
+  EXPECT_EQ(generator.active_voices(), ToneGenerator::kMaxVoices - 1);
+
+  // The stolen id no longer refers to a voice
+  generator.note_off(voices[0]);
+  generator.generate_samples(buffer.data(), buffer.size(), kSampleRate);
+  EXPECT_EQ(generator.active_voices(), ToneGenerator::kMaxVoices - 1);
+
+  generator.note_off(voices[1]);
+  generator.generate_samples(buffer.data(), buffer.size(), kSampleRate);
+  EXPECT_EQ(generator.active_voices(), ToneGenerator::kMaxVoices - 2);
+
+  generator.all_notes_off();
+  generator.generate_samples(buffer.data(), buffer.size(), kSampleRate);
+  EXPECT_EQ(generator.active_voices(), 0);
+}
+
+TEST(ToneGeneratorTest, NoteOffFadesOut) {
+  ToneGenerator generator;
+  const ToneGenerator::VoiceId voice = generator.note_on(1000.0, 1.0f);
+  std::vector<float> buffer(kSettleSamples);
+  generator.generate_samples(buffer.data(), buffer.size(), kSampleRate);
+
+  ASSERT_TRUE(generator.note_off(voice));
+  std::vector<float> fade(480);
+  generator.generate_samples(fade.data(), fade.size(), kSampleRate);
+  // Unit sine at 1 kHz moves at most 2 pi 1000 / fs per sample
+  const double max_step = 2.0 * kPi * 1000.0 / kSampleRate;
+  EXPECT_LE(std::abs(fade[0] - buffer.back()), max_step + 1e-4);
+  for (std::size_t i = 1; i < fade.size(); ++i) {
+    ASSERT_LE(std::abs(fade[i] - fade[i - 1]), max_step + 1e-4) << i;
+  }
+  EXPECT_EQ(fade.back(), 0.0f);
+}
+
+}  // namespace
+}  // namespace simple_tuner
@@ -0,0 +1,215 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "simple_tuner/algorithms/TuningTable.h"
+#include "simple_tuner/dsp/FastLog2.h"
+
+namespace simple_tuner {
+namespace {
+
+TEST(FastLog2Test, ErrorWithinDocumentedBound) {
+  // Dense sweep over the audio range plus the mantissa fold point
+  double max_error = 0.0;
+  for (double x = 1.0; x < 30000.0; x *= 1.0001) {
+    max_error = std::max(max_error, std::abs(dsp::fast_log2(x) - std::log2(x)));
+  }
+  for (double x : {1.41421356, 1.41421357, 0.001, 1e-300, 1e300}) {
+    max_error = std::max(max_error, std::abs(dsp::fast_log2(x) - std::log2(x)));
+  }
+  EXPECT_LT(max_error, 1.1e-9);
+  EXPECT_EQ(dsp::fast_log2(1.0), 0.0);
+  EXPECT_EQ(dsp::fast_log2(1024.0), 10.0);
+}
+
+TEST(TuningTableTest, EqualTemperamentMatchesFormula) {
+  TuningTable table;
+  for (int key = TuningTable::kFirstKey; key <= TuningTable::kLastKey; ++key) {
+    const double expected = 440.0 * std::pow(2.0, (key - 69) / 12.0);
+    EXPECT_NEAR(table.target_frequency(key) / expected, 1.0, 1e-12) << key;
+  }
+  // Outside the piano range the formula is used directly
+  EXPECT_NEAR(table.target_frequency(120), 440.0 * std::pow(2.0, 51 / 12.0),
+              1e-6);
+}
+
+TEST(TuningTableTest, ReferenceChangeRebuildsAllKeys) {
+  TuningTable table;
+  table.set_temperament(Temperament::kWerckmeisterIII);
+  const double c4 = table.target_frequency(60);
+  table.set_reference_a4(442.0);
+  EXPECT_DOUBLE_EQ(table.target_frequency(69), 442.0);
+  EXPECT_NEAR(table.target_frequency(60) / c4, 442.0 / 440.0, 1e-12);
+}
+
+TEST(TuningTableTest, HistoricalTemperamentsKeepAAtReference) {
+  const Temperament temperaments[] = {
+      Temperament::kPythagorean, Temperament::kQuarterCommaMeantone,
+      Temperament::kWerckmeisterIII, Temperament::kKirnbergerIII,
+      Temperament::kVallotti};
+  for (Temperament temperament : temperaments) {
+    TuningTable table;
+    table.set_temperament(temperament);
+    EXPECT_DOUBLE_EQ(table.target_frequency(69), 440.0);
+    EXPECT_NEAR(table.target_frequency(57), 220.0, 1e-9);
+  }
+}
+
+TEST(TuningTableTest, MeantoneHasPureMajorThirds) {
+  TuningTable table;
+  table.set_temperament(Temperament::kQuarterCommaMeantone);
+  // C4 -> E4 is a just 5:4 to within the table's 0.01-cent rounding
+  const double ratio = table.target_frequency(64) / table.target_frequency(60);
+  EXPECT_NEAR(1200.0 * std::log2(ratio / 1.25), 0.0, 0.02);
+
+  // Pythagorean fifths are a pure 3:2
+  table.set_temperament(Temperament::kPythagorean);
+  const double fifth =
+      table.target_frequency(67) / table.target_frequency(60);
+  EXPECT_NEAR(1200.0 * std::log2(fifth / 1.5), 0.0, 0.02);
+}
+
+TEST(TuningTableTest, TemperamentsFollowTheirChainsOfFifths) {
+  // Fifths Eb-Bb, Bb-F, ..., C#-G# in cents (G#-Eb, the wolf where there
+  // is one, takes up the rest); each pitch class deviates from equal
+  // temperament by the sum of (fifth - 700) along the chain
+  constexpr double kPure = 701.955;
+  constexpr double kMeantone = 696.578;            // 1/4 syntonic comma
+  constexpr double kQuarterPythagorean = 696.090;  // 1/4 Pythagorean comma
+  constexpr double kSixthPythagorean = 698.045;    // 1/6 Pythagorean comma
+  constexpr double kSchisma = 700.001;             // Pure less a schisma
+  struct Chain {
+    Temperament temperament;
+    std::array<double, 11> fifths;
+  };
+  const Chain chains[] = {
+      {Temperament::kPythagorean,
+       {kPure, kPure, kPure, kPure, kPure, kPure, kPure, kPure, kPure, kPure,
+        kPure}},
+      {Temperament::kQuarterCommaMeantone,
+       {kMeantone, kMeantone, kMeantone, kMeantone, kMeantone, kMeantone,
+        kMeantone, kMeantone, kMeantone, kMeantone, kMeantone}},
+      {Temperament::kWerckmeisterIII,
+       {kPure, kPure, kPure, kQuarterPythagorean, kQuarterPythagorean,
+        kQuarterPythagorean, kPure, kPure, kQuarterPythagorean, kPure,
+        kPure}},
+      {Temperament::kKirnbergerIII,
+       {kPure, kPure, kPure, kMeantone, kMeantone, kMeantone, kMeantone,
+        kPure, kPure, kSchisma, kPure}},
+      {Temperament::kVallotti,
+       {kPure, kPure, kSixthPythagorean, kSixthPythagorean, kSixthPythagorean,
+        kSixthPythagorean, kSixthPythagorean, kSixthPythagorean, kPure, kPure,
+        kPure}},
+  };
+  constexpr int kPitchClassEb = 3;
+  constexpr int kPitchClassA = 9;
+  for (const Chain& chain : chains) {
+    std::array<double, 12> deviation{};
+    int pitch_class = kPitchClassEb;
+    for (double fifth : chain.fifths) {
+      const int next = (pitch_class + 7) % 12;
+      deviation[next] = deviation[pitch_class] + (fifth - 700.0);
+      pitch_class = next;
+    }
+    for (int pc = 0; pc < 12; ++pc) {
+      // The table holds 0.01-cent values; offsets are taken relative to A
+      EXPECT_NEAR(TuningTable::temperament_offset(chain.temperament, pc),
+                  deviation[pc] - deviation[kPitchClassA], 0.015)
+          << static_cast<int>(chain.temperament) << " pitch class " << pc;
+    }
+  }
+}
+
+TEST(TuningTableTest, StretchCurveOffsetsKeys) {
+  TuningTable table;
+  std::array<double, TuningTable::kNumKeys> stretch{};
+  for (int i = 0; i < TuningTable::kNumKeys; ++i) {
+    stretch[static_cast<std::size_t>(i)] = 0.5 * (i - 48);  // A4 is index 48
+  }
+  table.set_stretch_curve(stretch);
+  EXPECT_DOUBLE_EQ(table.target_frequency(69), 440.0);
+  EXPECT_NEAR(table.cents_from_target(440.0 * std::pow(2.0, 39 / 12.0), 108),
+              -19.5, 1e-6);
+  EXPECT_DOUBLE_EQ(table.get_key_offset(108), 19.5);
+
+  table.set_key_offset(69, 3.0);
+  EXPECT_NEAR(table.cents_from_target(440.0, 69), -3.0, 1e-6);
+
+  table.clear_stretch_curve();
+  EXPECT_NEAR(table.cents_from_target(440.0, 69), 0.0, 1e-6);
+}
+
+TEST(TuningTableTest, NearestKeyFollowsTargets) {
+  TuningTable table;
+  EXPECT_EQ(table.nearest_key(440.0), 69);
+  EXPECT_EQ(table.nearest_key(452.0), 69);  // +47 cents
+  EXPECT_EQ(table.nearest_key(454.0), 70);  // +54 cents
+  EXPECT_EQ(table.nearest_key(1.0), TuningTable::kFirstKey);
+  EXPECT_EQ(table.nearest_key(20000.0), TuningTable::kLastKey);
+
+  // A4 stretched 40 cents sharp: 452 Hz is now nearest to it, and 430 Hz
+  // (-40 cents) is nearer G#4
+  table.set_key_offset(69, 40.0);
+  EXPECT_EQ(table.nearest_key(452.0), 69);
+  EXPECT_EQ(table.nearest_key(430.0), 68);
+}
+
+TEST(TuningTableTest, CentsMatchExactFormula) {
+  TuningTable table;
+  table.set_temperament(Temperament::kVallotti);
+  for (double frequency = 30.0; frequency < 4200.0; frequency *= 1.013) {
+    const int key = table.nearest_key(frequency);
+    const double exact =
+        1200.0 * std::log2(frequency / table.target_frequency(key));
+    ASSERT_NEAR(table.cents_from_target(frequency, key), exact, 2e-6);
+    ASSERT_LE(std::abs(exact), 60.0);
+  }
+}
+
+TEST(TuningTableTest, BatchMatchesScalarLookups) {
+  TuningTable table(442.0);
+  table.set_temperament(Temperament::kWerckmeisterIII);
+  std::array<double, TuningTable::kNumKeys> stretch{};
+  for (int i = 0; i < TuningTable::kNumKeys; ++i) {
+    stretch[static_cast<std::size_t>(i)] = 0.004 * (i - 40) * (i - 40) - 5.0;
+  }
+  table.set_stretch_curve(stretch);
+
+  // More than one internal chunk, from below A0 to above C8
+  std::vector<double> frequencies;
+  for (double frequency = 20.0; frequency < 5000.0; frequency *= 1.007) {
+    frequencies.push_back(frequency);
+  }
+  const std::size_t count = frequencies.size();
+  ASSERT_GT(count, 600u);
+  std::vector<int> keys(count);
+  std::vector<double> cents(count);
+  table.nearest_keys(frequencies.data(), count, keys.data(), cents.data());
+
+  for (std::size_t i = 0; i < count; ++i) {
+    const int key = table.nearest_key(frequencies[i]);
+    ASSERT_EQ(keys[i], key) << frequencies[i];
+    ASSERT_NEAR(cents[i], table.cents_from_target(frequencies[i], key), 0.01);
+  }
+}
+
+TEST(TuningTableTest, BatchMapsInvalidFrequenciesToFirstKey) {
+  TuningTable table;
+  const double frequencies[] = {
+      0.0, -440.0, std::numeric_limits<double>::quiet_NaN(), 440.0};
+  int keys[4];
+  double cents[4];
+  table.nearest_keys(frequencies, 4, keys, cents);
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(keys[i], TuningTable::kFirstKey);
+    EXPECT_EQ(cents[i], 0.0);
+  }
+  EXPECT_EQ(keys[3], 69);
+  EXPECT_NEAR(cents[3], 0.0, 1e-6);
+}
+
+}  // namespace
+}  // namespace simple_tuner
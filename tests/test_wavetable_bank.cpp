@@ -0,0 +1,175 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "simple_tuner/algorithms/PitchDetector.h"
+#include "simple_tuner/algorithms/ToneGenerator.h"
+#include "simple_tuner/algorithms/WavetableBank.h"
+
+namespace simple_tuner {
+namespace {
+
+constexpr double kSampleRate = 48000.0;
+constexpr double kPi = 3.14159265358979323846;
+
+// Magnitude of the DFT of a table at an integer bin (cycles per table)
+double bin_magnitude(const WavetableBank::Table& table, std::size_t bin) {
+  double re = 0.0;
+  double im = 0.0;
+  const double step = 2.0 * kPi * static_cast<double>(bin) /
+                      static_cast<double>(table.length);
+  for (std::size_t j = 0; j < table.length; ++j) {
+    re += table.samples[j] * std::cos(step * static_cast<double>(j));
+    im -= table.samples[j] * std::sin(step * static_cast<double>(j));
+  }
+  return std::hypot(re, im) / static_cast<double>(table.length);
+}
+
+TEST(WavetableBankTest, RespectsMemoryBudget) {
+  const std::size_t budgets[] = {128 * 1024, 1024 * 1024, 4 * 1024 * 1024};
+  std::size_t previous_length = 0;
+  for (std::size_t budget : budgets) {
+    WavetableBank bank(kSampleRate, budget);
+    EXPECT_LE(bank.memory_bytes(), budget);
+    const std::size_t length = bank.table_length();
+    EXPECT_EQ(length & (length - 1), 0u);  // Power of two
+    EXPECT_GT(length, previous_length);
+    previous_length = length;
+  }
+}
+
+TEST(WavetableBankTest, TablesNormalizedWithGuardSample) {
+  WavetableBank bank(kSampleRate);
+  for (int note = 21; note <= 108; note += 7) {
+    const auto& table = bank.table_for_note(note);
+    const float peak = std::abs(*std::max_element(
+        table.samples, table.samples + table.length,
+        [](float a, float b) { return std::abs(a) < std::abs(b); }));
+    EXPECT_NEAR(peak, 1.0f, 1e-6f);
+    EXPECT_EQ(table.samples[table.length], table.samples[0]);
+  }
+}
+
+TEST(WavetableBankTest, PartialsFollowInharmonicSeries) {
+  // A low bass string: partial 7 sits well above 7 * f0
+  WavetableBank bank(kSampleRate);
+  const auto& table = bank.table_for_note(24);
+  const double b = WavetableBank::inharmonicity(25);
+  const double ratio = 7.0 * std::sqrt((1.0 + b * 49.0) / (1.0 + b));
+  const auto stretched =
+      static_cast<std::size_t>(std::lround(table.cycles * ratio));
+  const auto harmonic = static_cast<std::size_t>(7.0 * table.cycles);
+  ASSERT_NE(stretched, harmonic);
+  EXPECT_GT(bin_magnitude(table, stretched), 0.01);
+  EXPECT_LT(bin_magnitude(table, harmonic), 1e-4);
+}
+
+TEST(WavetableBankTest, BandLimitedForHighestKeyInRange) {
+  WavetableBank bank(kSampleRate);
+  const auto& table = bank.table_for_note(108);  // C8
+  const double top_frequency = 440.0 * std::pow(2.0, (108 - 69) / 12.0);
+  // Table bins map to multiples of f0 / cycles; check everything at or above
+  // Nyquist for the highest key of the range
+  const auto first_alias = static_cast<std::size_t>(
+      std::ceil(0.5 * kSampleRate * table.cycles / top_frequency));
+  for (std::size_t bin = first_alias; bin < table.length / 2; bin += 3) {
+    ASSERT_LT(bin_magnitude(table, bin), 1e-5) << "bin " << bin;
+  }
+}
+
+TEST(WavetableBankTest, PianoToneFundamentalAtSetFrequency) {
+  WavetableBank bank(kSampleRate);
+  ToneGenerator generator;
+  generator.set_wavetable_bank(&bank);
+  generator.set_waveform(ToneGenerator::Waveform::kPiano);
+  generator.set_frequency(220.0);
+  generator.set_enabled(true);
+
+  // One second: the spectrum resolves 1 Hz
+  std::vector<float> buffer(static_cast<std::size_t>(kSampleRate));
+  generator.generate_samples(buffer.data(), buffer.size(), kSampleRate);
+
+  const auto magnitude = [&](double frequency) {
+    double re = 0.0;
+    double im = 0.0;
+    for (std::size_t i = 0; i < buffer.size(); ++i) {
+      const double angle =
+          2.0 * kPi * frequency * static_cast<double>(i) / kSampleRate;
+      re += buffer[i] * std::cos(angle);
+      im += buffer[i] * std::sin(angle);
+    }
+    return std::hypot(re, im) / static_cast<double>(buffer.size());
+  };
+  const double fundamental = magnitude(220.0);
+  EXPECT_GT(fundamental, 0.05);
+  EXPECT_GT(fundamental, 100.0 * magnitude(219.0));
+  EXPECT_GT(fundamental, 100.0 * magnitude(221.0));
+
+  // Stretched upper partials pull a time-domain tuner slightly sharp, as
+  // on a real piano, but by well under a semitone
+  PitchDetector detector(kSampleRate, 4096);
+  const double detected = detector.detect_pitch(buffer.data() + 4096, 4096);
+  EXPECT_NEAR(1200.0 * std::log2(detected / 220.0), 0.0, 10.0);
+}
+
+TEST(WavetableBankTest, GlideAcrossRangeBoundaryDoesNotClick) {
+  // A2 -> D3 crosses into the next key range's table
+  WavetableBank bank(kSampleRate);
+  ASSERT_NE(&bank.table_for_frequency(110.0),
+            &bank.table_for_frequency(146.83));
+
+  constexpr std::size_t kBlock = 128;
+  // How large a phase jump is depends on where the table changes, so the
+  // glide starts at several phases
+  for (std::size_t glide_block = 100; glide_block < 108; ++glide_block) {
+    ToneGenerator generator;
+    generator.set_wavetable_bank(&bank);
+    generator.set_waveform(ToneGenerator::Waveform::kPiano);
+    generator.set_amplitude(1.0f);
+    generator.set_glide_time(0.05);
+    generator.set_frequency(110.0);
+    generator.set_enabled(true);
+
+    const std::size_t glide_start = glide_block * kBlock;
+    std::vector<float> buffer(glide_start + 300 * kBlock);
+    for (std::size_t offset = 0; offset < buffer.size(); offset += kBlock) {
+      if (offset == glide_start) {
+        generator.set_frequency(146.83);
+      }
+      generator.generate_samples(buffer.data() + offset, kBlock, kSampleRate);
+    }
+
+    const auto max_step = [&](std::size_t begin, std::size_t end) {
+      float step = 0.0f;
+      for (std::size_t i = begin + 1; i < end; ++i) {
+        step = std::max(step, std::abs(buffer[i] - buffer[i - 1]));
+      }
+      return step;
+    };
+    // The steepest the waveform gets once settled on D3 bounds every step
+    // of the glide up to it (a phase jump at the table change would not be)
+    const std::size_t settled = glide_start + 100 * kBlock;
+    EXPECT_LE(max_step(glide_start, settled),
+              1.1f * max_step(settled, buffer.size()))
+        << glide_block;
+  }
+}
+
+TEST(WavetableBankTest, PianoModeWithoutBankPlaysSine) {
+  ToneGenerator piano;
+  piano.set_waveform(ToneGenerator::Waveform::kPiano);
+  piano.set_enabled(true);
+  ToneGenerator sine;
+  sine.set_enabled(true);
+
+  std::vector<float> a(512);
+  std::vector<float> b(512);
+  piano.generate_samples(a.data(), a.size(), kSampleRate);
+  sine.generate_samples(b.data(), b.size(), kSampleRate);
+  EXPECT_EQ(a, b);
+}
+
+}  // namespace
+}  // namespace simple_tuner